@@ -5359,13 +5359,17 @@ void GetSnowflakeSemiStructuredFunctions(TypeFactory* type_factory,
         fn_options);
 
     // GET, GET_IGNORE_CASE
-    InsertFunction(
-        functions, options, "get", SCALAR,
-        {{variant_type, {array_variant_type, int64_type}, FN_GET_ARRAY},
-         {variant_type, {object_type, string_type}, FN_GET_OBJECT},
-         {variant_type, {variant_type, int64_type}, FN_GET_VARIANT_INT64},
-         {variant_type, {variant_type, string_type}, FN_GET_OBJECT_STRING}},
-        FunctionOptions().set_alias_name("get_ignore_case"));
+    // GET_IGNORE_CASE is a separate function rather than an alias so that the
+    // resolved call keeps its name; it shares its signature ids with GET and
+    // is told apart by name when it is evaluated.
+    for (absl::string_view name : {"get", "get_ignore_case"}) {
+      InsertFunction(
+          functions, options, name, SCALAR,
+          {{variant_type, {array_variant_type, int64_type}, FN_GET_ARRAY},
+           {variant_type, {object_type, string_type}, FN_GET_OBJECT},
+           {variant_type, {variant_type, int64_type}, FN_GET_VARIANT_INT64},
+           {variant_type, {variant_type, string_type}, FN_GET_OBJECT_STRING}});
+    }
 
     // GET_PATH
     InsertFunction(
@@ -22,6 +22,7 @@
 #include <string>
 
 #include "zetasql/base/logging.h"
+#include "absl/container/inlined_vector.h"
 #include "absl/strings/ascii.h"
 #include "absl/strings/escaping.h"
 #include "absl/strings/match.h"
@@ -84,6 +85,195 @@ bool JSONParser::ParseValue() {
   }
 }
 
+bool JSONParser::ParseOrSkipValue() {
+  const int max_depth = SkippableValueDepth();
+  if (max_depth >= 0) {
+    const absl::string_view value_start = p_;
+    if (SkipValue(max_depth)) return true;
+    // Parse the value again to report the failure through the handlers.
+    p_ = value_start;
+  }
+  return ParseValue();
+}
+
+// Mirrors ParseValue(), ParseObject() and ParseArray() iteratively, keeping
+// the open containers on a stack instead of recursing.
+bool JSONParser::SkipValue(const int max_depth) {
+  // The closing characters of the open objects and arrays, innermost last.
+  absl::InlinedVector<char, 16> closers;
+  while (true) {
+    // Skip a value.
+    SkipWhitespace();
+    if (p_.empty()) return false;
+    switch (*p_.data()) {
+      case '\"':
+      case '\'':
+        if (!SkipString()) return false;
+        break;
+      case '-':
+      case '0':
+      case '1':
+      case '2':
+      case '3':
+      case '4':
+      case '5':
+      case '6':
+      case '7':
+      case '8':
+      case '9':
+        if (!SkipNumber()) return false;
+        break;
+      case '{':
+      case '[': {
+        if (closers.size() >= max_depth) return false;
+        const char closer = *p_.data() == '{' ? '}' : ']';
+        AdvanceOneByte();
+        SkipWhitespace();
+        if (!p_.empty() && *p_.data() == closer) {
+          AdvanceOneByte();
+          break;
+        }
+        closers.push_back(closer);
+        if (closer == ']') continue;
+        // Skip the key of the first member, then its value.
+        if (p_.empty() || (*p_.data() != '\"' && *p_.data() != '\'') ||
+            !SkipString()) {
+          return false;
+        }
+        SkipWhitespace();
+        if (p_.empty() || *p_.data() != ':') return false;
+        AdvanceOneByte();
+        continue;
+      }
+      case ']':
+      case ',':
+        // ParseValue() reports a null for a missing value.
+        break;
+      case 't':
+        if (!absl::StartsWith(p_, kTrue)) return false;
+        p_.remove_prefix(kTrue.length());
+        break;
+      case 'f':
+        if (!absl::StartsWith(p_, kFalse)) return false;
+        p_.remove_prefix(kFalse.length());
+        break;
+      case 'n':
+        if (!absl::StartsWith(p_, kNull)) return false;
+        p_.remove_prefix(kNull.length());
+        break;
+      default:
+        return false;
+    }
+    // A value was skipped; close containers until one continues.
+    while (true) {
+      if (closers.empty()) return true;
+      SkipWhitespace();
+      if (p_.empty()) return false;
+      const char c = *p_.data();
+      AdvanceOneByte();
+      if (c == ',') {
+        // Allow a trailing ',' before the closing character.
+        SkipWhitespace();
+        if (!p_.empty() && *p_.data() == closers.back()) {
+          AdvanceOneByte();
+          closers.pop_back();
+          continue;
+        }
+        if (closers.back() == '}') {
+          if (p_.empty() || (*p_.data() != '\"' && *p_.data() != '\'') ||
+              !SkipString()) {
+            return false;
+          }
+          SkipWhitespace();
+          if (p_.empty() || *p_.data() != ':') return false;
+          AdvanceOneByte();
+        }
+        break;
+      }
+      if (c != closers.back()) return false;
+      closers.pop_back();
+    }
+  }
+}
+
+// Mirrors ParseStringHelper(), including how it advances through escapes and
+// multi-byte characters.
+bool JSONParser::SkipString() {
+  const char open = *p_.data();
+  AdvanceOneByte();
+  for (; !p_.empty(); AdvanceOneCodepoint()) {
+    // Skip ahead over a run of plain ASCII characters.
+    const char* p = p_.data();
+    const char* const end = p + p_.size();
+    while (p < end && *p != open && *p != '\\' &&
+           static_cast<unsigned char>(*p) < 0x80) {
+      ++p;
+    }
+    p_.remove_prefix(p - p_.data());
+    if (p_.empty()) break;
+    const char c = *p_.data();
+    if (c == open) {
+      AdvanceOneCodepoint();
+      return true;
+    }
+    if (c != '\\') continue;
+    if (p_.length() == 1) return false;
+    const char escaped = p_.data()[1];
+    if (escaped == 'u' || escaped == 'x') {
+      const int size =
+          escaped == 'u' ? kUnicodeEscapedLength : kLatin1HexEscapedLength;
+      if (p_.length() < size) return false;
+      for (int i = 2; i < size; ++i) {
+        if (!absl::ascii_isxdigit(p_.data()[i])) return false;
+      }
+      p_.remove_prefix(size - 1);
+    } else if (IsOctalDigit(escaped)) {
+      int num_octal_digits = 1;
+      while (num_octal_digits <
+                 std::min<int>(p_.length(), kLatin1OctEscapedLength) &&
+             IsOctalDigit(p_.data()[num_octal_digits])) {
+        ++num_octal_digits;
+      }
+      p_.remove_prefix(num_octal_digits - 1);
+    } else {
+      p_.remove_prefix(1);
+    }
+  }
+  return false;
+}
+
+bool JSONParser::SkipNumber() {
+  const char* p = p_.data();
+  const char* end = p + p_.size();
+  if (*p == '-') p++;
+  if (p < end && *p == '0') {
+    p++;
+  } else if (p < end && *p >= '1' && *p <= '9') {
+    do {
+      p++;
+    } while (p < end && *p >= '0' && *p <= '9');
+  } else {
+    return false;
+  }
+  if (p < end && *p == '.') {
+    p++;
+    if (p >= end || *p < '0' || *p > '9') return false;
+    do {
+      p++;
+    } while (p < end && *p >= '0' && *p <= '9');
+  }
+  if (p < end && (*p == 'e' || *p == 'E')) {
+    p++;
+    if (p < end && (*p == '+' || *p == '-')) p++;
+    if (p >= end || *p < '0' || *p > '9') return false;
+    do {
+      p++;
+    } while (p < end && *p >= '0' && *p <= '9');
+  }
+  p_.remove_prefix(p - p_.data());
+  return true;
+}
+
 bool JSONParser::ParseString() {
   std::string str;
   if (!ParseStringHelper(&str)) return false;
@@ -352,7 +542,7 @@ bool JSONParser::ParseObject() {
     AdvanceOneByte();
 
     // Parse the value for this member
-    if (!ParseValue()) return ReportFailure("Could not parse value");
+    if (!ParseOrSkipValue()) return ReportFailure("Could not parse value");
 
     // ',' '}' or possibly ',}' must appear next.
     t = GetNextTokenType();
@@ -395,7 +585,7 @@ bool JSONParser::ParseArray() {
   while (true) {
     if (!BeginArrayEntry())
       return ReportFailure("BeginArrayEntry returned false");
-    if (!ParseValue()) return ReportFailure("Could not parse value");
+    if (!ParseOrSkipValue()) return ReportFailure("Could not parse value");
 
     // ',' ']' or possibly ',]' must appear next.
     t = GetNextTokenType();
@@ -558,4 +748,6 @@ bool JSONParser::ParsedNumber(absl::string_view str) { return true; }
 bool JSONParser::ParsedBool(bool val) { return true; }
 bool JSONParser::ParsedNull() { return true; }
 
+int JSONParser::SkippableValueDepth() { return -1; }
+
 }  // namespace zetasql
@@ -87,6 +87,16 @@ class JSONParser {
   // The parser just parsed a null value.
   virtual bool ParsedNull();
 
+  // Called before parsing the value of each object member and each array
+  // element. A client that is not interested in the value can return the
+  // maximum depth of objects and arrays nested within it that it would accept;
+  // the value is then scanned without calling any of the functions above and
+  // without unescaping its strings. Values that are nested more deeply or
+  // that fail to scan are parsed normally instead, so that failures are
+  // reported exactly as without skipping. Returns -1, which parses every
+  // value, by default.
+  virtual int SkippableValueDepth();
+
   // Report the type and position of a failure.
   // Returns false for convenience.
   virtual bool ReportFailure(const std::string& error_message);
@@ -114,6 +124,20 @@ class JSONParser {
   // Handles any type
   bool ParseValue();
 
+  // Parses the value at p_, or skips it if SkippableValueDepth() allows.
+  bool ParseOrSkipValue();
+
+  // Advances p_ past the value at p_ with the same grammar as ParseValue(),
+  // but without calling any handlers. Returns false if the value does not
+  // parse or has more than 'max_depth' levels of nested objects and arrays,
+  // in which case p_ is left anywhere within the value.
+  bool SkipValue(int max_depth);
+
+  // Advances p_ past the string or number at p_, like ParseStringHelper() and
+  // ParseNumberTextHelper() but without unescaping or reporting failures.
+  bool SkipString();
+  bool SkipNumber();
+
   // Expects p_ to point to the beginning of a string.
   bool ParseString();
 
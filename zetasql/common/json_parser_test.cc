@@ -26,6 +26,8 @@
 #include <cstdint>
 #include "absl/flags/flag.h"
 #include "absl/strings/escaping.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
 
@@ -659,4 +661,100 @@ TEST(JSONParserTest, FunctionSimple) {
   }
 }
 
+// Records the parser calls as a compact string, skipping the values of members
+// whose key starts with "skip" and of array elements after the first.
+class ValueSkipper : public JSONParser {
+ public:
+  ValueSkipper(absl::string_view json, int max_depth)
+      : JSONParser(json), max_depth_(max_depth) {}
+
+  const std::string& events() const { return events_; }
+
+ protected:
+  bool BeginObject() override { return Add("{"); }
+  bool EndObject() override { return Add("}"); }
+  bool BeginMember(const std::string& key) override {
+    skip_ = absl::StartsWith(key, "skip");
+    return Add(key + ":");
+  }
+  bool BeginArray() override {
+    array_indexes_.push_back(0);
+    return Add("[");
+  }
+  bool EndArray() override {
+    array_indexes_.pop_back();
+    return Add("]");
+  }
+  bool BeginArrayEntry() override {
+    skip_ = array_indexes_.back()++ > 0;
+    return true;
+  }
+  bool ParsedString(const std::string& str) override {
+    return Add("'" + str + "'");
+  }
+  bool ParsedNumber(absl::string_view str) override { return Add(str); }
+  bool ParsedBool(bool val) override { return Add(val ? "true" : "false"); }
+  bool ParsedNull() override { return Add("null"); }
+
+  int SkippableValueDepth() override { return skip_ ? max_depth_ : -1; }
+
+ private:
+  bool Add(absl::string_view event) {
+    absl::StrAppend(&events_, event, " ");
+    return true;
+  }
+
+  const int max_depth_;
+  bool skip_ = false;
+  std::vector<int> array_indexes_;
+  std::string events_;
+};
+
+TEST(JSONParserTest, SkipValues) {
+  ValueSkipper skipper(
+      R"({"a": 1, "skip1": {"b": ["x\"}", {'c': null}, [], {}], "d": true},)"
+      R"( "e": [1, {"f": 2}, [3, '\u0041\x41\101\]']], "skip2": -1.5e3, })",
+      /*max_depth=*/10);
+  ASSERT_TRUE(skipper.Parse());
+  EXPECT_EQ(skipper.events(), "{ a: 1 skip1: e: [ 1 ] skip2: } ");
+}
+
+TEST(JSONParserTest, SkipValuesTooDeep) {
+  const char* str = R"({"skip": [[1], [[2]]], "a": [[3], [[4]]]})";
+  {
+    ValueSkipper skipper(str, /*max_depth=*/3);
+    ASSERT_TRUE(skipper.Parse());
+    EXPECT_EQ(skipper.events(), "{ skip: a: [ [ 3 ] ] } ");
+  }
+  {
+    // Values that are nested too deeply are parsed normally.
+    ValueSkipper skipper(str, /*max_depth=*/2);
+    ASSERT_TRUE(skipper.Parse());
+    EXPECT_EQ(skipper.events(), "{ skip: [ [ 1 ] ] a: [ [ 3 ] ] } ");
+  }
+}
+
+// Skipping a value must not change whether the document parses, including for
+// the forms that the parser accepts leniently.
+TEST(JSONParserTest, SkipValuesSameResult) {
+  const char* values[] = {
+      "1",       "-0.5e+7", "\"a\\\"b\"", "'a\"b'",   "\"\\u12\"",
+      "\"\\uzzzz\"", "\"\\x4\"", "\"\\",  "\"abc",    "true",
+      "nul",     "[1,,2]",  "[,]",     "[1,]",      "[1 2]",
+      "{\"a\":}", "{\"a\":,\"b\":1}", "{\"a\":1,}", "{a:1}", "{,}",
+      "[}",      "{]",      "1.",      "-",         "01",
+      "1e",      "",        "]",       "{\"a\" 1}", "[\"\xC3\xA9\"]",
+  };
+  for (const char* value : values) {
+    for (const std::string& str :
+         {absl::StrCat("{\"skip\":", value, "}"),
+          absl::StrCat("{\"skip\":", value, ",\"a\":[1,2]}"),
+          absl::StrCat("[0,", value, "]")}) {
+      JSONParser parser(str);
+      ValueSkipper skipper(str, /*max_depth=*/10);
+      EXPECT_EQ(skipper.Parse(), parser.Parse()) << "Input: " << str;
+    }
+  }
+}
+
 }  // namespace
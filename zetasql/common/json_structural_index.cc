@@ -0,0 +1,371 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/common/json_structural_index.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+
+#include "zetasql/base/bits.h"
+#include "zetasql/common/utf_util.h"
+#include "absl/strings/string_view.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define ZETASQL_JSON_STRUCTURAL_INDEX_AVX2 1
+#include <immintrin.h>
+#endif
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace zetasql {
+namespace {
+
+constexpr size_t kBlockSize = 64;
+
+// Bit masks over one block of input, where bit i describes byte i.
+struct BlockMasks {
+  uint64_t quote = 0;
+  uint64_t backslash = 0;
+  // '{', '}', '[', ']', ':' and ','.
+  uint64_t op = 0;
+  // ' ', '\t', '\n' and '\r'.
+  uint64_t whitespace = 0;
+  // Bytes below 0x20, which are not allowed in strings.
+  uint64_t control = 0;
+  uint64_t non_ascii = 0;
+};
+
+using ClassifyBlockFn = void (*)(const char* block, BlockMasks* masks);
+
+#if !defined(__SSE2__)
+void ClassifyBlockScalar(const char* block, BlockMasks* masks) {
+  *masks = BlockMasks();
+  for (int i = 0; i < kBlockSize; ++i) {
+    const unsigned char c = static_cast<unsigned char>(block[i]);
+    const uint64_t bit = uint64_t{1} << i;
+    switch (c) {
+      case '"':
+        masks->quote |= bit;
+        break;
+      case '\\':
+        masks->backslash |= bit;
+        break;
+      case '{':
+      case '}':
+      case '[':
+      case ']':
+      case ':':
+      case ',':
+        masks->op |= bit;
+        break;
+      case ' ':
+      case '\t':
+      case '\n':
+      case '\r':
+        masks->whitespace |= bit;
+        break;
+      default:
+        break;
+    }
+    if (c < 0x20) masks->control |= bit;
+    if (c >= 0x80) masks->non_ascii |= bit;
+  }
+}
+#endif  // !__SSE2__
+
+#if defined(__SSE2__)
+inline __m128i EqSSE2(__m128i v, char c) {
+  return _mm_cmpeq_epi8(v, _mm_set1_epi8(c));
+}
+
+void ClassifyBlockSSE2(const char* block, BlockMasks* masks) {
+  *masks = BlockMasks();
+  for (int i = 0; i < kBlockSize; i += 16) {
+    const __m128i v =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i));
+    // Setting bit 5 maps '[' to '{' and ']' to '}'.
+    const __m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+    const __m128i op =
+        _mm_or_si128(_mm_or_si128(EqSSE2(lower, '{'), EqSSE2(lower, '}')),
+                     _mm_or_si128(EqSSE2(v, ':'), EqSSE2(v, ',')));
+    const __m128i whitespace =
+        _mm_or_si128(_mm_or_si128(EqSSE2(v, ' '), EqSSE2(v, '\t')),
+                     _mm_or_si128(EqSSE2(v, '\n'), EqSSE2(v, '\r')));
+    const __m128i control =
+        _mm_cmpeq_epi8(_mm_min_epu8(v, _mm_set1_epi8(0x1F)), v);
+    const auto bits = [i](int mask) {
+      return uint64_t{static_cast<uint16_t>(mask)} << i;
+    };
+    masks->quote |= bits(_mm_movemask_epi8(EqSSE2(v, '"')));
+    masks->backslash |= bits(_mm_movemask_epi8(EqSSE2(v, '\\')));
+    masks->op |= bits(_mm_movemask_epi8(op));
+    masks->whitespace |= bits(_mm_movemask_epi8(whitespace));
+    masks->control |= bits(_mm_movemask_epi8(control));
+    masks->non_ascii |= bits(_mm_movemask_epi8(v));
+  }
+}
+#endif  // __SSE2__
+
+#if defined(ZETASQL_JSON_STRUCTURAL_INDEX_AVX2)
+__attribute__((target("avx2"))) inline __m256i EqAVX2(__m256i v, char c) {
+  return _mm256_cmpeq_epi8(v, _mm256_set1_epi8(c));
+}
+
+__attribute__((target("avx2"))) void ClassifyBlockAVX2(const char* block,
+                                                       BlockMasks* masks) {
+  *masks = BlockMasks();
+  for (int i = 0; i < kBlockSize; i += 32) {
+    const __m256i v =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + i));
+    // Setting bit 5 maps '[' to '{' and ']' to '}'.
+    const __m256i lower = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+    const __m256i op = _mm256_or_si256(
+        _mm256_or_si256(EqAVX2(lower, '{'), EqAVX2(lower, '}')),
+        _mm256_or_si256(EqAVX2(v, ':'), EqAVX2(v, ',')));
+    const __m256i whitespace =
+        _mm256_or_si256(_mm256_or_si256(EqAVX2(v, ' '), EqAVX2(v, '\t')),
+                        _mm256_or_si256(EqAVX2(v, '\n'), EqAVX2(v, '\r')));
+    const __m256i control =
+        _mm256_cmpeq_epi8(_mm256_min_epu8(v, _mm256_set1_epi8(0x1F)), v);
+    const auto bits = [i](int mask) {
+      return uint64_t{static_cast<uint32_t>(mask)} << i;
+    };
+    masks->quote |= bits(_mm256_movemask_epi8(EqAVX2(v, '"')));
+    masks->backslash |= bits(_mm256_movemask_epi8(EqAVX2(v, '\\')));
+    masks->op |= bits(_mm256_movemask_epi8(op));
+    masks->whitespace |= bits(_mm256_movemask_epi8(whitespace));
+    masks->control |= bits(_mm256_movemask_epi8(control));
+    masks->non_ascii |= bits(_mm256_movemask_epi8(v));
+  }
+}
+#endif  // ZETASQL_JSON_STRUCTURAL_INDEX_AVX2
+
+ClassifyBlockFn SelectClassifyBlock() {
+#if defined(ZETASQL_JSON_STRUCTURAL_INDEX_AVX2)
+  if (__builtin_cpu_supports("avx2")) {
+    return &ClassifyBlockAVX2;
+  }
+#endif
+#if defined(__SSE2__)
+  return &ClassifyBlockSSE2;
+#else
+  return &ClassifyBlockScalar;
+#endif
+}
+
+// Returns the mask of characters escaped by a backslash, i.e. those preceded
+// by an odd-length run of backslashes. '*prev_ends_odd_backslash' is 1 if the
+// previous block ended with such a run, and is updated for the next block.
+uint64_t FindEscaped(uint64_t backslash, uint64_t* prev_ends_odd_backslash) {
+  constexpr uint64_t kEvenBits = 0x5555555555555555ULL;
+  constexpr uint64_t kOddBits = ~kEvenBits;
+  const uint64_t start_edges = backslash & ~(backslash << 1);
+  // A run that continues from the previous block flips the parity.
+  const uint64_t even_start_mask = kEvenBits ^ *prev_ends_odd_backslash;
+  const uint64_t even_starts = start_edges & even_start_mask;
+  const uint64_t odd_starts = start_edges & ~even_start_mask;
+  // Adding the start of a run to the run carries to the bit after its end.
+  const uint64_t even_carries = backslash + even_starts;
+  uint64_t odd_carries = backslash + odd_starts;
+  const bool ends_odd_backslash = odd_carries < backslash;
+  odd_carries |= *prev_ends_odd_backslash;
+  *prev_ends_odd_backslash = ends_odd_backslash ? 1 : 0;
+  const uint64_t even_start_odd_end = even_carries & ~backslash & kOddBits;
+  const uint64_t odd_start_even_end = odd_carries & ~backslash & kEvenBits;
+  return even_start_odd_end | odd_start_even_end;
+}
+
+// Returns the mask with bit i set iff an odd number of bits at or below i are
+// set in 'x'. Applied to the quotes, this marks the strings.
+uint64_t PrefixXor(uint64_t x) {
+  x ^= x << 1;
+  x ^= x << 2;
+  x ^= x << 4;
+  x ^= x << 8;
+  x ^= x << 16;
+  x ^= x << 32;
+  return x;
+}
+
+int HexDigitValue(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+// Parses the four hex digits at the start of 'input'. Returns -1 if they are
+// not hex digits.
+int32_t ParseHex4(absl::string_view input) {
+  if (input.size() < 4) return -1;
+  int32_t value = 0;
+  for (int i = 0; i < 4; ++i) {
+    const int digit = HexDigitValue(input[i]);
+    if (digit < 0) return -1;
+    value = (value << 4) | digit;
+  }
+  return value;
+}
+
+void AppendUTF8(uint32_t code_point, std::string* output) {
+  if (code_point < 0x80) {
+    output->push_back(static_cast<char>(code_point));
+  } else if (code_point < 0x800) {
+    output->push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+    output->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  } else if (code_point < 0x10000) {
+    output->push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+    output->push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+    output->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  } else {
+    output->push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+    output->push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+    output->push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+    output->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  }
+}
+
+}  // namespace
+
+bool JSONStructuralIndex::Build(absl::string_view json) {
+  static const ClassifyBlockFn classify_block = SelectClassifyBlock();
+
+  positions_.clear();
+  if (json.size() > std::numeric_limits<int32_t>::max()) {
+    return false;
+  }
+  uint64_t prev_ends_odd_backslash = 0;
+  // All ones if the previous block ended inside a string.
+  uint64_t prev_in_string = 0;
+  // 1 if the previous block ended with a number or literal character.
+  uint64_t prev_scalar = 0;
+  size_t first_non_ascii_block = json.size();
+  char padded[kBlockSize];
+  for (size_t offset = 0; offset < json.size(); offset += kBlockSize) {
+    const char* block = json.data() + offset;
+    if (json.size() - offset < kBlockSize) {
+      // Pad the last block with whitespace, which is never structural.
+      std::memset(padded, ' ', kBlockSize);
+      std::memcpy(padded, block, json.size() - offset);
+      block = padded;
+    }
+    BlockMasks masks;
+    classify_block(block, &masks);
+
+    const uint64_t quotes =
+        masks.quote & ~FindEscaped(masks.backslash, &prev_ends_odd_backslash);
+    // Opening quotes and string contents; closing quotes are not included.
+    const uint64_t in_string = PrefixXor(quotes) ^ prev_in_string;
+    prev_in_string =
+        static_cast<uint64_t>(static_cast<int64_t>(in_string) >> 63);
+    if ((masks.control & in_string) != 0) {
+      return false;
+    }
+    if (masks.non_ascii != 0 && first_non_ascii_block == json.size()) {
+      first_non_ascii_block = offset;
+    }
+
+    const uint64_t outside_strings = ~(in_string | quotes);
+    const uint64_t scalar =
+        outside_strings & ~(masks.op | masks.whitespace);
+    const uint64_t scalar_starts = scalar & ~((scalar << 1) | prev_scalar);
+    prev_scalar = scalar >> 63;
+    uint64_t structural = (masks.op & outside_strings) | quotes | scalar_starts;
+    while (structural != 0) {
+      positions_.push_back(static_cast<uint32_t>(
+          offset + zetasql_base::Bits::FindLSBSetNonZero64(structural)));
+      structural &= structural - 1;
+    }
+  }
+  if (prev_in_string != 0) {
+    return false;
+  }
+  // Everything before the first block with a non-ASCII byte is ASCII, so
+  // validation can start at a character boundary there.
+  return first_non_ascii_block == json.size() ||
+         IsWellFormedUTF8(json.substr(first_non_ascii_block));
+}
+
+namespace json_structural_internal {
+
+bool UnescapeJSONString(absl::string_view escaped, std::string* output) {
+  output->clear();
+  size_t position = 0;
+  while (position < escaped.size()) {
+    const size_t backslash = escaped.find('\\', position);
+    if (backslash == absl::string_view::npos) {
+      output->append(escaped.data() + position, escaped.size() - position);
+      break;
+    }
+    output->append(escaped.data() + position, backslash - position);
+    if (backslash + 1 >= escaped.size()) return false;
+    position = backslash + 2;
+    switch (escaped[backslash + 1]) {
+      case '"':
+        output->push_back('"');
+        break;
+      case '\\':
+        output->push_back('\\');
+        break;
+      case '/':
+        output->push_back('/');
+        break;
+      case 'b':
+        output->push_back('\b');
+        break;
+      case 'f':
+        output->push_back('\f');
+        break;
+      case 'n':
+        output->push_back('\n');
+        break;
+      case 'r':
+        output->push_back('\r');
+        break;
+      case 't':
+        output->push_back('\t');
+        break;
+      case 'u': {
+        int32_t code_point = ParseHex4(escaped.substr(position));
+        if (code_point < 0 || (code_point >= 0xDC00 && code_point <= 0xDFFF)) {
+          return false;
+        }
+        position += 4;
+        if (code_point >= 0xD800 && code_point <= 0xDBFF) {
+          // A high surrogate must be followed by an escaped low surrogate.
+          if (escaped.substr(position, 2) != "\\u") return false;
+          const int32_t low = ParseHex4(escaped.substr(position + 2));
+          if (low < 0xDC00 || low > 0xDFFF) return false;
+          position += 6;
+          code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+        }
+        AppendUTF8(code_point, output);
+        break;
+      }
+      default:
+        return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace json_structural_internal
+}  // namespace zetasql
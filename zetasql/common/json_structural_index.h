@@ -0,0 +1,347 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef ZETASQL_COMMON_JSON_STRUCTURAL_INDEX_H_
+#define ZETASQL_COMMON_JSON_STRUCTURAL_INDEX_H_
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+
+namespace zetasql {
+
+// The positions of the structural characters of a JSON document: the brackets,
+// braces, colons and commas outside of strings, both quotes of every string,
+// and the first character of every number and literal.
+//
+// The index is built 64 bytes at a time. Each block is classified with SSE2
+// or AVX2 where available, and with a scalar loop otherwise; escapes and
+// string boundaries are then resolved with bitwise arithmetic on the masks.
+class JSONStructuralIndex {
+ public:
+  JSONStructuralIndex() = default;
+  JSONStructuralIndex(const JSONStructuralIndex&) = delete;
+  JSONStructuralIndex& operator=(const JSONStructuralIndex&) = delete;
+
+  // Indexes 'json', replacing the previous contents. Returns false if 'json'
+  // cannot be valid JSON because a string is unterminated or contains a
+  // control character, or because 'json' is not well formed UTF-8. Also
+  // returns false for documents of 2GB or more.
+  bool Build(absl::string_view json);
+
+  const std::vector<uint32_t>& positions() const { return positions_; }
+
+ private:
+  std::vector<uint32_t> positions_;
+};
+
+// The outcome of ParseJSONWithStructuralIndex().
+enum class JSONStructuralParseResult {
+  // The whole document was reported to the handler.
+  kParsed,
+  // The handler returned false, which stopped the parse.
+  kStoppedByHandler,
+  // The document is not valid JSON, or uses a form that the structural parser
+  // leaves to the reference parser, e.g. a byte order mark or a number that
+  // overflows a double. The caller must parse it again with a fresh handler
+  // using the reference parser, which produces the exact error.
+  kNotAccepted,
+};
+
+// Parses 'json' using a JSONStructuralIndex and reports it to 'handler', which
+// implements the nlohmann SAX interface (null(), boolean(), number_integer(),
+// number_unsigned(), number_float(), string(), start_object(), key(),
+// end_object(), start_array() and end_array()).
+//
+// Every document accepted by this parser is accepted by nlohmann::json
+// sax_parse() with the same sequence of handler calls, so a handler sees no
+// difference between the two except speed. Documents that are not accepted
+// are not diagnosed; see JSONStructuralParseResult::kNotAccepted.
+template <typename Handler>
+JSONStructuralParseResult ParseJSONWithStructuralIndex(absl::string_view json,
+                                                       Handler* handler);
+
+// Implementation details follow.
+
+namespace json_structural_internal {
+
+inline bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+
+// Returns true if 'c' may follow a number or literal.
+inline bool IsScalarDelimiter(char c) {
+  switch (c) {
+    case ' ':
+    case '\t':
+    case '\n':
+    case '\r':
+    case ',':
+    case ':':
+    case '[':
+    case ']':
+    case '{':
+    case '}':
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Unescapes the contents of a JSON string literal that contains at least one
+// backslash into 'output'. Returns false for invalid escapes, including
+// unpaired surrogates.
+bool UnescapeJSONString(absl::string_view escaped, std::string* output);
+
+template <typename Handler>
+class StructuralParser {
+ public:
+  StructuralParser(absl::string_view json, const std::vector<uint32_t>& tokens,
+                   Handler* handler)
+      : json_(json), tokens_(tokens), handler_(handler) {}
+
+  JSONStructuralParseResult Parse() {
+    // Containers being parsed, innermost last: '{' or '['.
+    std::vector<char> containers;
+    while (true) {
+      // Parse a value.
+      if (AtEnd()) return kNotAccepted;
+      switch (Current()) {
+        case '{':
+          if (!handler_->start_object(kUnknownSize)) return kStoppedByHandler;
+          ++next_;
+          if (!AtEnd() && Current() == '}') {
+            ++next_;
+            if (!handler_->end_object()) return kStoppedByHandler;
+            break;
+          }
+          containers.push_back('{');
+          if (!ParseKey()) return result_;
+          continue;
+        case '[':
+          if (!handler_->start_array(kUnknownSize)) return kStoppedByHandler;
+          ++next_;
+          if (!AtEnd() && Current() == ']') {
+            ++next_;
+            if (!handler_->end_array()) return kStoppedByHandler;
+            break;
+          }
+          containers.push_back('[');
+          continue;
+        case '"':
+          if (!ParseString()) return kNotAccepted;
+          if (!handler_->string(buffer_)) return kStoppedByHandler;
+          break;
+        default:
+          if (!ParseScalar()) return result_;
+          break;
+      }
+      // A value was parsed; close containers until one continues.
+      while (true) {
+        if (containers.empty()) {
+          return AtEnd() ? JSONStructuralParseResult::kParsed : kNotAccepted;
+        }
+        if (AtEnd()) return kNotAccepted;
+        const char c = Current();
+        ++next_;
+        if (c == ',') {
+          if (containers.back() == '{' && !ParseKey()) return result_;
+          break;
+        }
+        if (c == '}' && containers.back() == '{') {
+          if (!handler_->end_object()) return kStoppedByHandler;
+        } else if (c == ']' && containers.back() == '[') {
+          if (!handler_->end_array()) return kStoppedByHandler;
+        } else {
+          return kNotAccepted;
+        }
+        containers.pop_back();
+      }
+    }
+  }
+
+ private:
+  static constexpr JSONStructuralParseResult kNotAccepted =
+      JSONStructuralParseResult::kNotAccepted;
+  static constexpr JSONStructuralParseResult kStoppedByHandler =
+      JSONStructuralParseResult::kStoppedByHandler;
+  // nlohmann reports containers of unknown size as size_t(-1).
+  static constexpr size_t kUnknownSize = static_cast<size_t>(-1);
+
+  bool AtEnd() const { return next_ >= tokens_.size(); }
+  char Current() const { return json_[tokens_[next_]]; }
+
+  // Parses the string literal starting at the current token into 'buffer_'.
+  bool ParseString() {
+    // Both quotes are structural, and nothing between them is.
+    if (next_ + 1 >= tokens_.size()) return false;
+    const size_t begin = tokens_[next_] + 1;
+    const size_t end = tokens_[next_ + 1];
+    next_ += 2;
+    const absl::string_view contents = json_.substr(begin, end - begin);
+    if (std::memchr(contents.data(), '\\', contents.size()) == nullptr) {
+      buffer_.assign(contents.data(), contents.size());
+      return true;
+    }
+    return UnescapeJSONString(contents, &buffer_);
+  }
+
+  // Parses an object key and the following colon. On failure sets 'result_'
+  // and returns false.
+  bool ParseKey() {
+    if (AtEnd() || Current() != '"' || !ParseString() || AtEnd() ||
+        Current() != ':') {
+      result_ = kNotAccepted;
+      return false;
+    }
+    ++next_;
+    if (!handler_->key(buffer_)) {
+      result_ = kStoppedByHandler;
+      return false;
+    }
+    return true;
+  }
+
+  // Parses the number or literal starting at the current token and reports it
+  // to the handler. On failure sets 'result_' and returns false.
+  bool ParseScalar() {
+    const absl::string_view rest = json_.substr(tokens_[next_]);
+    ++next_;
+    result_ = kNotAccepted;
+    switch (rest[0]) {
+      case 'n':
+        return ParseLiteral(rest, "null") && Handled(handler_->null());
+      case 't':
+        return ParseLiteral(rest, "true") && Handled(handler_->boolean(true));
+      case 'f':
+        return ParseLiteral(rest, "false") &&
+               Handled(handler_->boolean(false));
+      default:
+        return ParseNumber(rest);
+    }
+  }
+
+  // Returns true if 'rest' starts with the complete 'literal'.
+  static bool ParseLiteral(absl::string_view rest, absl::string_view literal) {
+    return rest.substr(0, literal.size()) == literal &&
+           (rest.size() == literal.size() ||
+            IsScalarDelimiter(rest[literal.size()]));
+  }
+
+  // Records the result of a handler call that reported a value.
+  bool Handled(bool handler_result) {
+    if (!handler_result) result_ = kStoppedByHandler;
+    return handler_result;
+  }
+
+  // Parses the number at the start of 'rest' like the nlohmann lexer: integers
+  // become int64 if negative and uint64 otherwise, falling back to double when
+  // out of range.
+  bool ParseNumber(absl::string_view rest) {
+    size_t p = 0;
+    const bool negative = rest[0] == '-';
+    if (negative) ++p;
+    const size_t digits_begin = p;
+    if (p >= rest.size() || !IsDigit(rest[p])) return false;
+    if (rest[p] == '0') {
+      ++p;
+    } else {
+      while (p < rest.size() && IsDigit(rest[p])) ++p;
+    }
+    const size_t digits_end = p;
+    bool is_integer = true;
+    if (p < rest.size() && rest[p] == '.') {
+      is_integer = false;
+      ++p;
+      if (p >= rest.size() || !IsDigit(rest[p])) return false;
+      while (p < rest.size() && IsDigit(rest[p])) ++p;
+    }
+    if (p < rest.size() && (rest[p] == 'e' || rest[p] == 'E')) {
+      is_integer = false;
+      ++p;
+      if (p < rest.size() && (rest[p] == '+' || rest[p] == '-')) ++p;
+      if (p >= rest.size() || !IsDigit(rest[p])) return false;
+      while (p < rest.size() && IsDigit(rest[p])) ++p;
+    }
+    if (p < rest.size() && !IsScalarDelimiter(rest[p])) return false;
+
+    uint64_t magnitude = 0;
+    if (is_integer &&
+        ParseMagnitude(rest.substr(digits_begin, digits_end - digits_begin),
+                       &magnitude) &&
+        (!negative || magnitude <= uint64_t{1} << 63)) {
+      if (negative) {
+        return Handled(handler_->number_integer(
+            static_cast<int64_t>(uint64_t{0} - magnitude)));
+      }
+      return Handled(handler_->number_unsigned(magnitude));
+    }
+    buffer_.assign(rest.data(), p);
+    const double value = std::strtod(buffer_.c_str(), nullptr);
+    // nlohmann reports an error for numbers that overflow.
+    if (!std::isfinite(value)) return false;
+    return Handled(handler_->number_float(value, buffer_));
+  }
+
+  // Sets '*magnitude' to the value of 'digits'. Returns false on overflow.
+  static bool ParseMagnitude(absl::string_view digits, uint64_t* magnitude) {
+    if (digits.size() > std::numeric_limits<uint64_t>::digits10 + 1) {
+      return false;
+    }
+    uint64_t value = 0;
+    for (const char c : digits) {
+      const uint64_t digit = c - '0';
+      if (value > (std::numeric_limits<uint64_t>::max() - digit) / 10) {
+        return false;
+      }
+      value = value * 10 + digit;
+    }
+    *magnitude = value;
+    return true;
+  }
+
+  const absl::string_view json_;
+  const std::vector<uint32_t>& tokens_;
+  Handler* const handler_;
+  // The index of the next token in 'tokens_'.
+  size_t next_ = 0;
+  // Holds the contents of the last string or number token.
+  std::string buffer_;
+  JSONStructuralParseResult result_ = kNotAccepted;
+};
+
+}  // namespace json_structural_internal
+
+template <typename Handler>
+JSONStructuralParseResult ParseJSONWithStructuralIndex(absl::string_view json,
+                                                       Handler* handler) {
+  JSONStructuralIndex index;
+  if (!index.Build(json)) {
+    return JSONStructuralParseResult::kNotAccepted;
+  }
+  return json_structural_internal::StructuralParser<Handler>(
+             json, index.positions(), handler)
+      .Parse();
+}
+
+}  // namespace zetasql
+
+#endif  // ZETASQL_COMMON_JSON_STRUCTURAL_INDEX_H_
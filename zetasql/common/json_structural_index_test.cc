@@ -0,0 +1,180 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/common/json_structural_index.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "single_include/nlohmann/json.hpp"
+
+namespace zetasql {
+namespace {
+
+using ::testing::ElementsAre;
+
+// Records the SAX events of a parse as strings. Stops the parse after
+// 'max_events' events if it is not negative.
+class EventRecorder {
+ public:
+  explicit EventRecorder(int max_events = -1) : max_events_(max_events) {}
+
+  bool null() { return Add("null"); }
+  bool boolean(bool val) { return Add(val ? "true" : "false"); }
+  bool number_integer(int64_t val) { return Add(absl::StrCat("int:", val)); }
+  bool number_unsigned(uint64_t val) {
+    return Add(absl::StrCat("uint:", val));
+  }
+  bool number_float(double val, const std::string& input_str) {
+    return Add(absl::StrCat("float:", val, ":", input_str));
+  }
+  bool string(std::string& val) { return Add(absl::StrCat("string:", val)); }
+  bool binary(std::vector<std::uint8_t>& val) { return Add("binary"); }
+  bool start_object(size_t size) {
+    return Add(absl::StrCat("start_object:", size));
+  }
+  bool key(std::string& val) { return Add(absl::StrCat("key:", val)); }
+  bool end_object() { return Add("end_object"); }
+  bool start_array(size_t size) {
+    return Add(absl::StrCat("start_array:", size));
+  }
+  bool end_array() { return Add("end_array"); }
+  bool parse_error(size_t /*unused*/, const std::string& /*unused*/,
+                   const nlohmann::detail::exception& /*unused*/) {
+    events_.push_back("error");
+    return false;
+  }
+
+  const std::vector<std::string>& events() const { return events_; }
+
+ private:
+  bool Add(std::string event) {
+    events_.push_back(std::move(event));
+    return max_events_ < 0 || events_.size() < max_events_;
+  }
+
+  const int max_events_;
+  std::vector<std::string> events_;
+};
+
+std::vector<uint32_t> GetPositions(absl::string_view json) {
+  JSONStructuralIndex index;
+  EXPECT_TRUE(index.Build(json));
+  return index.positions();
+}
+
+TEST(JSONStructuralIndexTest, Positions) {
+  EXPECT_THAT(
+      GetPositions(R"({"a": [1, true], "b\"c": -2})"),
+      ElementsAre(0, 1, 3, 4, 6, 7, 8, 10, 14, 15, 17, 22, 23, 25, 27));
+  EXPECT_THAT(GetPositions(R"( "{[,:]}" )"), ElementsAre(1, 8));
+  EXPECT_THAT(GetPositions(""), ElementsAre());
+}
+
+TEST(JSONStructuralIndexTest, StringsAcrossBlocks) {
+  // Place escapes and quotes on both sides of the 64-byte block boundary.
+  for (int padding = 50; padding < 70; ++padding) {
+    for (absl::string_view contents :
+         {"abc", "a\\\"b", "\\\\", "\\\\\\\"", "x\\\\\\\\\\\"y\\\\"}) {
+      const std::string json = absl::StrCat(std::string(padding, ' '), "[\"",
+                                            contents, "\", 1]");
+      SCOPED_TRACE(json);
+      EXPECT_THAT(GetPositions(json),
+                  ElementsAre(padding, padding + 1,
+                              padding + 2 + contents.size(),
+                              padding + 3 + contents.size(),
+                              padding + 5 + contents.size(),
+                              padding + 6 + contents.size()));
+    }
+  }
+}
+
+TEST(JSONStructuralIndexTest, RejectsInvalidStrings) {
+  JSONStructuralIndex index;
+  EXPECT_FALSE(index.Build("\"abc"));
+  EXPECT_FALSE(index.Build("[\"abc\\\"]"));
+  EXPECT_FALSE(index.Build("\"a\tb\""));
+  EXPECT_FALSE(index.Build(absl::string_view("\"a\0b\"", 5)));
+  EXPECT_FALSE(index.Build(absl::StrCat(std::string(100, ' '), "\"\xff\"")));
+  EXPECT_FALSE(index.Build("\"\xed\xa0\x80\""));
+  EXPECT_TRUE(index.Build("\"\xc3\xa9\xf0\x9f\x98\x80\""));
+}
+
+// Parses 'json' with both parsers and checks that they report the same events.
+void ExpectSameEvents(absl::string_view json) {
+  SCOPED_TRACE(json);
+  EventRecorder structural;
+  EXPECT_EQ(ParseJSONWithStructuralIndex(json, &structural),
+            JSONStructuralParseResult::kParsed);
+  EventRecorder reference;
+  EXPECT_TRUE(nlohmann::json::sax_parse(json, &reference));
+  EXPECT_EQ(structural.events(), reference.events());
+}
+
+TEST(ParseJSONWithStructuralIndexTest, MatchesNlohmann) {
+  for (absl::string_view json :
+       {"null", "true", "false", "0", "-0", "12", "-12", "1.5", "-1.25e-3",
+        "1E+2", "0.0000001", "18446744073709551615", "18446744073709551616",
+        "-9223372036854775808", "-9223372036854775809",
+        "123456789012345678901234567890", "\"\"", "\"abc\"",
+        R"("\"\\\/\b\f\n\r\t")", R"("\u00e9\u0000\ud83d\ude00")",
+        "\"\xc3\xa9\"", "[]", "{}", " [ 1 , [ ] , { } ] ", "[[[[[]]]]]",
+        R"({"a":1,"b":[true,false,null],"c":{"d":"e"},"a":2})",
+        "\n\t\r{\"\":\"\"}\n"}) {
+    ExpectSameEvents(json);
+  }
+  std::string large = "[";
+  for (int i = 0; i < 1000; ++i) {
+    absl::StrAppend(&large, i == 0 ? "" : ",", R"({"id":)", i,
+                    R"(,"name":"item \")", i, R"(\"","tags":["a","b\\"]})");
+  }
+  large.push_back(']');
+  ExpectSameEvents(large);
+}
+
+TEST(ParseJSONWithStructuralIndexTest, LeavesErrorsToReferenceParser) {
+  for (absl::string_view json :
+       {"", " ", "nul", "nullx", "truefalse", "[1,]", "[1 2]", "{\"a\"}",
+        "{\"a\":1,}", "{1:2}", "{\"a\" 1}", "[\"a\" \"b\"]", "\"abc", "01",
+        "1.", ".5", "-", "+1", "1e", "1e999", "-1e999", "[1}", "{]", "]",
+        "[", "1 2", "\"\\x\"", "\"\\ud800\"", "\"\\udc00\"",
+        "\"\\ud800\\u0041\"", "\"\\u12\"", "\xef\xbb\xbfnull"}) {
+    SCOPED_TRACE(json);
+    EventRecorder structural;
+    EXPECT_EQ(ParseJSONWithStructuralIndex(json, &structural),
+              JSONStructuralParseResult::kNotAccepted);
+  }
+}
+
+TEST(ParseJSONWithStructuralIndexTest, StopsWhenHandlerReturnsFalse) {
+  EventRecorder structural(/*max_events=*/3);
+  EXPECT_EQ(ParseJSONWithStructuralIndex(R"([1, "a", [null], 2])",
+                                         &structural),
+            JSONStructuralParseResult::kStoppedByHandler);
+  EXPECT_THAT(structural.events(),
+              ElementsAre("start_array:18446744073709551615", "uint:1",
+                          "string:a"));
+}
+
+}  // namespace
+}  // namespace zetasql
@@ -18,8 +18,10 @@
 
 #include <cstdint>
 #include <memory>
+#include <utility>
 
 #include "absl/flags/flag.h"
+#include "zetasql/base/ret_check.h"
 
 ABSL_FLAG(int64_t, zetasql_simple_iterator_call_time_now_rows_period, 1000,
           "Only call zetasql_base::Clock::TimeNow() every this many rows");
@@ -28,15 +30,59 @@ namespace zetasql {
 
 absl::Status SimpleEvaluatorTableIterator::SetColumnFilterMap(
     absl::flat_hash_map<int, std::unique_ptr<ColumnFilter>> filter_map) {
+  absl::MutexLock l(&mutex_);
   filter_map_.clear();
+  filters_.clear();
   for (auto& entry : filter_map) {
     if (filter_column_idxs_.contains(entry.first)) {
+      ZETASQL_RET_CHECK_GE(entry.first, 0);
+      ZETASQL_RET_CHECK_LT(entry.first, column_major_values_.size());
+      filters_.emplace_back(column_major_values_[entry.first].get(),
+                            entry.second.get());
       ZETASQL_RET_CHECK(filter_map_.insert(std::move(entry)).second);
     }
   }
   return absl::OkStatus();
 }
 
+bool SimpleEvaluatorTableIterator::MatchesFiltersLocked() const {
+  for (const auto& [values, filter] : filters_) {
+    const Value& value = (*values)[row_idx_];
+    switch (filter->kind()) {
+      case ColumnFilter::kRange: {
+        const Value& lower_bound = filter->lower_bound();
+        const Value& upper_bound = filter->upper_bound();
+        if (lower_bound.is_valid() &&
+            lower_bound.SqlLessThan(value) != values::True() &&
+            lower_bound.SqlEquals(value) != values::True()) {
+          return false;
+        }
+        if (upper_bound.is_valid() &&
+            value.SqlLessThan(upper_bound) != values::True() &&
+            value.SqlEquals(upper_bound) != values::True()) {
+          return false;
+        }
+        break;
+      }
+      case ColumnFilter::kInList: {
+        bool found = false;
+        for (const Value& element : filter->in_list()) {
+          if (value.SqlEquals(element) == values::True()) {
+            found = true;
+            break;
+          }
+        }
+        if (!found) return false;
+        break;
+      }
+      default:
+        // Skip this unknown column filter.
+        break;
+    }
+  }
+  return true;
+}
+
 bool SimpleEvaluatorTableIterator::NextRow() {
   absl::MutexLock l(&mutex_);
   if (cancelled_) return false;
@@ -51,44 +97,7 @@ bool SimpleEvaluatorTableIterator::NextRow() {
       return false;
     }
 
-    bool keep_row = true;
-    for (const auto& entry : filter_map_) {
-      if (!keep_row) break;
-
-      const int column_idx = entry.first;
-      const std::unique_ptr<ColumnFilter>& filter = entry.second;
-
-      const Value& value = (*column_major_values_[column_idx])[row_idx_];
-      switch (filter->kind()) {
-        case ColumnFilter::kRange: {
-          const Value& lower_bound = filter->lower_bound();
-          const Value& upper_bound = filter->upper_bound();
-          keep_row = !lower_bound.is_valid() ||
-                     (lower_bound.SqlLessThan(value) == values::True()) ||
-                     (lower_bound.SqlEquals(value) == values::True());
-          if (!keep_row) break;
-          keep_row = !upper_bound.is_valid() ||
-                     (value.SqlLessThan(upper_bound) == values::True()) ||
-                     (value.SqlEquals(upper_bound) == values::True());
-          break;
-        }
-        case ColumnFilter::kInList:
-          keep_row = false;
-          for (const Value& element : filter->in_list()) {
-            if (value.SqlEquals(element) == values::True()) {
-              keep_row = true;
-              break;
-            }
-          }
-          break;
-        default:
-          // Skip this unknown column filter.
-          keep_row = true;
-          break;
-      }
-    }
-
-    if (keep_row) return true;
+    if (MatchesFiltersLocked()) return true;
   }
 
   return false;
@@ -24,6 +24,7 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "zetasql/base/logging.h"
@@ -51,7 +52,8 @@ class SimpleEvaluatorTableIterator : public EvaluatorTableIterator {
   // 'end_status' is the absl::Status to return when we have reached the end
   //  of 'column_major_values'.
   // 'filter_column_idxs' is the list of column indexes for which to enforce the
-  // filters passed to SetColumnFilters().
+  // filters passed to SetColumnFilters(). Like the keys of those filters, they
+  // are indexes into 'columns', not into the table.
   // 'cancel_cb' is called when Cancel() is called.
   // 'set_deadline_cb' is called when SetDeadline() is called.
   // 'clock' is used to enforce deadlines.
@@ -132,10 +134,12 @@ class SimpleEvaluatorTableIterator : public EvaluatorTableIterator {
 
  private:
   bool DoneLocked() const ABSL_SHARED_LOCKS_REQUIRED(mutex_) {
-    if (column_major_values_.empty()) return true;
     return row_idx_ >= num_rows_;
   }
 
+  // Returns true if row 'row_idx_' matches all of 'filters_'.
+  bool MatchesFiltersLocked() const ABSL_SHARED_LOCKS_REQUIRED(mutex_);
+
   const std::vector<const Column*> columns_;
   const absl::Status end_status_;
   const absl::flat_hash_set<int> filter_column_idxs_;
@@ -157,6 +161,10 @@ class SimpleEvaluatorTableIterator : public EvaluatorTableIterator {
   // Contains the entries passed to 'filter_map' that are in
   // 'filter_column_idxs_'.
   absl::flat_hash_map<int, std::unique_ptr<ColumnFilter>> filter_map_;
+  // The filters in 'filter_map_', with the values of the column they apply
+  // to, so that NextRow() only looks at the filtered columns.
+  std::vector<std::pair<const std::vector<Value>*, const ColumnFilter*>>
+      filters_;
 };
 
 }  // namespace zetasql
@@ -203,5 +203,43 @@ TEST_F(ColumnFilterTest, DeletionsInThreeColumnsOnlyRespectTwo) {
                                ElementsAre(Int64(4), Int64(40), Int64(400)))));
 }
 
+TEST(SimpleTableIteratorTest, FiltersAreKeyedOnScanColumns) {
+  SimpleTable table("TestTable", {{"a", Int64Type()},
+                                  {"b", Int64Type()},
+                                  {"c", Int64Type()}});
+  table.SetContents({{Int64(1), Int64(10), Int64(100)},
+                     {Int64(2), Int64(20), Int64(200)},
+                     {Int64(3), Int64(30), Int64(300)}});
+
+  // Scan only column 'c', and filter on it.
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<EvaluatorTableIterator> iter,
+                       table.CreateEvaluatorTableIterator({2}));
+  absl::flat_hash_map<int, std::unique_ptr<ColumnFilter>> filter_map;
+  filter_map.emplace(0, std::make_unique<ColumnFilter>(Int64(150), Value()));
+  ZETASQL_ASSERT_OK(iter->SetColumnFilterMap(std::move(filter_map)));
+
+  std::vector<Value> values;
+  while (iter->NextRow()) {
+    values.push_back(iter->GetValue(0));
+  }
+  ZETASQL_ASSERT_OK(iter->Status());
+  EXPECT_THAT(values, ElementsAre(Int64(200), Int64(300)));
+}
+
+TEST(SimpleTableIteratorTest, NoColumns) {
+  SimpleTable table("TestTable", {{"a", Int64Type()}});
+  table.SetContents({{Int64(1)}, {Int64(2)}});
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<EvaluatorTableIterator> iter,
+                       table.CreateEvaluatorTableIterator({}));
+  EXPECT_EQ(iter->NumColumns(), 0);
+  int num_rows = 0;
+  while (iter->NextRow()) {
+    ++num_rows;
+  }
+  ZETASQL_ASSERT_OK(iter->Status());
+  EXPECT_EQ(num_rows, 2);
+}
+
 }  // namespace
 }  // namespace zetasql
@@ -18,6 +18,7 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <limits>
 #include <optional>
 #include <string>
@@ -30,12 +31,55 @@
 #include "unicode/utf8.h"
 #include "zetasql/base/ret_check.h"
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 namespace zetasql {
 
 constexpr absl::string_view kReplacementCharacter = "\uFFFD";
 
+absl::string_view::size_type SpanAscii(absl::string_view s) {
+  // This is called once per value, often on short strings, so the vector
+  // width is chosen at compile time rather than dispatched at run time.
+  const char* data = s.data();
+  const size_t length = s.length();
+  size_t i = 0;
+#if defined(__AVX2__)
+  for (; i + 32 <= length; i += 32) {
+    const __m256i v =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+    const uint32_t non_ascii = static_cast<uint32_t>(_mm256_movemask_epi8(v));
+    if (non_ascii != 0) {
+      return i + __builtin_ctz(non_ascii);
+    }
+  }
+#elif defined(__SSE2__)
+  for (; i + 16 <= length; i += 16) {
+    const __m128i v =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    const int non_ascii = _mm_movemask_epi8(v);
+    if (non_ascii != 0) {
+      return i + __builtin_ctz(non_ascii);
+    }
+  }
+#endif
+  // Eight bytes at a time for the rest.
+  constexpr uint64_t kHighBits = 0x8080808080808080ULL;
+  for (; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, data + i, sizeof(word));
+    if ((word & kHighBits) != 0) break;
+  }
+  while (i < length && static_cast<uint8_t>(data[i]) < 0x80) ++i;
+  return i;
+}
+
 static int SpanWellFormedUTF8(const char* s, int length) {
-  for (int i = 0; i < length;) {
+  for (int i = static_cast<int>(SpanAscii(absl::string_view(s, length)));
+       i < length;) {
     int start = i;
     UChar32 c;
     U8_NEXT(s, i, length, c);
@@ -114,8 +158,12 @@ bool CheckAndCastStrLength(absl::string_view str, int32_t* str_length32) {
 
 std::optional<int32_t> ForwardN(absl::string_view str, int32_t str_length32,
                                 int64_t num_code_points) {
-  int32_t str_offset = 0;
-  for (int64_t i = 0; i < num_code_points && str_offset < str_length32; ++i) {
+  // Skip the ASCII prefix, where each byte is one code point.
+  int32_t str_offset = static_cast<int32_t>(SpanAscii(str.substr(
+      0, static_cast<size_t>(std::min<int64_t>(
+             std::max<int64_t>(num_code_points, 0), str_length32)))));
+  for (int64_t i = str_offset; i < num_code_points && str_offset < str_length32;
+       ++i) {
     UChar32 character;
     U8_NEXT(str, str_offset, str_length32, character);
     if (character < 0) {
@@ -129,8 +177,9 @@ absl::StatusOr<int32_t> LengthUtf8(absl::string_view str) {
   ZETASQL_RET_CHECK_LE(str.size(), std::numeric_limits<int32_t>::max());
   int32_t str_length32 = static_cast<int32_t>(str.size());
 
-  int utf8_length = 0;
-  int32_t offset = 0;
+  // Skip the ASCII prefix, where each byte is one code point.
+  int32_t offset = static_cast<int32_t>(SpanAscii(str));
+  int utf8_length = offset;
   while (offset < str_length32) {
     UChar32 character;
     U8_NEXT(str.data(), offset, str_length32, character);
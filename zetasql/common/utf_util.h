@@ -31,6 +31,11 @@
 // and CheckAndCastStrLength.
 namespace zetasql {
 
+// Returns the length of the prefix of `s` that is ASCII (bytes below 0x80).
+// This will return `s.length()` if `s` is entirely ASCII. Each ASCII byte is a
+// complete code point, so callers can use this to skip UTF-8 decoding.
+absl::string_view::size_type SpanAscii(absl::string_view s);
+
 // Returns the length of `s` that is well formed UTF8. This will return
 // `s.length()` if it is completely well formed UTF8.
 absl::string_view::size_type SpanWellFormedUTF8(absl::string_view s);
@@ -85,6 +85,23 @@ void TestCoerce(std::string str, std::string expected) {
   EXPECT_EQ(CoerceToWellFormedUTF8(str), expected) << "str: " << str;
 }
 
+TEST(UtfUtilTest, SpanAscii) {
+  EXPECT_EQ(SpanAscii(""), 0);
+  EXPECT_EQ(SpanAscii("\xc2\xbf"), 0);
+  EXPECT_EQ(SpanAscii(kInvalidUtf8Str), 1);
+  // Put a non-ASCII byte at every position of strings long enough to cover
+  // the vectorized loop and the tail.
+  for (int length = 1; length <= 80; ++length) {
+    std::string str(length, 'a');
+    EXPECT_EQ(SpanAscii(str), length);
+    for (int i = 0; i < length; ++i) {
+      str[i] = '\x80';
+      EXPECT_EQ(SpanAscii(str), i) << "length=" << length;
+      str[i] = '\x7f';
+    }
+  }
+}
+
 TEST(UtfUtilTest, CoerceToWellFormedUTF8) {
   TestCoerce("\xc1", "\uFFFD");
   TestCoerce("\uFFFD", "\uFFFD");  // REPLACEMENT CHARACTER is okay.
@@ -0,0 +1,435 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/local_service/columnar_table.h"
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "zetasql/base/logging.h"
+#include "zetasql/local_service/local_service.pb.h"
+#include "zetasql/public/catalog.h"
+#include "zetasql/public/evaluator_table_iterator.h"
+#include "zetasql/public/simple_catalog.h"
+#include "zetasql/public/type.h"
+#include "zetasql/public/value.h"
+#include "zetasql/public/value.pb.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "zetasql/base/ret_check.h"
+#include "zetasql/base/status_builder.h"
+#include "zetasql/base/status_macros.h"
+
+namespace zetasql {
+namespace local_service {
+
+namespace {
+
+bool IsStringOrBytes(const Type* type) {
+  return type->kind() == TYPE_STRING || type->kind() == TYPE_BYTES;
+}
+
+bool IsValid(const ColumnarTableData::Column& column, int64_t row) {
+  return (static_cast<uint8_t>(column.validity()[row / 8]) >> (row % 8)) & 1;
+}
+
+// Returns true if values of <type> are stored in one of the typed vectors of
+// a column, rather than as ValueProtos.
+bool HasPrimitiveEncoding(const Type* type) {
+  switch (type->kind()) {
+    case TYPE_INT32:
+    case TYPE_INT64:
+    case TYPE_DATE:
+    case TYPE_ENUM:
+    case TYPE_UINT32:
+    case TYPE_UINT64:
+    case TYPE_BOOL:
+    case TYPE_FLOAT:
+    case TYPE_DOUBLE:
+    case TYPE_STRING:
+    case TYPE_BYTES:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Checks that row <row> of <column> holds a valid encoding of a <type>.
+absl::Status ValidateColumnarValue(const ColumnarTableData::Column& column,
+                                   const Type* type, int64_t row) {
+  ZETASQL_RET_CHECK_GE(row, 0);
+  if (!column.validity().empty()) {
+    ZETASQL_RET_CHECK_LT(row / 8, column.validity().size());
+    if (!IsValid(column, row)) return absl::OkStatus();
+  }
+
+  switch (type->kind()) {
+    case TYPE_INT32:
+    case TYPE_DATE:
+    case TYPE_ENUM: {
+      ZETASQL_RET_CHECK_LT(row, column.int64_value_size());
+      const int64_t value = column.int64_value(row);
+      ZETASQL_RET_CHECK_GE(value, std::numeric_limits<int32_t>::min());
+      ZETASQL_RET_CHECK_LE(value, std::numeric_limits<int32_t>::max());
+      if (type->kind() == TYPE_ENUM) {
+        const std::string* name;
+        ZETASQL_RET_CHECK(type->AsEnum()->FindName(static_cast<int>(value), &name))
+            << "Invalid value " << value << " for " << type->DebugString();
+      }
+      return absl::OkStatus();
+    }
+    case TYPE_INT64:
+      ZETASQL_RET_CHECK_LT(row, column.int64_value_size());
+      return absl::OkStatus();
+    case TYPE_UINT32:
+      ZETASQL_RET_CHECK_LT(row, column.uint64_value_size());
+      ZETASQL_RET_CHECK_LE(column.uint64_value(row),
+                   std::numeric_limits<uint32_t>::max());
+      return absl::OkStatus();
+    case TYPE_UINT64:
+      ZETASQL_RET_CHECK_LT(row, column.uint64_value_size());
+      return absl::OkStatus();
+    case TYPE_BOOL:
+      ZETASQL_RET_CHECK_LT(row, column.bool_value_size());
+      return absl::OkStatus();
+    case TYPE_FLOAT:
+    case TYPE_DOUBLE:
+      ZETASQL_RET_CHECK_LT(row, column.double_value_size());
+      return absl::OkStatus();
+    case TYPE_STRING:
+    case TYPE_BYTES:
+      if (column.dictionary_index_size() > 0) {
+        ZETASQL_RET_CHECK_LT(row, column.dictionary_index_size());
+        const int32_t index = column.dictionary_index(row);
+        ZETASQL_RET_CHECK_GE(index, 0);
+        ZETASQL_RET_CHECK_LT(index, column.dictionary_size());
+      } else {
+        ZETASQL_RET_CHECK_LT(row, column.bytes_value_size());
+      }
+      return absl::OkStatus();
+    default:
+      ZETASQL_RET_CHECK_LT(row, column.value_size());
+      return absl::OkStatus();
+  }
+}
+
+// Decodes the non-NULL value in row <row> of <column>. The type must have a
+// primitive encoding, and the value must have been validated by
+// ValidateColumnarValue().
+Value DecodePrimitiveValue(const ColumnarTableData::Column& column,
+                           const Type* type, int64_t row) {
+  switch (type->kind()) {
+    case TYPE_INT32:
+      return Value::Int32(static_cast<int32_t>(column.int64_value(row)));
+    case TYPE_DATE:
+      return Value::Date(static_cast<int32_t>(column.int64_value(row)));
+    case TYPE_ENUM:
+      return Value::Enum(type->AsEnum(), column.int64_value(row));
+    case TYPE_INT64:
+      return Value::Int64(column.int64_value(row));
+    case TYPE_UINT32:
+      return Value::Uint32(static_cast<uint32_t>(column.uint64_value(row)));
+    case TYPE_UINT64:
+      return Value::Uint64(column.uint64_value(row));
+    case TYPE_BOOL:
+      return Value::Bool(column.bool_value(row));
+    case TYPE_FLOAT:
+      return Value::Float(static_cast<float>(column.double_value(row)));
+    case TYPE_DOUBLE:
+      return Value::Double(column.double_value(row));
+    case TYPE_STRING:
+    case TYPE_BYTES: {
+      const absl::string_view str =
+          column.dictionary_index_size() > 0
+              ? absl::string_view(
+                    column.dictionary(column.dictionary_index(row)))
+              : absl::string_view(column.bytes_value(row));
+      return type->kind() == TYPE_STRING ? Value::String(str)
+                                         : Value::Bytes(str);
+    }
+    default:
+      ABSL_LOG(FATAL) << "Unexpected type: " << type->DebugString();
+  }
+}
+
+}  // namespace
+
+ColumnarTableBuilder::ColumnarTableBuilder(
+    std::vector<const Type*> column_types)
+    : column_types_(std::move(column_types)),
+      columns_(column_types_.size()),
+      dictionary_indexes_(column_types_.size()),
+      has_null_(column_types_.size(), false) {}
+
+absl::Status ColumnarTableBuilder::AddRow(absl::Span<const Value> row) {
+  ZETASQL_RET_CHECK_EQ(row.size(), column_types_.size());
+  const int64_t bit = num_rows_ % 8;
+  for (int i = 0; i < row.size(); ++i) {
+    const Value& value = row[i];
+    const Type* type = column_types_[i];
+    ZETASQL_RET_CHECK(value.type()->Equals(type))
+        << value.type()->DebugString() << " vs. " << type->DebugString();
+    ColumnarTableData::Column& column = columns_[i];
+
+    std::string* validity = column.mutable_validity();
+    if (bit == 0) validity->push_back(0);
+    const bool is_null = value.is_null();
+    if (is_null) {
+      has_null_[i] = true;
+    } else {
+      validity->back() = static_cast<char>(validity->back() | (1 << bit));
+    }
+
+    switch (type->kind()) {
+      case TYPE_INT32:
+        column.add_int64_value(is_null ? 0 : value.int32_value());
+        estimated_byte_size_ += sizeof(int64_t);
+        break;
+      case TYPE_INT64:
+        column.add_int64_value(is_null ? 0 : value.int64_value());
+        estimated_byte_size_ += sizeof(int64_t);
+        break;
+      case TYPE_DATE:
+        column.add_int64_value(is_null ? 0 : value.date_value());
+        estimated_byte_size_ += sizeof(int64_t);
+        break;
+      case TYPE_ENUM:
+        column.add_int64_value(is_null ? 0 : value.enum_value());
+        estimated_byte_size_ += sizeof(int64_t);
+        break;
+      case TYPE_UINT32:
+        column.add_uint64_value(is_null ? 0 : value.uint32_value());
+        estimated_byte_size_ += sizeof(uint64_t);
+        break;
+      case TYPE_UINT64:
+        column.add_uint64_value(is_null ? 0 : value.uint64_value());
+        estimated_byte_size_ += sizeof(uint64_t);
+        break;
+      case TYPE_BOOL:
+        column.add_bool_value(is_null ? false : value.bool_value());
+        estimated_byte_size_ += 1;
+        break;
+      case TYPE_FLOAT:
+        column.add_double_value(is_null ? 0 : value.float_value());
+        estimated_byte_size_ += sizeof(double);
+        break;
+      case TYPE_DOUBLE:
+        column.add_double_value(is_null ? 0 : value.double_value());
+        estimated_byte_size_ += sizeof(double);
+        break;
+      case TYPE_STRING:
+      case TYPE_BYTES: {
+        int32_t index = 0;
+        if (!is_null) {
+          const absl::string_view str = type->kind() == TYPE_STRING
+                                            ? value.string_value()
+                                            : value.bytes_value();
+          auto& dictionary_index = dictionary_indexes_[i];
+          auto it = dictionary_index.find(str);
+          if (it == dictionary_index.end()) {
+            ZETASQL_RET_CHECK_LT(column.dictionary_size(),
+                         std::numeric_limits<int32_t>::max());
+            std::string* entry = column.add_dictionary();
+            entry->assign(str.data(), str.size());
+            it = dictionary_index.emplace(*entry, column.dictionary_size() - 1)
+                     .first;
+          }
+          index = it->second;
+          // Charge the plain encoding, which is the larger one.
+          estimated_byte_size_ += str.size();
+        }
+        column.add_dictionary_index(index);
+        estimated_byte_size_ += 3;
+        break;
+      }
+      default: {
+        ValueProto* proto = column.add_value();
+        if (!is_null) {
+          ZETASQL_RETURN_IF_ERROR(value.Serialize(proto));
+        }
+        estimated_byte_size_ += proto->ByteSizeLong() + 2;
+        break;
+      }
+    }
+  }
+  ++num_rows_;
+  return absl::OkStatus();
+}
+
+absl::Status ColumnarTableBuilder::Finish(ColumnarTableData* batch) {
+  batch->Clear();
+  batch->set_num_rows(num_rows_);
+  for (int i = 0; i < columns_.size(); ++i) {
+    ColumnarTableData::Column& column = columns_[i];
+    if (IsStringOrBytes(column_types_[i]) &&
+        column.dictionary_size() * int64_t{2} > num_rows_) {
+      // Too many distinct values for the dictionary to pay off.
+      ZETASQL_RET_CHECK_EQ(column.dictionary_index_size(), num_rows_);
+      column.mutable_bytes_value()->Reserve(static_cast<int>(num_rows_));
+      for (int64_t row = 0; row < num_rows_; ++row) {
+        std::string* value = column.add_bytes_value();
+        if (IsValid(column, row)) {
+          *value = column.dictionary(column.dictionary_index(row));
+        }
+      }
+      column.clear_dictionary();
+      column.clear_dictionary_index();
+    }
+    if (!has_null_[i]) column.clear_validity();
+
+    dictionary_indexes_[i].clear();
+    batch->add_column()->Swap(&column);
+    column.Clear();
+    has_null_[i] = false;
+  }
+  num_rows_ = 0;
+  estimated_byte_size_ = 0;
+  return absl::OkStatus();
+}
+
+absl::StatusOr<Value> GetColumnarValue(const ColumnarTableData::Column& column,
+                                       const Type* type, int64_t row) {
+  ZETASQL_RETURN_IF_ERROR(ValidateColumnarValue(column, type, row));
+  if (!column.validity().empty() && !IsValid(column, row)) {
+    return Value::Null(type);
+  }
+  if (!HasPrimitiveEncoding(type)) {
+    return Value::Deserialize(column.value(row), type);
+  }
+  return DecodePrimitiveValue(column, type, row);
+}
+
+absl::StatusOr<std::shared_ptr<const ColumnarTable>> ColumnarTable::Create(
+    std::vector<const Type*> column_types, ColumnarTableData data) {
+  ZETASQL_RET_CHECK_GE(data.num_rows(), 0);
+  ZETASQL_RET_CHECK_EQ(data.column_size(), column_types.size());
+  const int64_t num_rows = data.num_rows();
+  std::vector<std::vector<Value>> decoded_values(column_types.size());
+  for (int i = 0; i < column_types.size(); ++i) {
+    const ColumnarTableData::Column& column = data.column(i);
+    const Type* type = column_types[i];
+    if (!column.validity().empty()) {
+      ZETASQL_RET_CHECK_EQ(column.validity().size(), (num_rows + 7) / 8);
+    }
+    for (int64_t row = 0; row < num_rows; ++row) {
+      ZETASQL_RETURN_IF_ERROR(ValidateColumnarValue(column, type, row));
+    }
+
+    std::vector<Value>& values = decoded_values[i];
+    if (!HasPrimitiveEncoding(type)) {
+      values.reserve(num_rows);
+      for (int64_t row = 0; row < num_rows; ++row) {
+        ZETASQL_ASSIGN_OR_RETURN(values.emplace_back(),
+                         GetColumnarValue(column, type, row));
+      }
+    } else if (column.dictionary_index_size() > 0) {
+      values.reserve(column.dictionary_size());
+      for (const std::string& entry : column.dictionary()) {
+        values.push_back(type->kind() == TYPE_STRING ? Value::String(entry)
+                                                     : Value::Bytes(entry));
+      }
+    }
+  }
+  return std::shared_ptr<const ColumnarTable>(new ColumnarTable(
+      std::move(column_types), std::move(data), std::move(decoded_values)));
+}
+
+Value ColumnarTable::GetValue(int column, int64_t row) const {
+  const ColumnarTableData::Column& column_data = data_.column(column);
+  const Type* type = column_types_[column];
+  if (!column_data.validity().empty() && !IsValid(column_data, row)) {
+    return Value::Null(type);
+  }
+  const std::vector<Value>& decoded_values = decoded_values_[column];
+  if (!HasPrimitiveEncoding(type)) {
+    return decoded_values[row];
+  }
+  if (!decoded_values.empty()) {
+    return decoded_values[column_data.dictionary_index(row)];
+  }
+  return DecodePrimitiveValue(column_data, type, row);
+}
+
+ColumnarTableIterator::ColumnarTableIterator(
+    std::shared_ptr<const ColumnarTable> table,
+    std::vector<const Column*> columns, std::vector<int> column_idxs)
+    : table_(std::move(table)),
+      columns_(std::move(columns)),
+      column_idxs_(std::move(column_idxs)),
+      current_row_(column_idxs_.size()) {
+  ABSL_CHECK_EQ(columns_.size(), column_idxs_.size());
+}
+
+bool ColumnarTableIterator::NextRow() {
+  if (cancelled_.load(std::memory_order_relaxed)) return false;
+  if (row_ + 1 >= table_->num_rows()) {
+    row_ = table_->num_rows();
+    return false;
+  }
+  ++row_;
+  for (int i = 0; i < column_idxs_.size(); ++i) {
+    current_row_[i] = table_->GetValue(column_idxs_[i], row_);
+  }
+  return true;
+}
+
+absl::Status ColumnarTableIterator::Status() const {
+  if (cancelled_.load(std::memory_order_relaxed)) {
+    return zetasql_base::CancelledErrorBuilder()
+           << "ColumnarTableIterator was cancelled";
+  }
+  return absl::OkStatus();
+}
+
+absl::Status ColumnarTableIterator::Cancel() {
+  cancelled_.store(true, std::memory_order_relaxed);
+  return absl::OkStatus();
+}
+
+absl::Status SetColumnarContents(ColumnarTableData data, SimpleTable* table) {
+  std::vector<const Type*> column_types;
+  column_types.reserve(table->NumColumns());
+  for (int i = 0; i < table->NumColumns(); ++i) {
+    column_types.push_back(table->GetColumn(i)->GetType());
+  }
+  ZETASQL_ASSIGN_OR_RETURN(std::shared_ptr<const ColumnarTable> contents,
+                   ColumnarTable::Create(std::move(column_types),
+                                         std::move(data)));
+  // Like SimpleTable::SetContents(), the factory is owned by <table>, so it
+  // can refer to it.
+  table->SetEvaluatorTableIteratorFactory(
+      [contents = std::move(contents), table](absl::Span<const int> column_idxs)
+          -> absl::StatusOr<std::unique_ptr<EvaluatorTableIterator>> {
+        std::vector<const Column*> columns;
+        columns.reserve(column_idxs.size());
+        for (const int column_idx : column_idxs) {
+          columns.push_back(table->GetColumn(column_idx));
+        }
+        return std::make_unique<ColumnarTableIterator>(
+            contents, std::move(columns),
+            std::vector<int>(column_idxs.begin(), column_idxs.end()));
+      });
+  return absl::OkStatus();
+}
+
+}  // namespace local_service
+}  // namespace zetasql
@@ -0,0 +1,173 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Conversion between rows of Values and the ColumnarTableData proto used to
+// exchange tables with clients of the local service, and scans over tables
+// stored in that format.
+
+#ifndef ZETASQL_LOCAL_SERVICE_COLUMNAR_TABLE_H_
+#define ZETASQL_LOCAL_SERVICE_COLUMNAR_TABLE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "zetasql/local_service/local_service.pb.h"
+#include "zetasql/public/catalog.h"
+#include "zetasql/public/evaluator_table_iterator.h"
+#include "zetasql/public/simple_catalog.h"
+#include "zetasql/public/type.h"
+#include "zetasql/public/value.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+
+namespace zetasql {
+namespace local_service {
+
+// Accumulates rows and encodes them as a ColumnarTableData.
+//
+// STRING and BYTES columns are collected into a dictionary of distinct values.
+// When the batch is finished, a column is dictionary encoded if it has at most
+// half as many distinct values as rows, and stored as plain values otherwise.
+class ColumnarTableBuilder {
+ public:
+  explicit ColumnarTableBuilder(std::vector<const Type*> column_types);
+
+  ColumnarTableBuilder(const ColumnarTableBuilder&) = delete;
+  ColumnarTableBuilder& operator=(const ColumnarTableBuilder&) = delete;
+
+  // Appends a row. <row> must have one value per column, of the column's type.
+  absl::Status AddRow(absl::Span<const Value> row);
+
+  int64_t num_rows() const { return num_rows_; }
+
+  // Returns an estimate of the serialized size of the rows added so far.
+  int64_t EstimatedByteSize() const { return estimated_byte_size_; }
+
+  // Moves the rows added so far into <*batch>, replacing its contents, and
+  // resets the builder to start a new batch.
+  absl::Status Finish(ColumnarTableData* batch);
+
+ private:
+  const std::vector<const Type*> column_types_;
+  // Parallel to 'column_types_'. Values are added directly to the protos.
+  // STRING and BYTES values are always added to the dictionary first, and
+  // expanded into plain values by Finish() if there are too many of them.
+  std::vector<ColumnarTableData::Column> columns_;
+  // Parallel to 'column_types_'. Maps the dictionary entries of STRING and
+  // BYTES columns, which are owned by 'columns_', to their index.
+  std::vector<absl::flat_hash_map<absl::string_view, int32_t>>
+      dictionary_indexes_;
+  // Parallel to 'column_types_'. True if the column has a NULL value in the
+  // current batch.
+  std::vector<bool> has_null_;
+  int64_t num_rows_ = 0;
+  int64_t estimated_byte_size_ = 0;
+};
+
+// Returns the value in row <row> of <column>, whose type is <type>.
+absl::StatusOr<Value> GetColumnarValue(const ColumnarTableData::Column& column,
+                                       const Type* type, int64_t row);
+
+// An immutable table whose contents are held as a ColumnarTableData. Values are
+// decoded from the typed vectors one at a time as the table is scanned, rather
+// than converting the whole table to Values when it is loaded. Only the
+// dictionaries of STRING and BYTES columns, and columns of types without a
+// primitive encoding, are converted to Values up front.
+class ColumnarTable {
+ public:
+  // Validates <data> against <column_types>, so that GetValue() cannot fail.
+  static absl::StatusOr<std::shared_ptr<const ColumnarTable>> Create(
+      std::vector<const Type*> column_types, ColumnarTableData data);
+
+  ColumnarTable(const ColumnarTable&) = delete;
+  ColumnarTable& operator=(const ColumnarTable&) = delete;
+
+  int NumColumns() const { return static_cast<int>(column_types_.size()); }
+  int64_t num_rows() const { return data_.num_rows(); }
+
+  // Returns the value in row <row> of column <column>.
+  Value GetValue(int column, int64_t row) const;
+
+ private:
+  ColumnarTable(std::vector<const Type*> column_types, ColumnarTableData data,
+                std::vector<std::vector<Value>> decoded_values)
+      : column_types_(std::move(column_types)),
+        data_(std::move(data)),
+        decoded_values_(std::move(decoded_values)) {}
+
+  const std::vector<const Type*> column_types_;
+  const ColumnarTableData data_;
+  // Parallel to 'column_types_'. Holds the dictionary entries of dictionary
+  // encoded columns, and the values of columns stored as ValueProtos. Empty
+  // for other columns.
+  const std::vector<std::vector<Value>> decoded_values_;
+};
+
+// Iterates over some of the columns of a ColumnarTable.
+class ColumnarTableIterator : public EvaluatorTableIterator {
+ public:
+  // 'columns[i]' is the column at index 'column_idxs[i]' in 'table'.
+  ColumnarTableIterator(std::shared_ptr<const ColumnarTable> table,
+                        std::vector<const Column*> columns,
+                        std::vector<int> column_idxs);
+
+  ColumnarTableIterator(const ColumnarTableIterator&) = delete;
+  ColumnarTableIterator& operator=(const ColumnarTableIterator&) = delete;
+
+  int NumColumns() const override { return static_cast<int>(columns_.size()); }
+
+  std::string GetColumnName(int i) const override {
+    return columns_[i]->Name();
+  }
+
+  const Type* GetColumnType(int i) const override {
+    return columns_[i]->GetType();
+  }
+
+  bool NextRow() override;
+
+  const Value& GetValue(int i) const override { return current_row_[i]; }
+
+  absl::Status Status() const override;
+
+  absl::Status Cancel() override;
+
+ private:
+  const std::shared_ptr<const ColumnarTable> table_;
+  const std::vector<const Column*> columns_;
+  const std::vector<int> column_idxs_;
+  // The values of 'columns_' in the current row.
+  std::vector<Value> current_row_;
+  int64_t row_ = -1;
+  std::atomic<bool> cancelled_{false};
+};
+
+// Sets the contents of <table> to <data>, which must have a column for each of
+// the table's columns. Like SimpleTable::SetContents(), this installs an
+// EvaluatorTableIterator factory on the table.
+absl::Status SetColumnarContents(ColumnarTableData data, SimpleTable* table);
+
+}  // namespace local_service
+}  // namespace zetasql
+
+#endif  // ZETASQL_LOCAL_SERVICE_COLUMNAR_TABLE_H_
@@ -0,0 +1,231 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/local_service/columnar_table.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "zetasql/base/testing/status_matchers.h"
+#include "zetasql/local_service/local_service.pb.h"
+#include "zetasql/public/evaluator_table_iterator.h"
+#include "zetasql/public/simple_catalog.h"
+#include "zetasql/public/type.h"
+#include "zetasql/public/value.h"
+#include "zetasql/testing/test_value.h"
+#include "zetasql/testing/using_test_value.cc"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+
+using ::zetasql_base::testing::IsOkAndHolds;
+using ::zetasql_base::testing::StatusIs;
+
+namespace zetasql {
+namespace local_service {
+namespace {
+
+TEST(ColumnarTableTest, RoundTrip) {
+  const std::vector<const Type*> types = {
+      Int32Type(),  Int64Type(),  Uint32Type(),    Uint64Type(),
+      BoolType(),   FloatType(),  DoubleType(),    DateType(),
+      StringType(), BytesType(),  TimestampType(), Int64ArrayType()};
+  const std::vector<std::vector<Value>> rows = {
+      {Int32(-1), Int64(int64_t{1} << 40), Uint32(7), Uint64(uint64_t{1} << 63),
+       Bool(true), Float(1.5), Double(-2.25), Date(10), String("a"),
+       Bytes("x"), TimestampFromUnixMicros(5), Int64Array({1, 2})},
+      {NullInt32(), NullInt64(), NullUint32(), NullUint64(), NullBool(),
+       NullFloat(), NullDouble(), NullDate(), NullString(), NullBytes(),
+       NullTimestamp(), Null(Int64ArrayType())},
+      {Int32(0), Int64(0), Uint32(0), Uint64(0), Bool(false), Float(0),
+       Double(0), Date(0), String(""), Bytes(""), TimestampFromUnixMicros(0),
+       Int64Array({})},
+  };
+
+  ColumnarTableBuilder builder(types);
+  for (const std::vector<Value>& row : rows) {
+    ZETASQL_ASSERT_OK(builder.AddRow(row));
+  }
+  EXPECT_EQ(builder.num_rows(), rows.size());
+  EXPECT_GT(builder.EstimatedByteSize(), 0);
+
+  ColumnarTableData batch;
+  ZETASQL_ASSERT_OK(builder.Finish(&batch));
+  EXPECT_EQ(batch.num_rows(), rows.size());
+  ASSERT_EQ(batch.column_size(), types.size());
+  for (int column = 0; column < types.size(); ++column) {
+    // Row 1 is NULL in every column.
+    EXPECT_EQ(batch.column(column).validity(), "\x05") << column;
+    for (int row = 0; row < rows.size(); ++row) {
+      EXPECT_THAT(GetColumnarValue(batch.column(column), types[column], row),
+                  IsOkAndHolds(rows[row][column]))
+          << "column " << column << ", row " << row;
+    }
+  }
+  EXPECT_EQ(batch.column(0).int64_value_size(), rows.size());
+  EXPECT_EQ(batch.column(11).value_size(), rows.size());
+
+  // The builder starts over after Finish().
+  EXPECT_EQ(builder.num_rows(), 0);
+  ZETASQL_ASSERT_OK(builder.Finish(&batch));
+  EXPECT_EQ(batch.num_rows(), 0);
+  EXPECT_EQ(batch.column(0).int64_value_size(), 0);
+}
+
+TEST(ColumnarTableTest, DictionaryEncoding) {
+  ColumnarTableBuilder builder({StringType(), StringType()});
+  for (int i = 0; i < 10; ++i) {
+    ZETASQL_ASSERT_OK(builder.AddRow(
+        {String(i % 2 == 0 ? "even" : "odd"), String(std::to_string(i))}));
+  }
+  ZETASQL_ASSERT_OK(builder.AddRow({NullString(), NullString()}));
+
+  ColumnarTableData batch;
+  ZETASQL_ASSERT_OK(builder.Finish(&batch));
+  ASSERT_EQ(batch.column_size(), 2);
+
+  // Few distinct values.
+  const ColumnarTableData::Column& repeated = batch.column(0);
+  EXPECT_THAT(repeated.dictionary(), ::testing::ElementsAre("even", "odd"));
+  EXPECT_EQ(repeated.dictionary_index_size(), 11);
+  EXPECT_EQ(repeated.bytes_value_size(), 0);
+  EXPECT_THAT(GetColumnarValue(repeated, StringType(), 3),
+              IsOkAndHolds(String("odd")));
+  EXPECT_THAT(GetColumnarValue(repeated, StringType(), 10),
+              IsOkAndHolds(NullString()));
+
+  // All values are distinct.
+  const ColumnarTableData::Column& unique = batch.column(1);
+  EXPECT_EQ(unique.dictionary_size(), 0);
+  EXPECT_EQ(unique.dictionary_index_size(), 0);
+  ASSERT_EQ(unique.bytes_value_size(), 11);
+  EXPECT_EQ(unique.bytes_value(7), "7");
+  EXPECT_EQ(unique.bytes_value(10), "");
+  EXPECT_THAT(GetColumnarValue(unique, StringType(), 7),
+              IsOkAndHolds(String("7")));
+  EXPECT_THAT(GetColumnarValue(unique, StringType(), 10),
+              IsOkAndHolds(NullString()));
+}
+
+TEST(ColumnarTableTest, ValidityOmittedWithoutNulls) {
+  ColumnarTableBuilder builder({Int64Type()});
+  for (int i = 0; i < 20; ++i) {
+    ZETASQL_ASSERT_OK(builder.AddRow({Int64(i)}));
+  }
+  ColumnarTableData batch;
+  ZETASQL_ASSERT_OK(builder.Finish(&batch));
+  EXPECT_TRUE(batch.column(0).validity().empty());
+  EXPECT_THAT(GetColumnarValue(batch.column(0), Int64Type(), 19),
+              IsOkAndHolds(Int64(19)));
+
+  // A NULL in the second batch spans three validity bytes.
+  for (int i = 0; i < 20; ++i) {
+    ZETASQL_ASSERT_OK(builder.AddRow({i == 17 ? NullInt64() : Int64(i)}));
+  }
+  ZETASQL_ASSERT_OK(builder.Finish(&batch));
+  EXPECT_EQ(batch.column(0).validity(), std::string("\xff\xff\x0d", 3));
+  EXPECT_THAT(GetColumnarValue(batch.column(0), Int64Type(), 17),
+              IsOkAndHolds(NullInt64()));
+}
+
+TEST(ColumnarTableTest, Errors) {
+  ColumnarTableBuilder builder({Int64Type()});
+  EXPECT_THAT(builder.AddRow({String("a")}),
+              StatusIs(absl::StatusCode::kInternal));
+  EXPECT_THAT(builder.AddRow({Int64(1), Int64(2)}),
+              StatusIs(absl::StatusCode::kInternal));
+
+  ColumnarTableData::Column column;
+  column.add_int64_value(int64_t{1} << 40);
+  EXPECT_THAT(GetColumnarValue(column, Int32Type(), 0),
+              StatusIs(absl::StatusCode::kInternal));
+  EXPECT_THAT(GetColumnarValue(column, Int64Type(), 1),
+              StatusIs(absl::StatusCode::kInternal));
+}
+
+TEST(ColumnarTableTest, ScanSimpleTable) {
+  SimpleTable table("t", {{"id", Int64Type()},
+                          {"name", StringType()},
+                          {"ts", TimestampType()}});
+  ColumnarTableBuilder builder({Int64Type(), StringType(), TimestampType()});
+  ZETASQL_ASSERT_OK(builder.AddRow(
+      {Int64(1), String("a"), TimestampFromUnixMicros(10)}));
+  ZETASQL_ASSERT_OK(builder.AddRow({Int64(2), String("a"), NullTimestamp()}));
+  ZETASQL_ASSERT_OK(builder.AddRow({NullInt64(), NullString(),
+                            TimestampFromUnixMicros(30)}));
+  ZETASQL_ASSERT_OK(builder.AddRow(
+      {Int64(4), String("a"), TimestampFromUnixMicros(40)}));
+  ColumnarTableData data;
+  ZETASQL_ASSERT_OK(builder.Finish(&data));
+  ZETASQL_ASSERT_OK(SetColumnarContents(data, &table));
+
+  // Scan a subset of the columns, in a different order.
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<EvaluatorTableIterator> iter,
+                       table.CreateEvaluatorTableIterator({2, 1}));
+  ASSERT_EQ(iter->NumColumns(), 2);
+  EXPECT_EQ(iter->GetColumnName(0), "ts");
+  EXPECT_EQ(iter->GetColumnType(1), StringType());
+  std::vector<std::vector<Value>> rows;
+  while (iter->NextRow()) {
+    rows.push_back({iter->GetValue(0), iter->GetValue(1)});
+  }
+  ZETASQL_EXPECT_OK(iter->Status());
+  EXPECT_THAT(rows, ::testing::ElementsAre(
+                        ::testing::ElementsAre(TimestampFromUnixMicros(10),
+                                               String("a")),
+                        ::testing::ElementsAre(NullTimestamp(), String("a")),
+                        ::testing::ElementsAre(TimestampFromUnixMicros(30),
+                                               NullString()),
+                        ::testing::ElementsAre(TimestampFromUnixMicros(40),
+                                               String("a"))));
+
+  // Iterators are independent, and can be cancelled.
+  ZETASQL_ASSERT_OK_AND_ASSIGN(iter, table.CreateEvaluatorTableIterator({0}));
+  ASSERT_TRUE(iter->NextRow());
+  EXPECT_EQ(iter->GetValue(0), Int64(1));
+  ZETASQL_ASSERT_OK(iter->Cancel());
+  EXPECT_FALSE(iter->NextRow());
+  EXPECT_THAT(iter->Status(), StatusIs(absl::StatusCode::kCancelled));
+}
+
+TEST(ColumnarTableTest, CreateValidatesData) {
+  ColumnarTableData data;
+  data.set_num_rows(2);
+  ColumnarTableData::Column* column = data.add_column();
+  column->add_dictionary("a");
+  column->add_dictionary_index(0);
+  column->add_dictionary_index(1);
+  EXPECT_THAT(ColumnarTable::Create({StringType()}, data),
+              StatusIs(absl::StatusCode::kInternal));
+
+  // The second row is NULL, so its index is not used.
+  column->set_validity("\x01");
+  ZETASQL_EXPECT_OK(ColumnarTable::Create({StringType()}, data));
+
+  // Too few values.
+  data.set_num_rows(3);
+  column->set_validity("");
+  EXPECT_THAT(ColumnarTable::Create({StringType()}, data),
+              StatusIs(absl::StatusCode::kInternal));
+  // Wrong number of columns.
+  EXPECT_THAT(ColumnarTable::Create({StringType(), StringType()}, data),
+              StatusIs(absl::StatusCode::kInternal));
+}
+
+}  // namespace
+}  // namespace local_service
+}  // namespace zetasql
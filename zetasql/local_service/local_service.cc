@@ -26,8 +26,10 @@
 #include <vector>
 
 #include "google/protobuf/descriptor.pb.h"
+#include "zetasql/base/file_util.h"
 #include "zetasql/common/errors.h"
 #include "zetasql/common/proto_helper.h"
+#include "zetasql/local_service/columnar_table.h"
 #include "zetasql/local_service/local_service.pb.h"
 #include "zetasql/local_service/state.h"
 #include "zetasql/parser/parse_tree_serializer.h"
@@ -50,8 +52,10 @@
 #include "zetasql/resolved_ast/resolved_ast.h"
 #include "zetasql/resolved_ast/sql_builder.h"
 #include "absl/cleanup/cleanup.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/functional/bind_front.h"
+#include "absl/functional/function_ref.h"
 #include "absl/status/statusor.h"
 #include "absl/types/optional.h"
 #include "zetasql/base/map_util.h"
@@ -301,6 +305,20 @@ class InternalPreparedQueryState : public GenericState {
 
   const PreparedQuery* GetQuery() const { return query_.get(); }
 
+  // Returns a new PreparedQuery for the same analyzed query that collects
+  // operator profiles, which are an option of the PreparedQuery. This object
+  // must outlive the result.
+  absl::StatusOr<std::unique_ptr<PreparedQuery>> PrepareWithOperatorProfile()
+      const {
+    EvaluatorOptions evaluator_options;
+    evaluator_options.default_time_zone = options_->default_time_zone();
+    evaluator_options.collect_operator_profile = true;
+    auto query = std::make_unique<PreparedQuery>(query_->resolved_query_stmt(),
+                                                 evaluator_options);
+    ZETASQL_RETURN_IF_ERROR(query->Prepare(*options_));
+    return query;
+  }
+
   const AnalyzerOptions& GetAnalyzerOptions() const { return *options_; }
 
   absl::flat_hash_set<int64_t> owned_descriptor_pool_ids() const {
@@ -471,7 +489,37 @@ class RegisteredCatalogState : public GenericState {
                      SimpleTable::Deserialize(proto, type_deserializer));
 
     const TableContent* table_content = zetasql_base::FindOrNull(tables_contents, name);
-    if (table_content == nullptr || !table_content->has_table_data()) {
+    if (table_content == nullptr) {
+      return table;
+    }
+    const int num_contents = table_content->has_table_data() +
+                             table_content->has_columnar_table_data() +
+                             table_content->has_columnar_table_data_file();
+    if (num_contents > 1) {
+      return ::zetasql_base::InvalidArgumentErrorBuilder()
+             << "More than one kind of content set for table '" << name << "'";
+    }
+    if (table_content->has_columnar_table_data()) {
+      ZETASQL_RETURN_IF_ERROR(SetColumnarContents(
+          table_content->columnar_table_data(), table.get()));
+      return table;
+    }
+    if (table_content->has_columnar_table_data_file()) {
+      std::string contents;
+      ZETASQL_RETURN_IF_ERROR(internal::GetContents(
+          table_content->columnar_table_data_file(), &contents));
+      ColumnarTableData columnar_table_data;
+      if (!columnar_table_data.ParseFromString(contents)) {
+        return ::zetasql_base::InvalidArgumentErrorBuilder()
+               << "Failed to parse ColumnarTableData from "
+               << table_content->columnar_table_data_file();
+      }
+      contents.clear();
+      ZETASQL_RETURN_IF_ERROR(
+          SetColumnarContents(std::move(columnar_table_data), table.get()));
+      return table;
+    }
+    if (!table_content->has_table_data()) {
       return table;
     }
 
@@ -871,6 +919,148 @@ absl::Status ZetaSqlLocalServiceImpl::Evaluate(const EvaluateRequest& request,
   return absl::OkStatus();
 }
 
+absl::Status ZetaSqlLocalServiceImpl::EvaluateColumnar(
+    const EvaluateColumnarRequest& request,
+    EvaluateColumnarResponse* response) {
+  const int64_t id = request.prepared_expression_id();
+  std::shared_ptr<InternalPreparedExpressionState> state =
+      prepared_expressions_->Get(id);
+  if (state == nullptr) {
+    return MakeSqlError() << "Prepared expression " << id << " unknown.";
+  }
+  const AnalyzerOptions& analyzer_options = state->GetAnalyzerOptions();
+  const PreparedExpression* expression = state->GetExpression();
+
+  // Decode the rows, and find the column of each name.
+  std::vector<const Type*> types;
+  auto add_names = [&types](const RepeatedPtrField<std::string>& names,
+                            const QueryParametersMap& declared_types,
+                            absl::flat_hash_map<std::string, int>* indexes)
+      -> absl::Status {
+    for (const std::string& name : names) {
+      const std::string lower_name = absl::AsciiStrToLower(name);
+      const Type* type =
+          zetasql_base::FindPtrOrNull(declared_types, lower_name);
+      ZETASQL_RET_CHECK(type != nullptr)
+          << "Type not found for '" << lower_name << "'";
+      (*indexes)[lower_name] = static_cast<int>(types.size());
+      types.push_back(type);
+    }
+    return absl::OkStatus();
+  };
+  absl::flat_hash_map<std::string, int> column_indexes, param_indexes;
+  ZETASQL_RETURN_IF_ERROR(add_names(request.column_names(),
+                            analyzer_options.expression_columns(),
+                            &column_indexes));
+  ZETASQL_RETURN_IF_ERROR(add_names(request.param_names(),
+                            analyzer_options.query_parameters(),
+                            &param_indexes));
+  ZETASQL_ASSIGN_OR_RETURN(std::shared_ptr<const ColumnarTable> rows,
+                   ColumnarTable::Create(types, request.rows()));
+
+  // Gather the values of the referenced columns and parameters, in the order
+  // expected by ExecuteAfterPrepareBatch().
+  PreparedExpression::BatchOptions options;
+  options.num_rows = rows->num_rows();
+  auto add_values = [&rows, &options](
+                        const std::vector<std::string>& referenced,
+                        const absl::flat_hash_map<std::string, int>& indexes,
+                        absl::string_view kind,
+                        std::vector<ParameterValueList>* values)
+      -> absl::Status {
+    for (const std::string& name : referenced) {
+      const int* index = zetasql_base::FindOrNull(indexes, name);
+      if (index == nullptr) {
+        return MakeSqlError() << "No value for " << kind << " '" << name << "'";
+      }
+      ParameterValueList& column = values->emplace_back();
+      column.reserve(options.num_rows);
+      for (int64_t row = 0; row < options.num_rows; ++row) {
+        column.push_back(rows->GetValue(*index, row));
+      }
+    }
+    return absl::OkStatus();
+  };
+  ZETASQL_ASSIGN_OR_RETURN(std::vector<std::string> referenced_columns,
+                   expression->GetReferencedColumns());
+  ZETASQL_RETURN_IF_ERROR(add_values(referenced_columns, column_indexes,
+                             "column", &options.ordered_columns));
+  ZETASQL_ASSIGN_OR_RETURN(std::vector<std::string> referenced_params,
+                   expression->GetReferencedParameters());
+  ZETASQL_RETURN_IF_ERROR(add_values(referenced_params, param_indexes,
+                             "parameter", &options.ordered_parameters));
+
+  ZETASQL_ASSIGN_OR_RETURN(std::vector<Value> results,
+                   expression->ExecuteAfterPrepareBatch(options));
+  ColumnarTableBuilder builder({expression->output_type()});
+  for (const Value& result : results) {
+    ZETASQL_RETURN_IF_ERROR(builder.AddRow({result}));
+  }
+  return builder.Finish(response->mutable_result());
+}
+
+namespace {
+
+// Default for EvaluateQueryColumnarRequest.max_rows_per_batch.
+constexpr int64_t kDefaultColumnarBatchRows = 1024;
+// Columnar batches are sent early once they reach this estimated size, to stay
+// well below gRPC's default 4MB message size limit.
+constexpr int64_t kMaxColumnarBatchBytes = 1 << 20;
+
+// The response filled in by EvaluateImpl() for EvaluateQueryColumnar(). Rather
+// than holding the whole result, it passes each batch to the caller as soon as
+// the batch is complete.
+class ColumnarQueryResponseWriter {
+ public:
+  ColumnarQueryResponseWriter(
+      int64_t max_rows_per_batch,
+      absl::FunctionRef<absl::Status(const EvaluateQueryColumnarResponse&)>
+          emit)
+      : max_rows_per_batch_(max_rows_per_batch), emit_(emit) {}
+
+  PreparedQueryState* mutable_prepared() {
+    return response_.mutable_prepared();
+  }
+
+  int64_t max_rows_per_batch() const { return max_rows_per_batch_; }
+
+  bool has_written() const { return has_written_; }
+
+  // Sends the rows in <*builder> as the next batch.
+  absl::Status WriteBatch(ColumnarTableBuilder* builder) {
+    ZETASQL_RETURN_IF_ERROR(builder->Finish(response_.mutable_batch()));
+    ZETASQL_RETURN_IF_ERROR(emit_(response_));
+    // The schema is only sent with the first batch.
+    response_.clear_prepared();
+    has_written_ = true;
+    return absl::OkStatus();
+  }
+
+ private:
+  const int64_t max_rows_per_batch_;
+  absl::FunctionRef<absl::Status(const EvaluateQueryColumnarResponse&)> emit_;
+  EvaluateQueryColumnarResponse response_;
+  bool has_written_ = false;
+};
+
+absl::StatusOr<std::unique_ptr<EvaluatorTableIterator>> ExecutePreparedQuery(
+    const EvaluateQueryRequest& request,
+    InternalPreparedQueryState* internal_state, const PreparedQuery& query) {
+  const AnalyzerOptions& analyzer_options =
+      internal_state->GetAnalyzerOptions();
+
+  ParameterValueMap params;
+  ZETASQL_RETURN_IF_ERROR(RepeatedParametersToMap(
+      request.params(), analyzer_options.query_parameters(), &params));
+
+  PreparedQuery::QueryOptions options;
+  options.parameters = std::move(params);
+
+  return query.ExecuteAfterPrepare(options);
+}
+
+}  // namespace
+
 absl::Status ZetaSqlLocalServiceImpl::EvaluateQuery(
     const EvaluateQueryRequest& request, EvaluateQueryResponse* response) {
   std::optional<int64_t> prepared_query_id_opt =
@@ -881,6 +1071,23 @@ absl::Status ZetaSqlLocalServiceImpl::EvaluateQuery(
                       *prepared_queries_, "query", response);
 }
 
+absl::Status ZetaSqlLocalServiceImpl::EvaluateQueryColumnar(
+    const EvaluateQueryColumnarRequest& request,
+    absl::FunctionRef<absl::Status(const EvaluateQueryColumnarResponse&)>
+        emit) {
+  const EvaluateQueryRequest& query = request.query();
+  std::optional<int64_t> prepared_query_id_opt =
+      query.has_prepared_query_id()
+          ? std::optional<int64_t>(query.prepared_query_id())
+          : std::nullopt;
+  ColumnarQueryResponseWriter response(
+      request.max_rows_per_batch() > 0 ? request.max_rows_per_batch()
+                                       : kDefaultColumnarBatchRows,
+      emit);
+  return EvaluateImpl(query, query.table_content(), prepared_query_id_opt,
+                      *prepared_queries_, "query", &response);
+}
+
 absl::Status ZetaSqlLocalServiceImpl::EvaluateModify(
     const EvaluateModifyRequest& request, EvaluateModifyResponse* response) {
   std::optional<int64_t> prepared_modify_id_opt =
@@ -989,18 +1196,15 @@ absl::Status ZetaSqlLocalServiceImpl::EvaluatePrepared(
     const EvaluateQueryRequest& request,
     InternalPreparedQueryState* internal_state,
     EvaluateQueryResponse* response) {
-  const AnalyzerOptions& analyzer_options =
-      internal_state->GetAnalyzerOptions();
-
-  ParameterValueMap params;
-  ZETASQL_RETURN_IF_ERROR(RepeatedParametersToMap(
-      request.params(), analyzer_options.query_parameters(), &params));
-
-  PreparedQuery::QueryOptions options;
-  options.parameters = std::move(params);
-
+  const PreparedQuery* query = internal_state->GetQuery();
+  std::unique_ptr<PreparedQuery> profiled_query;
+  if (request.collect_operator_profile()) {
+    ZETASQL_ASSIGN_OR_RETURN(profiled_query,
+                     internal_state->PrepareWithOperatorProfile());
+    query = profiled_query.get();
+  }
   ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<EvaluatorTableIterator> results_iterator,
-                   internal_state->GetQuery()->ExecuteAfterPrepare(options));
+                   ExecutePreparedQuery(request, internal_state, *query));
 
   TableData* table_data = response->mutable_content()->mutable_table_data();
   while (results_iterator->NextRow()) {
@@ -1010,8 +1214,51 @@ absl::Status ZetaSqlLocalServiceImpl::EvaluatePrepared(
       ZETASQL_RETURN_IF_ERROR(results_iterator->GetValue(i).Serialize(value));
     }
   }
+  ZETASQL_RETURN_IF_ERROR(results_iterator->Status());
 
-  return results_iterator->Status();
+  if (request.collect_operator_profile()) {
+    ZETASQL_ASSIGN_OR_RETURN(*response->mutable_operator_profile(),
+                     query->ExplainAnalyze(*results_iterator));
+  }
+  return absl::OkStatus();
+}
+
+template <>
+absl::Status ZetaSqlLocalServiceImpl::EvaluatePrepared(
+    const EvaluateQueryRequest& request,
+    InternalPreparedQueryState* internal_state,
+    ColumnarQueryResponseWriter* response) {
+  ZETASQL_ASSIGN_OR_RETURN(
+      std::unique_ptr<EvaluatorTableIterator> results_iterator,
+      ExecutePreparedQuery(request, internal_state,
+                           *internal_state->GetQuery()));
+
+  const int num_columns = results_iterator->NumColumns();
+  std::vector<const Type*> column_types;
+  column_types.reserve(num_columns);
+  for (int i = 0; i < num_columns; i++) {
+    column_types.push_back(results_iterator->GetColumnType(i));
+  }
+  ColumnarTableBuilder builder(std::move(column_types));
+
+  std::vector<Value> row(num_columns);
+  while (results_iterator->NextRow()) {
+    for (int i = 0; i < num_columns; i++) {
+      row[i] = results_iterator->GetValue(i);
+    }
+    ZETASQL_RETURN_IF_ERROR(builder.AddRow(row));
+    if (builder.num_rows() >= response->max_rows_per_batch() ||
+        builder.EstimatedByteSize() >= kMaxColumnarBatchBytes) {
+      ZETASQL_RETURN_IF_ERROR(response->WriteBatch(&builder));
+    }
+  }
+  ZETASQL_RETURN_IF_ERROR(results_iterator->Status());
+
+  // Always send at least one batch, so that the caller gets the schema.
+  if (builder.num_rows() > 0 || !response->has_written()) {
+    ZETASQL_RETURN_IF_ERROR(response->WriteBatch(&builder));
+  }
+  return absl::OkStatus();
 }
 
 template <>
@@ -35,6 +35,7 @@
 #include "zetasql/public/simple_catalog.h"
 #include "zetasql/public/simple_table.pb.h"
 #include <cstdint>
+#include "absl/functional/function_ref.h"
 #include "absl/strings/string_view.h"
 #include "zetasql/base/status.h"
 
@@ -69,6 +70,10 @@ class ZetaSqlLocalServiceImpl {
   absl::Status Evaluate(const EvaluateRequest& request,
                         EvaluateResponse* response);
 
+  // Evaluates a prepared expression once per row of request.rows().
+  absl::Status EvaluateColumnar(const EvaluateColumnarRequest& request,
+                                EvaluateColumnarResponse* response);
+
   absl::Status PrepareQuery(const PrepareQueryRequest& request,
                             PrepareQueryResponse* response);
 
@@ -77,6 +82,14 @@ class ZetaSqlLocalServiceImpl {
   absl::Status EvaluateQuery(const EvaluateQueryRequest& request,
                              EvaluateQueryResponse* response);
 
+  // Evaluates the query in <request> and passes the result to <emit> in
+  // batches of rows encoded as ColumnarTableData. <emit> is called at least
+  // once; evaluation stops if it returns an error.
+  absl::Status EvaluateQueryColumnar(
+      const EvaluateQueryColumnarRequest& request,
+      absl::FunctionRef<absl::Status(const EvaluateQueryColumnarResponse&)>
+          emit);
+
   absl::Status PrepareModify(const PrepareModifyRequest& request,
                              PrepareModifyResponse* response);
 
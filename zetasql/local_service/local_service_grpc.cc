@@ -128,6 +128,12 @@ grpc::Status ZetaSqlLocalServiceGrpcImpl::EvaluateStream(
   return grpc::Status();
 }
 
+grpc::Status ZetaSqlLocalServiceGrpcImpl::EvaluateColumnar(
+    grpc::ServerContext* context, const EvaluateColumnarRequest* req,
+    EvaluateColumnarResponse* resp) {
+  return ToGrpcStatus(service_.EvaluateColumnar(*req, resp));
+}
+
 grpc::Status ZetaSqlLocalServiceGrpcImpl::PrepareQuery(
     grpc::ServerContext* context, const PrepareQueryRequest* req,
     PrepareQueryResponse* resp) {
@@ -174,6 +180,18 @@ grpc::Status ZetaSqlLocalServiceGrpcImpl::EvaluateQueryStream(
   return grpc::Status();
 }
 
+grpc::Status ZetaSqlLocalServiceGrpcImpl::EvaluateQueryColumnar(
+    grpc::ServerContext* context, const EvaluateQueryColumnarRequest* req,
+    grpc::ServerWriter<EvaluateQueryColumnarResponse>* writer) {
+  return ToGrpcStatus(service_.EvaluateQueryColumnar(
+      *req, [writer](const EvaluateQueryColumnarResponse& resp) {
+        if (!writer->Write(resp)) {
+          return absl::CancelledError("The stream has been closed");
+        }
+        return absl::OkStatus();
+      }));
+}
+
 grpc::Status ZetaSqlLocalServiceGrpcImpl::PrepareModify(
     grpc::ServerContext* context, const PrepareModifyRequest* req,
     PrepareModifyResponse* resp) {
@@ -47,6 +47,10 @@ class ZetaSqlLocalServiceGrpcImpl
       grpc::ServerReaderWriter<EvaluateResponseBatch, EvaluateRequestBatch>*
           stream) override;
 
+  grpc::Status EvaluateColumnar(grpc::ServerContext* context,
+                                const EvaluateColumnarRequest* req,
+                                EvaluateColumnarResponse* resp) override;
+
   grpc::Status PrepareQuery(grpc::ServerContext* context,
                             const PrepareQueryRequest* req,
                             PrepareQueryResponse* resp) override;
@@ -64,6 +68,10 @@ class ZetaSqlLocalServiceGrpcImpl
       grpc::ServerReaderWriter<EvaluateQueryBatchResponse,
                                EvaluateQueryBatchRequest>* stream) override;
 
+  grpc::Status EvaluateQueryColumnar(
+      grpc::ServerContext* context, const EvaluateQueryColumnarRequest* req,
+      grpc::ServerWriter<EvaluateQueryColumnarResponse>* writer) override;
+
   grpc::Status PrepareModify(grpc::ServerContext* context,
                              const PrepareModifyRequest* req,
                              PrepareModifyResponse* resp) override;
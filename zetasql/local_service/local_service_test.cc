@@ -24,6 +24,7 @@
 
 #include "zetasql/base/logging.h"
 #include "zetasql/base/path.h"
+#include "zetasql/base/file_util.h"
 #include "google/protobuf/wrappers.pb.h"
 #include "google/protobuf/compiler/importer.h"
 #include "google/protobuf/descriptor.pb.h"
@@ -33,6 +34,7 @@
 #include "zetasql/common/testing/proto_matchers.h"
 #include "zetasql/base/testing/status_matchers.h"
 #include "zetasql/common/testing/testing_proto_util.h"
+#include "zetasql/local_service/columnar_table.h"
 #include "zetasql/proto/function.pb.h"
 #include "zetasql/proto/simple_catalog.pb.h"
 #include "zetasql/public/formatter_options.pb.h"
@@ -57,10 +59,12 @@ namespace zetasql {
 
 using ::zetasql::testing::EqualsProto;
 using ::testing::Eq;
+using ::testing::HasSubstr;
 using ::testing::IsEmpty;
 using ::testing::Not;
 using ::testing::UnorderedElementsAre;
 using ::zetasql_base::testing::IsOk;
+using ::zetasql_base::testing::IsOkAndHolds;
 using ::zetasql_base::testing::StatusIs;
 namespace local_service {
 
@@ -120,11 +124,26 @@ class ZetaSqlLocalServiceImplTest : public ::testing::Test {
     return service_.Evaluate(request, response);
   }
 
+  absl::Status EvaluateColumnar(const EvaluateColumnarRequest& request,
+                                EvaluateColumnarResponse* response) {
+    return service_.EvaluateColumnar(request, response);
+  }
+
   absl::Status EvaluateQuery(const EvaluateQueryRequest& request,
                              EvaluateQueryResponse* response) {
     return service_.EvaluateQuery(request, response);
   }
 
+  absl::Status EvaluateQueryColumnar(
+      const EvaluateQueryColumnarRequest& request,
+      std::vector<EvaluateQueryColumnarResponse>* responses) {
+    return service_.EvaluateQueryColumnar(
+        request, [responses](const EvaluateQueryColumnarResponse& response) {
+          responses->push_back(response);
+          return absl::OkStatus();
+        });
+  }
+
   absl::Status EvaluateModify(const EvaluateModifyRequest& request,
                               EvaluateModifyResponse* response) {
     return service_.EvaluateModify(request, response);
@@ -282,6 +301,22 @@ void InsertEmptyTestTableContent(
   (*tables_contents)[table_name] = table_content;
 }
 
+// Same rows as InsertTestTableContent(), in columnar form.
+ColumnarTableData MakeColumnarTestTableData() {
+  ColumnarTableData data;
+  data.set_num_rows(2);
+  ColumnarTableData::Column* column_str = data.add_column();
+  column_str->add_bytes_value("string_1");
+  column_str->add_bytes_value("string_2");
+  ColumnarTableData::Column* column_bool = data.add_column();
+  column_bool->add_bool_value(true);
+  column_bool->add_bool_value(true);
+  ColumnarTableData::Column* column_int = data.add_column();
+  column_int->add_int64_value(123);
+  column_int->add_int64_value(321);
+  return data;
+}
+
 TEST_F(ZetaSqlLocalServiceImplTest, PrepareCleansUpPoolsAndCatalogsOnError) {
   PrepareRequest request;
   PrepareResponse response;
@@ -2949,6 +2984,26 @@ TEST_F(ZetaSqlLocalServiceImplTest, EvaluateQueryWithSql) {
   ExpectValueIsString(row_0.cell(0), "apple");
 }
 
+TEST_F(ZetaSqlLocalServiceImplTest, EvaluateQueryWithOperatorProfile) {
+  EvaluateQueryRequest evaluate_request;
+  evaluate_request.set_sql(
+      "SELECT x FROM UNNEST([3, 1, 2]) AS x WHERE x > 1 ORDER BY x");
+
+  EvaluateQueryResponse evaluate_response;
+  ZETASQL_EXPECT_OK(EvaluateQuery(evaluate_request, &evaluate_response));
+  EXPECT_EQ(evaluate_response.content().table_data().row_size(), 2);
+  EXPECT_FALSE(evaluate_response.has_operator_profile());
+
+  evaluate_request.set_collect_operator_profile(true);
+  evaluate_response.Clear();
+  ZETASQL_EXPECT_OK(EvaluateQuery(evaluate_request, &evaluate_response));
+  EXPECT_EQ(evaluate_response.content().table_data().row_size(), 2);
+  EXPECT_THAT(evaluate_response.operator_profile(),
+              HasSubstr("SortOp: iterators=1 rows=2"));
+  EXPECT_THAT(evaluate_response.operator_profile(),
+              HasSubstr("ArrayScanOp: iterators=1 rows=3"));
+}
+
 TEST_F(ZetaSqlLocalServiceImplTest, EvaluateQueryWithSqlWithParam) {
   // Evaluate Query
   EvaluateQueryRequest evaluate_request;
@@ -2982,6 +3037,111 @@ TEST_F(ZetaSqlLocalServiceImplTest, EvaluateQueryWithSqlWithParam) {
   ExpectValueIsString(row_0.cell(0), "cherry");
 }
 
+TEST_F(ZetaSqlLocalServiceImplTest, EvaluateQueryColumnar) {
+  EvaluateQueryColumnarRequest request;
+  request.mutable_query()->set_sql(R"(
+      SELECT x, IF(MOD(x, 3) = 0, NULL, 'v') AS s
+      FROM UNNEST(GENERATE_ARRAY(1, 10)) AS x
+      ORDER BY x)");
+  request.set_max_rows_per_batch(4);
+
+  std::vector<EvaluateQueryColumnarResponse> responses;
+  ZETASQL_ASSERT_OK(EvaluateQueryColumnar(request, &responses));
+  ASSERT_EQ(responses.size(), 3);
+
+  // Only the first response has the schema.
+  EXPECT_EQ(responses[0].prepared().columns_size(), 2);
+  EXPECT_EQ(responses[0].prepared().columns(1).name(), "s");
+  ExpectTypeIsString(responses[0].prepared().columns(1).type());
+  EXPECT_FALSE(responses[1].has_prepared());
+  EXPECT_FALSE(responses[2].has_prepared());
+
+  EXPECT_EQ(responses[0].batch().num_rows(), 4);
+  EXPECT_EQ(responses[1].batch().num_rows(), 4);
+  EXPECT_EQ(responses[2].batch().num_rows(), 2);
+
+  const ColumnarTableData& batch = responses[1].batch();
+  ASSERT_EQ(batch.column_size(), 2);
+  EXPECT_THAT(batch.column(0).int64_value(),
+              ::testing::ElementsAre(5, 6, 7, 8));
+  EXPECT_TRUE(batch.column(0).validity().empty());
+  // x = 6 is NULL, and the single distinct value is dictionary encoded.
+  EXPECT_EQ(batch.column(1).validity(), "\x0d");
+  EXPECT_THAT(batch.column(1).dictionary(), ::testing::ElementsAre("v"));
+  EXPECT_THAT(GetColumnarValue(batch.column(1), types::StringType(), 1),
+              IsOkAndHolds(Value::NullString()));
+  EXPECT_THAT(GetColumnarValue(batch.column(1), types::StringType(), 2),
+              IsOkAndHolds(Value::String("v")));
+}
+
+TEST_F(ZetaSqlLocalServiceImplTest, EvaluateQueryColumnarNoRows) {
+  EvaluateQueryColumnarRequest request;
+  request.mutable_query()->set_sql(R"(SELECT 'apple' AS fruit LIMIT 0)");
+
+  std::vector<EvaluateQueryColumnarResponse> responses;
+  ZETASQL_ASSERT_OK(EvaluateQueryColumnar(request, &responses));
+  ASSERT_EQ(responses.size(), 1);
+  EXPECT_EQ(responses[0].prepared().columns_size(), 1);
+  EXPECT_EQ(responses[0].batch().num_rows(), 0);
+  EXPECT_EQ(responses[0].batch().column_size(), 1);
+}
+
+TEST_F(ZetaSqlLocalServiceImplTest, EvaluateColumnar) {
+  PrepareRequest prepare_request;
+  prepare_request.set_sql("IF(@n > 0, CONCAT(name, REPEAT('!', @n)), name)");
+  auto* column = prepare_request.mutable_options()->add_expression_columns();
+  column->set_name("name");
+  column->mutable_type()->set_type_kind(TYPE_STRING);
+  auto* param = prepare_request.mutable_options()->add_query_parameters();
+  param->set_name("n");
+  param->mutable_type()->set_type_kind(TYPE_INT64);
+  PrepareResponse prepare_response;
+  ZETASQL_ASSERT_OK(Prepare(prepare_request, &prepare_response));
+
+  EvaluateColumnarRequest request;
+  request.set_prepared_expression_id(
+      prepare_response.prepared().prepared_expression_id());
+  request.add_param_names("N");
+  request.add_column_names("name");
+  ColumnarTableBuilder builder({types::StringType(), types::Int64Type()});
+  ZETASQL_ASSERT_OK(builder.AddRow({Value::String("a"), Value::Int64(2)}));
+  ZETASQL_ASSERT_OK(builder.AddRow({Value::String("b"), Value::Int64(0)}));
+  ZETASQL_ASSERT_OK(builder.AddRow({Value::NullString(), Value::Int64(1)}));
+  ZETASQL_ASSERT_OK(builder.Finish(request.mutable_rows()));
+
+  EvaluateColumnarResponse response;
+  ZETASQL_ASSERT_OK(EvaluateColumnar(request, &response));
+  EXPECT_EQ(response.result().num_rows(), 3);
+  ASSERT_EQ(response.result().column_size(), 1);
+  const ColumnarTableData::Column& result = response.result().column(0);
+  EXPECT_THAT(GetColumnarValue(result, types::StringType(), 0),
+              IsOkAndHolds(Value::String("a!!")));
+  EXPECT_THAT(GetColumnarValue(result, types::StringType(), 1),
+              IsOkAndHolds(Value::String("b")));
+  EXPECT_THAT(GetColumnarValue(result, types::StringType(), 2),
+              IsOkAndHolds(Value::NullString()));
+
+  // Every referenced column and parameter needs a value.
+  request.clear_param_names();
+  ColumnarTableBuilder names_builder({types::StringType()});
+  ZETASQL_ASSERT_OK(names_builder.AddRow({Value::String("a")}));
+  ZETASQL_ASSERT_OK(names_builder.Finish(request.mutable_rows()));
+  EXPECT_THAT(EvaluateColumnar(request, &response),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("No value for parameter 'n'")));
+
+  ZETASQL_EXPECT_OK(Unprepare(prepare_response.prepared().prepared_expression_id()));
+}
+
+TEST_F(ZetaSqlLocalServiceImplTest, EvaluateColumnarWithWrongId) {
+  EvaluateColumnarRequest request;
+  request.set_prepared_expression_id(12345);
+  EvaluateColumnarResponse response;
+  EXPECT_THAT(EvaluateColumnar(request, &response),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("Prepared expression 12345 unknown")));
+}
+
 TEST_F(ZetaSqlLocalServiceImplTest,
        EvaluateQueryWithDescriptorPoolListProto) {
   // Evaluate Query
@@ -3166,6 +3326,56 @@ TEST_F(ZetaSqlLocalServiceImplTest, EvaluateQueryWithFullCatalogTableData) {
   ExpectValueIsInt32(row_0.cell(0), 123);
 }
 
+TEST_F(ZetaSqlLocalServiceImplTest,
+       EvaluateQueryWithFullCatalogColumnarTableData) {
+  EvaluateQueryRequest evaluate_request;
+  evaluate_request.set_sql(
+      R"(SELECT column_int FROM TestTable WHERE column_str = 'string_2')");
+  evaluate_request.mutable_simple_catalog()->mutable_builtin_function_options();
+  AddTestTable(evaluate_request.mutable_simple_catalog()->add_table(),
+               "TestTable");
+  *(*evaluate_request.mutable_table_content())["TestTable"]
+       .mutable_columnar_table_data() = MakeColumnarTestTableData();
+
+  EvaluateQueryResponse evaluate_response;
+  ZETASQL_EXPECT_OK(EvaluateQuery(evaluate_request, &evaluate_response));
+
+  EXPECT_EQ(evaluate_response.content().table_data().row_size(), 1);
+  const TableData::Row row_0 = evaluate_response.content().table_data().row(0);
+  EXPECT_EQ(row_0.cell_size(), 1);
+  ExpectValueIsInt32(row_0.cell(0), 321);
+}
+
+TEST_F(ZetaSqlLocalServiceImplTest,
+       EvaluateQueryWithFullCatalogColumnarTableDataFile) {
+  const std::string path =
+      zetasql_base::JoinPath(::testing::TempDir(), "columnar_test_table");
+  ZETASQL_ASSERT_OK(internal::SetContents(
+      path, MakeColumnarTestTableData().SerializeAsString()));
+
+  EvaluateQueryRequest evaluate_request;
+  evaluate_request.set_sql(R"(SELECT SUM(column_int) FROM TestTable)");
+  evaluate_request.mutable_simple_catalog()->mutable_builtin_function_options();
+  AddTestTable(evaluate_request.mutable_simple_catalog()->add_table(),
+               "TestTable");
+  (*evaluate_request.mutable_table_content())["TestTable"]
+      .set_columnar_table_data_file(path);
+
+  EvaluateQueryResponse evaluate_response;
+  ZETASQL_EXPECT_OK(EvaluateQuery(evaluate_request, &evaluate_response));
+  EXPECT_EQ(evaluate_response.content().table_data().row_size(), 1);
+  EXPECT_EQ(
+      evaluate_response.content().table_data().row(0).cell(0).int64_value(),
+      444);
+
+  // Only one kind of content can be set.
+  InsertTestTableContent(evaluate_request.mutable_table_content(), "TestTable");
+  (*evaluate_request.mutable_table_content())["TestTable"]
+      .set_columnar_table_data_file(path);
+  EXPECT_THAT(EvaluateQuery(evaluate_request, &evaluate_response),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
 TEST_F(ZetaSqlLocalServiceImplTest,
        EvaluateQueryWithDescriptorPoolListProtoWithFullCatalogTableData) {
   // Evaluate Query
@@ -796,7 +796,11 @@ class Table {
   // all tables in their Catalog have unique IDs.
   virtual int64_t GetSerializationId() const { return 0; }
 
-  // Returns an iterator over this table.
+  // Returns an iterator over the columns of this table with indexes
+  // 'column_idxs', in that order. With
+  // EvaluatorOptions::prune_unused_table_columns, the evaluator only asks for
+  // the columns that a query references, so this may be a subset of the
+  // columns.
   //
   // Not used for zetasql analysis.
   // Used only for evaluating queries on this table with the reference
@@ -36,6 +36,7 @@
 #include "zetasql/public/type.h"
 #include "zetasql/public/value.h"
 #include "zetasql/reference_impl/algebrizer.h"
+#include "zetasql/reference_impl/compiled_expr.h"
 #include "zetasql/reference_impl/evaluation.h"
 #include "zetasql/reference_impl/operator.h"
 #include "zetasql/reference_impl/parameters.h"
@@ -68,6 +69,7 @@ namespace {
 
 using ExpressionOptions =
     ::zetasql::PreparedExpressionBase::ExpressionOptions;
+using BatchOptions = ::zetasql::PreparedExpressionBase::BatchOptions;
 using QueryOptions = ::zetasql::PreparedQueryBase::QueryOptions;
 
 // Represents either a map of named parameters or a list of positional
@@ -284,9 +286,17 @@ class Evaluator {
         options, expression_output_value, query_output_iterator);
   }
 
+  // Evaluates the prepared expression once for each row of 'options'.
+  absl::StatusOr<std::vector<Value>> ExecuteAfterPrepareBatch(
+      const BatchOptions& options) const ABSL_LOCKS_EXCLUDED(mutex_);
+
   absl::StatusOr<std::string> ExplainAfterPrepare() const
       ABSL_LOCKS_EXCLUDED(mutex_);
 
+  // Implements PreparedQueryBase::ExplainAnalyze().
+  absl::StatusOr<std::string> ExplainAnalyze(
+      const EvaluatorTableIterator& iter) const ABSL_LOCKS_EXCLUDED(mutex_);
+
   // Returns NULL if this object is for a query instead of an expression.
   const Type* expression_output_type() const ABSL_LOCKS_EXCLUDED(mutex_);
 
@@ -381,6 +391,13 @@ class Evaluator {
       std::unique_ptr<EvaluatorTableIterator>* query_output_iterator) const
       ABSL_SHARED_LOCKS_REQUIRED(mutex_);
 
+  // Evaluates the prepared expression with 'params_data' holding the values of
+  // the columns, parameters and system variables.
+  absl::Status EvalExpressionLocked(const TupleData& params_data,
+                                    EvaluationContext* context,
+                                    Value* result) const
+      ABSL_SHARED_LOCKS_REQUIRED(mutex_);
+
   // Checks if 'parameters_map' specifies valid values for all variables from
   // resolved variable map 'variable_map', and populates 'values' with the
   // corresponding Values in the order they appear when iterating over
@@ -424,6 +441,8 @@ class Evaluator {
     evaluation_options.max_intermediate_byte_size =
         evaluator_options_.max_intermediate_byte_size;
     evaluation_options.return_all_rows_for_dml = false;
+    evaluation_options.collect_operator_profile =
+        evaluator_options_.collect_operator_profile;
 
     auto context = std::make_unique<EvaluationContext>(evaluation_options);
 
@@ -490,6 +509,10 @@ class Evaluator {
       ABSL_PT_GUARDED_BY(mutex_);
   std::unique_ptr<RelationalOp> compiled_relational_op_ ABSL_GUARDED_BY(mutex_)
       ABSL_PT_GUARDED_BY(mutex_);
+  // For expressions, `compiled_value_expr_` flattened into a register program.
+  // Used instead of `compiled_value_expr_` to execute the expression.
+  std::unique_ptr<CompiledValueExpr> compiled_program_ ABSL_GUARDED_BY(mutex_)
+      ABSL_PT_GUARDED_BY(mutex_);
 
   // Output columns corresponding to `compiled_relational_op_` Only valid if
   // the statement is ResolvedQueryStmt.
@@ -532,9 +555,10 @@ absl::Status Evaluator::PrepareLocked(const AnalyzerOptions& options,
   }
   is_prepared_ = true;
   analyzer_options_ = options;
-  // TODO: Enable pruning by default. We will need to
-  // fix some Table::CreateEvaluatorTableIterator() implementations to
-  // respect the input column indexes.
+  // TODO: Enable pruning by default, both here and through
+  // EvaluatorOptions::prune_unused_table_columns. We will need to fix some
+  // Table::CreateEvaluatorTableIterator() implementations to respect the
+  // input column indexes.
   // analyzer_options_.set_prune_unused_columns(true);
 
   if (catalog == nullptr && (statement_ == nullptr && expr_ == nullptr)) {
@@ -549,9 +573,14 @@ absl::Status Evaluator::PrepareLocked(const AnalyzerOptions& options,
   AlgebrizerOptions algebrizer_options;
   algebrizer_options.consolidate_proto_field_accesses = true;
   algebrizer_options.allow_hash_join = true;
+  algebrizer_options.allow_range_join = true;
   algebrizer_options.allow_order_by_limit_operator = true;
   algebrizer_options.push_down_filters = true;
+  algebrizer_options.prune_unused_table_columns =
+      evaluator_options_.prune_unused_table_columns;
   algebrizer_options.inline_with_entries = true;
+  algebrizer_options.fold_constants = true;
+  algebrizer_options.eliminate_common_subexpressions = true;
 
   if (!is_expr_) {
     if (statement_ == nullptr) {
@@ -657,6 +686,10 @@ absl::Status Evaluator::PrepareLocked(const AnalyzerOptions& options,
   } else {
     ZETASQL_RETURN_IF_ERROR(
         compiled_value_expr_->SetSchemasForEvaluation({&params_schema}));
+    if (is_expr_) {
+      ZETASQL_ASSIGN_OR_RETURN(compiled_program_,
+                       CompiledValueExpr::Create(compiled_value_expr_.get()));
+    }
   }
 
   return absl::OkStatus();
@@ -949,6 +982,19 @@ class TupleIteratorAdaptor : public EvaluatorTableIterator {
     context_->SetStatementEvaluationDeadline(deadline);
   }
 
+  // Returns the statistics collected for the operators under <root> so far.
+  absl::StatusOr<std::string> ProfileDebugString(
+      const RelationalOp& root) const {
+    absl::MutexLock l(&mutex_);
+    const OperatorProfile* profile = context_->operator_profile();
+    if (profile == nullptr) {
+      return zetasql_base::InvalidArgumentErrorBuilder()
+             << "ExplainAnalyze() requires an iterator returned by a query "
+                "created with EvaluatorOptions::collect_operator_profile";
+    }
+    return OperatorProfileDebugString(root, *profile);
+  }
+
  private:
   const std::vector<NameAndType> columns_;
   const std::vector<int> tuple_indexes_;
@@ -1019,20 +1065,119 @@ absl::Status Evaluator::ExecuteAfterPrepareWithOrderedParamsLocked(
         output_columns_, tuple_indexes, deletion_cb, std::move(context),
         std::move(tuple_iter));
   } else {
-    ZETASQL_RET_CHECK(compiled_value_expr_ != nullptr);
+    ZETASQL_RETURN_IF_ERROR(EvalExpressionLocked(params_data, context.get(),
+                                         expression_output_value));
+  }
+
+  return absl::OkStatus();
+}
+
+absl::Status Evaluator::EvalExpressionLocked(const TupleData& params_data,
+                                             EvaluationContext* context,
+                                             Value* result) const {
+  ZETASQL_RET_CHECK(compiled_value_expr_ != nullptr);
 
-    TupleSlot result;
-    absl::Status status;
-    if (!compiled_value_expr_->EvalSimple({&params_data}, context.get(),
-                                          &result, &status)) {
+  absl::Status status;
+  if (compiled_program_ != nullptr) {
+    if (!compiled_program_->Eval({&params_data}, context, result, &status)) {
       return status;
     }
-    *expression_output_value = result.value();
+    return absl::OkStatus();
   }
-
+  TupleSlot slot;
+  if (!compiled_value_expr_->EvalSimple({&params_data}, context, &slot,
+                                        &status)) {
+    return status;
+  }
+  *result = slot.value();
   return absl::OkStatus();
 }
 
+absl::StatusOr<std::vector<Value>> Evaluator::ExecuteAfterPrepareBatch(
+    const BatchOptions& options) const {
+  absl::ReaderMutexLock l(&mutex_);
+  if (!has_prepare_succeeded()) {
+    return ::zetasql_base::InvalidArgumentErrorBuilder()
+           << "Invalid prepared expression/query";
+  }
+  ZETASQL_RET_CHECK(is_expr_);
+
+  const int64_t num_rows = options.num_rows;
+  if (num_rows < 0) {
+    return ::zetasql_base::InvalidArgumentErrorBuilder()
+           << "Invalid number of rows: " << num_rows;
+  }
+  for (const std::vector<ParameterValueList>* batch_columns :
+       {&options.ordered_columns, &options.ordered_parameters}) {
+    for (const ParameterValueList& values : *batch_columns) {
+      if (static_cast<int64_t>(values.size()) != num_rows) {
+        return ::zetasql_base::InvalidArgumentErrorBuilder()
+               << "Expected " << num_rows << " values for each column and "
+               << "parameter but found " << values.size();
+      }
+    }
+  }
+  ZETASQL_RETURN_IF_ERROR(ValidateSystemVariables(options.system_variables));
+
+  std::unique_ptr<EvaluationContext> context = CreateEvaluationContext();
+  context->SetStatementEvaluationDeadline(options.deadline);
+  if (options.session_user.has_value()) {
+    context->SetSessionUser(options.session_user.value());
+  }
+
+  // Only the column and parameter slots of 'params_data' change from row to
+  // row.
+  const int num_columns = static_cast<int>(options.ordered_columns.size());
+  const int num_parameters =
+      static_cast<int>(options.ordered_parameters.size());
+  ParameterValueList params(num_columns + num_parameters);
+  for (const auto& algebrizer_sysvar : algebrizer_system_variables_) {
+    params.push_back(options.system_variables.at(algebrizer_sysvar.first));
+  }
+  TupleData params_data = CreateTupleDataFromValues(std::move(params));
+
+  // Rows are fully validated only when their types differ from those of the
+  // first row, which usually happens only for the first row itself.
+  std::vector<const Type*> row_types(num_columns + num_parameters);
+  auto validate_row = [&](int64_t row) -> absl::Status {
+    ParameterValueList row_columns, row_parameters;
+    row_columns.reserve(num_columns);
+    for (const ParameterValueList& values : options.ordered_columns) {
+      row_columns.push_back(values[row]);
+    }
+    row_parameters.reserve(num_parameters);
+    for (const ParameterValueList& values : options.ordered_parameters) {
+      row_parameters.push_back(values[row]);
+    }
+    ZETASQL_RETURN_IF_ERROR(ValidateColumns(row_columns));
+    return ValidateParameters(row_parameters);
+  };
+
+  std::vector<Value> results;
+  results.reserve(num_rows);
+  for (int64_t row = 0; row < num_rows; ++row) {
+    bool types_match = row > 0;
+    for (int i = 0; i < num_columns + num_parameters; ++i) {
+      const Value& value =
+          i < num_columns ? options.ordered_columns[i][row]
+                          : options.ordered_parameters[i - num_columns][row];
+      if (row == 0) {
+        row_types[i] = value.type();
+      } else if (types_match && value.type() != row_types[i] &&
+                 !value.type()->Equals(row_types[i])) {
+        types_match = false;
+      }
+      params_data.mutable_slot(i)->SetValue(value);
+    }
+    if (!types_match) {
+      ZETASQL_RETURN_IF_ERROR(validate_row(row));
+    }
+    ZETASQL_RETURN_IF_ERROR(EvalExpressionLocked(params_data, context.get(),
+                                         &results.emplace_back()));
+  }
+  return results;
+}
+
 absl::StatusOr<std::string> Evaluator::ExplainAfterPrepare() const {
   absl::ReaderMutexLock l(&mutex_);
   ZETASQL_RET_CHECK(is_prepared()) << "Prepare must be called first";
@@ -1044,6 +1189,24 @@ absl::StatusOr<std::string> Evaluator::ExplainAfterPrepare() const {
   }
 }
 
+absl::StatusOr<std::string> Evaluator::ExplainAnalyze(
+    const EvaluatorTableIterator& iter) const {
+  absl::ReaderMutexLock l(&mutex_);
+  ZETASQL_RET_CHECK(is_prepared()) << "Prepare must be called first";
+  ZETASQL_RET_CHECK(compiled_relational_op_ != nullptr);
+  const TupleIteratorAdaptor* adaptor =
+      dynamic_cast<const TupleIteratorAdaptor*>(&iter);
+  if (adaptor == nullptr) {
+    return zetasql_base::InvalidArgumentErrorBuilder()
+           << "ExplainAnalyze() requires an iterator returned by "
+              "ExecuteAfterPrepare()";
+  }
+  ZETASQL_ASSIGN_OR_RETURN(std::string profile,
+                   adaptor->ProfileDebugString(*compiled_relational_op_));
+  return absl::StrCat(compiled_relational_op_->DebugString(),
+                      "\n\nProfile:\n", profile);
+}
+
 const Type* Evaluator::expression_output_type() const {
   absl::ReaderMutexLock l(&mutex_);
   ABSL_CHECK(is_expr_) << "Only expressions have output types";
@@ -1386,6 +1549,12 @@ PreparedExpressionBase::ExecuteAfterPrepareWithOrderedParams(
   return ExecuteAfterPrepare(std::move(options));
 }
 
+absl::StatusOr<std::vector<Value>>
+PreparedExpressionBase::ExecuteAfterPrepareBatch(
+    const BatchOptions& options) const {
+  return evaluator_->ExecuteAfterPrepareBatch(options);
+}
+
 absl::StatusOr<std::string> PreparedExpressionBase::ExplainAfterPrepare()
     const {
   return evaluator_->ExplainAfterPrepare();
@@ -1495,6 +1664,11 @@ absl::StatusOr<std::string> PreparedQueryBase::ExplainAfterPrepare() const {
   return evaluator_->ExplainAfterPrepare();
 }
 
+absl::StatusOr<std::string> PreparedQueryBase::ExplainAnalyze(
+    const EvaluatorTableIterator& iter) const {
+  return evaluator_->ExplainAnalyze(iter);
+}
+
 int PreparedQueryBase::num_columns() const {
   return evaluator_->query_output_columns().size();
 }
@@ -249,6 +249,20 @@ struct EvaluatorOptions {
   // accounting charges each of them individually. In some cases, it is
   // necessary to set this option to a very large value.
   int64_t max_intermediate_byte_size = 128 * 1024 * 1024;
+
+  // If true, table scans only ask Table::CreateEvaluatorTableIterator() for
+  // the columns that the query references, rather than for every column in
+  // the ResolvedTableScan. Only set this if all the tables in the catalog
+  // honor the 'column_idxs' passed to CreateEvaluatorTableIterator(); a table
+  // that ignores them returns its values in the wrong positions.
+  bool prune_unused_table_columns = false;
+
+  // If true, every execution of a query records the number of rows produced
+  // by each operator of the query plan, the time spent in it, its memory usage
+  // and the sizes of the hash tables it builds. See
+  // PreparedQueryBase::ExplainAnalyze(). This slows down evaluation, so should
+  // only be enabled for diagnosis.
+  bool collect_operator_profile = false;
 };
 
 class PreparedExpressionBase {
@@ -442,6 +456,34 @@ class PreparedExpressionBase {
       ParameterValueList columns, ParameterValueList parameters,
       SystemVariableValuesMap system_variables = {}) const;
 
+  // Options struct for ExecuteAfterPrepareBatch(). Columns and parameters are
+  // passed column by column: each element of <ordered_columns> and
+  // <ordered_parameters> holds the values of one column or parameter for all
+  // <num_rows> rows. They are in the same order as the ordered_columns and
+  // ordered_parameters of ExpressionOptions.
+  struct BatchOptions {
+    BatchOptions() {}
+    int64_t num_rows = 0;
+    std::vector<ParameterValueList> ordered_columns;
+    std::vector<ParameterValueList> ordered_parameters;
+
+    // Shared by all the rows.
+    SystemVariableValuesMap system_variables;
+    absl::Time deadline = absl::InfiniteFuture();
+    std::optional<std::string> session_user;
+  };
+
+  // Evaluates the expression once for each row of <options>, and returns the
+  // results in row order. This is more efficient than calling
+  // ExecuteAfterPrepareWithOrderedParams() once per row, since the
+  // evaluation state is set up once for the whole batch. All rows see the
+  // same current date and time. Fails with the first error from any row.
+  //
+  // Thread safe. Multiple evaluations can proceed in parallel.
+  // REQUIRES: Prepare() has been called successfully.
+  absl::StatusOr<std::vector<Value>> ExecuteAfterPrepareBatch(
+      const BatchOptions& options) const;
+
   // Returns a human-readable representation of how this expression would
   // actually be executed. Do not try to interpret this string with code, as the
   // format can change at any time. Requires that Prepare has already been
@@ -578,6 +620,15 @@ class PreparedQueryBase {
   // called.
   absl::StatusOr<std::string> ExplainAfterPrepare() const;
 
+  // Returns ExplainAfterPrepare(), followed by the runtime statistics of each
+  // operator collected while evaluating <iter> so far. <iter> must have been
+  // returned by ExecuteAfterPrepare() on this query, which must have been
+  // created with EvaluatorOptions::collect_operator_profile. Typically called
+  // after consuming all the rows of <iter>. As with ExplainAfterPrepare(), the
+  // format can change at any time.
+  absl::StatusOr<std::string> ExplainAnalyze(
+      const EvaluatorTableIterator& iter) const;
+
   // Get the schema of the output table of this query. Anonymous column names
   // are empty. (There may be more than one column with the same name.)
   //
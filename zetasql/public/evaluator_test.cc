@@ -17,6 +17,7 @@
 #include "zetasql/public/evaluator.h"
 
 #include <cstdint>
+#include <limits>
 #include <memory>
 #include <string>
 #include <utility>
@@ -85,6 +86,7 @@ using ::testing::Eq;
 using ::testing::HasSubstr;
 using ::testing::IsEmpty;
 using ::testing::UnorderedElementsAre;
+using ::testing::UnorderedElementsAreArray;
 using ::zetasql_base::testing::IsOkAndHolds;
 using ::zetasql_base::testing::StatusIs;
 using ExpressionOptions = ::zetasql::PreparedExpression::ExpressionOptions;
@@ -155,6 +157,41 @@ TEST(EvaluatorTest, BooleanExpression) {
   EXPECT_TRUE(types::BoolType()->Equals(expr.output_type()));
 }
 
+TEST(EvaluatorTest, VariantExpression) {
+  PreparedExpression expr(
+      "TO_JSON(OBJECT_INSERT(OBJECT_CONSTRUCT('a', GET_PATH(PARSE_JSON(j), "
+      "'x[1].y'), 'b', NULL), 'c', ARRAY_SIZE(GET(PARSE_JSON(j), 'x'))))");
+  EXPECT_EQ(String(R"({"a":"v","c":2})"),
+            expr.Execute({{"j", String(R"({"x": [0, {"y": "v"}]})")}}).value());
+  // Missing paths are NULL rather than errors.
+  EXPECT_EQ(String("{}"),
+            expr.Execute({{"j", String(R"({"x": 1})")}}).value());
+  EXPECT_THAT(expr.Execute({{"j", String("{")}}),
+              StatusIs(absl::StatusCode::kOutOfRange,
+                       HasSubstr("Error parsing JSON")));
+}
+
+TEST(EvaluatorTest, VariantGetIgnoreCase) {
+  PreparedExpression expr("TO_JSON(GET_IGNORE_CASE(PARSE_JSON(j), k))");
+  const std::string json = R"({"Ab": 1, "aB": 2, "cd": 3})";
+  // An exact match wins over members that only match ignoring case.
+  EXPECT_EQ(String("2"),
+            expr.Execute({{"j", String(json)}, {"k", String("aB")}}).value());
+  EXPECT_EQ(String("1"),
+            expr.Execute({{"j", String(json)}, {"k", String("AB")}}).value());
+  EXPECT_EQ(String("3"),
+            expr.Execute({{"j", String(json)}, {"k", String("CD")}}).value());
+  EXPECT_TRUE(expr.Execute({{"j", String(json)}, {"k", String("x")}})
+                  .value()
+                  .is_null());
+
+  // GET itself stays case sensitive.
+  PreparedExpression get_expr("GET(PARSE_JSON(j), k)");
+  EXPECT_TRUE(get_expr.Execute({{"j", String(json)}, {"k", String("CD")}})
+                  .value()
+                  .is_null());
+}
+
 TEST(EvaluatorTest, ExpressionWithSubquery) {
   PreparedExpression expr("1 + (SELECT a)");
   EXPECT_EQ(Int64(3), expr.Execute({{"a", Int64(2)}}).value());
@@ -1138,6 +1175,51 @@ TEST(EvaluatorTest,
               IsOkAndHolds(Value::Int64(15)));
 }
 
+TEST(EvaluatorTest, ExecuteAfterPrepareBatch) {
+  PreparedExpression expr("IF(col > @param, col - @param, NULL)");
+
+  AnalyzerOptions options;
+  ZETASQL_ASSERT_OK(options.AddQueryParameter("param", types::Int64Type()));
+  ZETASQL_ASSERT_OK(options.AddExpressionColumn("col", types::Int64Type()));
+  ZETASQL_ASSERT_OK(expr.Prepare(options));
+
+  PreparedExpression::BatchOptions batch;
+  batch.num_rows = 4;
+  batch.ordered_columns = {{Value::Int64(5), Value::Int64(1),
+                            Value::NullInt64(), Value::Int64(9)}};
+  batch.ordered_parameters = {
+      {Value::Int64(2), Value::Int64(2), Value::Int64(2), Value::Int64(0)}};
+  EXPECT_THAT(expr.ExecuteAfterPrepareBatch(batch),
+              IsOkAndHolds(ElementsAre(Value::Int64(3), Value::NullInt64(),
+                                       Value::NullInt64(), Value::Int64(9))));
+
+  batch.num_rows = 0;
+  batch.ordered_columns = {{}};
+  batch.ordered_parameters = {{}};
+  EXPECT_THAT(expr.ExecuteAfterPrepareBatch(batch), IsOkAndHolds(IsEmpty()));
+
+  // Every column must have a value for every row.
+  batch.num_rows = 2;
+  batch.ordered_columns = {{Value::Int64(5), Value::Int64(1)}};
+  batch.ordered_parameters = {{Value::Int64(2)}};
+  EXPECT_THAT(expr.ExecuteAfterPrepareBatch(batch),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("Expected 2 values")));
+
+  // Rows are type checked like ExecuteAfterPrepareWithOrderedParams().
+  batch.ordered_parameters = {{Value::Int64(2), Value::String("a")}};
+  EXPECT_THAT(expr.ExecuteAfterPrepareBatch(batch),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("Expected query parameter 'param'")));
+
+  // Errors from any row fail the batch.
+  batch.ordered_columns = {
+      {Value::Int64(5), Value::Int64(std::numeric_limits<int64_t>::max())}};
+  batch.ordered_parameters = {{Value::Int64(2), Value::Int64(-1)}};
+  EXPECT_THAT(expr.ExecuteAfterPrepareBatch(batch),
+              StatusIs(absl::StatusCode::kOutOfRange));
+}
+
 TEST(EvaluatorTest, ExplainAfterPrepareWithoutPrepare) {
   PreparedExpression expr("@param + col");
   EXPECT_THAT(expr.ExplainAfterPrepare(),
@@ -3975,6 +4057,242 @@ TEST(PreparedQuery, ExecuteAfterPrepareBuiltinFunction) {
   ASSERT_EQ(sql_builder.sql(), "SELECT 1 + 2 AS x");
 }
 
+TEST(PreparedQuery, SharedSubexpressionsDoNotChangeResults) {
+  // 'x * 10' is shared by the filter and the projection. 'div(100, x - 1)'
+  // occurs twice, but only in the branch that is not taken when x is 1, so it
+  // must not be computed for that row.
+  PreparedQuery query(
+      "select x * 10 as a, x * 10 + 1 as b, "
+      "if(x = 1, 0, div(100, x - 1)) + if(x = 1, 0, div(100, x - 1)) as c "
+      "from unnest([1, 2, 3]) as x where x * 10 > 5 order by x",
+      EvaluatorOptions());
+  ZETASQL_ASSERT_OK(query.Prepare(AnalyzerOptions()));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::string explain, query.ExplainAfterPrepare());
+  EXPECT_THAT(explain, HasSubstr("$cse"));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<EvaluatorTableIterator> iter,
+                       query.Execute());
+  std::vector<std::vector<Value>> rows;
+  while (iter->NextRow()) {
+    rows.push_back(
+        {iter->GetValue(0), iter->GetValue(1), iter->GetValue(2)});
+  }
+  ZETASQL_EXPECT_OK(iter->Status());
+  EXPECT_THAT(rows, ElementsAre(ElementsAre(Int64(10), Int64(11), Int64(0)),
+                                ElementsAre(Int64(20), Int64(21), Int64(200)),
+                                ElementsAre(Int64(30), Int64(31), Int64(100))));
+}
+
+TEST(PreparedQuery, SharedSubexpressionFollowedByDifferentExpression) {
+  // 'x * 10' is shared by the filter and the projection, and is compared with
+  // 'x * 20', which has the same kind and type but does not match.
+  PreparedQuery query(
+      "select x * 10 as a, x * 20 as b from unnest([1, 2]) as x "
+      "where x * 10 > 5 order by x",
+      EvaluatorOptions());
+  ZETASQL_ASSERT_OK(query.Prepare(AnalyzerOptions()));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::string explain, query.ExplainAfterPrepare());
+  EXPECT_THAT(explain, HasSubstr("$cse"));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<EvaluatorTableIterator> iter,
+                       query.Execute());
+  std::vector<std::vector<Value>> rows;
+  while (iter->NextRow()) {
+    rows.push_back({iter->GetValue(0), iter->GetValue(1)});
+  }
+  ZETASQL_EXPECT_OK(iter->Status());
+  EXPECT_THAT(rows, ElementsAre(ElementsAre(Int64(10), Int64(20)),
+                                ElementsAre(Int64(20), Int64(40))));
+}
+
+TEST(PreparedQuery, FoldedConstantErrorsAreRaisedAtRuntime) {
+  PreparedQuery query("select if(x > 5, div(1, 0), x) from unnest([1, 2]) as x",
+                      EvaluatorOptions());
+  ZETASQL_ASSERT_OK(query.Prepare(AnalyzerOptions()));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<EvaluatorTableIterator> iter,
+                       query.Execute());
+  ASSERT_TRUE(iter->NextRow());
+  EXPECT_EQ(iter->GetValue(0), Int64(1));
+  ASSERT_TRUE(iter->NextRow());
+  EXPECT_EQ(iter->GetValue(0), Int64(2));
+  EXPECT_FALSE(iter->NextRow());
+  ZETASQL_EXPECT_OK(iter->Status());
+}
+
+TEST(PreparedQuery, ScansOnlyReferencedColumns) {
+  std::vector<SimpleTable::NameAndType> columns;
+  std::vector<Value> row;
+  for (int i = 0; i < 8; ++i) {
+    columns.push_back({absl::StrCat("c", i), types::Int64Type()});
+    row.push_back(Int64(i));
+  }
+  SimpleTable contents("contents", columns);
+  contents.SetContents({row});
+
+  // Records the columns requested by the evaluator.
+  SimpleTable wide("wide", columns);
+  std::vector<int> requested_columns;
+  wide.SetEvaluatorTableIteratorFactory(
+      [&](absl::Span<const int> column_idxs)
+          -> absl::StatusOr<std::unique_ptr<EvaluatorTableIterator>> {
+        requested_columns.assign(column_idxs.begin(), column_idxs.end());
+        return contents.CreateEvaluatorTableIterator(column_idxs);
+      });
+
+  SimpleCatalog catalog("TestCatalog");
+  catalog.AddTable(wide.Name(), &wide);
+  catalog.AddBuiltinFunctions(BuiltinFunctionOptions::AllReleasedFunctions());
+
+  // Without pruning, every column is read.
+  PreparedQuery unpruned_query("select c7, c2 from wide where c5 > 3",
+                               EvaluatorOptions());
+  ZETASQL_ASSERT_OK(unpruned_query.Prepare(AnalyzerOptions(), &catalog));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<EvaluatorTableIterator> iter,
+                       unpruned_query.Execute());
+  ASSERT_TRUE(iter->NextRow());
+  EXPECT_EQ(iter->GetValue(0), Int64(7));
+  EXPECT_EQ(iter->GetValue(1), Int64(2));
+  EXPECT_FALSE(iter->NextRow());
+  ZETASQL_EXPECT_OK(iter->Status());
+  EXPECT_EQ(requested_columns.size(), 8);
+
+  EvaluatorOptions evaluator_options;
+  evaluator_options.prune_unused_table_columns = true;
+  PreparedQuery query("select c7, c2 from wide where c5 > 3",
+                      evaluator_options);
+  ZETASQL_ASSERT_OK(query.Prepare(AnalyzerOptions(), &catalog));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(iter, query.Execute());
+  ASSERT_TRUE(iter->NextRow());
+  EXPECT_EQ(iter->GetValue(0), Int64(7));
+  EXPECT_EQ(iter->GetValue(1), Int64(2));
+  EXPECT_FALSE(iter->NextRow());
+  ZETASQL_EXPECT_OK(iter->Status());
+  EXPECT_THAT(requested_columns, UnorderedElementsAre(2, 5, 7));
+
+  // SELECT * needs every column.
+  PreparedQuery star_query("select * from wide", evaluator_options);
+  ZETASQL_ASSERT_OK(star_query.Prepare(AnalyzerOptions(), &catalog));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(iter, star_query.Execute());
+  while (iter->NextRow()) {
+  }
+  ZETASQL_EXPECT_OK(iter->Status());
+  EXPECT_EQ(requested_columns.size(), 8);
+}
+
+TEST(PreparedQuery, RangeJoin) {
+  SimpleTable l("l", {{"id", types::Int64Type()},
+                      {"lo", types::Int64Type()},
+                      {"hi", types::Int64Type()}});
+  l.SetContents({{Int64(1), Int64(1), Int64(2)},
+                 {Int64(2), Int64(3), Int64(3)},
+                 {Int64(3), NullInt64(), Int64(5)},
+                 {Int64(4), Int64(10), Int64(12)},
+                 {Int64(5), Int64(2), NullInt64()}});
+  SimpleTable r("r", {{"id", types::Int64Type()}, {"k", types::Int64Type()}});
+  r.SetContents({{Int64(10), Int64(1)},
+                 {Int64(20), Int64(2)},
+                 {Int64(30), Int64(3)},
+                 {Int64(40), NullInt64()},
+                 {Int64(50), Int64(5)}});
+
+  SimpleCatalog catalog("TestCatalog");
+  catalog.AddTable(l.Name(), &l);
+  catalog.AddTable(r.Name(), &r);
+  catalog.AddBuiltinFunctions(BuiltinFunctionOptions::AllReleasedFunctions());
+
+  struct RangeJoinTestCase {
+    std::string join;
+    std::string condition;
+    std::vector<std::vector<Value>> expected;
+  };
+  const Value null = NullInt64();
+  const std::vector<RangeJoinTestCase> test_cases = {
+      {"join",
+       "r.k between l.lo and l.hi",
+       {{Int64(1), Int64(10)}, {Int64(1), Int64(20)}, {Int64(2), Int64(30)}}},
+      {"left join",
+       "r.k between l.lo and l.hi",
+       {{Int64(1), Int64(10)},
+        {Int64(1), Int64(20)},
+        {Int64(2), Int64(30)},
+        {Int64(3), null},
+        {Int64(4), null},
+        {Int64(5), null}}},
+      {"right join",
+       "r.k between l.lo and l.hi",
+       {{Int64(1), Int64(10)},
+        {Int64(1), Int64(20)},
+        {Int64(2), Int64(30)},
+        {null, Int64(40)},
+        {null, Int64(50)}}},
+      {"full join",
+       "r.k between l.lo and l.hi",
+       {{Int64(1), Int64(10)},
+        {Int64(1), Int64(20)},
+        {Int64(2), Int64(30)},
+        {Int64(3), null},
+        {Int64(4), null},
+        {Int64(5), null},
+        {null, Int64(40)},
+        {null, Int64(50)}}},
+      {"join",
+       "r.k > l.lo",
+       {{Int64(1), Int64(20)},
+        {Int64(1), Int64(30)},
+        {Int64(1), Int64(50)},
+        {Int64(2), Int64(50)},
+        {Int64(5), Int64(30)},
+        {Int64(5), Int64(50)}}},
+      {"left join",
+       "r.k >= l.lo and r.k < l.hi",
+       {{Int64(1), Int64(10)},
+        {Int64(2), null},
+        {Int64(3), null},
+        {Int64(4), null},
+        {Int64(5), null}}},
+      {"right join",
+       "l.lo < r.k",
+       {{Int64(1), Int64(20)},
+        {Int64(1), Int64(30)},
+        {Int64(1), Int64(50)},
+        {Int64(2), Int64(50)},
+        {Int64(5), Int64(30)},
+        {Int64(5), Int64(50)},
+        {null, Int64(10)},
+        {null, Int64(40)}}},
+      {"full join",
+       "r.k <= l.hi and r.k > l.lo",
+       {{Int64(1), Int64(20)},
+        {Int64(2), null},
+        {Int64(3), null},
+        {Int64(4), null},
+        {Int64(5), null},
+        {null, Int64(10)},
+        {null, Int64(30)},
+        {null, Int64(40)},
+        {null, Int64(50)}}},
+  };
+  for (const RangeJoinTestCase& test_case : test_cases) {
+    const std::string sql = absl::StrCat("select l.id, r.id from l ",
+                                         test_case.join, " r on ",
+                                         test_case.condition);
+    SCOPED_TRACE(sql);
+    PreparedQuery query(sql, EvaluatorOptions());
+    ZETASQL_ASSERT_OK(query.Prepare(AnalyzerOptions(), &catalog));
+    ZETASQL_ASSERT_OK_AND_ASSIGN(std::string explain, query.ExplainAfterPrepare());
+    EXPECT_THAT(explain, HasSubstr("range_join_right_expr"));
+
+    ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<EvaluatorTableIterator> iter,
+                         query.Execute());
+    std::vector<std::vector<Value>> rows;
+    while (iter->NextRow()) {
+      rows.push_back({iter->GetValue(0), iter->GetValue(1)});
+    }
+    ZETASQL_EXPECT_OK(iter->Status());
+    EXPECT_THAT(rows, UnorderedElementsAreArray(test_case.expected));
+  }
+}
+
 }  // namespace
 
 class PreparedQueryTest : public ::testing::Test {
@@ -4027,6 +4345,65 @@ TEST_F(PreparedQueryTest, TopNAccumulator) {
   EXPECT_TRUE(context_->used_top_n_accumulator());
 }
 
+TEST_F(PreparedQueryTest, RecursiveIterationMetrics) {
+  // Each iteration only sees the rows produced by the previous one. The cycle
+  // back to 1 is removed by UNION DISTINCT, which ends the recursion.
+  PreparedQuery query(
+      "with recursive r as (select 1 as n union distinct "
+      "select if(n < 3, n + 1, 1) from r) select n from r",
+      EvaluatorOptions());
+  SetupContextCallback(&query);
+
+  AnalyzerOptions analyzer_options;
+  analyzer_options.mutable_language()->EnableLanguageFeature(
+      FEATURE_V_1_3_WITH_RECURSIVE);
+  ZETASQL_ASSERT_OK(query.Prepare(analyzer_options));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<EvaluatorTableIterator> iter,
+                       query.ExecuteAfterPrepare());
+  std::vector<Value> values;
+  while (iter->NextRow()) {
+    values.push_back(iter->GetValue(0));
+  }
+  ZETASQL_ASSERT_OK(iter->Status());
+  EXPECT_THAT(values, UnorderedElementsAre(Int64(1), Int64(2), Int64(3)));
+
+  EXPECT_THAT(context_->recursive_iteration_row_counts(),
+              ElementsAre(1, 1, 1, 0));
+}
+
+TEST_F(PreparedQueryTest, ExplainAnalyze) {
+  const std::string sql =
+      "select x, count(*) from unnest([1, 2, 2, 3]) as x group by x";
+
+  // Statistics are only collected when requested.
+  PreparedQuery unprofiled_query(sql, EvaluatorOptions());
+  ZETASQL_ASSERT_OK(unprofiled_query.Prepare(AnalyzerOptions()));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<EvaluatorTableIterator> iter,
+                       unprofiled_query.ExecuteAfterPrepare());
+  EXPECT_THAT(unprofiled_query.ExplainAnalyze(*iter),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+
+  EvaluatorOptions evaluator_options;
+  evaluator_options.collect_operator_profile = true;
+  PreparedQuery query(sql, evaluator_options);
+  SetupContextCallback(&query);
+  ZETASQL_ASSERT_OK(query.Prepare(AnalyzerOptions()));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(iter, query.ExecuteAfterPrepare());
+  ASSERT_NE(context_->operator_profile(), nullptr);
+  int num_rows = 0;
+  while (iter->NextRow()) {
+    ++num_rows;
+  }
+  ZETASQL_ASSERT_OK(iter->Status());
+  EXPECT_EQ(num_rows, 3);
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::string explain, query.ExplainAnalyze(*iter));
+  EXPECT_THAT(explain, HasSubstr("AggregateOp: iterators=1 rows=3"));
+  EXPECT_THAT(explain, HasSubstr("hash_table_size=3"));
+  EXPECT_THAT(explain, HasSubstr("ArrayScanOp: iterators=1 rows=4"));
+}
+
 TEST_F(PreparedQueryTest, ReadZeroColumnsWithPruningUnusedColumnsEnabled) {
   SimpleTable test_table("TestTable", {{"a", types::Int64Type()}});
   test_table.SetContents({{Int64(30)}, {Int64(20)}, {Int64(10)}});
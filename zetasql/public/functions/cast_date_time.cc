@@ -23,6 +23,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <limits>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -48,11 +49,13 @@
 #include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
+#include "absl/strings/str_replace.h"
 #include "absl/strings/string_view.h"
 #include "absl/strings/substitute.h"
 #include "absl/time/civil_time.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
+#include "absl/types/span.h"
 #include "unicode/uchar.h"
 #include "unicode/utf8.h"
 #include "zetasql/base/general_trie.h"
@@ -66,6 +69,7 @@ namespace functions {
 namespace {
 
 using cast_date_time_internal::DateTimeFormatElement;
+using cast_date_time_internal::DigitCountRange;
 using cast_date_time_internal::FormatElementCategory;
 using cast_date_time_internal::FormatElementType;
 using cast_date_time_internal::GetDateTimeFormatElements;
@@ -139,16 +143,16 @@ ParseWithCandidatesResult ParseStringWithCandidates(
 // absl::string_view::npos otherwise.
 size_t ParseMonthNames(absl::string_view timestamp_string, bool abbreviated,
                        int* month) {
-  absl::Span<const absl::string_view> month_names;
-
-  if (abbreviated) {
-    month_names = {"JAN", "FEB", "MAR", "APR", "MAY", "JUN",
-                   "JUL", "AUG", "SEP", "OCT", "NOV", "DEC"};
-  } else {
-    month_names = {"JANUARY",   "FEBRUARY", "MARCH",    "APRIL",
-                   "MAY",       "JUNE",     "JULY",     "AUGUST",
-                   "SEPTEMBER", "OCTOBER",  "NOVEMBER", "DECEMBER"};
-  }
+  static constexpr absl::string_view kAbbreviatedMonthNames[] = {
+      "JAN", "FEB", "MAR", "APR", "MAY", "JUN",
+      "JUL", "AUG", "SEP", "OCT", "NOV", "DEC"};
+  static constexpr absl::string_view kMonthNames[] = {
+      "JANUARY", "FEBRUARY", "MARCH",     "APRIL",   "MAY",      "JUNE",
+      "JULY",    "AUGUST",   "SEPTEMBER", "OCTOBER", "NOVEMBER", "DECEMBER"};
+  // The names must outlive <month_names>, so they cannot be braced lists.
+  const absl::Span<const absl::string_view> month_names =
+      abbreviated ? absl::MakeConstSpan(kAbbreviatedMonthNames)
+                  : absl::MakeConstSpan(kMonthNames);
 
   ParseWithCandidatesResult parsing_result =
       ParseStringWithCandidates(timestamp_string, month_names,
@@ -550,13 +554,6 @@ absl::StatusOr<std::vector<bool>> ComputeElementPrecedesDigits(
   return element_precedes_digits;
 }
 
-// This struct specifies the range of number of digits that an element can
-// parse.
-struct DigitCountRange {
-  int min = 0;
-  int max = 0;
-};
-
 // Returns a vector of DigitCountRange objects <digit_count_ranges> where
 // <digit_count_ranges[i]> indicates the range of number of digits to parse for
 // <format_elements[i]>. For elements that do not parse digits (e.g. "-") or
@@ -753,9 +750,11 @@ size_t ParseWithFormatElementOfTypeTZH(absl::string_view timestamp_string,
 }
 
 // This function conducts the parsing for <timestamp_string> with
-// <format_elements>.
+// <format_elements>. <digit_count_ranges> must be the result of
+// ComputeDigitCountRanges() for <format_elements>.
 absl::Status ParseTimeWithFormatElements(
     const std::vector<DateTimeFormatElement>& format_elements,
+    absl::Span<const DigitCountRange> digit_count_ranges,
     absl::string_view timestamp_string, const absl::TimeZone default_timezone,
     const absl::Time current_timestamp, TimestampScale scale,
     absl::Time* timestamp) {
@@ -787,8 +786,7 @@ absl::Status ParseTimeWithFormatElements(
   int timezone_offset_min = 0;
 
   bool error_in_parsing = false;
-  ZETASQL_ASSIGN_OR_RETURN(const std::vector<DigitCountRange> digit_count_ranges,
-                   ComputeDigitCountRanges(format_elements));
+  ZETASQL_RET_CHECK_EQ(digit_count_ranges.size(), format_elements.size());
 
   // Skips leading whitespaces.
   timestamp_str_parsed_length +=
@@ -1316,12 +1314,13 @@ absl::Status ValidateDateTimeFormatElements(
 // The result <timestamp> is always at microseconds precision.
 absl::Status ParseTimeWithFormatElements(
     const std::vector<DateTimeFormatElement>& format_elements,
+    absl::Span<const DigitCountRange> digit_count_ranges,
     absl::string_view timestamp_string, const absl::TimeZone default_timezone,
     const absl::Time current_timestamp, int64_t* timestamp_micros) {
   absl::Time base_time;
   ZETASQL_RETURN_IF_ERROR(ParseTimeWithFormatElements(
-      format_elements, timestamp_string, default_timezone, current_timestamp,
-      kMicroseconds, &base_time));
+      format_elements, digit_count_ranges, timestamp_string, default_timezone,
+      current_timestamp, kMicroseconds, &base_time));
 
   if (!ConvertTimeToTimestamp(base_time, timestamp_micros)) {
     return MakeEvalError() << "Invalid result from parsing function";
@@ -1866,23 +1865,107 @@ absl::StatusOr<std::string> ResolveFormatString(
   }
 }
 
+// Returns the absl::FormatTime() pattern producing the output of
+// <format_element> if that output does not depend on the casing of the
+// element, and std::nullopt otherwise.
+static std::optional<std::string> GetCasingIndependentPattern(
+    const DateTimeFormatElement& format_element) {
+  switch (format_element.type) {
+    case FormatElementType::kSimpleLiteral:
+    case FormatElementType::kDoubleQuotedLiteral:
+      // Literals are not null-terminated, but parts of a pattern may be passed
+      // to strftime().
+      if (absl::StrContains(format_element.literal_value, '\0')) {
+        return std::nullopt;
+      }
+      return absl::StrReplaceAll(format_element.literal_value, {{"%", "%%"}});
+    case FormatElementType::kWhitespace:
+      return std::string(format_element.len_in_format_str, ' ');
+    default:
+      break;
+  }
+  if (format_element.format_casing_type ==
+      FormatCasingType::kFormatCasingTypeUnspecified) {
+    return std::nullopt;
+  }
+  switch (format_element.type) {
+    case FormatElementType::kMM:
+    case FormatElementType::kDD:
+    case FormatElementType::kDDD:
+    case FormatElementType::kHH:
+    case FormatElementType::kHH12:
+    case FormatElementType::kHH24:
+    case FormatElementType::kMI:
+    case FormatElementType::kSS:
+    case FormatElementType::kFFN:
+      break;
+    case FormatElementType::kMON:
+    case FormatElementType::kMONTH:
+    case FormatElementType::kDAY:
+    case FormatElementType::kDY:
+      if (format_element.format_casing_type !=
+              FormatCasingType::kPreserveCase &&
+          format_element.format_casing_type !=
+              FormatCasingType::kOnlyFirstLetterUppercase) {
+        return std::nullopt;
+      }
+      break;
+    default:
+      return std::nullopt;
+  }
+  // The patterns of these elements do not depend on the time being formatted.
+  absl::StatusOr<std::string> pattern = FromDateTimeFormatElementToFormatString(
+      format_element, absl::UTCTimeZone().At(absl::UnixEpoch()));
+  if (!pattern.ok()) {
+    return std::nullopt;
+  }
+  return *std::move(pattern);
+}
+
+std::vector<FormatSegment> CompileFormatSegments(
+    const std::vector<DateTimeFormatElement>& format_elements) {
+  std::vector<FormatSegment> format_segments;
+  for (int i = 0; i < format_elements.size(); ++i) {
+    std::optional<std::string> pattern =
+        GetCasingIndependentPattern(format_elements[i]);
+    if (!pattern.has_value()) {
+      format_segments.push_back({.element_index = i});
+    } else if (!format_segments.empty() &&
+               format_segments.back().element_index < 0) {
+      absl::StrAppend(&format_segments.back().pattern, *pattern);
+    } else {
+      format_segments.push_back({.pattern = *std::move(pattern)});
+    }
+  }
+  return format_segments;
+}
+
 absl::StatusOr<std::string> FromCastFormatTimestampToStringInternal(
     absl::Span<const DateTimeFormatElement> format_elements,
-    absl::Time base_time, absl::TimeZone timezone) {
+    absl::Span<const FormatSegment> format_segments, absl::Time base_time,
+    absl::TimeZone timezone) {
   if (!IsValidTime(base_time)) {
     return MakeEvalError() << "Invalid timestamp value: "
                            << absl::ToUnixMicros(base_time);
   }
   absl::TimeZone normalized_timezone =
       internal_functions::GetNormalizedTimeZone(base_time, timezone);
-  std::string updated_format_string;
-  for (const DateTimeFormatElement& format_element : format_elements) {
+  std::string result;
+  for (const FormatSegment& format_segment : format_segments) {
+    if (format_segment.element_index < 0) {
+      absl::StrAppend(&result,
+                      absl::FormatTime(format_segment.pattern, base_time,
+                                       normalized_timezone));
+      continue;
+    }
+    ZETASQL_RET_CHECK_LT(format_segment.element_index, format_elements.size());
     ZETASQL_ASSIGN_OR_RETURN(
         std::string str_format,
-        ResolveFormatString(format_element, base_time, normalized_timezone));
-    absl::StrAppend(&updated_format_string, str_format);
+        ResolveFormatString(format_elements[format_segment.element_index],
+                            base_time, normalized_timezone));
+    absl::StrAppend(&result, str_format);
   }
-  return updated_format_string;
+  return result;
 }
 
 }  // namespace cast_date_time_internal
@@ -1895,8 +1978,11 @@ absl::StatusOr<StringToTimestampCaster> StringToTimestampCaster::Create(
                    GetDateTimeFormatElements(format_string));
   ZETASQL_RETURN_IF_ERROR(
       ValidateDateTimeFormatElementsForTimestampType(format_elements));
+  ZETASQL_ASSIGN_OR_RETURN(std::vector<DigitCountRange> digit_count_ranges,
+                   ComputeDigitCountRanges(format_elements));
 
-  return StringToTimestampCaster(std::move(format_elements));
+  return StringToTimestampCaster(std::move(format_elements),
+                                 std::move(digit_count_ranges));
 }
 
 absl::Status StringToTimestampCaster::Cast(absl::string_view timestamp_string,
@@ -1907,9 +1993,22 @@ absl::Status StringToTimestampCaster::Cast(absl::string_view timestamp_string,
     return MakeEvalError() << "Input string is not valid UTF-8";
   }
 
-  return ParseTimeWithFormatElements(format_elements_, timestamp_string,
-                                     default_timezone, current_timestamp,
-                                     timestamp_micros);
+  return ParseTimeWithFormatElements(format_elements_, digit_count_ranges_,
+                                     timestamp_string, default_timezone,
+                                     current_timestamp, timestamp_micros);
+}
+
+absl::Status StringToTimestampCaster::Cast(absl::string_view timestamp_string,
+                                           absl::TimeZone default_timezone,
+                                           absl::Time current_timestamp,
+                                           absl::Time* timestamp) const {
+  if (!IsWellFormedUTF8(timestamp_string)) {
+    return MakeEvalError() << "Input string is not valid UTF-8";
+  }
+
+  return ParseTimeWithFormatElements(
+      format_elements_, digit_count_ranges_, timestamp_string,
+      default_timezone, current_timestamp, kNanoseconds, timestamp);
 }
 
 absl::Status CastStringToTimestamp(absl::string_view format_string,
@@ -1947,16 +2046,9 @@ absl::Status CastStringToTimestamp(absl::string_view format_string,
   if (!IsWellFormedUTF8(timestamp_string)) {
     return MakeEvalError() << "Input string is not valid UTF-8";
   }
-  ZETASQL_RETURN_IF_ERROR(ConductBasicFormatStringChecks(format_string));
-
-  ZETASQL_ASSIGN_OR_RETURN(const std::vector<DateTimeFormatElement> format_elements,
-                   GetDateTimeFormatElements(format_string));
-  ZETASQL_RETURN_IF_ERROR(
-      ValidateDateTimeFormatElementsForTimestampType(format_elements));
-
-  return ParseTimeWithFormatElements(format_elements, timestamp_string,
-                                     default_timezone, current_timestamp,
-                                     kNanoseconds, timestamp);
+  ZETASQL_ASSIGN_OR_RETURN(auto caster, StringToTimestampCaster::Create(format_string));
+  return caster.Cast(timestamp_string, default_timezone, current_timestamp,
+                     timestamp);
 }
 
 absl::Status CastStringToTimestamp(absl::string_view format_string,
@@ -1983,8 +2075,11 @@ absl::StatusOr<StringToDateCaster> StringToDateCaster::Create(
   ZETASQL_ASSIGN_OR_RETURN(auto format_elements,
                    GetDateTimeFormatElements(format_string));
   ZETASQL_RETURN_IF_ERROR(ValidateDateTimeFormatElementsForDateType(format_elements));
+  ZETASQL_ASSIGN_OR_RETURN(std::vector<DigitCountRange> digit_count_ranges,
+                   ComputeDigitCountRanges(format_elements));
 
-  return StringToDateCaster(std::move(format_elements));
+  return StringToDateCaster(std::move(format_elements),
+                            std::move(digit_count_ranges));
 }
 
 absl::Status StringToDateCaster::Cast(absl::string_view date_string,
@@ -2002,9 +2097,9 @@ absl::Status StringToDateCaster::Cast(absl::string_view date_string,
   // as <current_timestamp> and "UTC" as <default_timezone>, so the
   // <current_year> and <current_date> used in ParseTimeWithFormatElements
   // function would be the same as year and month in <current_date>.
-  ZETASQL_RETURN_IF_ERROR(ParseTimeWithFormatElements(format_elements_, date_string,
-                                              absl::UTCTimeZone(),
-                                              current_date_utc_ts, &timestamp));
+  ZETASQL_RETURN_IF_ERROR(ParseTimeWithFormatElements(
+      format_elements_, digit_count_ranges_, date_string, absl::UTCTimeZone(),
+      current_date_utc_ts, &timestamp));
   ZETASQL_RETURN_IF_ERROR(ExtractFromTimestamp(DATE, timestamp, kMicroseconds,
                                        absl::UTCTimeZone(), date));
   return absl::OkStatus();
@@ -2030,8 +2125,11 @@ absl::StatusOr<StringToTimeCaster> StringToTimeCaster::Create(
   ZETASQL_ASSIGN_OR_RETURN(auto format_elements,
                    GetDateTimeFormatElements(format_string));
   ZETASQL_RETURN_IF_ERROR(ValidateDateTimeFormatElementsForTimeType(format_elements));
+  ZETASQL_ASSIGN_OR_RETURN(std::vector<DigitCountRange> digit_count_ranges,
+                   ComputeDigitCountRanges(format_elements));
 
-  return StringToTimeCaster(std::move(format_elements));
+  return StringToTimeCaster(std::move(format_elements),
+                            std::move(digit_count_ranges));
 }
 
 absl::Status StringToTimeCaster::Cast(absl::string_view time_string,
@@ -2050,7 +2148,7 @@ absl::Status StringToTimeCaster::Cast(absl::string_view time_string,
   // final output since we derive default values for time parts from
   // "00:00:00:000000000".
   ZETASQL_RETURN_IF_ERROR(ParseTimeWithFormatElements(
-      format_elements_, time_string, absl::UTCTimeZone(),
+      format_elements_, digit_count_ranges_, time_string, absl::UTCTimeZone(),
       /*current_timestamp=*/absl::UnixEpoch(), scale, &timestamp));
   ZETASQL_RETURN_IF_ERROR(
       ConvertTimestampToTime(timestamp, absl::UTCTimeZone(), scale, time));
@@ -2065,8 +2163,11 @@ absl::StatusOr<StringToDatetimeCaster> StringToDatetimeCaster::Create(
                    GetDateTimeFormatElements(format_string));
   ZETASQL_RETURN_IF_ERROR(
       ValidateDateTimeFormatElementsForDatetimeType(format_elements));
+  ZETASQL_ASSIGN_OR_RETURN(std::vector<DigitCountRange> digit_count_ranges,
+                   ComputeDigitCountRanges(format_elements));
 
-  return StringToDatetimeCaster(std::move(format_elements));
+  return StringToDatetimeCaster(std::move(format_elements),
+                                std::move(digit_count_ranges));
 }
 
 absl::Status StringToDatetimeCaster::Cast(absl::string_view datetime_string,
@@ -2088,8 +2189,8 @@ absl::Status StringToDatetimeCaster::Cast(absl::string_view datetime_string,
   // <current_year> and <current_date> used in ParseTimeWithFormatElements
   // function would be the same as year and month in <current_date>.
   ZETASQL_RETURN_IF_ERROR(ParseTimeWithFormatElements(
-      format_elements_, datetime_string, absl::UTCTimeZone(),
-      current_date_utc_ts, scale, &timestamp));
+      format_elements_, digit_count_ranges_, datetime_string,
+      absl::UTCTimeZone(), current_date_utc_ts, scale, &timestamp));
   ZETASQL_RETURN_IF_ERROR(
       ConvertTimestampToDatetime(timestamp, absl::UTCTimeZone(), datetime));
   return absl::OkStatus();
@@ -2153,7 +2254,10 @@ absl::StatusOr<DateToStringCaster> DateToStringCaster::Create(
       cast_date_time_internal::GetDateTimeFormatElements(format_string));
   ZETASQL_RETURN_IF_ERROR(
       ValidateDateDateTimeFormatElementsForFormatting(format_elements));
-  return DateToStringCaster(std::move(format_elements));
+  std::vector<cast_date_time_internal::FormatSegment> format_segments =
+      cast_date_time_internal::CompileFormatSegments(format_elements);
+  return DateToStringCaster(std::move(format_elements),
+                            std::move(format_segments));
 }
 
 absl::Status DateToStringCaster::Cast(int32_t date, std::string* out) const {
@@ -2166,8 +2270,8 @@ absl::Status DateToStringCaster::Cast(int32_t date, std::string* out) const {
   int64_t date_timestamp = static_cast<int64_t>(date) * kNaiveNumMicrosPerDay;
   ZETASQL_ASSIGN_OR_RETURN(
       *out, cast_date_time_internal::FromCastFormatTimestampToStringInternal(
-                format_elements_, MakeTime(date_timestamp, kMicroseconds),
-                absl::UTCTimeZone()));
+                format_elements_, format_segments_,
+                MakeTime(date_timestamp, kMicroseconds), absl::UTCTimeZone()));
   return absl::OkStatus();
 }
 
@@ -2186,7 +2290,10 @@ absl::StatusOr<DatetimeToStringCaster> DatetimeToStringCaster::Create(
       cast_date_time_internal::GetDateTimeFormatElements(format_string));
   ZETASQL_RETURN_IF_ERROR(
       ValidateDatetimeDateTimeFormatElementsForFormatting(format_elements));
-  return DatetimeToStringCaster(std::move(format_elements));
+  std::vector<cast_date_time_internal::FormatSegment> format_segments =
+      cast_date_time_internal::CompileFormatSegments(format_elements);
+  return DatetimeToStringCaster(std::move(format_elements),
+                                std::move(format_segments));
 }
 
 absl::Status DatetimeToStringCaster::Cast(const DatetimeValue& datetime,
@@ -2202,7 +2309,8 @@ absl::Status DatetimeToStringCaster::Cast(const DatetimeValue& datetime,
 
   ZETASQL_ASSIGN_OR_RETURN(
       *out, cast_date_time_internal::FromCastFormatTimestampToStringInternal(
-                format_elements_, datetime_in_utc, absl::UTCTimeZone()));
+                format_elements_, format_segments_, datetime_in_utc,
+                absl::UTCTimeZone()));
   return absl::OkStatus();
 }
 
@@ -2221,7 +2329,10 @@ absl::StatusOr<TimeToStringCaster> TimeToStringCaster::Create(
       cast_date_time_internal::GetDateTimeFormatElements(format_string));
   ZETASQL_RETURN_IF_ERROR(
       ValidateTimeDateTimeFormatElementsForFormatting(format_elements));
-  return TimeToStringCaster(std::move(format_elements));
+  std::vector<cast_date_time_internal::FormatSegment> format_segments =
+      cast_date_time_internal::CompileFormatSegments(format_elements);
+  return TimeToStringCaster(std::move(format_elements),
+                            std::move(format_segments));
 }
 
 absl::Status TimeToStringCaster::Cast(const TimeValue& time,
@@ -2239,7 +2350,8 @@ absl::Status TimeToStringCaster::Cast(const TimeValue& time,
 
   ZETASQL_ASSIGN_OR_RETURN(
       *out, cast_date_time_internal::FromCastFormatTimestampToStringInternal(
-                format_elements_, time_in_epoch_day, absl::UTCTimeZone()));
+                format_elements_, format_segments_, time_in_epoch_day,
+                absl::UTCTimeZone()));
   return absl::OkStatus();
 }
 
@@ -2256,7 +2368,10 @@ absl::StatusOr<TimestampToStringCaster> TimestampToStringCaster::Create(
   ZETASQL_ASSIGN_OR_RETURN(
       auto format_elements,
       cast_date_time_internal::GetDateTimeFormatElements(format_string));
-  return TimestampToStringCaster(std::move(format_elements));
+  std::vector<cast_date_time_internal::FormatSegment> format_segments =
+      cast_date_time_internal::CompileFormatSegments(format_elements);
+  return TimestampToStringCaster(std::move(format_elements),
+                                 std::move(format_segments));
 }
 
 absl::Status TimestampToStringCaster::Cast(int64_t timestamp_micros,
@@ -2264,8 +2379,8 @@ absl::Status TimestampToStringCaster::Cast(int64_t timestamp_micros,
                                            std::string* out) const {
   ZETASQL_ASSIGN_OR_RETURN(
       *out, cast_date_time_internal::FromCastFormatTimestampToStringInternal(
-                format_elements_, MakeTime(timestamp_micros, kMicroseconds),
-                timezone));
+                format_elements_, format_segments_,
+                MakeTime(timestamp_micros, kMicroseconds), timezone));
   return absl::OkStatus();
 }
 
@@ -2274,7 +2389,7 @@ absl::Status TimestampToStringCaster::Cast(absl::Time timestamp,
                                            std::string* out) const {
   ZETASQL_ASSIGN_OR_RETURN(
       *out, cast_date_time_internal::FromCastFormatTimestampToStringInternal(
-                format_elements_, timestamp, timezone));
+                format_elements_, format_segments_, timestamp, timezone));
   return absl::OkStatus();
 }
 
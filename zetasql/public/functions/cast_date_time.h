@@ -333,8 +333,34 @@ struct DateTimeFormatElement {
 absl::StatusOr<std::vector<DateTimeFormatElement>> GetDateTimeFormatElements(
     absl::string_view format_str);
 
+// The range of the number of digits that a format element can parse. It only
+// depends on the format string, so it is computed once per caster.
+struct DigitCountRange {
+  int min = 0;
+  int max = 0;
+};
+
+// A piece of a format string compiled for formatting. Consecutive elements
+// whose output does not depend on their casing (literals, numeric elements,
+// and name elements with preserved casing) are merged into a single
+// absl::FormatTime() <pattern>. Any other element is resolved on its own, and
+// <element_index> is its index into the format elements of the caster.
+struct FormatSegment {
+  std::string pattern;
+  int element_index = -1;
+};
+
+// Compiles <format_elements> into the segments used by the *ToStringCaster
+// classes. Formatting with the segments produces the same output and errors
+// as resolving each element separately.
+std::vector<FormatSegment> CompileFormatSegments(
+    const std::vector<DateTimeFormatElement>& format_elements);
+
 }  // namespace cast_date_time_internal
 
+// The casters below validate and compile a format string once, so that it can
+// be applied to many values without being interpreted again, e.g. when the
+// format of a CAST is a constant.
 class StringToDateCaster {
  public:
   static absl::StatusOr<StringToDateCaster> Create(
@@ -345,12 +371,16 @@ class StringToDateCaster {
                     int32_t* date) const;
 
  private:
-  explicit StringToDateCaster(
+  StringToDateCaster(
       std::vector<cast_date_time_internal::DateTimeFormatElement>&&
-          format_elements)
-      : format_elements_(std::move(format_elements)) {}
+          format_elements,
+      std::vector<cast_date_time_internal::DigitCountRange>&&
+          digit_count_ranges)
+      : format_elements_(std::move(format_elements)),
+        digit_count_ranges_(std::move(digit_count_ranges)) {}
 
   std::vector<cast_date_time_internal::DateTimeFormatElement> format_elements_;
+  std::vector<cast_date_time_internal::DigitCountRange> digit_count_ranges_;
 };
 
 class StringToTimeCaster {
@@ -363,12 +393,16 @@ class StringToTimeCaster {
                     TimeValue* time) const;
 
  private:
-  explicit StringToTimeCaster(
+  StringToTimeCaster(
       std::vector<cast_date_time_internal::DateTimeFormatElement>&&
-          format_elements)
-      : format_elements_(std::move(format_elements)) {}
+          format_elements,
+      std::vector<cast_date_time_internal::DigitCountRange>&&
+          digit_count_ranges)
+      : format_elements_(std::move(format_elements)),
+        digit_count_ranges_(std::move(digit_count_ranges)) {}
 
   std::vector<cast_date_time_internal::DateTimeFormatElement> format_elements_;
+  std::vector<cast_date_time_internal::DigitCountRange> digit_count_ranges_;
 };
 
 class StringToDatetimeCaster {
@@ -381,12 +415,16 @@ class StringToDatetimeCaster {
                     int32_t current_date, DatetimeValue* datetime) const;
 
  private:
-  explicit StringToDatetimeCaster(
+  StringToDatetimeCaster(
       std::vector<cast_date_time_internal::DateTimeFormatElement>&&
-          format_elements)
-      : format_elements_(std::move(format_elements)) {}
+          format_elements,
+      std::vector<cast_date_time_internal::DigitCountRange>&&
+          digit_count_ranges)
+      : format_elements_(std::move(format_elements)),
+        digit_count_ranges_(std::move(digit_count_ranges)) {}
 
   std::vector<cast_date_time_internal::DateTimeFormatElement> format_elements_;
+  std::vector<cast_date_time_internal::DigitCountRange> digit_count_ranges_;
 };
 
 class StringToTimestampCaster {
@@ -399,14 +437,22 @@ class StringToTimestampCaster {
                     absl::TimeZone default_timezone,
                     absl::Time current_timestamp,
                     int64_t* timestamp_micros) const;
+  absl::Status Cast(absl::string_view timestamp_string,
+                    absl::TimeZone default_timezone,
+                    absl::Time current_timestamp,
+                    absl::Time* timestamp) const;
 
  private:
-  explicit StringToTimestampCaster(
+  StringToTimestampCaster(
       std::vector<cast_date_time_internal::DateTimeFormatElement>&&
-          format_elements)
-      : format_elements_(std::move(format_elements)) {}
+          format_elements,
+      std::vector<cast_date_time_internal::DigitCountRange>&&
+          digit_count_ranges)
+      : format_elements_(std::move(format_elements)),
+        digit_count_ranges_(std::move(digit_count_ranges)) {}
 
   std::vector<cast_date_time_internal::DateTimeFormatElement> format_elements_;
+  std::vector<cast_date_time_internal::DigitCountRange> digit_count_ranges_;
 };
 
 class DateToStringCaster {
@@ -418,12 +464,15 @@ class DateToStringCaster {
   absl::Status Cast(int32_t date, std::string* out) const;
 
  private:
-  explicit DateToStringCaster(
+  DateToStringCaster(
       std::vector<cast_date_time_internal::DateTimeFormatElement>&&
-          format_elements)
-      : format_elements_(std::move(format_elements)) {}
+          format_elements,
+      std::vector<cast_date_time_internal::FormatSegment>&& format_segments)
+      : format_elements_(std::move(format_elements)),
+        format_segments_(std::move(format_segments)) {}
 
   std::vector<cast_date_time_internal::DateTimeFormatElement> format_elements_;
+  std::vector<cast_date_time_internal::FormatSegment> format_segments_;
 };
 
 class DatetimeToStringCaster {
@@ -435,12 +484,15 @@ class DatetimeToStringCaster {
   absl::Status Cast(const DatetimeValue& datetime, std::string* out) const;
 
  private:
-  explicit DatetimeToStringCaster(
+  DatetimeToStringCaster(
       std::vector<cast_date_time_internal::DateTimeFormatElement>&&
-          format_elements)
-      : format_elements_(std::move(format_elements)) {}
+          format_elements,
+      std::vector<cast_date_time_internal::FormatSegment>&& format_segments)
+      : format_elements_(std::move(format_elements)),
+        format_segments_(std::move(format_segments)) {}
 
   std::vector<cast_date_time_internal::DateTimeFormatElement> format_elements_;
+  std::vector<cast_date_time_internal::FormatSegment> format_segments_;
 };
 
 class TimeToStringCaster {
@@ -452,12 +504,15 @@ class TimeToStringCaster {
   absl::Status Cast(const TimeValue& time, std::string* out) const;
 
  private:
-  explicit TimeToStringCaster(
+  TimeToStringCaster(
       std::vector<cast_date_time_internal::DateTimeFormatElement>&&
-          format_elements)
-      : format_elements_(std::move(format_elements)) {}
+          format_elements,
+      std::vector<cast_date_time_internal::FormatSegment>&& format_segments)
+      : format_elements_(std::move(format_elements)),
+        format_segments_(std::move(format_segments)) {}
 
   std::vector<cast_date_time_internal::DateTimeFormatElement> format_elements_;
+  std::vector<cast_date_time_internal::FormatSegment> format_segments_;
 };
 
 class TimestampToStringCaster {
@@ -472,12 +527,15 @@ class TimestampToStringCaster {
                     std::string* out) const;
 
  private:
-  explicit TimestampToStringCaster(
+  TimestampToStringCaster(
       std::vector<cast_date_time_internal::DateTimeFormatElement>&&
-          format_elements)
-      : format_elements_(std::move(format_elements)) {}
+          format_elements,
+      std::vector<cast_date_time_internal::FormatSegment>&& format_segments)
+      : format_elements_(std::move(format_elements)),
+        format_segments_(std::move(format_segments)) {}
 
   std::vector<cast_date_time_internal::DateTimeFormatElement> format_elements_;
+  std::vector<cast_date_time_internal::FormatSegment> format_segments_;
 };
 
 }  // namespace functions
@@ -47,10 +47,12 @@ namespace {
 using testing::HasSubstr;
 using zetasql_base::testing::StatusIs;
 
+using cast_date_time_internal::CompileFormatSegments;
 using cast_date_time_internal::DateTimeFormatElement;
 using cast_date_time_internal::FormatCasingType;
 using cast_date_time_internal::FormatElementCategory;
 using cast_date_time_internal::FormatElementType;
+using cast_date_time_internal::FormatSegment;
 using cast_date_time_internal::GetDateTimeFormatElements;
 
 static void ExecuteDateTimeFormatElementParsingTest(
@@ -1661,6 +1663,48 @@ TEST(DateTimeUtilTest, StringToTimestampCasterTest) {
   ZETASQL_EXPECT_OK(caster.Cast("1973 11 29 21:33:09", absl::UTCTimeZone(), current_ts,
                         &timestamp_micros));
   EXPECT_EQ(timestamp_micros, 123456789000000);
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      auto nanos_caster,
+      StringToTimestampCaster::Create("YYYY MM DD HH24:MI:SS.FF9"));
+  absl::Time timestamp;
+  ZETASQL_EXPECT_OK(nanos_caster.Cast("1973 11 29 21:33:09.012345678",
+                              absl::UTCTimeZone(), current_ts, &timestamp));
+  EXPECT_EQ(timestamp, absl::FromUnixNanos(123456789012345678));
+}
+
+TEST(DateTimeUtilTest, CompileFormatSegmentsTest) {
+  const std::string format_string =
+      "YYYY-MM-DD\"%\"HH24:MI:SS.FF3 Month MON Dy DAY AM DDD";
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::vector<DateTimeFormatElement> format_elements,
+                       GetDateTimeFormatElements(format_string));
+  std::vector<FormatSegment> format_segments =
+      CompileFormatSegments(format_elements);
+
+  // Year elements, elements that are not in the preserved casing and AM/PM
+  // are resolved on their own; everything in between is merged into a single
+  // absl::FormatTime() pattern.
+  ASSERT_EQ(format_segments.size(), 8);
+  EXPECT_EQ(format_segments[0].element_index, 0);
+  EXPECT_EQ(format_segments[1].element_index, -1);
+  EXPECT_EQ(format_segments[1].pattern, "-%m-%d%%%H:%M:%S.%E3f %B ");
+  EXPECT_EQ(format_elements[format_segments[2].element_index].type,
+            FormatElementType::kMON);
+  EXPECT_EQ(format_segments[3].pattern, " %a ");
+  EXPECT_EQ(format_elements[format_segments[4].element_index].type,
+            FormatElementType::kDAY);
+  EXPECT_EQ(format_segments[5].pattern, " ");
+  EXPECT_EQ(format_elements[format_segments[6].element_index].type,
+            FormatElementType::kAM);
+  EXPECT_EQ(format_segments[7].pattern, " %j");
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto caster,
+                       TimestampToStringCaster::Create(format_string));
+  std::string out;
+  int64_t timestamp =
+      123456789012345;  // Thursday, November 29, 1973 9:33:09 PM
+  ZETASQL_EXPECT_OK(caster.Cast(timestamp, absl::UTCTimeZone(), &out));
+  EXPECT_EQ(out, "1973-11-29%21:33:09.012 November NOV Thu THURSDAY PM 333");
 }
 
 }  // namespace
@@ -16,9 +16,11 @@
 
 #include "zetasql/public/functions/convert_string.h"
 
+#include <charconv>
 #include <cmath>
 #include <cstdint>
 #include <string>
+#include <system_error>
 
 #include "zetasql/common/string_util.h"
 #include "zetasql/public/functions/util.h"
@@ -26,6 +28,7 @@
 #include "zetasql/base/string_numbers.h"
 #include "absl/base/optimization.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/ascii.h"
 #include "absl/strings/escaping.h"
 #include "absl/strings/match.h"
 #include "absl/strings/numbers.h"
@@ -63,6 +66,38 @@ bool IsHex(absl::string_view str) {
   return str.size() >= 2 && str[0] == '0' && (str[1] == 'x' || str[1] == 'X');
 }
 
+// Parses the whole of <str> as a decimal number with std::from_chars, which
+// does not allocate and is considerably faster than absl::SimpleAtoi and
+// absl::SimpleAtod. std::from_chars accepts a subset of their syntax (no
+// whitespace, no '+' sign, no hex) and gives the same value on that subset,
+// so a false return only means that the caller must fall back to them.
+template <typename T>
+bool FromCharsFastPath(absl::string_view str, T* out) {
+  const char* end = str.data() + str.size();
+  const std::from_chars_result result = std::from_chars(str.data(), end, *out);
+  return result.ec == std::errc() && result.ptr == end;
+}
+
+// Like FromCharsFastPath, for float and double. Only takes plain decimal
+// numbers: "inf" and "nan(...)" are left to absl::SimpleAtod, as the NaN
+// payloads of the two parsers may differ.
+template <typename T>
+bool FloatingPointFromCharsFastPath(absl::string_view str, T* out) {
+#ifdef __cpp_lib_to_chars
+  absl::string_view digits = str;
+  absl::ConsumePrefix(&digits, "-");
+  if (digits.empty() ||
+      !(absl::ascii_isdigit(digits[0]) || digits[0] == '.')) {
+    return false;
+  }
+  return FromCharsFastPath(str, out);
+#else
+  // The standard library does not implement std::from_chars for floating
+  // point.
+  return false;
+#endif
+}
+
 constexpr absl::string_view kTrueStringValue = "true";
 constexpr absl::string_view kFalseStringValue = "false";
 
@@ -167,6 +202,7 @@ bool StringToNumeric(absl::string_view value, bool* out, absl::Status* error) {
 template <>
 bool StringToNumeric(absl::string_view value, int32_t* out,
                      absl::Status* error) {
+  if (ABSL_PREDICT_TRUE(FromCharsFastPath(value, out))) return true;
   TrimLeadingSpaces(&value);
   if (ABSL_PREDICT_FALSE(IsHex(value))) {
     if (ABSL_PREDICT_TRUE(
@@ -191,6 +227,7 @@ bool StringToNumeric(absl::string_view value, int32_t* out,
 template <>
 bool StringToNumeric(absl::string_view value, int64_t* out,
                      absl::Status* error) {
+  if (ABSL_PREDICT_TRUE(FromCharsFastPath(value, out))) return true;
   TrimLeadingSpaces(&value);
   if (ABSL_PREDICT_FALSE(IsHex(value))) {
     if (ABSL_PREDICT_TRUE(
@@ -208,6 +245,7 @@ bool StringToNumeric(absl::string_view value, int64_t* out,
 template <>
 bool StringToNumeric(absl::string_view value, uint32_t* out,
                      absl::Status* error) {
+  if (ABSL_PREDICT_TRUE(FromCharsFastPath(value, out))) return true;
   TrimLeadingSpaces(&value);
   if (ABSL_PREDICT_FALSE(IsHex(value))) {
     if (ABSL_PREDICT_TRUE(
@@ -225,6 +263,7 @@ bool StringToNumeric(absl::string_view value, uint32_t* out,
 template <>
 bool StringToNumeric(absl::string_view value, uint64_t* out,
                      absl::Status* error) {
+  if (ABSL_PREDICT_TRUE(FromCharsFastPath(value, out))) return true;
   TrimLeadingSpaces(&value);
   if (ABSL_PREDICT_FALSE(IsHex(value))) {
     if (ABSL_PREDICT_TRUE(
@@ -241,6 +280,9 @@ bool StringToNumeric(absl::string_view value, uint64_t* out,
 
 template <>
 bool StringToNumeric(absl::string_view value, float* out, absl::Status* error) {
+  if (ABSL_PREDICT_TRUE(FloatingPointFromCharsFastPath(value, out))) {
+    return true;
+  }
   if (ABSL_PREDICT_TRUE(absl::SimpleAtof(value, out))) return true;
   return internal::UpdateError(error, FormatError("Bad float value: ", value));
 }
@@ -248,6 +290,9 @@ bool StringToNumeric(absl::string_view value, float* out, absl::Status* error) {
 template <>
 bool StringToNumeric(absl::string_view value, double* out,
                      absl::Status* error) {
+  if (ABSL_PREDICT_TRUE(FloatingPointFromCharsFastPath(value, out))) {
+    return true;
+  }
   if (ABSL_PREDICT_TRUE(absl::SimpleAtod(value, out))) return true;
   return internal::UpdateError(error, FormatError("Bad double value: ", value));
 }
@@ -182,6 +182,46 @@ TEST(Convert, TestDouble) {
   TestAll<double>();
 }
 
+// StringToNumeric tries std::from_chars first. These inputs are outside the
+// syntax it accepts and must be handled by the fallback parsers.
+TEST(Convert, FromCharsFallback) {
+  absl::Status error;
+  for (absl::string_view input : {" 12", "12 ", "+12", "\t12\n"}) {
+    int64_t int64_out;
+    EXPECT_TRUE(StringToNumeric(input, &int64_out, &error)) << input;
+    EXPECT_EQ(12, int64_out) << input;
+    uint32_t uint32_out;
+    EXPECT_TRUE(StringToNumeric(input, &uint32_out, &error)) << input;
+    EXPECT_EQ(12, uint32_out) << input;
+    double double_out;
+    EXPECT_TRUE(StringToNumeric(input, &double_out, &error)) << input;
+    EXPECT_EQ(12, double_out) << input;
+  }
+  ZETASQL_EXPECT_OK(error);
+
+  int64_t int64_out;
+  EXPECT_TRUE(StringToNumeric("-0x1A", &int64_out, &error));
+  EXPECT_EQ(-26, int64_out);
+  EXPECT_FALSE(StringToNumeric("9223372036854775808", &int64_out, &error));
+  EXPECT_FALSE(error.ok());
+
+  error = absl::OkStatus();
+  double double_out;
+  EXPECT_TRUE(StringToNumeric("+.5e1", &double_out, &error));
+  EXPECT_EQ(5, double_out);
+  EXPECT_TRUE(StringToNumeric("1e400", &double_out, &error));
+  EXPECT_EQ(std::numeric_limits<double>::infinity(), double_out);
+  EXPECT_TRUE(StringToNumeric("-1e400", &double_out, &error));
+  EXPECT_EQ(-std::numeric_limits<double>::infinity(), double_out);
+  EXPECT_TRUE(StringToNumeric("1e-400", &double_out, &error));
+  EXPECT_EQ(0, double_out);
+  EXPECT_TRUE(StringToNumeric("-inf", &double_out, &error));
+  EXPECT_EQ(-std::numeric_limits<double>::infinity(), double_out);
+  EXPECT_TRUE(StringToNumeric("nan", &double_out, &error));
+  EXPECT_TRUE(std::isnan(double_out));
+  ZETASQL_EXPECT_OK(error);
+}
+
 template <typename T>
 void TestNumericToString(const QueryParamsWithResult& test) {
   if (test.param(0).is_null()) return;
@@ -51,6 +51,10 @@
 #include "zetasql/base/status_macros.h"
 #include "zetasql/base/time_proto_util.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 namespace zetasql {
 namespace functions {
 namespace {
@@ -491,6 +495,177 @@ static bool TimeZonePartsToOffset(const char timezone_sign,
   return true;
 }
 
+static bool IsAsciiDigits(const char* p, int length) {
+  for (int i = 0; i < length; ++i) {
+    if (!absl::ascii_isdigit(p[i])) return false;
+  }
+  return true;
+}
+
+// Returns the value of the two ASCII digits at <p>.
+static int TwoDigitValue(const char* p) {
+  return (p[0] - '0') * 10 + (p[1] - '0');
+}
+
+// Returns whether the 10 characters at <p> are 'YYYY-MM-DD'.
+static bool IsCanonicalDate(const char* p) {
+  return IsAsciiDigits(p, 4) && p[4] == '-' && IsAsciiDigits(p + 5, 2) &&
+         p[7] == '-' && IsAsciiDigits(p + 8, 2);
+}
+
+// Returns whether the 19 characters at <p> are 'YYYY-MM-DD?HH:MM:SS'.  The
+// character between the date and the time is not checked.
+static bool IsCanonicalDatetime(const char* p) {
+#if defined(__SSE2__)
+  // Checks the first 16 characters at once.  Subtracting '0' maps the digits
+  // to 0-9 and everything else above 9 (as unsigned bytes).
+  const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+  const __m128i d = _mm_sub_epi8(v, _mm_set1_epi8('0'));
+  const int digits =
+      _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(d, _mm_set1_epi8(9)), d));
+  const int separators = _mm_movemask_epi8(_mm_cmpeq_epi8(
+      v, _mm_setr_epi8(0, 0, 0, 0, '-', 0, 0, '-', 0, 0, 0, 0, 0, ':', 0, 0)));
+  // Digits at 0-3, 5-6, 8-9, 11-12 and 14-15; separators at 4, 7 and 13.
+  constexpr int kDigitMask = 0xDB6F;
+  constexpr int kSeparatorMask = 0x2090;
+  if ((digits & kDigitMask) != kDigitMask ||
+      (separators & kSeparatorMask) != kSeparatorMask) {
+    return false;
+  }
+#else
+  if (!IsCanonicalDate(p) || !IsAsciiDigits(p + 11, 2) || p[13] != ':' ||
+      !IsAsciiDigits(p + 14, 2)) {
+    return false;
+  }
+#endif
+  return p[16] == ':' && IsAsciiDigits(p + 17, 2);
+}
+
+// Lengths of 'YYYY-MM-DD' and 'YYYY-MM-DD HH:MM:SS'.
+static constexpr int kCanonicalDateLength = 10;
+static constexpr int kCanonicalDatetimeLength = 19;
+
+// Parses the canonical date 'YYYY-MM-DD' or datetime
+// 'YYYY-MM-DD( |T|t)HH:MM:SS[.F]' at the start of <str>, where every field
+// has exactly the width shown and the fraction has between 1 and <scale>
+// digits.  These are the forms that timestamps and datetimes are printed in,
+// and they can be parsed without the branching in ParseDigits().
+//
+// Returns the number of characters consumed, or 0 if <str> does not start
+// with one of these forms, in which case the outputs are not modified.  The
+// field values are not range checked.
+static int ParseCanonicalDatetimePrefix(absl::string_view str,
+                                        TimestampScale scale, int* year,
+                                        int* month, int* day, int* hour,
+                                        int* minute, int* second,
+                                        int* subsecond) {
+  const char* p = str.data();
+  const int length = static_cast<int>(str.length());
+  if (length >= kCanonicalDatetimeLength &&
+      (p[kCanonicalDateLength] == ' ' || p[kCanonicalDateLength] == 'T' ||
+       p[kCanonicalDateLength] == 't')) {
+    if (!IsCanonicalDatetime(p)) {
+      return 0;
+    }
+    int idx = kCanonicalDatetimeLength;
+    int fraction = 0;
+    if (idx < length && p[idx] == '.') {
+      const int start_idx = ++idx;
+      while (idx < length && absl::ascii_isdigit(p[idx]) &&
+             idx - start_idx < scale) {
+        fraction = fraction * 10 + (p[idx] - '0');
+        ++idx;
+      }
+      const int num_digits = idx - start_idx;
+      // A digit after <scale> of them means there are too many.
+      if (num_digits == 0 || (idx < length && absl::ascii_isdigit(p[idx]))) {
+        return 0;
+      }
+      fraction *= powers_of_ten[scale - num_digits];
+    }
+    *hour = TwoDigitValue(p + 11);
+    *minute = TwoDigitValue(p + 14);
+    *second = TwoDigitValue(p + 17);
+    *subsecond = fraction;
+    *year = TwoDigitValue(p) * 100 + TwoDigitValue(p + 2);
+    *month = TwoDigitValue(p + 5);
+    *day = TwoDigitValue(p + 8);
+    return idx;
+  }
+  if (length < kCanonicalDateLength || !IsCanonicalDate(p)) {
+    return 0;
+  }
+  *year = TwoDigitValue(p) * 100 + TwoDigitValue(p + 2);
+  *month = TwoDigitValue(p + 5);
+  *day = TwoDigitValue(p + 8);
+  return kCanonicalDateLength;
+}
+
+// Parses a time zone suffix of the form 'Z', '+HH' or '+HH:MM' (or with '-'),
+// returning the offset from UTC in <offset_seconds>.  Returns false for
+// anything else, including the forms that MakeTimeZone() also accepts.
+static bool ParseCanonicalTimeZoneSuffix(absl::string_view str,
+                                         int64_t* offset_seconds) {
+  if (str.length() == 1 && (str[0] == 'Z' || str[0] == 'z')) {
+    *offset_seconds = 0;
+    return true;
+  }
+  if ((str.length() != 3 && str.length() != 6) ||
+      !IsAsciiDigits(str.data() + 1, 2)) {
+    return false;
+  }
+  int timezone_minute = 0;
+  if (str.length() == 6) {
+    if (str[3] != ':' || !IsAsciiDigits(str.data() + 4, 2)) {
+      return false;
+    }
+    timezone_minute = TwoDigitValue(str.data() + 4);
+  }
+  return TimeZonePartsToOffset(str[0], TwoDigitValue(str.data() + 1),
+                               timezone_minute, kSeconds, offset_seconds);
+}
+
+// Fast path for ConvertStringToTimestamp() for strings in canonical form (see
+// ParseCanonicalDatetimePrefix()), optionally followed by a canonical time
+// zone suffix (see ParseCanonicalTimeZoneSuffix()).  A time zone in the
+// string is applied as a fixed offset, without constructing an
+// absl::TimeZone.  Returns false if <str> is not in canonical form or is
+// invalid; the caller must then fall back to the general parser, which also
+// produces the error.
+static bool ConvertCanonicalStringToTimestamp(absl::string_view str,
+                                              absl::TimeZone default_timezone,
+                                              TimestampScale scale,
+                                              bool allow_tz_in_str,
+                                              absl::Time* output) {
+  int year = 0, month = 0, day = 0, hour = 0, minute = 0, second = 0;
+  int subsecond = 0;
+  const int idx = ParseCanonicalDatetimePrefix(
+      str, scale, &year, &month, &day, &hour, &minute, &second, &subsecond);
+  if (idx == 0 || !IsValidDay(year, month, day) ||
+      !IsValidTimeOfDay(hour, minute, second)) {
+    return false;
+  }
+  const absl::CivilSecond cs(year, month, day, hour, minute, second);
+  absl::Time time;
+  if (idx == static_cast<int64_t>(str.length())) {
+    time = default_timezone.At(cs).pre;
+  } else {
+    // A time zone may only follow the time, not a bare date.
+    int64_t offset_seconds;
+    if (idx == kCanonicalDateLength || !allow_tz_in_str ||
+        !ParseCanonicalTimeZoneSuffix(str.substr(idx), &offset_seconds)) {
+      return false;
+    }
+    time = absl::FromUnixSeconds((cs - absl::CivilSecond()) - offset_seconds);
+  }
+  time += MakeDuration(subsecond, scale);
+  if (!IsValidTime(time)) {
+    return false;
+  }
+  *output = time;
+  return true;
+}
+
 // Parses the string into the relevant timestamp parts.  <scale> indicates
 // the number of subsecond digits requested.  Parts not present in the string
 // get initialized to 0 or "" as appropriate.  The subsecond part is
@@ -2282,7 +2457,14 @@ absl::Status MakeTimeZone(absl::string_view timezone_string,
 
 absl::Status ConvertStringToDate(absl::string_view str, int32_t* date) {
   int year = 0, month = 0, day = 0, idx = 0;
-  if (!ParseStringToDateParts(str, &idx, &year, &month, &day) ||
+  if (str.length() == kCanonicalDateLength) {
+    int unused_time_part;
+    idx = ParseCanonicalDatetimePrefix(
+        str, kSeconds, &year, &month, &day, &unused_time_part,
+        &unused_time_part, &unused_time_part, &unused_time_part);
+  }
+  if ((idx != kCanonicalDateLength &&
+       !ParseStringToDateParts(str, &idx, &year, &month, &day)) ||
       !IsValidDay(year, month, day)) {
     return MakeEvalError() << "Invalid date: '" << str << "'";
   }
@@ -2353,6 +2535,10 @@ absl::Status ConvertStringToTimestamp(absl::string_view str,
                                       TimestampScale scale,
                                       bool allow_tz_in_str,
                                       absl::Time* output) {
+  if (ConvertCanonicalStringToTimestamp(str, default_timezone, scale,
+                                        allow_tz_in_str, output)) {
+    return absl::OkStatus();
+  }
   int year = 0, month = 0, day = 0, hour = 0, minute = 0, second = 0;
   int subsecond = 0;
   bool string_includes_timezone = false;
@@ -2415,8 +2601,13 @@ absl::Status ConvertStringToDatetime(absl::string_view str,
       << "Only kMicroseconds and kNanoseconds are acceptable values for scale";
   int year = 0, month = 0, day = 0, hour = 0, minute = 0, second = 0;
   int subsecond = 0;
-  if (!ParseStringToDatetimeParts(str, scale, &year, &month, &day, &hour,
-                                  &minute, &second, &subsecond) ||
+  const bool is_canonical =
+      ParseCanonicalDatetimePrefix(str, scale, &year, &month, &day, &hour,
+                                   &minute, &second, &subsecond) ==
+      static_cast<int64_t>(str.length());
+  if ((!is_canonical &&
+       !ParseStringToDatetimeParts(str, scale, &year, &month, &day, &hour,
+                                   &minute, &second, &subsecond)) ||
       !IsValidDay(year, month, day) ||
       !IsValidTimeOfDay(hour, minute, second)) {
     return MakeEvalError() << MakeInvalidTypedStrErrorMsg("datetime", str,
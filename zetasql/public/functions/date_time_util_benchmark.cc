@@ -0,0 +1,104 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Measures string to TIMESTAMP/DATETIME/DATE conversion for canonical inputs,
+// which take the fast path, and for inputs that need the general parser.
+
+#include <cstdint>
+
+#include "zetasql/base/logging.h"
+#include "zetasql/public/civil_time.h"
+#include "zetasql/public/functions/date_time_util.h"
+#include "benchmark/benchmark.h"
+#include "absl/time/time.h"
+
+namespace zetasql {
+namespace functions {
+
+static const char* const kTimestampStrings[] = {
+    "2023-04-05 12:34:56.123456",  // canonical
+    "2023-04-05T12:34:56+05:30",   // canonical with offset
+    "2023-04-05 12:34:56Z",        // canonical with 'Z'
+    "2023-04-05",                  // date only
+    "2023-4-5 1:2:3.4",            // single digit fields
+    "2023-04-05 12:34:56 America/Los_Angeles",  // named time zone
+};
+
+// Arguments: index into kTimestampStrings.
+static void BM_ConvertStringToTimestamp(::benchmark::State& state) {
+  const char* str = kTimestampStrings[state.range(0)];
+  const absl::TimeZone timezone = absl::UTCTimeZone();
+  for (auto s : state) {
+    int64_t timestamp;
+    ZETASQL_CHECK_OK(
+        ConvertStringToTimestamp(str, timezone, kMicroseconds, &timestamp));
+    ::benchmark::DoNotOptimize(timestamp);
+  }
+  state.SetLabel(str);
+}
+BENCHMARK(BM_ConvertStringToTimestamp)->DenseRange(0, 5);
+
+// Same as above, but with the default time zone given by name, which is how
+// the evaluator passes it.
+static void BM_ConvertStringToTimestampNamedZone(::benchmark::State& state) {
+  const char* str = kTimestampStrings[state.range(0)];
+  for (auto s : state) {
+    int64_t timestamp;
+    ZETASQL_CHECK_OK(ConvertStringToTimestamp(str, "America/Los_Angeles",
+                                      kMicroseconds, &timestamp));
+    ::benchmark::DoNotOptimize(timestamp);
+  }
+  state.SetLabel(str);
+}
+BENCHMARK(BM_ConvertStringToTimestampNamedZone)->DenseRange(0, 5);
+
+static const char* const kDatetimeStrings[] = {
+    "2023-04-05 12:34:56.123456",  // canonical
+    "2023-4-5 1:2:3.4",            // single digit fields
+};
+
+// Arguments: index into kDatetimeStrings.
+static void BM_ConvertStringToDatetime(::benchmark::State& state) {
+  const char* str = kDatetimeStrings[state.range(0)];
+  for (auto s : state) {
+    DatetimeValue datetime;
+    ZETASQL_CHECK_OK(ConvertStringToDatetime(str, kMicroseconds, &datetime));
+    ::benchmark::DoNotOptimize(datetime);
+  }
+  state.SetLabel(str);
+}
+BENCHMARK(BM_ConvertStringToDatetime)->DenseRange(0, 1);
+
+static void BM_ConvertStringToDate(::benchmark::State& state) {
+  for (auto s : state) {
+    int32_t date;
+    ZETASQL_CHECK_OK(ConvertStringToDate("2023-04-05", &date));
+    ::benchmark::DoNotOptimize(date);
+  }
+}
+BENCHMARK(BM_ConvertStringToDate);
+
+static void BM_MakeTimeZone(::benchmark::State& state) {
+  for (auto s : state) {
+    absl::TimeZone timezone;
+    ZETASQL_CHECK_OK(MakeTimeZone("America/Los_Angeles", &timezone));
+    ::benchmark::DoNotOptimize(timezone);
+  }
+}
+BENCHMARK(BM_MakeTimeZone)->ThreadRange(1, 8);
+
+}  // namespace functions
+}  // namespace zetasql
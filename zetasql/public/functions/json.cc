@@ -38,6 +38,7 @@
 #include "absl/status/statusor.h"
 #include "absl/strings/match.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "re2/re2.h"
 #include "zetasql/base/ret_check.h"
 #include "zetasql/base/status_macros.h"
@@ -46,6 +47,8 @@ namespace zetasql {
 namespace functions {
 namespace {
 using json_internal::JSONPathExtractor;
+using json_internal::JSONPathExtractScalar;
+using json_internal::JSONPathMultiExtractor;
 using json_internal::StrictJSONPathIterator;
 using json_internal::StrictJSONPathToken;
 using json_internal::ValidJSONPathIterator;
@@ -150,6 +153,59 @@ absl::Status JsonPathEvaluator::ExtractScalar(absl::string_view json,
   return absl::OkStatus();
 }
 
+// static
+absl::Status JsonPathEvaluator::ExtractMultiple(
+    absl::string_view json, absl::Span<const Extraction> extractions) {
+  std::vector<std::unique_ptr<JSONPathExtractor>> extractors;
+  std::vector<JSONPathExtractor*> extractor_ptrs;
+  extractors.reserve(extractions.size());
+  extractor_ptrs.reserve(extractions.size());
+  for (const Extraction& extraction : extractions) {
+    const JsonPathEvaluator& evaluator = *extraction.evaluator;
+    if (extraction.scalar) {
+      extractors.push_back(std::make_unique<JSONPathExtractScalar>(
+          json, evaluator.path_iterator_.get()));
+    } else {
+      auto parser = std::make_unique<JSONPathExtractor>(
+          json, evaluator.path_iterator_.get());
+      parser->set_special_character_escaping(
+          evaluator.enable_special_character_escaping_in_values_);
+      parser->set_special_character_key_escaping(
+          evaluator.enable_special_character_escaping_in_keys_);
+      parser->set_escaping_needed_callback(
+          &evaluator.escaping_needed_callback_);
+      extractors.push_back(std::move(parser));
+    }
+    extractor_ptrs.push_back(extractors.back().get());
+    extraction.value->clear();
+  }
+  if (extractors.empty()) {
+    return absl::OkStatus();
+  }
+
+  JSONPathMultiExtractor multi_extractor(json, extractor_ptrs);
+  multi_extractor.ParseAll();
+  for (int i = 0; i < extractions.size(); ++i) {
+    const Extraction& extraction = extractions[i];
+    if (extraction.scalar) {
+      static_cast<JSONPathExtractScalar*>(extractors[i].get())
+          ->FinishExtract(multi_extractor.Parsed(i), extraction.value,
+                          extraction.is_null);
+    } else {
+      extractors[i]->FinishExtract(multi_extractor.Parsed(i),
+                                   extraction.value, extraction.is_null);
+    }
+  }
+  for (const std::unique_ptr<JSONPathExtractor>& extractor : extractors) {
+    if (extractor->StoppedDueToStackSpace()) {
+      return MakeEvalError() << "JSON parsing failed due to deeply nested "
+                                "array/struct. Maximum nesting depth is "
+                             << JSONPathExtractor::kMaxParsingDepth;
+    }
+  }
+  return absl::OkStatus();
+}
+
 std::optional<std::string> JsonPathEvaluator::ExtractScalar(
     JSONValueConstRef input) const {
   std::optional<JSONValueConstRef> optional_json = Extract(input);
@@ -35,6 +35,7 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 
 namespace zetasql {
 namespace functions {
@@ -174,6 +175,25 @@ class JsonPathEvaluator {
   absl::Status ExtractScalar(absl::string_view json, std::string* value,
                              bool* is_null) const;
 
+  // One extraction performed by ExtractMultiple().
+  struct Extraction {
+    const JsonPathEvaluator* evaluator;
+    // Extracts like ExtractScalar() if true, and like Extract() otherwise.
+    bool scalar = false;
+    std::string* value;
+    bool* is_null;
+  };
+
+  // Performs several extractions from the same `json` in a single pass over
+  // it, e.g. for a query that extracts several paths from one column. Each
+  // extraction sets its value and is_null exactly as the corresponding call
+  // to Extract() or ExtractScalar() would; parsing ends as soon as every path
+  // is resolved.
+  //
+  // Error cases are the same as in Extract(), for any of the extractions.
+  static absl::Status ExtractMultiple(absl::string_view json,
+                                      absl::Span<const Extraction> extractions);
+
   // Similar to the string version above, but for JSON types.
   // Returns std::nullopt to indicate that:
   // * json_path does not match anything.
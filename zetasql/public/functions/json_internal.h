@@ -41,6 +41,7 @@
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 
 namespace zetasql {
 namespace functions {
@@ -170,6 +171,8 @@ class StrictJSONPathIterator final
       : JSONPathIterator(std::move(tokens)) {}
 };
 
+class JSONPathMultiExtractor;
+
 //
 // An efficient algorithm to extract the specified JSON path from the JSON text.
 // Let $n$ be the number of nodes in the tree corresponding to the JSON text
@@ -180,6 +183,9 @@ class StrictJSONPathIterator final
 //
 // Invariant maintaining functions are inlined for performance reasons.
 //
+// Members and elements whose key or index does not match the path are skipped
+// without unescaping their strings or visiting their descendants.
+//
 class JSONPathExtractor : public zetasql::JSONParser {
  public:
   // Maximum recursion depth when parsing JSON. We check both for stack space
@@ -224,7 +230,17 @@ class JSONPathExtractor : public zetasql::JSONParser {
   bool Extract(std::string* result, bool* is_null,
                std::optional<std::function<void(absl::Status)>> issue_warning =
                    std::nullopt) {
-    bool parse_success = zetasql::JSONParser::Parse() || stop_on_first_match_;
+    return FinishExtract(zetasql::JSONParser::Parse(), result, is_null,
+                         std::move(issue_warning));
+  }
+
+  // Same as Extract(), but for an extractor whose parse was driven by a
+  // JSONPathMultiExtractor. `parsed` is the result of that parse for this
+  // extractor.
+  bool FinishExtract(bool parsed, std::string* result, bool* is_null,
+                     std::optional<std::function<void(absl::Status)>>
+                         issue_warning = std::nullopt) {
+    bool parse_success = parsed || stop_on_first_match_;
 
     // Parse-failed OR no-match-found OR null-Value
     *is_null = !parse_success || !stop_on_first_match_ || parsed_null_result_;
@@ -368,6 +384,16 @@ class JSONPathExtractor : public zetasql::JSONParser {
     return JSONParser::ReportFailure(error_message);
   }
 
+  // A member or element that does not match the current path token cannot
+  // contain a match, so it is skipped as long as it stays within the maximum
+  // parsing depth.
+  int SkippableValueDepth() override {
+    if (accept_ || !extend_match_ || matching_token_) {
+      return -1;
+    }
+    return static_cast<int>(kMaxParsingDepth + 1 - curr_depth_);
+  }
+
   void Init() {
     path_iterator_.Rewind();
     curr_depth_ = 1;
@@ -502,6 +528,9 @@ class JSONPathExtractor : public zetasql::JSONParser {
   bool stopped_due_to_stack_space_ = false;
   // Whether the JSONPath points to an array.
   bool array_accepted_ = false;
+
+ private:
+  friend class JSONPathMultiExtractor;
 };
 
 //
@@ -515,8 +544,13 @@ class JSONPathExtractScalar final : public JSONPathExtractor {
       : JSONPathExtractor(json, iter) {}
 
   bool Extract(std::string* result, bool* is_null) {
-    bool parse_success =
-        zetasql::JSONParser::Parse() || accept_ || stop_on_first_match_;
+    return FinishExtract(zetasql::JSONParser::Parse(), result, is_null);
+  }
+
+  // Same as Extract(), but for an extractor whose parse was driven by a
+  // JSONPathMultiExtractor.
+  bool FinishExtract(bool parsed, std::string* result, bool* is_null) {
+    bool parse_success = parsed || accept_ || stop_on_first_match_;
 
     // Parse-failed  OR Subtree-Node OR null-Value OR no-match-found
     *is_null = !parse_success || accept_ || parsed_null_result_ ||
@@ -697,6 +731,94 @@ class JSONPathStringArrayExtractor final : public JSONPathExtractor {
   std::vector<std::optional<std::string>> result_array_;
 };
 
+// Drives several JSONPathExtractors over the same JSON text with a single
+// parse. Each extractor receives the same calls as when parsing the text by
+// itself, up to the call where it stops, so its FinishExtract() returns the
+// same result as its Extract() would. The parse ends when every extractor has
+// stopped, and values are skipped when none of the remaining extractors needs
+// them.
+class JSONPathMultiExtractor final : public zetasql::JSONParser {
+ public:
+  // `extractors` must have been constructed on `json`. They and the object
+  // underlying `json` must outlive this object.
+  JSONPathMultiExtractor(absl::string_view json,
+                         absl::Span<JSONPathExtractor* const> extractors)
+      : zetasql::JSONParser(json),
+        extractors_(extractors.begin(), extractors.end()),
+        stopped_(extractors.size(), false),
+        num_running_(static_cast<int>(extractors.size())) {}
+
+  // Parses the JSON text, reporting it to every extractor.
+  void ParseAll() { parsed_ = zetasql::JSONParser::Parse(); }
+
+  // Returns what Parse() would have returned for the extractor at `index` if
+  // it had parsed the JSON text by itself. Only valid after ParseAll().
+  bool Parsed(int index) const { return !stopped_[index] && parsed_; }
+
+ protected:
+  bool BeginObject() override {
+    return Forward(&JSONPathExtractor::BeginObject);
+  }
+  bool EndObject() override { return Forward(&JSONPathExtractor::EndObject); }
+  bool BeginMember(const std::string& key) override {
+    return Forward(&JSONPathExtractor::BeginMember, key);
+  }
+  bool EndMember(bool last) override {
+    return Forward(&JSONPathExtractor::EndMember, last);
+  }
+  bool BeginArray() override { return Forward(&JSONPathExtractor::BeginArray); }
+  bool EndArray() override { return Forward(&JSONPathExtractor::EndArray); }
+  bool BeginArrayEntry() override {
+    return Forward(&JSONPathExtractor::BeginArrayEntry);
+  }
+  bool EndArrayEntry(bool last) override {
+    return Forward(&JSONPathExtractor::EndArrayEntry, last);
+  }
+  bool ParsedString(const std::string& str) override {
+    return Forward(&JSONPathExtractor::ParsedString, str);
+  }
+  bool ParsedNumber(absl::string_view str) override {
+    return Forward(&JSONPathExtractor::ParsedNumber, str);
+  }
+  bool ParsedBool(bool val) override {
+    return Forward(&JSONPathExtractor::ParsedBool, val);
+  }
+  bool ParsedNull() override { return Forward(&JSONPathExtractor::ParsedNull); }
+
+  // A value is skipped only if every running extractor would skip it.
+  int SkippableValueDepth() override {
+    int depth = -1;
+    for (int i = 0; i < extractors_.size(); ++i) {
+      if (stopped_[i]) continue;
+      const int extractor_depth = extractors_[i]->SkippableValueDepth();
+      if (extractor_depth < 0) return -1;
+      if (depth < 0 || extractor_depth < depth) depth = extractor_depth;
+    }
+    return depth;
+  }
+
+ private:
+  // Calls `handler` on every running extractor, stopping those that return
+  // false. Returns false when no extractor is left running.
+  template <typename... Params, typename... Args>
+  bool Forward(bool (JSONPathExtractor::*handler)(Params...), Args&&... args) {
+    for (int i = 0; i < extractors_.size(); ++i) {
+      if (!stopped_[i] && !(extractors_[i]->*handler)(args...)) {
+        stopped_[i] = true;
+        --num_running_;
+      }
+    }
+    return num_running_ > 0;
+  }
+
+  const std::vector<JSONPathExtractor*> extractors_;
+  // Whether each extractor has returned false from a handler, which ends its
+  // parse.
+  std::vector<bool> stopped_;
+  int num_running_;
+  bool parsed_ = false;
+};
+
 }  // namespace json_internal
 }  // namespace functions
 }  // namespace zetasql
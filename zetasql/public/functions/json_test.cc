@@ -371,6 +371,85 @@ TEST(JsonTest, StringJsonExtractScalar) {
   }
 }
 
+TEST(JsonTest, StringJsonExtractMultiple) {
+  const std::vector<std::pair<std::string, bool>> paths_and_scalar = {
+      {"$.a.b[0].c", false}, {"$.a.b[0].c", true}, {"$.a.d", false},
+      {"$.a", true},         {"$.e[1]", true},     {"$.x", false},
+      {"$", false}};
+  std::vector<std::unique_ptr<JsonPathEvaluator>> evaluators;
+  for (const auto& [path, scalar] : paths_and_scalar) {
+    ZETASQL_ASSERT_OK_AND_ASSIGN(
+        std::unique_ptr<JsonPathEvaluator> evaluator,
+        JsonPathEvaluator::Create(
+            path, /*sql_standard_mode=*/false,
+            /*enable_special_character_escaping_in_values=*/true,
+            /*enable_special_character_escaping_in_keys=*/true));
+    evaluators.push_back(std::move(evaluator));
+  }
+  for (absl::string_view json :
+       {R"({"a": {"b": [ { "c" : "foo" } ], "d": {"b\"ar": "q\"w"} },
+            "e": [1, 2.5, [3]]})",
+        R"({"e": [true, null], "a": {"d": [], "b": [ 'x', {"c": 1}]}})",
+        R"({"a": {"b": [ { "c" : "foo" } ]}, "e": [1, 2], "a": 1})",
+        R"({"a": {"b": [ { "c" : "foo" } ]}, "e": [1, 2], "x": })",
+        R"({"e": [1, 2], "a": {"d": 1,, "b": [0]}})", "[1, 2]", "nul", ""}) {
+    SCOPED_TRACE(json);
+    std::vector<std::string> values(evaluators.size());
+    auto is_null = std::make_unique<bool[]>(evaluators.size());
+    std::vector<JsonPathEvaluator::Extraction> extractions;
+    for (int i = 0; i < evaluators.size(); ++i) {
+      extractions.push_back({evaluators[i].get(), paths_and_scalar[i].second,
+                             &values[i], &is_null[i]});
+    }
+    ZETASQL_ASSERT_OK(JsonPathEvaluator::ExtractMultiple(json, extractions));
+    for (int i = 0; i < evaluators.size(); ++i) {
+      SCOPED_TRACE(paths_and_scalar[i].first);
+      std::string expected_value;
+      bool expected_is_null;
+      if (paths_and_scalar[i].second) {
+        ZETASQL_ASSERT_OK(evaluators[i]->ExtractScalar(json, &expected_value,
+                                               &expected_is_null));
+      } else {
+        ZETASQL_ASSERT_OK(evaluators[i]->Extract(json, &expected_value,
+                                         &expected_is_null));
+      }
+      EXPECT_EQ(is_null[i], expected_is_null);
+      EXPECT_EQ(values[i], expected_value);
+    }
+  }
+}
+
+TEST(JsonTest, StringJsonExtractMultipleDeeplyNested) {
+  const std::string json = absl::StrCat(
+      R"({"a": 1, "b": )", std::string(1001, '['), std::string(1001, ']'),
+      "}");
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      const std::unique_ptr<JsonPathEvaluator> evaluator_a,
+      JsonPathEvaluator::Create(
+          "$.a", /*sql_standard_mode=*/true,
+          /*enable_special_character_escaping_in_values=*/false,
+          /*enable_special_character_escaping_in_keys=*/false));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      const std::unique_ptr<JsonPathEvaluator> evaluator_c,
+      JsonPathEvaluator::Create(
+          "$.c", /*sql_standard_mode=*/true,
+          /*enable_special_character_escaping_in_values=*/false,
+          /*enable_special_character_escaping_in_keys=*/false));
+  std::string value_a, value_c;
+  bool is_null_a, is_null_c;
+  // "$.a" is resolved before the nested array, so only "$.c" reaches it.
+  ZETASQL_EXPECT_OK(JsonPathEvaluator::ExtractMultiple(
+      json, {{evaluator_a.get(), /*scalar=*/true, &value_a, &is_null_a}}));
+  EXPECT_FALSE(is_null_a);
+  EXPECT_EQ(value_a, "1");
+  EXPECT_THAT(
+      JsonPathEvaluator::ExtractMultiple(
+          json, {{evaluator_a.get(), /*scalar=*/true, &value_a, &is_null_a},
+                 {evaluator_c.get(), /*scalar=*/true, &value_c, &is_null_c}}),
+      StatusIs(absl::StatusCode::kOutOfRange,
+               HasSubstr("JSON parsing failed due to deeply nested")));
+}
+
 TEST(JsonTest, NativeJsonExtractScalar) {
   const JSONValue json =
       JSONValue::ParseJSONString(
@@ -1563,6 +1642,39 @@ TEST(JSONPathExtractorTest, StopParserOnFirstMatch) {
   }
 }
 
+TEST(JSONPathExtractorTest, SkippedSubtreesKeepParseErrors) {
+  struct TestCase {
+    std::string input;
+    bool parse_success;
+  };
+  const std::vector<TestCase> test_cases = {
+      // Non-matching members are skipped but must still be valid.
+      {R"({"x": {"y": [1, 'two', {"z": null}]}, "a": {"b": 1}})", true},
+      {R"({"x": {"y": [1, 'two', {"z": nul}]}, "a": {"b": 1}})", false},
+      {R"({"x": {"y": [1, "two}, "a": {"b": 1}})", false},
+      // Skipped members may be nested up to the maximum parsing depth.
+      {absl::StrCat(R"({"x": )", std::string(999, '['),
+                    std::string(999, ']'), R"(, "a": {"b": 1}})"),
+       true},
+      {absl::StrCat(R"({"x": )", std::string(1000, '['),
+                    std::string(1000, ']'), R"(, "a": {"b": 1}})"),
+       false}};
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      const std::unique_ptr<ValidJSONPathIterator> path_itr,
+      ValidJSONPathIterator::Create("$.a.b", /*sql_standard_mode=*/true));
+  for (const TestCase& test_case : test_cases) {
+    SCOPED_TRACE(test_case.input);
+    JSONPathExtractor parser(test_case.input, path_itr.get());
+    std::string result;
+    bool is_null;
+    EXPECT_EQ(parser.Extract(&result, &is_null), test_case.parse_success);
+    EXPECT_EQ(is_null, !test_case.parse_success);
+    if (test_case.parse_success) {
+      EXPECT_EQ(result, "1");
+    }
+  }
+}
+
 TEST(JSONPathExtractorTest, BasicArrayAccess) {
   std::string input =
       "{ \"e\" : { \"b\" : \"a10\", \"l11\" : \"test\" }, \"a\" : { "
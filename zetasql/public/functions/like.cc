@@ -17,11 +17,15 @@
 #include "zetasql/public/functions/like.h"
 
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <memory>
 #include <string>
+#include <utility>
 
 #include "zetasql/base/logging.h"
 #include "absl/memory/memory.h"
+#include "absl/strings/match.h"
 #include "re2/re2.h"
 #include "zetasql/base/status.h"
 #include "zetasql/base/status_macros.h"
@@ -115,5 +119,149 @@ absl::Status CreateLikeRegexp(absl::string_view pattern, TypeKind type,
   return CreateLikeRegexpWithOptions(pattern, options, regexp);
 }
 
+namespace {
+
+// Returns true if <text> is a sequence of the characters that RE2 matches with
+// '.' in UTF-8 mode: ASCII bytes, or a lead byte in [C2-F4] followed by the
+// number of continuation bytes it announces. RE2 is slightly more lenient than
+// strict UTF-8 validation here (e.g., it accepts encoded surrogates), and
+// LikeMatcher must agree with RE2 rather than with IsWellFormedUTF8().
+bool IsRe2Utf8(absl::string_view text) {
+  const char* p = text.data();
+  const char* const end = p + text.size();
+  while (p < end) {
+    // Skip over ASCII 8 bytes at a time; this is the common case.
+    uint64_t word;
+    while (static_cast<size_t>(end - p) >= sizeof(word)) {
+      std::memcpy(&word, p, sizeof(word));
+      if ((word & 0x8080808080808080ULL) != 0) break;
+      p += sizeof(word);
+    }
+    if (p == end) break;
+
+    const uint8_t c = static_cast<uint8_t>(*p);
+    int num_continuation_bytes;
+    if (c < 0x80) {
+      ++p;
+      continue;
+    } else if (c < 0xC2) {
+      return false;
+    } else if (c < 0xE0) {
+      num_continuation_bytes = 1;
+    } else if (c < 0xF0) {
+      num_continuation_bytes = 2;
+    } else if (c < 0xF5) {
+      num_continuation_bytes = 3;
+    } else {
+      return false;
+    }
+    if (end - p <= num_continuation_bytes) return false;
+    for (int i = 1; i <= num_continuation_bytes; ++i) {
+      if ((static_cast<uint8_t>(p[i]) & 0xC0) != 0x80) return false;
+    }
+    p += num_continuation_bytes + 1;
+  }
+  return true;
+}
+
+bool IsAscii(absl::string_view text) {
+  for (char c : text) {
+    if (static_cast<uint8_t>(c) >= 0x80) return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+absl::StatusOr<std::unique_ptr<const LikeMatcher>> LikeMatcher::Create(
+    absl::string_view pattern, TypeKind type) {
+  ABSL_DCHECK(type == TYPE_STRING || type == TYPE_BYTES);
+
+  // Recognizes patterns of the form [%]literal[%]. Consecutive '%' are
+  // equivalent to a single one.
+  enum { kBeforeLiteral, kInLiteral, kAfterLiteral } state = kBeforeLiteral;
+  bool leading_percent = false;
+  bool is_simple = true;
+  std::string literal;
+  for (size_t i = 0; is_simple && i < pattern.size(); ++i) {
+    char c = pattern[i];
+    if (c == '_') {
+      is_simple = false;
+    } else if (c == '%') {
+      if (state == kBeforeLiteral) {
+        leading_percent = true;
+      } else {
+        state = kAfterLiteral;
+      }
+    } else if (state == kAfterLiteral) {
+      is_simple = false;
+    } else {
+      if (c == '\\') {
+        if (i + 1 >= pattern.size()) {
+          // Let CreateLikeRegexp() report the error.
+          is_simple = false;
+          break;
+        }
+        c = pattern[++i];
+      }
+      literal.push_back(c);
+      state = kInLiteral;
+    }
+  }
+
+  const bool require_utf8 = type == TYPE_STRING;
+  std::unique_ptr<RE2> regexp;
+  if (!is_simple || (require_utf8 && !IsAscii(literal))) {
+    // Compiling the regexp validates non-ASCII STRING patterns, so that
+    // invalid UTF-8 yields the same error as the regexp-based implementation.
+    ZETASQL_RETURN_IF_ERROR(CreateLikeRegexp(pattern, type, &regexp));
+    if (!is_simple || !IsRe2Utf8(literal)) {
+      return absl::WrapUnique(new LikeMatcher(Kind::kRegexp, "", require_utf8,
+                                              std::move(regexp)));
+    }
+    regexp.reset();
+  }
+
+  Kind kind;
+  switch (state) {
+    case kBeforeLiteral:
+      kind = leading_percent ? Kind::kMatchAll : Kind::kExact;
+      break;
+    case kInLiteral:
+      kind = leading_percent ? Kind::kSuffix : Kind::kExact;
+      break;
+    case kAfterLiteral:
+      kind = leading_percent ? Kind::kSubstring : Kind::kPrefix;
+      break;
+  }
+  return absl::WrapUnique(
+      new LikeMatcher(kind, std::move(literal), require_utf8, nullptr));
+}
+
+bool LikeMatcher::Match(absl::string_view text) const {
+  // For STRING inputs, the text matched by '%' must consist of valid
+  // characters. Since literal_ is itself valid, it suffices to check the part
+  // of <text> outside the literal (or all of it, for kSubstring).
+  switch (kind_) {
+    case Kind::kExact:
+      return text == literal_;
+    case Kind::kPrefix:
+      return absl::StartsWith(text, literal_) &&
+             (!require_utf8_ || IsRe2Utf8(text.substr(literal_.size())));
+    case Kind::kSuffix:
+      return absl::EndsWith(text, literal_) &&
+             (!require_utf8_ ||
+              IsRe2Utf8(text.substr(0, text.size() - literal_.size())));
+    case Kind::kSubstring:
+      return text.find(literal_) != absl::string_view::npos &&
+             (!require_utf8_ || IsRe2Utf8(text));
+    case Kind::kMatchAll:
+      return !require_utf8_ || IsRe2Utf8(text);
+    case Kind::kRegexp:
+      break;
+  }
+  return RE2::FullMatch(text, *regexp_);
+}
+
 }  // namespace functions
 }  // namespace zetasql
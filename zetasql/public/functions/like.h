@@ -19,6 +19,7 @@
 
 #include <memory>
 #include <string>
+#include <utility>
 
 #include "zetasql/public/type.pb.h"
 #include "absl/base/attributes.h"
@@ -51,6 +52,66 @@ absl::Status CreateLikeRegexpWithOptions(absl::string_view pattern,
                                          const RE2::Options& options,
                                          std::unique_ptr<RE2>* regexp);
 
+// A LIKE pattern compiled for repeated matching. Patterns of the common shapes
+//   'abc'    (exact match),
+//   'abc%'   (prefix match),
+//   '%abc'   (suffix match),
+//   '%abc%'  (substring match) and
+//   '%'      (matches everything),
+// where 'abc' contains no unescaped wildcards, are matched with plain byte
+// comparisons. All other patterns (e.g., containing '_' or a '%' in the middle)
+// fall back to a regexp created with CreateLikeRegexp().
+//
+// Match() returns exactly what RE2::FullMatch() returns for the regexp created
+// by CreateLikeRegexp() with the same pattern and type, including for STRING
+// inputs that are not valid UTF-8.
+//
+// This class is thread-safe.
+class LikeMatcher {
+ public:
+  enum class Kind {
+    kExact,
+    kPrefix,
+    kSuffix,
+    kSubstring,
+    kMatchAll,
+    kRegexp,
+  };
+
+  // Compiles <pattern> for inputs of <type>, which must be either TYPE_STRING
+  // or TYPE_BYTES. Returns the same errors as CreateLikeRegexp().
+  static absl::StatusOr<std::unique_ptr<const LikeMatcher>> Create(
+      absl::string_view pattern, TypeKind type);
+
+  LikeMatcher(const LikeMatcher&) = delete;
+  LikeMatcher& operator=(const LikeMatcher&) = delete;
+
+  // Returns true if <text> matches the whole pattern.
+  bool Match(absl::string_view text) const;
+
+  Kind kind() const { return kind_; }
+
+  // The unescaped literal part of the pattern. Empty for kMatchAll and
+  // kRegexp.
+  absl::string_view literal() const { return literal_; }
+
+ private:
+  LikeMatcher(Kind kind, std::string literal, bool require_utf8,
+              std::unique_ptr<RE2> regexp)
+      : kind_(kind),
+        literal_(std::move(literal)),
+        require_utf8_(require_utf8),
+        regexp_(std::move(regexp)) {}
+
+  const Kind kind_;
+  const std::string literal_;
+  // True if the input is STRING, in which case text matched by a '%' must be
+  // valid UTF-8 for the regexp to match it.
+  const bool require_utf8_;
+  // Only set for kRegexp.
+  const std::unique_ptr<RE2> regexp_;
+};
+
 }  // namespace functions
 }  // namespace zetasql
 
@@ -0,0 +1,100 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Compares LikeMatcher against matching with the regexp from
+// CreateLikeRegexp() for the common LIKE pattern shapes.
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "zetasql/base/logging.h"
+#include "zetasql/public/functions/like.h"
+#include "benchmark/benchmark.h"
+#include "absl/strings/str_cat.h"
+#include "re2/re2.h"
+
+namespace zetasql {
+namespace functions {
+
+static constexpr int kNumInputs = 256;
+
+static const char* const kPatterns[] = {
+    "customer-1234@example.com",  // exact
+    "customer-%",                 // prefix
+    "%@example.com",              // suffix
+    "%1234%",                     // substring
+    "customer-%@%.com",           // general; needs a regexp
+};
+
+static std::vector<std::string> MakeInputs(int length) {
+  std::vector<std::string> inputs;
+  for (int i = 0; i < kNumInputs; ++i) {
+    std::string input = absl::StrCat("customer-", i, "@");
+    input.append(std::max(0, length - static_cast<int>(input.size()) - 4),
+                 'x');
+    absl::StrAppend(&input, ".com");
+    inputs.push_back(std::move(input));
+  }
+  return inputs;
+}
+
+// Arguments: index into kPatterns, input length.
+static void BM_LikeMatcher(::benchmark::State& state) {
+  const char* pattern = kPatterns[state.range(0)];
+  const std::vector<std::string> inputs = MakeInputs(state.range(1));
+  std::unique_ptr<const LikeMatcher> matcher =
+      LikeMatcher::Create(pattern, TYPE_STRING).value();
+  for (auto s : state) {
+    for (const std::string& input : inputs) {
+      ::benchmark::DoNotOptimize(matcher->Match(input));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumInputs);
+  state.SetLabel(pattern);
+}
+BENCHMARK(BM_LikeMatcher)->ArgsProduct({{0, 1, 2, 3, 4}, {32, 1024}});
+
+// Arguments: index into kPatterns, input length.
+static void BM_LikeRegexp(::benchmark::State& state) {
+  const char* pattern = kPatterns[state.range(0)];
+  const std::vector<std::string> inputs = MakeInputs(state.range(1));
+  std::unique_ptr<RE2> regexp;
+  ZETASQL_CHECK_OK(CreateLikeRegexp(pattern, TYPE_STRING, &regexp));
+  for (auto s : state) {
+    for (const std::string& input : inputs) {
+      ::benchmark::DoNotOptimize(RE2::FullMatch(input, *regexp));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumInputs);
+  state.SetLabel(pattern);
+}
+BENCHMARK(BM_LikeRegexp)->ArgsProduct({{0, 1, 2, 3, 4}, {32, 1024}});
+
+// Cost of classifying and compiling a pattern, paid per distinct pattern.
+static void BM_LikeMatcherCreate(::benchmark::State& state) {
+  const char* pattern = kPatterns[state.range(0)];
+  for (auto s : state) {
+    ::benchmark::DoNotOptimize(LikeMatcher::Create(pattern, TYPE_STRING));
+  }
+  state.SetLabel(pattern);
+}
+BENCHMARK(BM_LikeMatcherCreate)->DenseRange(0, 4);
+
+}  // namespace functions
+}  // namespace zetasql
@@ -17,9 +17,13 @@
 #include "zetasql/public/functions/like.h"
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/escaping.h"
 #include "absl/strings/substitute.h"
 #include "re2/re2.h"
 #include "zetasql/base/status.h"
@@ -142,6 +146,18 @@ TEST_P(LikeMatchTest, MatchTest) {
   ASSERT_EQ(params.expected_outcome, RE2::FullMatch(params.input, *re));
 }
 
+TEST_P(LikeMatchTest, LikeMatcherMatchTest) {
+  const LikeMatchTestParams& params = GetParam();
+
+  SCOPED_TRACE(absl::Substitute("Matching pattern \"$0\" with string \"$1\"",
+                                params.pattern, params.input));
+  absl::StatusOr<std::unique_ptr<const LikeMatcher>> matcher =
+      LikeMatcher::Create(params.pattern, params.type);
+  ASSERT_TRUE(matcher.ok()) << matcher.status();
+
+  ASSERT_EQ(params.expected_outcome, (*matcher)->Match(params.input));
+}
+
 TEST(LikeTest, BadPatternUTF8) {
   std::unique_ptr<RE2> re;
   absl::Status status = CreateLikeRegexp("\xC2", TYPE_STRING, &re);
@@ -158,5 +174,109 @@ TEST(LikeTest, BadPatternEscape) {
   EXPECT_EQ(absl::StatusCode::kOutOfRange, status.code());
 }
 
+TEST(LikeMatcherTest, ClassifiesPatterns) {
+  struct {
+    const char* pattern;
+    LikeMatcher::Kind kind;
+    const char* literal;
+  } test_cases[] = {
+      {"", LikeMatcher::Kind::kExact, ""},
+      {"abc", LikeMatcher::Kind::kExact, "abc"},
+      {"a\\%c", LikeMatcher::Kind::kExact, "a%c"},
+      {"abc%", LikeMatcher::Kind::kPrefix, "abc"},
+      {"abc%%", LikeMatcher::Kind::kPrefix, "abc"},
+      {"%abc", LikeMatcher::Kind::kSuffix, "abc"},
+      {"%\\_abc", LikeMatcher::Kind::kSuffix, "_abc"},
+      {"%abc%", LikeMatcher::Kind::kSubstring, "abc"},
+      {"%%abc%%", LikeMatcher::Kind::kSubstring, "abc"},
+      {"%фюы%", LikeMatcher::Kind::kSubstring, "фюы"},
+      {"%", LikeMatcher::Kind::kMatchAll, ""},
+      {"%%%", LikeMatcher::Kind::kMatchAll, ""},
+      {"a_c", LikeMatcher::Kind::kRegexp, ""},
+      {"a%c", LikeMatcher::Kind::kRegexp, ""},
+      {"%a%c%", LikeMatcher::Kind::kRegexp, ""},
+      {"_%", LikeMatcher::Kind::kRegexp, ""},
+  };
+  for (const auto& test_case : test_cases) {
+    SCOPED_TRACE(test_case.pattern);
+    for (TypeKind type : {TYPE_STRING, TYPE_BYTES}) {
+      absl::StatusOr<std::unique_ptr<const LikeMatcher>> matcher =
+          LikeMatcher::Create(test_case.pattern, type);
+      ASSERT_TRUE(matcher.ok()) << matcher.status();
+      EXPECT_EQ((*matcher)->kind(), test_case.kind);
+      EXPECT_EQ((*matcher)->literal(), test_case.literal);
+    }
+  }
+}
+
+// LikeMatcher must agree with the regexp from CreateLikeRegexp() on every
+// input, including STRING inputs that are not valid UTF-8.
+TEST(LikeMatcherTest, AgreesWithRegexp) {
+  const std::vector<std::string> patterns = {
+      "", "%", "%%", "a", "ab", "ab%", "%ab", "%ab%", "%b%", "%\\%%",
+      "ф", "ф%", "%ф", "%ф%", "%\xC3\xA9%", "\xC3\xA9%", "\\_%", "a_",
+  };
+  const std::vector<std::string> texts = {
+      "",
+      "a",
+      "ab",
+      "abab",
+      "xaby",
+      "%",
+      "_x",
+      "ф",
+      "фa",
+      "aф",
+      "xфy",
+      "\xC3\xA9",
+      "ab\xC3\xA9ab",
+      // Invalid UTF-8 around otherwise matching text.
+      "ab\xFF",
+      "\xFFab",
+      "x\xC3ab",
+      "ab\xC0\x80",
+      "ab\xE0\x80",
+      "\xC3\xA9\xA9",
+      // Sequences RE2 treats as characters despite not being well-formed.
+      "ab\xED\xA0\x80",
+      "\xE0\x80\x80ab",
+      "ab\xF4\x90\x80\x80",
+      "ab\xF5\x80\x80\x80",
+      // Long inputs exercise the 8-byte ASCII scan.
+      "abcdefghijklmnopqrstuvwxyz0123456789ab",
+      "abcdefghijklmnopqrstuvwxyz0123456789\xFFab",
+  };
+  for (TypeKind type : {TYPE_STRING, TYPE_BYTES}) {
+    for (const std::string& pattern : patterns) {
+      std::unique_ptr<RE2> regexp;
+      ASSERT_TRUE(CreateLikeRegexp(pattern, type, &regexp).ok()) << pattern;
+      absl::StatusOr<std::unique_ptr<const LikeMatcher>> matcher =
+          LikeMatcher::Create(pattern, type);
+      ASSERT_TRUE(matcher.ok()) << matcher.status();
+      for (const std::string& text : texts) {
+        EXPECT_EQ((*matcher)->Match(text), RE2::FullMatch(text, *regexp))
+            << "pattern: \"" << absl::CHexEscape(pattern) << "\" text: \""
+            << absl::CHexEscape(text) << "\" type: " << TypeKind_Name(type);
+      }
+    }
+  }
+}
+
+TEST(LikeMatcherTest, BadPatterns) {
+  for (const char* pattern : {"\xC2", "%\xC2%", "abc\xFF%", "\\", "abc%\\"}) {
+    SCOPED_TRACE(absl::CHexEscape(pattern));
+    absl::StatusOr<std::unique_ptr<const LikeMatcher>> matcher =
+        LikeMatcher::Create(pattern, TYPE_STRING);
+    ASSERT_FALSE(matcher.ok());
+    EXPECT_EQ(absl::StatusCode::kOutOfRange, matcher.status().code());
+  }
+  // Not valid UTF-8, but fine for BYTES.
+  absl::StatusOr<std::unique_ptr<const LikeMatcher>> matcher =
+      LikeMatcher::Create("%\xC2%", TYPE_BYTES);
+  ASSERT_TRUE(matcher.ok());
+  EXPECT_EQ((*matcher)->kind(), LikeMatcher::Kind::kSubstring);
+  EXPECT_TRUE((*matcher)->Match("a\xC2"));
+}
+
 }  // namespace functions
 }  // namespace zetasql
@@ -201,6 +201,17 @@ bool Utf8Trimmer::Initialize(absl::string_view to_trim, absl::Status* error) {
   if (!CheckAndCastStrLength(to_trim, &str_length32, error)) {
     return false;
   }
+  if (SpanAscii(to_trim) == to_trim.length()) {
+    unicode_set_.reset();
+    has_explicit_replacement_char_ = false;
+    ascii_only_ = true;
+    memset(ascii_to_trim_, 0, sizeof(ascii_to_trim_));
+    for (const char ch : to_trim) {
+      ascii_to_trim_[static_cast<uint8_t>(ch)] = true;
+    }
+    return true;
+  }
+  ascii_only_ = false;
   unicode_set_ = std::make_unique<icu::UnicodeSet>();
   has_explicit_replacement_char_ = false;
   int32_t offset = 0;
@@ -220,6 +231,12 @@ bool Utf8Trimmer::Initialize(absl::string_view to_trim, absl::Status* error) {
   return true;
 }
 
+// Returns whether <ch> is an ASCII character marked in <ascii_set>.
+static bool IsAsciiIn(const bool (&ascii_set)[128], char ch) {
+  const uint8_t byte = static_cast<uint8_t>(ch);
+  return byte < 0x80 && ascii_set[byte];
+}
+
 // Implementation of trim left which takes a lambda to compute whether the
 // Unicode character should be trimmed.
 // Note: UChar32 means "Unicode chararacter 32-bit", and is signed.
@@ -252,6 +269,19 @@ static bool TrimRightImpl(absl::string_view str,
 
 bool Utf8Trimmer::TrimLeft(absl::string_view str, absl::string_view* out,
                            absl::Status* error) const {
+  if (ascii_only_) {
+    int32_t str_length32;
+    if (!CheckAndCastStrLength(str, &str_length32, error)) {
+      return false;
+    }
+    size_t prefix_length = 0;
+    while (prefix_length < str.length() &&
+           IsAsciiIn(ascii_to_trim_, str[prefix_length])) {
+      ++prefix_length;
+    }
+    *out = str.substr(prefix_length);
+    return true;
+  }
   if (unicode_set_ == nullptr) {
     // Not initialized, no characters are trimmed. Return input.
     *out = str;
@@ -266,6 +296,19 @@ bool Utf8Trimmer::TrimLeft(absl::string_view str, absl::string_view* out,
 
 bool Utf8Trimmer::TrimRight(absl::string_view str, absl::string_view* out,
                             absl::Status* error) const {
+  if (ascii_only_) {
+    int32_t str_length32;
+    if (!CheckAndCastStrLength(str, &str_length32, error)) {
+      return false;
+    }
+    size_t suffix_start = str.length();
+    while (suffix_start > 0 &&
+           IsAsciiIn(ascii_to_trim_, str[suffix_start - 1])) {
+      --suffix_start;
+    }
+    *out = str.substr(0, suffix_start);
+    return true;
+  }
   if (unicode_set_ == nullptr) {
     // Not initialized, no characters are trimmed. Return input.
     *out = str;
@@ -412,8 +455,9 @@ bool LengthUtf8(absl::string_view str, int64_t* out, absl::Status* error) {
     return false;
   }
 
-  int utf8_length = 0;
-  int32_t offset = 0;
+  // Skip the ASCII prefix, where each byte is one character.
+  int32_t offset = static_cast<int32_t>(SpanAscii(str));
+  int utf8_length = offset;
   while (offset < str_length32) {
     UChar32 character;
     U8_NEXT(str.data(), offset, str_length32, character);
@@ -462,8 +506,29 @@ bool TrimSpacesUtf8(absl::string_view str, absl::string_view* out,
          RightTrimSpacesUtf8(intermediate, out, error);
 }
 
+// The ASCII characters with the Unicode White_Space property are exactly those
+// matched by absl::ascii_isspace(). LeftTrimSpacesUtf8() and
+// RightTrimSpacesUtf8() trim these without ICU, and only fall back to it when
+// they reach a non-ASCII character, which might be whitespace too.
+static bool IsAsciiSpace(char ch) {
+  return static_cast<uint8_t>(ch) < 0x80 && absl::ascii_isspace(ch);
+}
+
 bool LeftTrimSpacesUtf8(absl::string_view str, absl::string_view* out,
                         absl::Status* error) {
+  int32_t str_length32;
+  if (!CheckAndCastStrLength(str, &str_length32, error)) {
+    return false;
+  }
+  size_t prefix_length = 0;
+  while (prefix_length < str.length() && IsAsciiSpace(str[prefix_length])) {
+    ++prefix_length;
+  }
+  str.remove_prefix(prefix_length);
+  if (str.empty() || static_cast<uint8_t>(str[0]) < 0x80) {
+    *out = str;
+    return true;
+  }
   icu::ErrorCode cannot_fail;
   const icu::UnicodeSet* whitespace_unicode_set = icu::UnicodeSet::fromUSet(
       u_getBinaryPropertySet(UCHAR_WHITE_SPACE, cannot_fail));
@@ -472,6 +537,20 @@ bool LeftTrimSpacesUtf8(absl::string_view str, absl::string_view* out,
 
 bool RightTrimSpacesUtf8(absl::string_view str, absl::string_view* out,
                          absl::Status* error) {
+  int32_t str_length32;
+  if (!CheckAndCastStrLength(str, &str_length32, error)) {
+    return false;
+  }
+  size_t suffix_length = 0;
+  while (suffix_length < str.length() &&
+         IsAsciiSpace(str[str.length() - 1 - suffix_length])) {
+    ++suffix_length;
+  }
+  str.remove_suffix(suffix_length);
+  if (str.empty() || static_cast<uint8_t>(str.back()) < 0x80) {
+    *out = str;
+    return true;
+  }
   icu::ErrorCode cannot_fail;
   const icu::UnicodeSet* whitespace_unicode_set = icu::UnicodeSet::fromUSet(
       u_getBinaryPropertySet(UCHAR_WHITE_SPACE, cannot_fail));
@@ -572,7 +651,14 @@ bool SubstrUtf8(absl::string_view str, int64_t pos, absl::string_view* out,
 static bool ForwardN(absl::string_view str, int32_t str_length32,
                      int64_t num_code_points, int32_t* str_offset,
                      bool* hit_end, absl::Status* error) {
+  // Skip the ASCII prefix, where each byte is one character.
   int64_t i = 0;
+  if (num_code_points > 0 && *str_offset < str_length32) {
+    const int64_t max_length =
+        std::min<int64_t>(num_code_points, str_length32 - *str_offset);
+    i = SpanAscii(str.substr(*str_offset, static_cast<size_t>(max_length)));
+    *str_offset += static_cast<int32_t>(i);
+  }
   for (; i < num_code_points && *str_offset < str_length32; ++i) {
     UChar32 character;
     U8_NEXT(str.data(), *str_offset, str_length32, character);
@@ -592,6 +678,11 @@ static bool BackN(absl::string_view str, int64_t num_code_points,
                   int32_t* str_offset, bool* hit_start, absl::Status* error) {
   int64_t i = 0;
   for (; i<num_code_points&& * str_offset> 0; ++i) {
+    if (static_cast<uint8_t>(str[*str_offset - 1]) < 0x80) {
+      // An ASCII byte is always a complete character.
+      --*str_offset;
+      continue;
+    }
     UChar32 character;
     U8_PREV(str.data(), 0, *str_offset, character);
 
@@ -990,6 +1081,12 @@ bool UpperUtf8(absl::string_view str, std::string* out, absl::Status* error) {
   if (!CheckAndCastStrLength(str, &str_length32, error)) {
     return false;
   }
+  // Case mapping an ASCII string only changes 'a'-'z'. Mixed strings must go
+  // through ICU as a whole, since mappings such as the Greek final sigma
+  // depend on the surrounding characters.
+  if (SpanAscii(str) == str.length()) {
+    return UpperBytes(str, out, error);
+  }
   out->clear();
   out->reserve(str.length());
 
@@ -1014,6 +1111,10 @@ bool LowerUtf8(absl::string_view str, std::string* out, absl::Status* error) {
   if (!CheckAndCastStrLength(str, &str_length32, error)) {
     return false;
   }
+  // See UpperUtf8().
+  if (SpanAscii(str) == str.length()) {
+    return LowerBytes(str, out, error);
+  }
   out->clear();
   out->reserve(str.length());
 
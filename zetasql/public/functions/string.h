@@ -165,6 +165,11 @@ class Utf8Trimmer {
   // ill-formed).  We do this conditionally, as it is more expensive, since
   // it requires two passes over the input.
   bool has_explicit_replacement_char_ = false;
+  // Set instead of <unicode_set_> when every character to trim is ASCII, the
+  // common case, which needs neither ICU nor UTF-8 decoding: such characters
+  // are never part of a multi-byte sequence.
+  bool ascii_only_ = false;
+  bool ascii_to_trim_[128] = {};
 };
 
 // This class allows for a more efficient implementation of TRIM(), LTRIM()
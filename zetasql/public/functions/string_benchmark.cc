@@ -0,0 +1,170 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Measures the UTF-8 string functions on ASCII input, which takes the ASCII
+// fast paths, and on input with non-ASCII characters, which does not.
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "zetasql/public/functions/string.h"
+#include "benchmark/benchmark.h"
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+
+namespace zetasql {
+namespace functions {
+
+static constexpr int kNumInputs = 64;
+
+// Returns inputs of <length> bytes surrounded by two spaces on each side. If
+// <non_ascii> is set, every tenth character is a two byte 'é'.
+static std::vector<std::string> MakeInputs(int length, bool non_ascii) {
+  std::vector<std::string> inputs;
+  for (int i = 0; i < kNumInputs; ++i) {
+    std::string input = "  ";
+    while (input.size() < static_cast<size_t>(length) + 2) {
+      if (non_ascii && input.size() % 10 == 0) {
+        input.append("\xC3\xA9");
+      } else {
+        input.push_back('a' + (i + input.size()) % 26);
+      }
+    }
+    input.append("  ");
+    inputs.push_back(std::move(input));
+  }
+  return inputs;
+}
+
+// All of the benchmarks below take two arguments: the input length and
+// whether the input has non-ASCII characters.
+
+static void BM_LengthUtf8(::benchmark::State& state) {
+  const std::vector<std::string> inputs =
+      MakeInputs(state.range(0), state.range(1));
+  absl::Status error;
+  for (auto s : state) {
+    for (const std::string& input : inputs) {
+      int64_t length;
+      ::benchmark::DoNotOptimize(LengthUtf8(input, &length, &error));
+      ::benchmark::DoNotOptimize(length);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumInputs);
+}
+BENCHMARK(BM_LengthUtf8)->ArgsProduct({{16, 1024}, {0, 1}});
+
+// SUBSTR(input, 6, 8) and SUBSTR(input, -8, 4).
+static void BM_SubstrUtf8(::benchmark::State& state) {
+  const std::vector<std::string> inputs =
+      MakeInputs(state.range(0), state.range(1));
+  absl::Status error;
+  for (auto s : state) {
+    for (const std::string& input : inputs) {
+      absl::string_view out;
+      ::benchmark::DoNotOptimize(
+          SubstrWithLengthUtf8(input, 6, 8, &out, &error));
+      ::benchmark::DoNotOptimize(out);
+      ::benchmark::DoNotOptimize(
+          SubstrWithLengthUtf8(input, -8, 4, &out, &error));
+      ::benchmark::DoNotOptimize(out);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumInputs);
+}
+BENCHMARK(BM_SubstrUtf8)->ArgsProduct({{16, 1024}, {0, 1}});
+
+static void BM_UpperUtf8(::benchmark::State& state) {
+  const std::vector<std::string> inputs =
+      MakeInputs(state.range(0), state.range(1));
+  absl::Status error;
+  std::string out;
+  for (auto s : state) {
+    for (const std::string& input : inputs) {
+      ::benchmark::DoNotOptimize(UpperUtf8(input, &out, &error));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumInputs);
+}
+BENCHMARK(BM_UpperUtf8)->ArgsProduct({{16, 1024}, {0, 1}});
+
+static void BM_LowerUtf8(::benchmark::State& state) {
+  const std::vector<std::string> inputs =
+      MakeInputs(state.range(0), state.range(1));
+  absl::Status error;
+  std::string out;
+  for (auto s : state) {
+    for (const std::string& input : inputs) {
+      ::benchmark::DoNotOptimize(LowerUtf8(input, &out, &error));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumInputs);
+}
+BENCHMARK(BM_LowerUtf8)->ArgsProduct({{16, 1024}, {0, 1}});
+
+static void BM_TrimSpacesUtf8(::benchmark::State& state) {
+  const std::vector<std::string> inputs =
+      MakeInputs(state.range(0), state.range(1));
+  absl::Status error;
+  for (auto s : state) {
+    for (const std::string& input : inputs) {
+      absl::string_view out;
+      ::benchmark::DoNotOptimize(TrimSpacesUtf8(input, &out, &error));
+      ::benchmark::DoNotOptimize(out);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumInputs);
+}
+BENCHMARK(BM_TrimSpacesUtf8)->ArgsProduct({{16, 1024}, {0, 1}});
+
+// TRIM(input, ' a') with a trimmer initialized once, as for a constant
+// argument.
+static void BM_Utf8Trimmer(::benchmark::State& state) {
+  const std::vector<std::string> inputs =
+      MakeInputs(state.range(0), state.range(1));
+  absl::Status error;
+  Utf8Trimmer trimmer;
+  trimmer.Initialize(" a", &error);
+  for (auto s : state) {
+    for (const std::string& input : inputs) {
+      absl::string_view out;
+      ::benchmark::DoNotOptimize(trimmer.Trim(input, &out, &error));
+      ::benchmark::DoNotOptimize(out);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumInputs);
+}
+BENCHMARK(BM_Utf8Trimmer)->ArgsProduct({{16, 1024}, {0, 1}});
+
+// LPAD(input, length + 8, '-').
+static void BM_LeftPadUtf8(::benchmark::State& state) {
+  const std::vector<std::string> inputs =
+      MakeInputs(state.range(0), state.range(1));
+  absl::Status error;
+  std::string out;
+  for (auto s : state) {
+    for (const std::string& input : inputs) {
+      ::benchmark::DoNotOptimize(
+          LeftPadUtf8(input, state.range(0) + 8, "-", &out, &error));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumInputs);
+}
+BENCHMARK(BM_LeftPadUtf8)->ArgsProduct({{16, 1024}, {0, 1}});
+
+}  // namespace functions
+}  // namespace zetasql
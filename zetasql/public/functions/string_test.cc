@@ -602,11 +602,42 @@ TEST(Trim, Utf8) {
   TestUtf8Trimmer(trimmer, "", "", "", "");
   TestUtf8Trimmer(trimmer, "abc", "", "", "");
   TestUtf8Trimmer(trimmer, "бч", "бч", "бч", "бч");
+  TestUtf8Trimmer(trimmer, "abбca", "бca", "abб", "б");
   // It is undefined behavior what we chose to do on ill formed strings, in this
   // case, we don't detect that we have an ill formed string.
   TestUtf8Trimmer(trimmer, kIllFormed, kIllFormed, kIllFormed, kIllFormed);
 }
 
+TEST(TrimSpaces, Utf8) {
+  absl::Status error;
+  absl::string_view out;
+  EXPECT_TRUE(TrimSpacesUtf8(" \t\n\v\f\rabc \r\n", &out, &error));
+  EXPECT_EQ(out, "abc");
+  // Non-ASCII whitespace next to ASCII whitespace.
+  EXPECT_TRUE(TrimSpacesUtf8(" \u00a0 \u3000abc\u2003 \u00a0", &out, &error));
+  EXPECT_EQ(out, "abc");
+  // Control characters other than \t through \r are not whitespace.
+  EXPECT_TRUE(TrimSpacesUtf8("\x1c abc \x1f", &out, &error));
+  EXPECT_EQ(out, "\x1c abc \x1f");
+  ZETASQL_EXPECT_OK(error);
+}
+
+TEST(UpperLower, Utf8) {
+  absl::Status error;
+  std::string out;
+  EXPECT_TRUE(UpperUtf8("Hello, World! 123", &out, &error));
+  EXPECT_EQ(out, "HELLO, WORLD! 123");
+  EXPECT_TRUE(LowerUtf8("Hello, World! 123", &out, &error));
+  EXPECT_EQ(out, "hello, world! 123");
+  // Mixed strings are mapped as a whole: the final sigma depends on the
+  // preceding ASCII letter.
+  EXPECT_TRUE(LowerUtf8("AΣ", &out, &error));
+  EXPECT_EQ(out, "aς");
+  EXPECT_TRUE(UpperUtf8("straße", &out, &error));
+  EXPECT_EQ(out, "STRASSE");
+  ZETASQL_EXPECT_OK(error);
+}
+
 TEST(Split, Utf8) {
   absl::Status error;
   std::vector<std::string> result;
@@ -23,7 +23,9 @@
 #include <stdint.h>
 
 #include <algorithm>
+#include <cstring>
 #include <iterator>
+#include <limits>
 #include <memory>
 #include <optional>
 #include <queue>
@@ -34,19 +36,24 @@
 #include <vector>
 
 
+#include "zetasql/base/endian.h"
 #include "zetasql/base/logging.h"
+#include "zetasql/common/json_structural_index.h"
 #include "zetasql/public/numeric_parser.h"
 #include <cstdint>  
 #include "absl/base/optimization.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_split.h"
 #include "absl/strings/string_view.h"
 #include "absl/strings/substitute.h"
+#include "absl/types/span.h"
 #include "single_include/nlohmann/json.hpp"
 #include "zetasql/base/map_util.h"
 #include "zetasql/base/ret_check.h"
+#include "zetasql/base/status.h"
 #include "zetasql/base/status_builder.h"
 #include "zetasql/base/status_macros.h"
 
@@ -220,6 +227,580 @@ class JSONValueBuilder {
   JSON* object_member_ = nullptr;
 };
 
+// The CompactJSONValue encoding. Every value starts with a one byte tag,
+// followed by a little-endian payload:
+//   null, false, true:  no payload.
+//   int64, uint64, double: 8 bytes.
+//   string: uint32 size, then the bytes.
+//   array: uint32 count, one uint32 end offset per element, then the elements.
+//   object: uint32 count, one uint32 end offset per key, one uint32 end offset
+//       per value, then the keys, then the values. Keys are sorted and unique.
+// End offsets are relative to the start of the keys, values or elements, so
+// every value is self-delimiting and can be referenced by its first byte.
+namespace compact {
+
+enum Tag : char {
+  kNull = 0,
+  kFalse = 1,
+  kTrue = 2,
+  kInt64 = 3,
+  kUInt64 = 4,
+  kDouble = 5,
+  kString = 6,
+  kArray = 7,
+  kObject = 8,
+};
+
+constexpr size_t kMaxOffset = std::numeric_limits<uint32_t>::max();
+
+absl::Status DocumentTooLargeError() {
+  return absl::OutOfRangeError("JSON document is too large");
+}
+
+inline uint32_t LoadUInt32(const char* p) {
+  return zetasql_base::LittleEndian::Load32(p);
+}
+
+inline void AppendUInt32(uint32_t value, std::string* output) {
+  char buffer[sizeof(value)];
+  zetasql_base::LittleEndian::Store32(buffer, value);
+  output->append(buffer, sizeof(buffer));
+}
+
+inline void AppendUInt64(Tag tag, uint64_t value, std::string* output) {
+  char buffer[1 + sizeof(value)];
+  buffer[0] = tag;
+  zetasql_base::LittleEndian::Store64(buffer + 1, value);
+  output->append(buffer, sizeof(buffer));
+}
+
+inline void AppendDouble(double value, std::string* output) {
+  uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  AppendUInt64(kDouble, bits, output);
+}
+
+inline void AppendString(absl::string_view value, std::string* output) {
+  output->push_back(kString);
+  AppendUInt32(static_cast<uint32_t>(value.size()), output);
+  output->append(value.data(), value.size());
+}
+
+inline Tag GetTag(const char* value) { return static_cast<Tag>(*value); }
+
+inline uint32_t GetCount(const char* container) {
+  return LoadUInt32(container + 1);
+}
+
+inline uint64_t GetUInt64Payload(const char* value) {
+  return zetasql_base::LittleEndian::Load64(value + 1);
+}
+
+inline double GetDoublePayload(const char* value) {
+  const uint64_t bits = GetUInt64Payload(value);
+  double result;
+  std::memcpy(&result, &bits, sizeof(result));
+  return result;
+}
+
+inline absl::string_view GetStringPayload(const char* value) {
+  return absl::string_view(value + 5, LoadUInt32(value + 1));
+}
+
+// Returns the start of the end offset table of an array, or of the key end
+// offset table of an object.
+inline const char* GetEnds(const char* container) { return container + 5; }
+
+// Returns the start of the elements of an array with 'count' elements.
+inline const char* GetElements(const char* array, uint32_t count) {
+  return array + 5 + 4 * static_cast<size_t>(count);
+}
+
+// Returns the start of the keys of an object with 'count' members.
+inline const char* GetKeys(const char* object, uint32_t count) {
+  return object + 5 + 8 * static_cast<size_t>(count);
+}
+
+// Returns the start of the values of an object with 'count' members.
+inline const char* GetValues(const char* object, uint32_t count) {
+  return GetKeys(object, count) +
+         (count == 0 ? 0 : LoadUInt32(GetEnds(object) + 4 * (count - 1)));
+}
+
+inline uint32_t GetStart(const char* ends, uint32_t index) {
+  return index == 0 ? 0 : LoadUInt32(ends + 4 * (index - 1));
+}
+
+inline const char* GetArrayElement(const char* array, uint32_t index) {
+  return GetElements(array, GetCount(array)) + GetStart(GetEnds(array), index);
+}
+
+inline absl::string_view GetObjectKey(const char* object, uint32_t index) {
+  const char* ends = GetEnds(object);
+  const uint32_t start = GetStart(ends, index);
+  return absl::string_view(GetKeys(object, GetCount(object)) + start,
+                           LoadUInt32(ends + 4 * index) - start);
+}
+
+inline const char* GetObjectValue(const char* object, uint32_t index) {
+  const uint32_t count = GetCount(object);
+  return GetValues(object, count) +
+         GetStart(GetEnds(object) + 4 * count, index);
+}
+
+// Returns the number of bytes of the encoding of 'value'.
+size_t GetEncodedSize(const char* value) {
+  switch (GetTag(value)) {
+    case kNull:
+    case kFalse:
+    case kTrue:
+      return 1;
+    case kInt64:
+    case kUInt64:
+    case kDouble:
+      return 9;
+    case kString:
+      return 5 + LoadUInt32(value + 1);
+    case kArray: {
+      const uint32_t count = GetCount(value);
+      return (GetElements(value, count) - value) +
+             GetStart(GetEnds(value), count);
+    }
+    case kObject: {
+      const uint32_t count = GetCount(value);
+      return (GetValues(value, count) - value) +
+             GetStart(GetEnds(value) + 4 * count, count);
+    }
+  }
+  ABSL_LOG(FATAL) << "Invalid compact JSON encoding";
+}
+
+// Returns the index of the member of 'object' with the given 'key', if any.
+std::optional<uint32_t> FindMember(const char* object, absl::string_view key) {
+  uint32_t low = 0;
+  uint32_t high = GetCount(object);
+  while (low < high) {
+    const uint32_t middle = low + (high - low) / 2;
+    const int comparison = GetObjectKey(object, middle).compare(key);
+    if (comparison == 0) {
+      return middle;
+    }
+    if (comparison < 0) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return std::nullopt;
+}
+
+// Appends an array whose encoded elements are the consecutive ranges of
+// 'data' that end at 'ends'.
+absl::Status AppendArray(absl::string_view data,
+                         absl::Span<const uint32_t> ends, std::string* output) {
+  if (ends.size() > kMaxOffset) {
+    return DocumentTooLargeError();
+  }
+  output->reserve(output->size() + 5 + 4 * ends.size() + data.size());
+  output->push_back(kArray);
+  AppendUInt32(static_cast<uint32_t>(ends.size()), output);
+  for (uint32_t end : ends) {
+    AppendUInt32(end, output);
+  }
+  output->append(data.data(), data.size());
+  return absl::OkStatus();
+}
+
+// Appends an object with the given 'keys', whose encoded values are the
+// consecutive ranges of 'data' that end at 'ends'. Of duplicate keys, the
+// first one is kept.
+absl::Status AppendObject(absl::Span<const std::string> keys,
+                          absl::string_view data,
+                          absl::Span<const uint32_t> ends,
+                          std::string* output) {
+  std::vector<uint32_t> order(keys.size());
+  for (uint32_t i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  std::stable_sort(order.begin(), order.end(), [keys](uint32_t a, uint32_t b) {
+    return keys[a] < keys[b];
+  });
+  order.erase(std::unique(order.begin(), order.end(),
+                          [keys](uint32_t a, uint32_t b) {
+                            return keys[a] == keys[b];
+                          }),
+              order.end());
+
+  size_t keys_size = 0;
+  for (uint32_t index : order) {
+    keys_size += keys[index].size();
+  }
+  if (keys_size > kMaxOffset) {
+    return DocumentTooLargeError();
+  }
+  output->reserve(output->size() + 5 + 8 * order.size() + keys_size +
+                  data.size());
+  output->push_back(kObject);
+  AppendUInt32(static_cast<uint32_t>(order.size()), output);
+  uint32_t end = 0;
+  for (uint32_t index : order) {
+    end += static_cast<uint32_t>(keys[index].size());
+    AppendUInt32(end, output);
+  }
+  end = 0;
+  for (uint32_t index : order) {
+    end += ends[index] - (index == 0 ? 0 : ends[index - 1]);
+    AppendUInt32(end, output);
+  }
+  for (uint32_t index : order) {
+    output->append(keys[index]);
+  }
+  for (uint32_t index : order) {
+    const uint32_t start = index == 0 ? 0 : ends[index - 1];
+    output->append(data.data() + start, ends[index] - start);
+  }
+  return absl::OkStatus();
+}
+
+// Appends the encoding of a JSONValue tree.
+void AppendTree(const JSON& value, std::string* output) {
+  switch (value.type()) {
+    case JSON::value_t::null:
+    case JSON::value_t::discarded:
+    case JSON::value_t::binary:
+      output->push_back(kNull);
+      return;
+    case JSON::value_t::boolean:
+      output->push_back(value.get<bool>() ? kTrue : kFalse);
+      return;
+    case JSON::value_t::number_integer:
+      AppendUInt64(kInt64, static_cast<uint64_t>(value.get<int64_t>()),
+                   output);
+      return;
+    case JSON::value_t::number_unsigned:
+      AppendUInt64(kUInt64, value.get<uint64_t>(), output);
+      return;
+    case JSON::value_t::number_float:
+      AppendDouble(value.get<double>(), output);
+      return;
+    case JSON::value_t::string:
+      AppendString(value.get_ref<const std::string&>(), output);
+      return;
+    case JSON::value_t::array: {
+      std::string data;
+      std::vector<uint32_t> ends;
+      ends.reserve(value.size());
+      for (const JSON& element : value) {
+        AppendTree(element, &data);
+        ABSL_CHECK_LE(data.size(), kMaxOffset) << "JSON document is too large";
+        ends.push_back(static_cast<uint32_t>(data.size()));
+      }
+      ZETASQL_CHECK_OK(AppendArray(data, ends, output));
+      return;
+    }
+    case JSON::value_t::object: {
+      std::vector<std::string> keys;
+      std::string data;
+      std::vector<uint32_t> ends;
+      keys.reserve(value.size());
+      ends.reserve(value.size());
+      for (const auto& member : value.items()) {
+        keys.push_back(member.key());
+        AppendTree(member.value(), &data);
+        ABSL_CHECK_LE(data.size(), kMaxOffset) << "JSON document is too large";
+        ends.push_back(static_cast<uint32_t>(data.size()));
+      }
+      ZETASQL_CHECK_OK(AppendObject(keys, data, ends, output));
+      return;
+    }
+  }
+}
+
+// Returns the JSONValue tree of an encoded value.
+JSON ToTree(const char* value) {
+  switch (GetTag(value)) {
+    case kNull:
+      return JSON();
+    case kFalse:
+      return JSON(false);
+    case kTrue:
+      return JSON(true);
+    case kInt64:
+      return JSON(static_cast<int64_t>(GetUInt64Payload(value)));
+    case kUInt64:
+      return JSON(GetUInt64Payload(value));
+    case kDouble:
+      return JSON(GetDoublePayload(value));
+    case kString:
+      return JSON(std::string(GetStringPayload(value)));
+    case kArray: {
+      JSON array = JSON::array();
+      const uint32_t count = GetCount(value);
+      for (uint32_t i = 0; i < count; ++i) {
+        array.push_back(ToTree(GetArrayElement(value, i)));
+      }
+      return array;
+    }
+    case kObject: {
+      JSON object = JSON::object();
+      const uint32_t count = GetCount(value);
+      for (uint32_t i = 0; i < count; ++i) {
+        object.emplace(std::string(GetObjectKey(value, i)),
+                       ToTree(GetObjectValue(value, i)));
+      }
+      return object;
+    }
+  }
+  ABSL_LOG(FATAL) << "Invalid compact JSON encoding";
+}
+
+// Appends 'str' as a JSON string literal, escaped like JSON::dump() does.
+void AppendEscapedString(absl::string_view str, std::string* output) {
+  static constexpr char kHexDigits[] = "0123456789abcdef";
+  output->push_back('"');
+  size_t unescaped_start = 0;
+  for (size_t i = 0; i < str.size(); ++i) {
+    const unsigned char c = str[i];
+    if (c >= 0x20 && c != '"' && c != '\\') {
+      continue;
+    }
+    output->append(str.data() + unescaped_start, i - unescaped_start);
+    unescaped_start = i + 1;
+    switch (c) {
+      case '"':
+        output->append("\\\"");
+        break;
+      case '\\':
+        output->append("\\\\");
+        break;
+      case '\b':
+        output->append("\\b");
+        break;
+      case '\f':
+        output->append("\\f");
+        break;
+      case '\n':
+        output->append("\\n");
+        break;
+      case '\r':
+        output->append("\\r");
+        break;
+      case '\t':
+        output->append("\\t");
+        break;
+      default:
+        output->append("\\u00");
+        output->push_back(kHexDigits[c >> 4]);
+        output->push_back(kHexDigits[c & 0xf]);
+        break;
+    }
+  }
+  output->append(str.data() + unescaped_start, str.size() - unescaped_start);
+  output->push_back('"');
+}
+
+// Appends the text of an encoded value. If 'indent' is negative the output is
+// compact, otherwise it is formatted like JSON::dump(indent) with
+// 'current_indent' spaces before the value's closing bracket.
+void AppendText(const char* value, int indent, int current_indent,
+                std::string* output) {
+  switch (GetTag(value)) {
+    case kNull:
+      output->append("null");
+      return;
+    case kFalse:
+      output->append("false");
+      return;
+    case kTrue:
+      output->append("true");
+      return;
+    case kInt64:
+      absl::StrAppend(output, static_cast<int64_t>(GetUInt64Payload(value)));
+      return;
+    case kUInt64:
+      absl::StrAppend(output, GetUInt64Payload(value));
+      return;
+    case kDouble:
+      // Share the shortest round-trip formatting of JSON::dump().
+      output->append(JSON(GetDoublePayload(value)).dump());
+      return;
+    case kString:
+      AppendEscapedString(GetStringPayload(value), output);
+      return;
+    case kArray:
+    case kObject: {
+      const bool is_object = GetTag(value) == kObject;
+      const uint32_t count = GetCount(value);
+      output->push_back(is_object ? '{' : '[');
+      if (count > 0) {
+        const int member_indent = indent < 0 ? -1 : current_indent + indent;
+        for (uint32_t i = 0; i < count; ++i) {
+          if (i > 0) output->push_back(',');
+          if (indent >= 0) {
+            output->push_back('\n');
+            output->append(member_indent, ' ');
+          }
+          const char* child;
+          if (is_object) {
+            AppendEscapedString(GetObjectKey(value, i), output);
+            output->append(indent < 0 ? ":" : ": ");
+            child = GetObjectValue(value, i);
+          } else {
+            child = GetArrayElement(value, i);
+          }
+          AppendText(child, indent, member_indent, output);
+        }
+        if (indent >= 0) {
+          output->push_back('\n');
+          output->append(current_indent, ' ');
+        }
+      }
+      output->push_back(is_object ? '}' : ']');
+      return;
+    }
+  }
+}
+
+// Returns true iff the nesting level of an encoded value exceeds
+// 'max_nesting'.
+bool NestingLevelExceedsMax(const char* value, int64_t max_nesting) {
+  const Tag tag = GetTag(value);
+  if (tag != kArray && tag != kObject) {
+    return false;
+  }
+  if (max_nesting == 0) {
+    return true;
+  }
+  const uint32_t count = GetCount(value);
+  for (uint32_t i = 0; i < count; ++i) {
+    const char* child = tag == kArray ? GetArrayElement(value, i)
+                                      : GetObjectValue(value, i);
+    if (NestingLevelExceedsMax(child, max_nesting - 1)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace compact
+
+// Builds the CompactJSONValue encoding of a JSON document from parser events,
+// without materializing a document tree. Values are appended to the buffer of
+// their enclosing container, which is encoded once it is complete.
+class CompactJSONValueBuilder {
+ public:
+  // Constructs a builder that sets 'output' to the encoding of the parsed
+  // document. 'max_nesting' is handled like in JSONValueBuilder.
+  CompactJSONValueBuilder(std::string& output, std::optional<int> max_nesting)
+      : output_(output), max_nesting_(max_nesting) {
+    if (max_nesting_.has_value() && *max_nesting_ < 0) {
+      max_nesting_ = 0;
+    }
+  }
+
+  absl::Status BeginObject() { return BeginContainer(/*is_object=*/true); }
+
+  absl::Status EndObject() {
+    Container& object = containers_[--depth_];
+    ZETASQL_RETURN_IF_ERROR(compact::AppendObject(object.keys, object.data,
+                                          object.ends, &BeginValue()));
+    return EndValue();
+  }
+
+  absl::Status BeginMember(const std::string& key) {
+    containers_[depth_ - 1].keys.push_back(key);
+    return absl::OkStatus();
+  }
+
+  absl::Status BeginArray() { return BeginContainer(/*is_object=*/false); }
+
+  absl::Status EndArray() {
+    Container& array = containers_[--depth_];
+    ZETASQL_RETURN_IF_ERROR(
+        compact::AppendArray(array.data, array.ends, &BeginValue()));
+    return EndValue();
+  }
+
+  absl::Status ParsedString(const std::string& str) {
+    compact::AppendString(str, &BeginValue());
+    return EndValue();
+  }
+
+  absl::Status ParsedInt(int64_t val) {
+    compact::AppendUInt64(compact::kInt64, static_cast<uint64_t>(val),
+                          &BeginValue());
+    return EndValue();
+  }
+
+  absl::Status ParsedUInt(uint64_t val) {
+    compact::AppendUInt64(compact::kUInt64, val, &BeginValue());
+    return EndValue();
+  }
+
+  absl::Status ParsedDouble(double val) {
+    compact::AppendDouble(val, &BeginValue());
+    return EndValue();
+  }
+
+  absl::Status ParsedBool(bool val) {
+    BeginValue().push_back(val ? compact::kTrue : compact::kFalse);
+    return EndValue();
+  }
+
+  absl::Status ParsedNull() {
+    BeginValue().push_back(compact::kNull);
+    return EndValue();
+  }
+
+ private:
+  struct Container {
+    std::string data;
+    std::vector<uint32_t> ends;
+    std::vector<std::string> keys;
+  };
+
+  absl::Status BeginContainer(bool is_object) {
+    if (max_nesting_.has_value() && depth_ >= *max_nesting_) {
+      return absl::OutOfRangeError(
+          absl::StrCat("Max nesting of ", *max_nesting_,
+                       " has been exceeded while parsing JSON document"));
+    }
+    // Containers are reused across siblings to keep their buffers.
+    if (depth_ == containers_.size()) {
+      containers_.emplace_back();
+    }
+    Container& container = containers_[depth_++];
+    container.data.clear();
+    container.ends.clear();
+    container.keys.clear();
+    return absl::OkStatus();
+  }
+
+  // Returns the buffer the next value is appended to.
+  std::string& BeginValue() {
+    return depth_ == 0 ? output_ : containers_[depth_ - 1].data;
+  }
+
+  // Records the end of a value appended to the enclosing container.
+  absl::Status EndValue() {
+    if (depth_ > 0) {
+      Container& container = containers_[depth_ - 1];
+      if (container.data.size() > compact::kMaxOffset) {
+        return compact::DocumentTooLargeError();
+      }
+      container.ends.push_back(static_cast<uint32_t>(container.data.size()));
+    }
+    return absl::OkStatus();
+  }
+
+  std::string& output_;
+  std::optional<int> max_nesting_;
+  // Containers being built, outermost first. Only the first 'depth_' are in
+  // use.
+  std::vector<Container> containers_;
+  size_t depth_ = 0;
+};
+
 // The base class for JSONValue parsers that provides status tracking.
 class JSONValueParserBase {
  public:
@@ -289,14 +870,17 @@ class JSONValueParserBase {
 };
 
 // The parser implementation that uses nlohmann library implementation based on
-// the JSON RFC.
+// the JSON RFC. 'ValueBuilder' is JSONValueBuilder or CompactJSONValueBuilder,
+// constructed from 'output'.
 //
 // NOTE: Method names are specific requirement of nlohmann SAX parser interface.
+template <typename ValueBuilder>
 class JSONValueStandardParser : public JSONValueParserBase {
  public:
-  JSONValueStandardParser(JSON& value, WideNumberMode wide_number_mode,
+  template <typename Output>
+  JSONValueStandardParser(Output& output, WideNumberMode wide_number_mode,
                           std::optional<int> max_nesting)
-      : value_builder_(value, max_nesting),
+      : value_builder_(output, max_nesting),
         wide_number_mode_(wide_number_mode) {}
   JSONValueStandardParser() = delete;
 
@@ -353,7 +937,7 @@ class JSONValueStandardParser : public JSONValueParserBase {
   bool is_errored() const { return !status().ok(); }
 
  private:
-  JSONValueBuilder value_builder_;
+  ValueBuilder value_builder_;
   const WideNumberMode wide_number_mode_;
 };
 
@@ -433,15 +1017,34 @@ class JSONValueStandardValidator : public JSONValueParserBase {
   int current_nesting_ = 0;
 };
 
+// Parses 'str' with a parser returned by 'make_parser', which must start from
+// an empty output each time it is called, and returns the parser's status.
+// Documents are parsed with the SIMD structural index first; any that it does
+// not accept are parsed again with the nlohmann parser, which reports the
+// exact error.
+template <typename MakeParser>
+absl::Status SaxParse(absl::string_view str, MakeParser make_parser) {
+  {
+    auto parser = make_parser();
+    if (ParseJSONWithStructuralIndex(str, &parser) !=
+        JSONStructuralParseResult::kNotAccepted) {
+      return parser.status();
+    }
+  }
+  auto parser = make_parser();
+  JSON::sax_parse(str, &parser);
+  return parser.status();
+}
+
 }  // namespace
 
 absl::Status IsValidJSON(absl::string_view str,
                          const JSONParsingOptions& parsing_options) {
-  JSONValueStandardValidator validator(
-      parsing_options.wide_number_mode == WideNumberMode::kExact,
-      parsing_options.max_nesting);
-  JSON::sax_parse(str, &validator);
-  return validator.status();
+  return SaxParse(str, [&parsing_options] {
+    return JSONValueStandardValidator(
+        parsing_options.wide_number_mode == WideNumberMode::kExact,
+        parsing_options.max_nesting);
+  });
 }
 
 // NOTE: DO NOT CHANGE THIS STRUCT. The JSONValueRef code assumes that
@@ -453,19 +1056,20 @@ struct JSONValue::Impl {
 StatusOr<JSONValue> JSONValue::ParseJSONString(
     absl::string_view str, JSONParsingOptions parsing_options) {
   JSONValue json;
-  JSONValueStandardParser parser(json.impl_->value,
-                                 parsing_options.wide_number_mode,
-                                 parsing_options.max_nesting);
-  JSON::sax_parse(str, &parser);
-  ZETASQL_RETURN_IF_ERROR(parser.status());
+  ZETASQL_RETURN_IF_ERROR(SaxParse(str, [&json, &parsing_options] {
+    json.impl_->value = JSON();
+    return JSONValueStandardParser<JSONValueBuilder>(
+        json.impl_->value, parsing_options.wide_number_mode,
+        parsing_options.max_nesting);
+  }));
   return json;
 }
 
 StatusOr<JSONValue> JSONValue::DeserializeFromProtoBytes(
     absl::string_view str, std::optional<int> max_nesting_level) {
   JSONValue json;
-  JSONValueStandardParser parser(json.impl_->value, WideNumberMode::kRound,
-                                 max_nesting_level);
+  JSONValueStandardParser<JSONValueBuilder> parser(
+      json.impl_->value, WideNumberMode::kRound, max_nesting_level);
   JSON::sax_parse(str, &parser, JSON::input_format_t::ubjson);
   ZETASQL_RETURN_IF_ERROR(parser.status());
   return json;
@@ -473,7 +1077,11 @@ StatusOr<JSONValue> JSONValue::DeserializeFromProtoBytes(
 
 JSONValue JSONValue::CopyFrom(JSONValueConstRef value) {
   JSONValue copy;
-  copy.impl_->value = value.impl_->value;
+  if (value.compact_ != nullptr) {
+    copy.impl_->value = compact::ToTree(value.compact_);
+  } else {
+    copy.impl_->value = value.impl_->value;
+  }
   return copy;
 }
 
@@ -506,22 +1114,93 @@ JSONValueConstRef JSONValue::GetConstRef() const {
   return JSONValueConstRef(impl_.get());
 }
 
+CompactJSONValue::CompactJSONValue()
+    : buffer_(1, static_cast<char>(compact::kNull)) {}
+
+JSONValueConstRef CompactJSONValue::GetConstRef() const {
+  return JSONValueConstRef(buffer_.data());
+}
+
+StatusOr<CompactJSONValue> CompactJSONValue::ParseJSONString(
+    absl::string_view str, JSONParsingOptions parsing_options) {
+  std::string buffer;
+  ZETASQL_RETURN_IF_ERROR(SaxParse(str, [&buffer, &parsing_options] {
+    buffer.clear();
+    return JSONValueStandardParser<CompactJSONValueBuilder>(
+        buffer, parsing_options.wide_number_mode, parsing_options.max_nesting);
+  }));
+  return CompactJSONValue(std::move(buffer));
+}
+
+CompactJSONValue CompactJSONValue::CopyFrom(JSONValueConstRef value) {
+  std::string buffer;
+  if (value.compact_ != nullptr) {
+    buffer.assign(value.compact_, compact::GetEncodedSize(value.compact_));
+  } else {
+    compact::AppendTree(value.impl_->value, &buffer);
+  }
+  return CompactJSONValue(std::move(buffer));
+}
+
 JSONValueConstRef::JSONValueConstRef(const JSONValue::Impl* value_pointer)
     : impl_(value_pointer) {}
 
-bool JSONValueConstRef::IsBoolean() const { return impl_->value.is_boolean(); }
+JSONValueConstRef::JSONValueConstRef(const char* compact_value)
+    : impl_(nullptr), compact_(compact_value) {}
 
-bool JSONValueConstRef::IsNumber() const { return impl_->value.is_number(); }
+bool JSONValueConstRef::IsBoolean() const {
+  if (compact_ != nullptr) {
+    const compact::Tag tag = compact::GetTag(compact_);
+    return tag == compact::kFalse || tag == compact::kTrue;
+  }
+  return impl_->value.is_boolean();
+}
+
+bool JSONValueConstRef::IsNumber() const {
+  if (compact_ != nullptr) {
+    const compact::Tag tag = compact::GetTag(compact_);
+    return tag == compact::kInt64 || tag == compact::kUInt64 ||
+           tag == compact::kDouble;
+  }
+  return impl_->value.is_number();
+}
 
-bool JSONValueConstRef::IsNull() const { return impl_->value.is_null(); }
+bool JSONValueConstRef::IsNull() const {
+  if (compact_ != nullptr) {
+    return compact::GetTag(compact_) == compact::kNull;
+  }
+  return impl_->value.is_null();
+}
 
-bool JSONValueConstRef::IsString() const { return impl_->value.is_string(); }
+bool JSONValueConstRef::IsString() const {
+  if (compact_ != nullptr) {
+    return compact::GetTag(compact_) == compact::kString;
+  }
+  return impl_->value.is_string();
+}
 
-bool JSONValueConstRef::IsObject() const { return impl_->value.is_object(); }
+bool JSONValueConstRef::IsObject() const {
+  if (compact_ != nullptr) {
+    return compact::GetTag(compact_) == compact::kObject;
+  }
+  return impl_->value.is_object();
+}
 
-bool JSONValueConstRef::IsArray() const { return impl_->value.is_array(); }
+bool JSONValueConstRef::IsArray() const {
+  if (compact_ != nullptr) {
+    return compact::GetTag(compact_) == compact::kArray;
+  }
+  return impl_->value.is_array();
+}
 
 bool JSONValueConstRef::IsInt64() const {
+  if (compact_ != nullptr) {
+    const compact::Tag tag = compact::GetTag(compact_);
+    return tag == compact::kInt64 ||
+           (tag == compact::kUInt64 &&
+            compact::GetUInt64Payload(compact_) <=
+                static_cast<uint64_t>(std::numeric_limits<int64_t>::max()));
+  }
   // is_number_integer() returns true for both signed and unsigned values. We
   // need to make sure that the value fits int64_t if it is unsigned.
   return impl_->value.is_number_integer() &&
@@ -530,49 +1209,122 @@ bool JSONValueConstRef::IsInt64() const {
 }
 
 bool JSONValueConstRef::IsUInt64() const {
+  if (compact_ != nullptr) {
+    return compact::GetTag(compact_) == compact::kUInt64;
+  }
   return impl_->value.is_number_unsigned();
 }
 
 bool JSONValueConstRef::IsDouble() const {
+  if (compact_ != nullptr) {
+    return compact::GetTag(compact_) == compact::kDouble;
+  }
   return impl_->value.is_number_float();
 }
 
+namespace {
+
+// Returns the number stored in a compact encoding as 'T', converting like
+// JSON::get<T>() does.
+template <typename T>
+T GetCompactNumber(const char* value) {
+  switch (compact::GetTag(value)) {
+    case compact::kInt64:
+      return static_cast<T>(
+          static_cast<int64_t>(compact::GetUInt64Payload(value)));
+    case compact::kUInt64:
+      return static_cast<T>(compact::GetUInt64Payload(value));
+    case compact::kDouble:
+      return static_cast<T>(compact::GetDoublePayload(value));
+    default:
+      ABSL_LOG(FATAL) << "JSON value is not a number";
+  }
+}
+
+}  // namespace
+
 int64_t JSONValueConstRef::GetInt64() const {
+  if (compact_ != nullptr) {
+    return GetCompactNumber<int64_t>(compact_);
+  }
   return impl_->value.get<int64_t>();
 }
 
 uint64_t JSONValueConstRef::GetUInt64() const {
+  if (compact_ != nullptr) {
+    return GetCompactNumber<uint64_t>(compact_);
+  }
   return impl_->value.get<uint64_t>();
 }
 
 double JSONValueConstRef::GetDouble() const {
+  if (compact_ != nullptr) {
+    return GetCompactNumber<double>(compact_);
+  }
   return impl_->value.get<double>();
 }
 
 std::string JSONValueConstRef::GetString() const {
+  if (compact_ != nullptr) {
+    if (ABSL_PREDICT_FALSE(!IsString())) {
+      ABSL_LOG(FATAL) << "JSON value is not a string";
+    }
+    return std::string(compact::GetStringPayload(compact_));
+  }
   return impl_->value.get<std::string>();
 }
 
-bool JSONValueConstRef::GetBoolean() const { return impl_->value.get<bool>(); }
+bool JSONValueConstRef::GetBoolean() const {
+  if (compact_ != nullptr) {
+    if (ABSL_PREDICT_FALSE(!IsBoolean())) {
+      ABSL_LOG(FATAL) << "JSON value is not a boolean";
+    }
+    return compact::GetTag(compact_) == compact::kTrue;
+  }
+  return impl_->value.get<bool>();
+}
 
 size_t JSONValueConstRef::GetObjectSize() const {
   if (ABSL_PREDICT_FALSE(!IsObject())) {
     ABSL_LOG(FATAL) << "JSON value is not an object";
   }
+  if (compact_ != nullptr) {
+    return compact::GetCount(compact_);
+  }
   return impl_->value.size();
 }
 
 bool JSONValueConstRef::HasMember(absl::string_view key) const {
+  if (compact_ != nullptr) {
+    return IsObject() && compact::FindMember(compact_, key).has_value();
+  }
   return impl_->value.find(key) != impl_->value.end();
 }
 
 JSONValueConstRef JSONValueConstRef::GetMember(absl::string_view key) const {
+  if (compact_ != nullptr) {
+    std::optional<JSONValueConstRef> member = GetMemberIfExists(key);
+    if (ABSL_PREDICT_FALSE(!member.has_value())) {
+      ABSL_LOG(FATAL) << "JSON object has no member '" << key << "'";
+    }
+    return *member;
+  }
   return JSONValueConstRef(reinterpret_cast<const JSONValue::Impl*>(
       &impl_->value[std::string(key)]));
 }
 
 std::optional<JSONValueConstRef> JSONValueConstRef::GetMemberIfExists(
     absl::string_view key) const {
+  if (compact_ != nullptr) {
+    if (!IsObject()) {
+      return std::nullopt;
+    }
+    std::optional<uint32_t> index = compact::FindMember(compact_, key);
+    if (!index.has_value()) {
+      return std::nullopt;
+    }
+    return JSONValueConstRef(compact::GetObjectValue(compact_, *index));
+  }
   auto iter = impl_->value.find(key);
   if (iter == impl_->value.end()) {
     return std::nullopt;
@@ -584,6 +1336,16 @@ std::optional<JSONValueConstRef> JSONValueConstRef::GetMemberIfExists(
 std::vector<std::pair<absl::string_view, JSONValueConstRef>>
 JSONValueConstRef::GetMembers() const {
   std::vector<std::pair<absl::string_view, JSONValueConstRef>> members;
+  if (compact_ != nullptr) {
+    const uint32_t count = static_cast<uint32_t>(GetObjectSize());
+    members.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+      members.push_back(
+          {compact::GetObjectKey(compact_, i),
+           JSONValueConstRef(compact::GetObjectValue(compact_, i))});
+    }
+    return members;
+  }
   for (auto& member : impl_->value.items()) {
     members.push_back(
         {member.key(),
@@ -597,16 +1359,35 @@ size_t JSONValueConstRef::GetArraySize() const {
   if (ABSL_PREDICT_FALSE(!IsArray())) {
     ABSL_LOG(FATAL) << "JSON value is not an array";
   }
+  if (compact_ != nullptr) {
+    return compact::GetCount(compact_);
+  }
   return impl_->value.size();
 }
 
 JSONValueConstRef JSONValueConstRef::GetArrayElement(size_t index) const {
+  if (compact_ != nullptr) {
+    if (ABSL_PREDICT_FALSE(index >= GetArraySize())) {
+      ABSL_LOG(FATAL) << "JSON array index " << index << " is out of range";
+    }
+    return JSONValueConstRef(
+        compact::GetArrayElement(compact_, static_cast<uint32_t>(index)));
+  }
   return JSONValueConstRef(
       reinterpret_cast<const JSONValue::Impl*>(&impl_->value[index]));
 }
 
 std::vector<JSONValueConstRef> JSONValueConstRef::GetArrayElements() const {
   std::vector<JSONValueConstRef> elements;
+  if (compact_ != nullptr) {
+    const uint32_t count = static_cast<uint32_t>(GetArraySize());
+    elements.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+      elements.push_back(
+          JSONValueConstRef(compact::GetArrayElement(compact_, i)));
+    }
+    return elements;
+  }
   for (auto& element : impl_->value) {
     elements.emplace_back(
         JSONValueConstRef(reinterpret_cast<const JSONValue::Impl*>(&element)));
@@ -614,14 +1395,31 @@ std::vector<JSONValueConstRef> JSONValueConstRef::GetArrayElements() const {
   return elements;
 }
 
-std::string JSONValueConstRef::ToString() const { return impl_->value.dump(); }
+std::string JSONValueConstRef::ToString() const {
+  if (compact_ != nullptr) {
+    std::string output;
+    compact::AppendText(compact_, /*indent=*/-1, /*current_indent=*/0,
+                        &output);
+    return output;
+  }
+  return impl_->value.dump();
+}
 
 std::string JSONValueConstRef::Format() const {
+  if (compact_ != nullptr) {
+    std::string output;
+    compact::AppendText(compact_, /*indent=*/2, /*current_indent=*/0, &output);
+    return output;
+  }
   return impl_->value.dump(/*indent=*/2);
 }
 
 void JSONValueConstRef::SerializeAndAppendToProtoBytes(
     std::string* output) const {
+  if (compact_ != nullptr) {
+    JSON::to_ubjson(compact::ToTree(compact_), *output);
+    return;
+  }
   JSON::to_ubjson(impl_->value, *output);
 }
 
@@ -637,6 +1435,9 @@ uint64_t EstimateStringSpaceUsed(const std::string& str) {
 }  // namespace
 
 uint64_t JSONValueConstRef::SpaceUsed() const {
+  if (compact_ != nullptr) {
+    return sizeof(CompactJSONValue) + compact::GetEncodedSize(compact_);
+  }
   uint64_t space_used = sizeof(JSONValue);
   std::queue<const JSON*> nodes;
   nodes.push(&impl_->value);
@@ -672,6 +1473,9 @@ bool JSONValueConstRef::NestingLevelExceedsMax(int64_t max_nesting) const {
   if (max_nesting < 0) {
     max_nesting = 0;
   }
+  if (compact_ != nullptr) {
+    return compact::NestingLevelExceedsMax(compact_, max_nesting);
+  }
   if (!IsArray() && !IsObject()) {
     return false;
   }
@@ -704,6 +1508,10 @@ bool JSONValueConstRef::NestingLevelExceedsMax(int64_t max_nesting) const {
 // casting the integer into a floating point and comparing the numbers as
 // floating points. Signed and unsigned integers can also be equal.
 bool JSONValueConstRef::NormalizedEquals(JSONValueConstRef that) const {
+  if (compact_ != nullptr || that.compact_ != nullptr) {
+    return JSONValue::CopyFrom(*this).impl_->value ==
+           JSONValue::CopyFrom(that).impl_->value;
+  }
   return impl_->value == that.impl_->value;
 }
 
@@ -36,6 +36,7 @@
 
 namespace zetasql {
 
+class CompactJSONValue;
 class JSONValueConstRef;
 class JSONValueRef;
 
@@ -140,8 +141,50 @@ class JSONValue final {
   friend class JSONValueRef;
 };
 
+// CompactJSONValue stores an immutable JSON document in a single contiguous
+// buffer instead of a tree of heap-allocated nodes. Arrays store the end
+// offsets of their elements and objects store their keys sorted, so element
+// access is constant time and member lookup is a binary search, and neither
+// decodes the values that are skipped. Read access is provided through
+// JSONValueConstRef; use JSONValue::CopyFrom() to get a mutable copy.
+//
+// Parsing from text builds the buffer directly from the parser events, and
+// serializing to text writes straight from the buffer.
+class CompactJSONValue final {
+ public:
+  // Constructs a JSON 'null' document.
+  CompactJSONValue();
+
+  CompactJSONValue(CompactJSONValue&& value) = default;
+  CompactJSONValue& operator=(CompactJSONValue&& value) = default;
+
+  CompactJSONValue(const CompactJSONValue&) = delete;
+  CompactJSONValue& operator=(const CompactJSONValue&) = delete;
+
+  // Returns a read-only reference to the JSON value.
+  JSONValueConstRef GetConstRef() const;
+
+  // Parses a given JSON document string. Accepts the same documents and
+  // returns the same errors as JSONValue::ParseJSONString(). Like there, the
+  // first of duplicate object keys wins.
+  static absl::StatusOr<CompactJSONValue> ParseJSONString(
+      absl::string_view str,
+      JSONParsingOptions parsing_options = JSONParsingOptions());
+
+  // Returns a compact copy of the given value.
+  static CompactJSONValue CopyFrom(JSONValueConstRef value);
+
+  // Returns the number of bytes in the buffer.
+  size_t encoded_size() const { return buffer_.size(); }
+
+ private:
+  explicit CompactJSONValue(std::string buffer) : buffer_(std::move(buffer)) {}
+
+  std::string buffer_;
+};
+
 // JSONValueConstRef is a read-only reference to a JSON document stored by
-// JSONValue. The JSONValue instance referenced should outlive the
+// JSONValue or CompactJSONValue. The instance referenced should outlive the
 // JSONValueConstRef instance.
 class JSONValueConstRef {
  public:
@@ -255,9 +298,16 @@ class JSONValueConstRef {
   explicit JSONValueConstRef(const JSONValue::Impl* value_pointer);
 
  private:
+  // Constructs a reference to the CompactJSONValue encoding of a value.
+  explicit JSONValueConstRef(const char* compact_value);
+
   const JSONValue::Impl* impl_;
+  // Start of the referenced value in a CompactJSONValue buffer, or null if the
+  // referenced value is stored by JSONValue.
+  const char* compact_ = nullptr;
 
   friend class JSONValue;
+  friend class CompactJSONValue;
 };
 
 // JSONValueRef is a read/write reference to a JSON document stored by
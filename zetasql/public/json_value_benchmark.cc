@@ -0,0 +1,169 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Measures the throughput of JSON validation and parsing, as done by
+// PARSE_JSON and the Snowflake PARSE_JSON, over corpora of typical documents.
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "zetasql/public/json_value.h"
+#include "zetasql/public/variant_value.h"
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+#include "single_include/nlohmann/json.hpp"
+
+namespace zetasql {
+
+static constexpr int kNumDocuments = 256;
+
+enum Corpus {
+  // Flat records with short strings and integers, like event logs.
+  kRecords = 0,
+  // Deeply nested objects and arrays.
+  kNested = 1,
+  // Long strings with escapes and non-ASCII characters.
+  kStrings = 2,
+  // Arrays of floating point numbers.
+  kNumbers = 3,
+};
+
+static std::string MakeDocument(Corpus corpus, int i) {
+  switch (corpus) {
+    case kRecords:
+      return absl::StrCat(
+          R"({"id":)", i, R"(,"user":"user_)", i % 97,
+          R"(","event":"click","ts":1700000000)", i,
+          R"(,"ok":true,"tags":["a","b","c"],"geo":{"lat":37,"lon":-122}})");
+    case kNested: {
+      std::string document;
+      for (int depth = 0; depth < 16; ++depth) {
+        absl::StrAppend(&document, R"({"level":)", depth, R"(,"child":[)");
+      }
+      absl::StrAppend(&document, i);
+      for (int depth = 0; depth < 16; ++depth) {
+        absl::StrAppend(&document, "]}");
+      }
+      return document;
+    }
+    case kStrings: {
+      std::string document = "[";
+      for (int j = 0; j < 8; ++j) {
+        absl::StrAppend(&document, j == 0 ? "" : ",",
+                        R"("Lorem ipsum dolor sit amet, \"consectetur\" )",
+                        "adipiscing elit \xc3\xa9\xe2\x82\xac ", i * 8 + j,
+                        R"(\n\tsed do eiusmod tempor é incididunt")");
+      }
+      document.push_back(']');
+      return document;
+    }
+    case kNumbers: {
+      std::string document = "[";
+      for (int j = 0; j < 32; ++j) {
+        absl::StrAppend(&document, j == 0 ? "" : ",", i * 0.37 + j * 1.5e-3);
+      }
+      document.push_back(']');
+      return document;
+    }
+  }
+  return "null";
+}
+
+static std::vector<std::string> MakeCorpus(Corpus corpus, int64_t* bytes) {
+  std::vector<std::string> documents;
+  *bytes = 0;
+  for (int i = 0; i < kNumDocuments; ++i) {
+    documents.push_back(MakeDocument(corpus, i));
+    *bytes += documents.back().size();
+  }
+  return documents;
+}
+
+// Argument: Corpus.
+static void BM_IsValidJSON(::benchmark::State& state) {
+  int64_t bytes;
+  const std::vector<std::string> documents =
+      MakeCorpus(static_cast<Corpus>(state.range(0)), &bytes);
+  for (auto s : state) {
+    for (const std::string& document : documents) {
+      ::benchmark::DoNotOptimize(IsValidJSON(document));
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * bytes);
+}
+BENCHMARK(BM_IsValidJSON)->DenseRange(kRecords, kNumbers);
+
+// Argument: Corpus.
+static void BM_ParseJSONString(::benchmark::State& state) {
+  int64_t bytes;
+  const std::vector<std::string> documents =
+      MakeCorpus(static_cast<Corpus>(state.range(0)), &bytes);
+  for (auto s : state) {
+    for (const std::string& document : documents) {
+      ::benchmark::DoNotOptimize(JSONValue::ParseJSONString(document));
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * bytes);
+}
+BENCHMARK(BM_ParseJSONString)->DenseRange(kRecords, kNumbers);
+
+// Argument: Corpus.
+static void BM_ParseCompactJSONString(::benchmark::State& state) {
+  int64_t bytes;
+  const std::vector<std::string> documents =
+      MakeCorpus(static_cast<Corpus>(state.range(0)), &bytes);
+  for (auto s : state) {
+    for (const std::string& document : documents) {
+      ::benchmark::DoNotOptimize(CompactJSONValue::ParseJSONString(document));
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * bytes);
+}
+BENCHMARK(BM_ParseCompactJSONString)->DenseRange(kRecords, kNumbers);
+
+// Argument: Corpus.
+static void BM_ParseVariantJson(::benchmark::State& state) {
+  int64_t bytes;
+  const std::vector<std::string> documents =
+      MakeCorpus(static_cast<Corpus>(state.range(0)), &bytes);
+  for (auto s : state) {
+    for (const std::string& document : documents) {
+      ::benchmark::DoNotOptimize(VariantValue::ParseJson(document));
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * bytes);
+}
+BENCHMARK(BM_ParseVariantJson)->DenseRange(kRecords, kNumbers);
+
+// The byte-at-a-time nlohmann parser, as a baseline for the above.
+// Argument: Corpus.
+static void BM_NlohmannParse(::benchmark::State& state) {
+  int64_t bytes;
+  const std::vector<std::string> documents =
+      MakeCorpus(static_cast<Corpus>(state.range(0)), &bytes);
+  for (auto s : state) {
+    for (const std::string& document : documents) {
+      ::benchmark::DoNotOptimize(
+          nlohmann::json::parse(document, /*cb=*/nullptr,
+                                /*allow_exceptions=*/false));
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * bytes);
+}
+BENCHMARK(BM_NlohmannParse)->DenseRange(kRecords, kNumbers);
+
+}  // namespace zetasql
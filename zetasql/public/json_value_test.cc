@@ -43,6 +43,7 @@
 
 namespace {
 
+using ::zetasql::CompactJSONValue;
 using ::zetasql::IsValidJSON;
 using ::zetasql::JSONParsingOptions;
 using ::zetasql::JSONValue;
@@ -2264,4 +2265,102 @@ TEST(JSONValueValidator, InvalidJSON) {
   }
 }
 
+TEST(CompactJSONValueTest, MatchesJSONValue) {
+  for (absl::string_view json :
+       {"null", "true", "false", "0", "-5", "18446744073709551615", "1.5",
+        "1e100", "-0.0", R"("a\"b\\c\n\u0001é")", "[]", "{}",
+        "[1,[2,[3,{}]],[]]",
+        R"({"b":1,"a":[true,null,"x"],"c":{"z":1,"y":{}}})",
+        R"({"k":1,"k":2,"a":3})", R"({"":1,"é":2,"Z":3})"}) {
+    SCOPED_TRACE(json);
+    ZETASQL_ASSERT_OK_AND_ASSIGN(JSONValue tree,
+                         JSONValue::ParseJSONString(json));
+    ZETASQL_ASSERT_OK_AND_ASSIGN(CompactJSONValue compact,
+                         CompactJSONValue::ParseJSONString(json));
+    JSONValueConstRef tree_ref = tree.GetConstRef();
+    JSONValueConstRef compact_ref = compact.GetConstRef();
+    EXPECT_EQ(compact_ref.ToString(), tree_ref.ToString());
+    EXPECT_EQ(compact_ref.Format(), tree_ref.Format());
+    EXPECT_TRUE(compact_ref.NormalizedEquals(tree_ref));
+    EXPECT_TRUE(tree_ref.NormalizedEquals(compact_ref));
+    EXPECT_EQ(compact_ref.IsInt64(), tree_ref.IsInt64());
+    EXPECT_EQ(compact_ref.IsUInt64(), tree_ref.IsUInt64());
+    EXPECT_EQ(compact_ref.IsDouble(), tree_ref.IsDouble());
+    for (int max_nesting = 0; max_nesting < 4; ++max_nesting) {
+      EXPECT_EQ(compact_ref.NestingLevelExceedsMax(max_nesting),
+                tree_ref.NestingLevelExceedsMax(max_nesting));
+    }
+
+    std::string tree_bytes;
+    std::string compact_bytes;
+    tree_ref.SerializeAndAppendToProtoBytes(&tree_bytes);
+    compact_ref.SerializeAndAppendToProtoBytes(&compact_bytes);
+    EXPECT_EQ(compact_bytes, tree_bytes);
+
+    EXPECT_EQ(CompactJSONValue::CopyFrom(tree_ref).GetConstRef().ToString(),
+              tree_ref.ToString());
+    EXPECT_EQ(JSONValue::CopyFrom(compact_ref).GetConstRef().ToString(),
+              tree_ref.ToString());
+  }
+}
+
+TEST(CompactJSONValueTest, Access) {
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      CompactJSONValue compact,
+      CompactJSONValue::ParseJSONString(
+          R"({"b": 1, "a": [true, null, "x"], "c": {"z": -1, "y": {}}})"));
+  JSONValueConstRef ref = compact.GetConstRef();
+  ASSERT_TRUE(ref.IsObject());
+  EXPECT_EQ(ref.GetObjectSize(), 3);
+  EXPECT_TRUE(ref.HasMember("c"));
+  EXPECT_FALSE(ref.HasMember("d"));
+
+  JSONValueConstRef array = ref.GetMember("a");
+  ASSERT_TRUE(array.IsArray());
+  EXPECT_EQ(array.GetArraySize(), 3);
+  EXPECT_TRUE(array.GetArrayElement(0).GetBoolean());
+  EXPECT_TRUE(array.GetArrayElement(1).IsNull());
+  EXPECT_EQ(array.GetArrayElement(2).GetString(), "x");
+  EXPECT_EQ(array.GetArrayElements().size(), 3);
+  EXPECT_FALSE(array.GetMemberIfExists("a").has_value());
+
+  std::optional<JSONValueConstRef> z =
+      ref.GetMember("c").GetMemberIfExists("z");
+  ASSERT_TRUE(z.has_value());
+  EXPECT_TRUE(z->IsInt64());
+  EXPECT_EQ(z->GetInt64(), -1);
+  EXPECT_FALSE(ref.GetMember("c").GetMemberIfExists("x").has_value());
+
+  std::vector<std::pair<absl::string_view, JSONValueConstRef>> members =
+      ref.GetMembers();
+  ASSERT_EQ(members.size(), 3);
+  EXPECT_EQ(members[0].first, "a");
+  EXPECT_EQ(members[1].first, "b");
+  EXPECT_EQ(members[1].second.GetUInt64(), 1);
+  EXPECT_EQ(members[2].first, "c");
+}
+
+TEST(CompactJSONValueTest, ParseErrors) {
+  EXPECT_TRUE(CompactJSONValue().GetConstRef().IsNull());
+  for (absl::string_view json : {"", "[1,", R"({"a" 1})", "01", "[1]]"}) {
+    SCOPED_TRACE(json);
+    absl::Status tree_status = JSONValue::ParseJSONString(json).status();
+    EXPECT_FALSE(tree_status.ok());
+    EXPECT_EQ(CompactJSONValue::ParseJSONString(json).status(), tree_status);
+  }
+
+  JSONParsingOptions options{.max_nesting = 1};
+  ZETASQL_EXPECT_OK(CompactJSONValue::ParseJSONString(R"({"a": 10})", options));
+  EXPECT_THAT(
+      CompactJSONValue::ParseJSONString(R"({"a": [10, 20]})", options),
+      StatusIs(absl::StatusCode::kOutOfRange,
+               HasSubstr("Max nesting of 1 has been exceeded")));
+
+  options = {.wide_number_mode = WideNumberMode::kExact};
+  EXPECT_THAT(CompactJSONValue::ParseJSONString("1.00000000000000000001",
+                                                options),
+              StatusIs(absl::StatusCode::kOutOfRange,
+                       HasSubstr("cannot round-trip")));
+}
+
 }  // namespace
@@ -23,6 +23,7 @@
 
 #include <algorithm>
 #include <array>
+#include <charconv>
 #include <cmath>
 #include <cstdint>
 #include <cstdio>
@@ -31,6 +32,7 @@
 #include <optional>
 #include <ostream>
 #include <string>
+#include <system_error>
 #include <type_traits>
 #include <vector>
 
@@ -1019,6 +1021,59 @@ void NumericValue::AppendToString(std::string* output) const {
                                 false, output);
 }
 
+namespace {
+
+// Parses "[+-]<digits>[.<digits>]", optionally surrounded by whitespace, where
+// the integer part fits in 64 bits and there are at most kMaxFractionalDigits
+// fractional digits. Such values are always exact NUMERICs, so they need
+// neither rounding nor range checks. Returns false for any other input, valid
+// or not; the caller then falls back to the general parser.
+bool ParsePlainDecimal(absl::string_view str, __int128* packed) {
+  constexpr int kMaxFractionalDigits = NumericValue::kMaxFractionalDigits;
+  const char* start = str.data();
+  const char* end = str.data() + str.size();
+  for (; start < end && absl::ascii_isspace(*start); ++start) {
+  }
+  for (; start < end && absl::ascii_isspace(*(end - 1)); --end) {
+  }
+  if (start == end) {
+    return false;
+  }
+  const bool negative = *start == '-';
+  start += (*start == '-' || *start == '+');
+
+  uint64_t int_value = 0;
+  const std::from_chars_result int_result =
+      std::from_chars(start, end, int_value);
+  if (int_result.ec == std::errc::result_out_of_range) {
+    return false;
+  }
+  const char* ptr = int_result.ptr;
+  const bool has_int_digits = ptr != start;
+  uint64_t fract_value = 0;
+  int num_fract_digits = 0;
+  if (ptr < end && *ptr == '.') {
+    ++ptr;
+    const char* fract_start = ptr;
+    ptr = std::from_chars(fract_start, end, fract_value).ptr;
+    num_fract_digits = static_cast<int>(ptr - fract_start);
+  }
+  if (ptr != end || num_fract_digits > kMaxFractionalDigits ||
+      (!has_int_digits && num_fract_digits == 0)) {
+    return false;
+  }
+  static constexpr std::array<uint32_t, kMaxFractionalDigits + 1> kPowersOf10 =
+      {1,      10,      100,      1000,      10000,
+       100000, 1000000, 10000000, 100000000, 1000000000};
+  const __int128 abs_value =
+      static_cast<__int128>(int_value) * NumericValue::kScalingFactor +
+      fract_value * kPowersOf10[kMaxFractionalDigits - num_fract_digits];
+  *packed = negative ? -abs_value : abs_value;
+  return true;
+}
+
+}  // namespace
+
 // Parses a textual representation of a NUMERIC value. Returns an error if the
 // given string cannot be parsed as a number or if the textual numeric value
 // exceeds NUMERIC precision. If 'is_strict' is true then the function will
@@ -1028,6 +1083,12 @@ void NumericValue::AppendToString(std::string* output) const {
 template <internal::DigitTrimMode trim_mode>
 absl::StatusOr<NumericValue> NumericValue::FromStringInternal(
     absl::string_view str, int64_t decimal_places) {
+  __int128 packed;
+  if (ABSL_PREDICT_TRUE(decimal_places >= kMaxFractionalDigits &&
+                        ParsePlainDecimal(str, &packed))) {
+    // ParsePlainDecimal only accepts values within the NUMERIC range.
+    return NumericValue(packed);
+  }
   constexpr uint8_t word_count = 2;
   FixedPointRepresentation<word_count> parsed;
   absl::Status parse_status =
@@ -1163,14 +1224,18 @@ absl::StatusOr<NumericValue> NumericValue::FromDouble(double value) {
   return MakeEvalError() << "numeric out of range: " << value;
 }
 
-absl::StatusOr<NumericValue> NumericValue::Multiply(NumericValue rh) const {
-  const __int128 value = as_packed_int();
-  const __int128 rh_value = rh.as_packed_int();
-  bool negative = value < 0;
-  bool rh_negative = rh_value < 0;
+namespace {
+
+// Sets <*result> to <x> * <y> / NumericValue::kScalingFactor, rounded half
+// away from zero, where <x> and <y> are absolute values of packed NUMERICs.
+// Returns false if the result exceeds internal::kNumericMax. Kept out of line
+// so that the fast path in Multiply stays small.
+ABSL_ATTRIBUTE_NOINLINE
+bool MultiplyAbsPackedValues(unsigned __int128 x, unsigned __int128 y,
+                             unsigned __int128* result) {
+  constexpr uint64_t kScalingFactor = NumericValue::kScalingFactor;
   FixedUint<64, 4> product =
-      ExtendAndMultiply(FixedUint<64, 2>(int128_abs(value)),
-                        FixedUint<64, 2>(int128_abs(rh_value)));
+      ExtendAndMultiply(FixedUint<64, 2>(x), FixedUint<64, 2>(y));
 
   // This value represents kNumericMax * kScalingFactor + kScalingFactor / 2.
   // At this value, <res> would be internal::kNumericMax + 1 and overflow.
@@ -1179,14 +1244,42 @@ absl::StatusOr<NumericValue> NumericValue::Multiply(NumericValue rh) const {
   if (ABSL_PREDICT_TRUE(product < kOverflowThreshold)) {
     FixedUint<64, 3> res(product);
     res += kScalingFactor / 2;
-    res /= kScalingFactor;
-    unsigned __int128 v = static_cast<unsigned __int128>(res);
-    // We already checked the value range, so no need to call FromPackedInt.
-    return NumericValue(
-        static_cast<__int128>(negative == rh_negative ? v : -v));
+    res /= std::integral_constant<uint64_t, kScalingFactor>();
+    *result = static_cast<unsigned __int128>(res);
+    return true;
   }
-  return MakeEvalError() << "numeric overflow: " << ToString() << " * "
-                         << rh.ToString();
+  return false;
+}
+
+}  // namespace
+
+absl::StatusOr<NumericValue> NumericValue::Multiply(NumericValue rh) const {
+  const __int128 value = as_packed_int();
+  const __int128 rh_value = rh.as_packed_int();
+  bool negative = value < 0;
+  bool rh_negative = rh_value < 0;
+  const unsigned __int128 abs_value = int128_abs(value);
+  const unsigned __int128 abs_rh_value = int128_abs(rh_value);
+  unsigned __int128 v;
+  if (ABSL_PREDICT_TRUE(static_cast<uint64_t>(abs_value >> 64) == 0 &&
+                        static_cast<uint64_t>(abs_rh_value >> 64) == 0)) {
+    // Both operands are below 2^64 / kScalingFactor (about 1.8e10), so the
+    // product fits in 128 bits, and the result, at most 2^128 /
+    // kScalingFactor, is always within the NUMERIC range.
+    const unsigned __int128 product =
+        abs_value * abs_rh_value + kScalingFactor / 2;
+    // Division of a 128-bit value is a library call; a 64-bit division by a
+    // constant compiles to a multiplication.
+    v = static_cast<uint64_t>(product >> 64) == 0
+            ? static_cast<uint64_t>(product) / kScalingFactor
+            : product / kScalingFactor;
+  } else if (ABSL_PREDICT_FALSE(
+                 !MultiplyAbsPackedValues(abs_value, abs_rh_value, &v))) {
+    return MakeEvalError() << "numeric overflow: " << ToString() << " * "
+                           << rh.ToString();
+  }
+  // We already checked the value range, so no need to call FromPackedInt.
+  return NumericValue(static_cast<__int128>(negative == rh_negative ? v : -v));
 }
 
 absl::StatusOr<NumericValue> NumericValue::MultiplyAndDivideByPowerOfTwo(
@@ -2246,7 +2339,7 @@ absl::StatusOr<NumericValue> NumericValue::FromScaledLittleEndianValue(
 }
 
 absl::StatusOr<NumericValue> NumericValue::SumAggregator::GetSum() const {
-  auto res_status = NumericValue::FromFixedInt(sum_);
+  auto res_status = NumericValue::FromFixedInt(GetTotal());
   if (res_status.ok()) {
     return res_status;
   }
@@ -2259,7 +2352,7 @@ absl::StatusOr<NumericValue> NumericValue::SumAggregator::GetAverage(
     return MakeEvalError() << "division by zero: AVG";
   }
 
-  FixedInt<64, 3> dividend = sum_;
+  FixedInt<64, 3> dividend = GetTotal();
   dividend.DivAndRoundAwayFromZero(count);
 
   auto res_status = NumericValue::FromFixedInt(dividend);
@@ -2271,7 +2364,7 @@ absl::StatusOr<NumericValue> NumericValue::SumAggregator::GetAverage(
 
 void NumericValue::SumAggregator::SerializeAndAppendToProtoBytes(
     std::string* bytes) const {
-  sum_.SerializeToBytes(bytes);
+  GetTotal().SerializeToBytes(bytes);
 }
 
 absl::StatusOr<NumericValue::SumAggregator>
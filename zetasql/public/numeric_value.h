@@ -359,11 +359,19 @@ class NumericValue final {
         absl::string_view bytes);
 
     bool operator==(const SumAggregator& other) const {
-      return sum_ == other.sum_;
+      return GetTotal() == other.GetTotal();
     }
 
    private:
+    // Returns <sum_> + <partial_sum_>.
+    FixedInt<64, 3> GetTotal() const;
+
+    // The sum is <sum_> + <partial_sum_>. Values are added to <partial_sum_>
+    // with plain 128-bit arithmetic, and <partial_sum_> is only moved into the
+    // wider <sum_> when that overflows, i.e. only when the running sum exceeds
+    // 2^127, about 1.7 times the largest NUMERIC value.
     FixedInt<64, 3> sum_;
+    __int128 partial_sum_ = 0;
   };
 
   // Aggregates the input of multiple NUMERIC values and provides functions for
@@ -1114,13 +1122,12 @@ inline absl::StatusOr<NumericValue> NumericValue::FromHighAndLowBits(
 }
 
 inline absl::StatusOr<NumericValue> NumericValue::Add(NumericValue rh) const {
-  FixedInt<64, 2> sum(as_packed_int());
-  bool overflow = sum.AddOverflow(FixedInt<64, 2>(rh.as_packed_int()));
-  if (ABSL_PREDICT_TRUE(!overflow)) {
-    auto numeric_value_status = FromFixedInt(sum);
-    if (ABSL_PREDICT_TRUE(numeric_value_status.ok())) {
-      return numeric_value_status;
-    }
+  __int128 sum;
+  if (ABSL_PREDICT_TRUE(
+          !__builtin_add_overflow(as_packed_int(), rh.as_packed_int(), &sum)) &&
+      ABSL_PREDICT_TRUE(sum >= internal::kNumericMin) &&
+      ABSL_PREDICT_TRUE(sum <= internal::kNumericMax)) {
+    return NumericValue(sum);
   }
   return MakeEvalError() << "numeric overflow: " << ToString() << " + "
                          << rh.ToString();
@@ -1128,13 +1135,12 @@ inline absl::StatusOr<NumericValue> NumericValue::Add(NumericValue rh) const {
 
 inline absl::StatusOr<NumericValue> NumericValue::Subtract(
     NumericValue rh) const {
-  FixedInt<64, 2> diff(as_packed_int());
-  bool overflow = diff.SubtractOverflow(FixedInt<64, 2>(rh.as_packed_int()));
-  if (ABSL_PREDICT_TRUE(!overflow)) {
-    auto numeric_value_status = FromFixedInt(diff);
-    if (ABSL_PREDICT_TRUE(numeric_value_status.ok())) {
-      return numeric_value_status;
-    }
+  __int128 diff;
+  if (ABSL_PREDICT_TRUE(!__builtin_sub_overflow(as_packed_int(),
+                                               rh.as_packed_int(), &diff)) &&
+      ABSL_PREDICT_TRUE(diff >= internal::kNumericMin) &&
+      ABSL_PREDICT_TRUE(diff <= internal::kNumericMax)) {
+    return NumericValue(diff);
   }
   return MakeEvalError() << "numeric overflow: " << ToString() << " - "
                          << rh.ToString();
@@ -1239,15 +1245,37 @@ inline bool NumericValue::HasFractionalPart() const {
 }
 
 inline void NumericValue::SumAggregator::Add(NumericValue value) {
-  sum_ += FixedInt<64, 3>(value.as_packed_int());
+  const __int128 packed = value.as_packed_int();
+  __int128 partial_sum;
+  if (ABSL_PREDICT_TRUE(
+          !__builtin_add_overflow(partial_sum_, packed, &partial_sum))) {
+    partial_sum_ = partial_sum;
+    return;
+  }
+  sum_ += FixedInt<64, 3>(partial_sum_);
+  partial_sum_ = packed;
 }
 
 inline void NumericValue::SumAggregator::Subtract(NumericValue value) {
-  sum_ -= FixedInt<64, 3>(value.as_packed_int());
+  const __int128 packed = value.as_packed_int();
+  __int128 partial_sum;
+  if (ABSL_PREDICT_TRUE(
+          !__builtin_sub_overflow(partial_sum_, packed, &partial_sum))) {
+    partial_sum_ = partial_sum;
+    return;
+  }
+  sum_ += FixedInt<64, 3>(partial_sum_);
+  partial_sum_ = -packed;
 }
 
 inline void NumericValue::SumAggregator::MergeWith(const SumAggregator& other) {
-  sum_ += other.sum_;
+  sum_ += other.GetTotal();
+}
+
+inline FixedInt<64, 3> NumericValue::SumAggregator::GetTotal() const {
+  FixedInt<64, 3> total = sum_;
+  total += FixedInt<64, 3>(partial_sum_);
+  return total;
 }
 
 inline constexpr BigNumericValue::BigNumericValue(
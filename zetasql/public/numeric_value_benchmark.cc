@@ -0,0 +1,125 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Per-value cost of NUMERIC parsing, arithmetic and SUM/AVG aggregation over
+// values like those of a NUMBER(38, 2) column holding amounts.
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "zetasql/public/numeric_value.h"
+#include "benchmark/benchmark.h"
+
+namespace zetasql {
+
+static constexpr int kNumValues = 1024;
+
+// Returns kNumValues values with two fractional digits whose absolute values
+// are below <max_integer_part> / 2.
+static std::vector<NumericValue> MakeValues(int64_t max_integer_part) {
+  std::mt19937_64 rng(12345);
+  std::vector<NumericValue> values;
+  values.reserve(kNumValues);
+  for (int i = 0; i < kNumValues; ++i) {
+    const int64_t cents =
+        static_cast<int64_t>(rng() % (max_integer_part * 100)) -
+        max_integer_part * 50;
+    values.push_back(
+        NumericValue::FromPackedInt(static_cast<__int128>(cents) * 10000000)
+            .value());
+  }
+  return values;
+}
+
+// Argument: bound of the integer part of the values.
+static void BM_NumericFromString(::benchmark::State& state) {
+  std::vector<std::string> strings;
+  for (const NumericValue& value : MakeValues(state.range(0))) {
+    strings.push_back(value.ToString());
+  }
+  for (auto s : state) {
+    for (const std::string& str : strings) {
+      ::benchmark::DoNotOptimize(NumericValue::FromString(str));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumValues);
+}
+BENCHMARK(BM_NumericFromString)->Arg(1000000)->Arg(1000000000000);
+
+static void BM_NumericAdd(::benchmark::State& state) {
+  const std::vector<NumericValue> values = MakeValues(1000000);
+  for (auto s : state) {
+    for (int i = 1; i < kNumValues; ++i) {
+      ::benchmark::DoNotOptimize(values[i - 1].Add(values[i]));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * (kNumValues - 1));
+}
+BENCHMARK(BM_NumericAdd);
+
+static void BM_NumericSubtract(::benchmark::State& state) {
+  const std::vector<NumericValue> values = MakeValues(1000000);
+  for (auto s : state) {
+    for (int i = 1; i < kNumValues; ++i) {
+      ::benchmark::DoNotOptimize(values[i - 1].Subtract(values[i]));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * (kNumValues - 1));
+}
+BENCHMARK(BM_NumericSubtract);
+
+// Argument: bound of the integer part of the operands.
+static void BM_NumericMultiply(::benchmark::State& state) {
+  const std::vector<NumericValue> values = MakeValues(state.range(0));
+  for (auto s : state) {
+    for (int i = 1; i < kNumValues; ++i) {
+      ::benchmark::DoNotOptimize(values[i - 1].Multiply(values[i]));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * (kNumValues - 1));
+}
+BENCHMARK(BM_NumericMultiply)->Arg(100)->Arg(1000000)->Arg(1000000000000);
+
+static void BM_NumericCompare(::benchmark::State& state) {
+  const std::vector<NumericValue> values = MakeValues(1000000);
+  for (auto s : state) {
+    int num_less = 0;
+    for (int i = 1; i < kNumValues; ++i) {
+      num_less += values[i - 1] < values[i];
+    }
+    ::benchmark::DoNotOptimize(num_less);
+  }
+  state.SetItemsProcessed(state.iterations() * (kNumValues - 1));
+}
+BENCHMARK(BM_NumericCompare);
+
+static void BM_NumericSumAndAverage(::benchmark::State& state) {
+  const std::vector<NumericValue> values = MakeValues(1000000);
+  for (auto s : state) {
+    NumericValue::SumAggregator aggregator;
+    for (const NumericValue& value : values) {
+      aggregator.Add(value);
+    }
+    ::benchmark::DoNotOptimize(aggregator.GetSum());
+    ::benchmark::DoNotOptimize(aggregator.GetAverage(kNumValues));
+  }
+  state.SetItemsProcessed(state.iterations() * kNumValues);
+}
+BENCHMARK(BM_NumericSumAndAverage);
+
+}  // namespace zetasql
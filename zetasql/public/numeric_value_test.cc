@@ -285,6 +285,13 @@ constexpr NumericStringTestData kNumericFromStringTestData[] = {
     {" 0", 0},
     {"0 ", 0},
     {" 0 ", 0},
+    {"\t-12.5\n", -125 * k1e9 / 10},
+
+    // Integer parts around 2^64.
+    {"18446744073709551615.999999999", kuint64max * k1e9 + 999999999},
+    {"-18446744073709551615.999999999", -(kuint64max * k1e9 + 999999999)},
+    {"18446744073709551616.5", kuint64max * k1e9 + k1e9 + 500000000},
+    {"-18446744073709551616.5", -(kuint64max * k1e9 + k1e9 + 500000000)},
 
     // Non-essential zeroes are ignored.
     {"00000000000000000000000000000000000000000000000000", 0},
@@ -417,6 +424,10 @@ constexpr absl::string_view kInvalidNumericStrings[] = {
     "abcd",
     "- 123",
     "123abc",
+    "1.-5",
+    "1.+5",
+    "1 .5",
+    "1. 5",
     "123..456",
     "123.4.56",
     ".",
@@ -3778,6 +3789,28 @@ TEST(NumericSumAggregatorTest, Serialization) {
       kNumericUnaryAggregatorTestInputs);
 }
 
+TEST(NumericSumAggregatorTest, SumBeyond128Bits) {
+  // Adding three maximal values overflows 128 bits; subtracting them again
+  // must give an aggregator equal to one that never saw them.
+  NumericValue::SumAggregator expected;
+  expected.Add(NumericValue(1));
+  NumericValue::SumAggregator aggregator;
+  aggregator.Add(NumericValue(1));
+  for (int i = 0; i < 3; ++i) {
+    aggregator.Add(NumericValue::MaxValue());
+  }
+  EXPECT_THAT(aggregator.GetSum(),
+              StatusIs(absl::StatusCode::kOutOfRange, "numeric overflow: SUM"));
+  EXPECT_FALSE(aggregator == expected);
+  for (int i = 0; i < 3; ++i) {
+    aggregator.Subtract(NumericValue::MaxValue());
+  }
+  EXPECT_TRUE(aggregator == expected);
+  EXPECT_EQ(aggregator.SerializeAsProtoBytes(),
+            expected.SerializeAsProtoBytes());
+  EXPECT_THAT(aggregator.GetSum(), IsOkAndHolds(NumericValue(1)));
+}
+
 TEST_F(NumericValueTest, VarianceAggregator) {
   using W = NumericValueWrapper;
   struct VarianceTestData {
@@ -1580,15 +1580,18 @@ void SimpleTable::SetContents(const std::vector<std::vector<Value>>& rows) {
     std::vector<const Column*> columns;
     std::vector<std::shared_ptr<const std::vector<Value>>> column_values;
     column_values.reserve(column_idxs.size());
+    // Filters are keyed on the index of the column in the scan.
+    absl::flat_hash_set<int> filter_column_idxs;
+    filter_column_idxs.reserve(column_idxs.size());
     for (const int column_idx : column_idxs) {
+      filter_column_idxs.insert(static_cast<int>(columns.size()));
       columns.push_back(GetColumn(column_idx));
       column_values.push_back(column_major_contents_[column_idx]);
     }
     std::unique_ptr<EvaluatorTableIterator> iter(
         new SimpleEvaluatorTableIterator(
             columns, column_values, num_rows_,
-            /*end_status=*/absl::OkStatus(), /*filter_column_idxs=*/
-            absl::flat_hash_set<int>(column_idxs.begin(), column_idxs.end()),
+            /*end_status=*/absl::OkStatus(), filter_column_idxs,
             /*cancel_cb=*/[]() {},
             /*set_deadline_cb=*/[](absl::Time t) {}, zetasql_base::Clock::RealClock()));
     return iter;
@@ -16,12 +16,14 @@
 
 #include "zetasql/public/time_zone_util.h"
 
+#include <string>
+
 #include "zetasql/common/errors.h"
 
 namespace zetasql {
 
-absl::Status FindTimeZoneByName(absl::string_view timezone_name,
-                                absl::TimeZone* tz) {
+static absl::Status LoadTimeZoneByName(absl::string_view timezone_name,
+                                       absl::TimeZone* tz) {
   // This ultimately looks into the zoneinfo directory (typically
   // /usr/share/zoneinfo, /usr/share/lib/zoneinfo, etc.).
   if (absl::LoadTimeZone(timezone_name, tz)) {
@@ -46,4 +48,32 @@ absl::Status FindTimeZoneByName(absl::string_view timezone_name,
   return MakeEvalError() << "Invalid time zone: " << timezone_name;
 }
 
+absl::Status FindTimeZoneByName(absl::string_view timezone_name,
+                                absl::TimeZone* tz) {
+  // absl::LoadTimeZone() handles UTC without taking a lock.
+  if (timezone_name == "UTC") {
+    *tz = absl::UTCTimeZone();
+    return absl::OkStatus();
+  }
+  // absl::LoadTimeZone() caches loaded zones, but every lookup copies the name
+  // and takes a global lock, which threads evaluating the same query contend
+  // on.  Queries almost always use a single time zone, so remembering the last
+  // one loaded on each thread avoids both.
+  struct CachedTimeZone {
+    std::string name;
+    absl::TimeZone tz;
+  };
+  thread_local CachedTimeZone cached;
+  if (!cached.name.empty() && cached.name == timezone_name) {
+    *tz = cached.tz;
+    return absl::OkStatus();
+  }
+  absl::Status status = LoadTimeZoneByName(timezone_name, tz);
+  if (status.ok()) {
+    cached.name = std::string(timezone_name);
+    cached.tz = *tz;
+  }
+  return status;
+}
+
 }  // namespace zetasql
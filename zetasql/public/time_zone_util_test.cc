@@ -41,4 +41,17 @@ TEST(TimeZoneTests, KyivTimezone) {
   }
 }
 
+TEST(TimeZoneTests, RepeatedLookups) {
+  // Lookups after the first are served from a cache; the results must not
+  // change.
+  for (int i = 0; i < 3; ++i) {
+    absl::TimeZone tz;
+    ZETASQL_ASSERT_OK(FindTimeZoneByName("America/Los_Angeles", &tz));
+    EXPECT_EQ(tz.name(), "America/Los_Angeles");
+    ZETASQL_ASSERT_OK(FindTimeZoneByName("UTC", &tz));
+    EXPECT_EQ(tz.name(), "UTC");
+    EXPECT_FALSE(FindTimeZoneByName("Invalid/Time_Zone", &tz).ok());
+  }
+}
+
 }  // namespace zetasql
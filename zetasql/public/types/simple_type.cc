@@ -49,6 +49,7 @@
 #include "zetasql/public/types/value_representations.h"
 #include "zetasql/public/value.pb.h"
 #include "zetasql/public/value_content.h"
+#include "zetasql/public/variant_value.h"
 #include <cstdint>
 #include "absl/hash/hash.h"
 #include "absl/status/status.h"
@@ -255,6 +256,10 @@ std::string GetJsonString(const ValueContent& value) {
   return value.GetAs<internal::JSONRef*>()->ToString();
 }
 
+VariantConstRef GetVariantValue(const ValueContent& value) {
+  return VariantConstRef(GetStringValue(value));
+}
+
 const IntervalValue& GetIntervalValue(const ValueContent& value) {
   return value.GetAs<internal::IntervalRef*>()->value();
 }
@@ -423,7 +428,12 @@ void SimpleType::CopyValueContent(TypeKind kind, const ValueContent& from,
   switch (kind) {
     case TYPE_STRING:
     case TYPE_BYTES:
-      from.GetAs<internal::StringRef*>()->Ref();
+    case TYPE_VARIANT:
+    case TYPE_OBJECT:
+      if (from.simple_type_extended_content_ !=
+          internal::StringRef::kStaticContent) {
+        from.GetAs<internal::StringRef*>()->Ref();
+      }
       break;
     case TYPE_GEOGRAPHY:
       from.GetAs<internal::GeographyRef*>()->Ref();
@@ -456,7 +466,12 @@ void SimpleType::ClearValueContent(TypeKind kind, const ValueContent& value) {
   switch (kind) {
     case TYPE_STRING:
     case TYPE_BYTES:
-      value.GetAs<internal::StringRef*>()->Unref();
+    case TYPE_VARIANT:
+    case TYPE_OBJECT:
+      if (value.simple_type_extended_content_ !=
+          internal::StringRef::kStaticContent) {
+        value.GetAs<internal::StringRef*>()->Unref();
+      }
       return;
     case TYPE_GEOGRAPHY:
       value.GetAs<internal::GeographyRef*>()->Unref();
@@ -487,6 +502,12 @@ uint64_t SimpleType::GetValueContentExternallyAllocatedByteSize(
   switch (kind()) {
     case TYPE_STRING:
     case TYPE_BYTES:
+    case TYPE_VARIANT:
+    case TYPE_OBJECT:
+      if (value.simple_type_extended_content_ ==
+          internal::StringRef::kStaticContent) {
+        return 0;
+      }
       return value.GetAs<internal::StringRef*>()->physical_byte_size();
     case TYPE_GEOGRAPHY:
       return value.GetAs<internal::GeographyRef*>()->physical_byte_size();
@@ -542,6 +563,9 @@ absl::HashState SimpleType::HashValueContent(const ValueContent& value,
     case TYPE_STRING:
     case TYPE_BYTES:
       return absl::HashState::combine(std::move(state), GetStringValue(value));
+    case TYPE_VARIANT:
+    case TYPE_OBJECT:
+      return absl::HashState::combine(std::move(state), GetVariantValue(value));
     case TYPE_DATE:
       return absl::HashState::combine(std::move(state), GetDateValue(value));
     case TYPE_TIMESTAMP:
@@ -605,6 +629,9 @@ bool SimpleType::ValueContentEquals(
     case TYPE_STRING:
     case TYPE_BYTES:
       return ReferencedValueEquals<internal::StringRef>(x, y);
+    case TYPE_VARIANT:
+    case TYPE_OBJECT:
+      return GetVariantValue(x).Equals(GetVariantValue(y));
     case TYPE_DATE:
       return ContentEquals<DateValueContentType>(x, y);
     case TYPE_TIMESTAMP:
@@ -830,6 +857,15 @@ std::string SimpleType::FormatValueContent(
                  ? absl::StrCat("JSON ", ToStringLiteral(s))
                  : s;
     }
+    case TYPE_VARIANT:
+    case TYPE_OBJECT: {
+      std::string s = GetVariantValue(value).ToJsonString();
+      if (!options.add_simple_type_prefix()) {
+        return s;
+      }
+      s = absl::StrCat("PARSE_JSON(", ToStringLiteral(s), ")");
+      return kind() == TYPE_OBJECT ? absl::StrCat("TO_OBJECT(", s, ")") : s;
+    }
     default:
       ABSL_LOG(ERROR) << "Unexpected type kind: " << kind();
       return "<Invalid simple type's value>";
@@ -877,6 +913,10 @@ absl::Status SimpleType::SerializeValueContent(const ValueContent& value,
     case TYPE_BYTES:
       value_proto->set_bytes_value(GetBytesValue(value));
       break;
+    case TYPE_VARIANT:
+    case TYPE_OBJECT:
+      value_proto->set_variant_value(GetStringValue(value));
+      break;
     case TYPE_DATE:
       value_proto->set_date_value(GetDateValue(value));
       break;
@@ -990,6 +1030,21 @@ absl::Status SimpleType::DeserializeValueContent(const ValueProto& value_proto,
       }
       value->set(new internal::StringRef(value_proto.bytes_value()));
       break;
+    case TYPE_VARIANT:
+    case TYPE_OBJECT: {
+      if (!value_proto.has_variant_value()) {
+        return TypeMismatchError(value_proto);
+      }
+      ZETASQL_ASSIGN_OR_RETURN(VariantValue variant,
+                       VariantValue::FromEncoded(value_proto.variant_value()));
+      if (kind() == TYPE_OBJECT &&
+          variant.GetConstRef().kind() != VariantKind::kObject) {
+        return absl::Status(absl::StatusCode::kOutOfRange,
+                            "Invalid value for OBJECT: not an object");
+      }
+      value->set(new internal::StringRef(std::move(variant).Release()));
+      break;
+    }
     case TYPE_DATE:
       if (!value_proto.has_date_value()) {
         return TypeMismatchError(value_proto);
@@ -514,7 +514,9 @@ bool Type::SupportsPartitioningImpl(const LanguageOptions& language_options,
 
 bool Type::SupportsOrdering(const LanguageOptions& language_options,
                             std::string* type_description) const {
-  bool supports_ordering = !IsGeography() && !IsJson();
+  // VARIANT and OBJECT values have no defined order, only equality.
+  bool supports_ordering = !IsGeography() && !IsJson() &&
+                           kind() != TYPE_VARIANT && kind() != TYPE_OBJECT;
   if (supports_ordering) return true;
   if (type_description != nullptr) {
     *type_description = TypeKindToString(this->kind(),
@@ -30,6 +30,7 @@
 #include "zetasql/public/numeric_value.h"
 #include "zetasql/public/value_content.h"
 #include "absl/strings/cord.h"
+#include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
 #include "absl/types/variant.h"
 #include "zetasql/base/compact_reference_counted.h"
@@ -209,16 +210,46 @@ class IntervalRef final
 
 // -------------------------------------------------------
 // StringRef is ref count wrapper around string.
+//
+// Empty and single byte strings are very common, so they share StringRefs that
+// are never deleted. A STRING or BYTES ValueContent holding one of those has
+// kStaticContent as its simple_type_extended_content, and does not own a
+// reference: copying and clearing it does not allocate or touch the reference
+// count.
 // -------------------------------------------------------
 class StringRef final
     : public zetasql_base::refcount::CompactReferenceCounted<StringRef, int64_t> {
  public:
+  // Strings of at most this many bytes are held by Static() StringRefs.
+  static constexpr int kMaxStaticSize = 1;
+  // The simple_type_extended_content of a ValueContent holding a Static()
+  // StringRef.
+  static constexpr int32_t kStaticContent = 1;
+
   StringRef() = default;
   explicit StringRef(std::string value) : value_(std::move(value)) {}
 
   StringRef(const StringRef&) = delete;
   StringRef& operator=(const StringRef&) = delete;
 
+  // Returns a StringRef holding <value> that is never deleted.
+  // REQUIRES: value.size() <= kMaxStaticSize.
+  static StringRef* Static(absl::string_view value) {
+    static StringRef* const* const kStaticRefs = [] {
+      // The empty string, followed by each single byte string.
+      StringRef** refs = new StringRef*[257];
+      refs[0] = new StringRef();
+      for (int c = 0; c < 256; ++c) {
+        refs[c + 1] = new StringRef(std::string(1, static_cast<char>(c)));
+      }
+      return refs;
+    }();
+    ABSL_DCHECK_LE(value.size(), kMaxStaticSize);
+    return kStaticRefs[value.empty()
+                           ? 0
+                           : static_cast<unsigned char>(value[0]) + 1];
+  }
+
   const std::string& value() const { return value_; }
 
   uint64_t physical_byte_size() const {
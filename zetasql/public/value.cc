@@ -620,6 +620,8 @@ static bool TypesSupportSqlEquals(const Type* type1, const Type* type2) {
     case TYPE_KIND_PAIR(TYPE_ENUM, TYPE_ENUM):
     case TYPE_KIND_PAIR(TYPE_NUMERIC, TYPE_NUMERIC):
     case TYPE_KIND_PAIR(TYPE_BIGNUMERIC, TYPE_BIGNUMERIC):
+    case TYPE_KIND_PAIR(TYPE_VARIANT, TYPE_VARIANT):
+    case TYPE_KIND_PAIR(TYPE_OBJECT, TYPE_OBJECT):
     case TYPE_KIND_PAIR(TYPE_FLOAT, TYPE_FLOAT):
     case TYPE_KIND_PAIR(TYPE_DOUBLE, TYPE_DOUBLE):
     case TYPE_KIND_PAIR(TYPE_INT64, TYPE_UINT64):
@@ -674,6 +676,8 @@ Value Value::SqlEquals(const Value& that) const {
     case TYPE_KIND_PAIR(TYPE_ENUM, TYPE_ENUM):
     case TYPE_KIND_PAIR(TYPE_NUMERIC, TYPE_NUMERIC):
     case TYPE_KIND_PAIR(TYPE_BIGNUMERIC, TYPE_BIGNUMERIC):
+    case TYPE_KIND_PAIR(TYPE_VARIANT, TYPE_VARIANT):
+    case TYPE_KIND_PAIR(TYPE_OBJECT, TYPE_OBJECT):
       return Value::Bool(Equals(that));
 
     case TYPE_KIND_PAIR(TYPE_STRUCT, TYPE_STRUCT): {
@@ -44,6 +44,7 @@
 #include "zetasql/public/types/value_representations.h"
 #include "zetasql/public/value.pb.h"
 #include "zetasql/public/value_content.h"
+#include "zetasql/public/variant_value.h"
 #include "absl/base/attributes.h"
 #include <cstdint>
 #include "absl/status/status.h"
@@ -201,6 +202,10 @@ class Value {
   // Returns the string representing stored JSON value.
   std::string json_string() const;
 
+  // REQUIRES: variant or object type
+  // The returned reference is valid as long as this value is.
+  VariantConstRef variant_value() const;
+
   // Returns the value content of extended type.
   // REQUIRES: type_kind() == TYPE_EXTENDED
   ValueContent extended_value() const;
@@ -437,6 +442,12 @@ class Value {
   // optimized for member access operations.
   static Value Json(JSONValue value);
 
+  // Creates a VARIANT value.
+  static Value Variant(VariantValue value);
+  // Creates an OBJECT value.
+  // REQUIRES: value.GetConstRef().kind() == VariantKind::kObject
+  static Value Object(VariantValue value);
+
   // Creates a value of extended type with the given content.
   static Value Extended(const ExtendedType* type, const ValueContent& value);
 
@@ -535,6 +546,8 @@ class Value {
   static Value NullNumeric();
   static Value NullBigNumeric();
   static Value NullJson();
+  static Value NullVariant();
+  static Value NullObject();
 
   // Returns an empty but non-null Geography value.
   static Value EmptyGeography();
@@ -751,7 +764,8 @@ class Value {
   explicit Value(double value);
   // REQUIRES: type_kind is date or timestamp_{seconds|millis|micros}
   Value(TypeKind type_kind, int64_t value);
-  // REQUIRES: type_kind is string or bytes
+  // REQUIRES: type_kind is string, bytes, variant or object. For variant and
+  // object, 'value' is the VariantValue encoding.
   Value(TypeKind type_kind, std::string value);
 
   // Constructs a timestamp value.
@@ -966,8 +980,10 @@ class Value {
     int32_t bit_field_32_value_;  // Whole-second part of TimeValue.
     int64_t bit_field_64_value_;  // Whole-second part of DatetimeValue.
     int32_t enum_value_;          // Used for TYPE_ENUM.
-    internal::StringRef*
-        string_ptr_;  // Reffed. Used for TYPE_STRING and TYPE_BYTES.
+    // Reffed, except for the shared StringRefs of short strings (see
+    // StringRef::Static()). Used for TYPE_STRING and TYPE_BYTES, and holds the
+    // encoding of TYPE_VARIANT and TYPE_OBJECT.
+    internal::StringRef* string_ptr_;
     internal::ValueContentContainerRef*
         container_ptr_;  // Reffed. Used for arrays, structs, and RANGE.
     internal::ProtoRep* proto_ptr_;          // Reffed. Used for protos.
@@ -1027,6 +1043,8 @@ Value Numeric(NumericValue v);
 Value Numeric(int64_t v);
 Value BigNumeric(BigNumericValue v);
 Value BigNumeric(int64_t v);
+Value Variant(VariantValue v);
+Value Object(VariantValue v);
 Value Enum(const EnumType* enum_type, int32_t value,
            bool allow_unnamed_values = true);
 Value Enum(const EnumType* enum_type, absl::string_view name);
@@ -1061,6 +1079,8 @@ Value NullDatetime();
 Value NullInterval();
 Value NullNumeric();
 Value NullBigNumeric();
+Value NullVariant();
+Value NullObject();
 Value Null(const Type* type);
 
 // Constructor for an invalid value.
@@ -0,0 +1,88 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Measures creating and copying STRING Values of various lengths, such as the
+// cells of a scanned table.
+
+#include <string>
+#include <vector>
+
+#include "zetasql/public/value.h"
+#include "benchmark/benchmark.h"
+
+namespace zetasql {
+
+static constexpr int kNumValues = 1024;
+
+static std::vector<std::string> MakeStrings(int length) {
+  std::vector<std::string> strings;
+  for (int i = 0; i < kNumValues; ++i) {
+    strings.push_back(std::string(length, static_cast<char>('a' + i % 26)));
+  }
+  return strings;
+}
+
+// Argument: string length.
+static void BM_CreateString(::benchmark::State& state) {
+  const std::vector<std::string> strings = MakeStrings(state.range(0));
+  for (auto s : state) {
+    for (const std::string& string : strings) {
+      ::benchmark::DoNotOptimize(Value::String(string));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumValues);
+}
+BENCHMARK(BM_CreateString)->Arg(0)->Arg(1)->Arg(8)->Arg(64);
+
+// Argument: string length.
+static void BM_CopyString(::benchmark::State& state) {
+  std::vector<Value> values;
+  for (const std::string& string : MakeStrings(state.range(0))) {
+    values.push_back(Value::String(string));
+  }
+  std::vector<Value> copies(kNumValues);
+  for (auto s : state) {
+    for (int i = 0; i < kNumValues; ++i) {
+      copies[i] = values[i];
+    }
+    ::benchmark::DoNotOptimize(copies.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kNumValues);
+}
+BENCHMARK(BM_CopyString)->Arg(0)->Arg(1)->Arg(8)->Arg(64);
+
+// Copies with all threads sharing the same source values, which is where
+// reference counting is most expensive.
+static void BM_CopyStringShared(::benchmark::State& state) {
+  static const std::vector<Value>* const kValues = [] {
+    auto* values = new std::vector<Value>;
+    for (const std::string& string : MakeStrings(1)) {
+      values->push_back(Value::String(string));
+    }
+    return values;
+  }();
+  std::vector<Value> copies(kNumValues);
+  for (auto s : state) {
+    for (int i = 0; i < kNumValues; ++i) {
+      copies[i] = (*kValues)[i];
+    }
+    ::benchmark::DoNotOptimize(copies.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kNumValues);
+}
+BENCHMARK(BM_CopyStringShared)->ThreadRange(1, 8);
+
+}  // namespace zetasql
@@ -183,10 +183,15 @@ inline Value::Value(double value)
     : metadata_(TypeKind::TYPE_DOUBLE), double_value_(value) {}
 
 inline Value::Value(TypeKind type_kind, std::string value)
-    : metadata_(type_kind),
-      string_ptr_(new internal::StringRef(std::move(value))) {
-  ABSL_CHECK(type_kind == TYPE_STRING ||
-        type_kind == TYPE_BYTES);
+    : metadata_(type_kind) {
+  ABSL_CHECK(type_kind == TYPE_STRING || type_kind == TYPE_BYTES ||
+             type_kind == TYPE_VARIANT || type_kind == TYPE_OBJECT);
+  if (value.size() <= internal::StringRef::kMaxStaticSize) {
+    metadata_ = Metadata(type_kind, internal::StringRef::kStaticContent);
+    string_ptr_ = internal::StringRef::Static(value);
+  } else {
+    string_ptr_ = new internal::StringRef(std::move(value));
+  }
 }
 
 inline Value::Value(const NumericValue& numeric)
@@ -319,6 +324,14 @@ inline Value Value::UnvalidatedJsonString(std::string v) {
 inline Value Value::Json(JSONValue v) {
   return Value(new internal::JSONRef(std::move(v)));
 }
+inline Value Value::Variant(VariantValue v) {
+  return Value(TYPE_VARIANT, std::move(v).Release());
+}
+inline Value Value::Object(VariantValue v) {
+  ABSL_CHECK(v.GetConstRef().kind() == VariantKind::kObject)
+      << "Not an object";
+  return Value(TYPE_OBJECT, std::move(v).Release());
+}
 inline Value Value::Enum(const EnumType* type, int64_t value,
                          bool allow_unknown_enum_values) {
   return Value(type, value, allow_unknown_enum_values);
@@ -354,6 +367,8 @@ inline Value Value::NullBigNumeric() {
   return Value(TypeKind::TYPE_BIGNUMERIC);
 }
 inline Value Value::NullJson() { return Value(TypeKind::TYPE_JSON); }
+inline Value Value::NullVariant() { return Value(TypeKind::TYPE_VARIANT); }
+inline Value Value::NullObject() { return Value(TypeKind::TYPE_OBJECT); }
 inline Value Value::EmptyGeography() {
   ABSL_CHECK(false);
   return NullGeography();
@@ -528,6 +543,14 @@ inline JSONValueConstRef Value::json_value() const {
   return json_ptr_->document().value();
 }
 
+inline VariantConstRef Value::variant_value() const {
+  ABSL_CHECK(metadata_.type_kind() == TYPE_VARIANT ||
+             metadata_.type_kind() == TYPE_OBJECT)
+      << "Not a variant type";
+  ABSL_CHECK(!metadata_.is_null()) << "Null value";
+  return VariantConstRef(string_ptr_->value());
+}
+
 inline std::string Value::json_string() const {
   ABSL_CHECK_EQ(TYPE_JSON, metadata_.type_kind()) << "Not a json type";
   ABSL_CHECK(!metadata_.is_null()) << "Null value";
@@ -849,6 +872,10 @@ inline Value BigNumeric(int64_t v) {
 
 inline Value Json(JSONValue v) { return Value::Json(std::move(v)); }
 
+inline Value Variant(VariantValue v) { return Value::Variant(std::move(v)); }
+
+inline Value Object(VariantValue v) { return Value::Object(std::move(v)); }
+
 inline Value Enum(const EnumType* enum_type, int32_t value,
                   bool allow_unnamed_values) {
   return Value::Enum(enum_type, value, allow_unnamed_values);
@@ -910,6 +937,8 @@ inline Value NullGeography() { return Value::NullGeography(); }
 inline Value NullNumeric() { return Value::NullNumeric(); }
 inline Value NullBigNumeric() { return Value::NullBigNumeric(); }
 inline Value NullJson() { return Value::NullJson(); }
+inline Value NullVariant() { return Value::NullVariant(); }
+inline Value NullObject() { return Value::NullObject(); }
 inline Value Null(const Type* type) { return Value::Null(type); }
 
 inline Value Invalid() { return Value::Invalid(); }
@@ -55,6 +55,7 @@
 #include "zetasql/public/simple_catalog.h"
 #include "zetasql/public/type.h"
 #include "zetasql/public/types/type_factory.h"
+#include "zetasql/public/variant_value.h"
 #include "zetasql/testdata/test_schema.pb.h"
 #include "zetasql/testing/test_value.h"
 #include "zetasql/testing/using_test_value.cc"
@@ -82,6 +83,7 @@ using ::google::protobuf::internal::WireFormatLite;
 using ::testing::HasSubstr;
 using ::testing::IsEmpty;
 using ::testing::Not;
+using ::zetasql_base::testing::IsOkAndHolds;
 using ::zetasql_base::testing::StatusIs;
 
 using interval_testing::Days;
@@ -451,6 +453,37 @@ TEST_F(ValueTest, StringNonNull) {
   EXPECT_EQ("foo", value_copy.string_value());
 }
 
+TEST_F(ValueTest, ShortStringsAreShared) {
+  // Empty and single byte strings are not allocated.
+  const Value empty = Value::String("");
+  const Value a = Value::Bytes("a");
+  EXPECT_EQ(&empty.string_value(), &Value::String("").string_value());
+  EXPECT_EQ(&a.bytes_value(), &Value::Bytes(std::string(1, 'a')).bytes_value());
+  EXPECT_EQ(&Value::String("\xff").string_value(),
+            &Value::Bytes("\xff").bytes_value());
+  EXPECT_NE(&Value::String("ab").string_value(),
+            &Value::String("ab").string_value());
+
+  // Copies and moves behave like those of other strings.
+  Value copy = a;
+  Value moved = std::move(copy);
+  copy = empty;
+  EXPECT_EQ(moved, a);
+  EXPECT_EQ(copy, empty);
+  EXPECT_EQ(moved.bytes_value(), "a");
+
+  // They are equal to, and hash like, strings that are allocated, such as
+  // deserialized ones.
+  ValueProto proto;
+  proto.set_bytes_value("a");
+  ZETASQL_ASSERT_OK_AND_ASSIGN(const Value deserialized,
+                       Value::Deserialize(proto, BytesType()));
+  EXPECT_EQ(deserialized, a);
+  EXPECT_EQ(deserialized.HashCode(), a.HashCode());
+  EXPECT_FALSE(deserialized.LessThan(a));
+  EXPECT_FALSE(a.LessThan(deserialized));
+}
+
 void disguised_move(Value& o1, Value& o2) {  // NOLINT
   o1 = std::move(o2);
 }
@@ -933,6 +966,83 @@ TEST_F(ValueTest, JSONFormatting) {
       R"sql(JSON '{"foo":[1,null,"bar"],"foo2":"hello","foo3":true}')sql");
 }
 
+TEST_F(ValueTest, Variant) {
+  const Value null_variant = Value::NullVariant();
+  EXPECT_TRUE(null_variant.is_null());
+  EXPECT_EQ(null_variant.type_kind(), TYPE_VARIANT);
+  EXPECT_DEATH(null_variant.variant_value(), "Null value");
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      VariantValue parsed,
+      VariantValue::ParseJson(R"({"b": [1, null], "a": "x"})"));
+  const Value variant = Value::Variant(std::move(parsed));
+  EXPECT_EQ(variant.type_kind(), TYPE_VARIANT);
+  EXPECT_EQ(variant.variant_value().kind(), VariantKind::kObject);
+  EXPECT_EQ(variant.DebugString(), R"({"a":"x","b":[1,null]})");
+  EXPECT_EQ(variant.GetSQLLiteral(), R"(PARSE_JSON('{"a":"x","b":[1,null]}'))");
+
+  // Values built differently are equal and hash the same.
+  ZETASQL_ASSERT_OK_AND_ASSIGN(VariantValue reparsed,
+                       VariantValue::ParseJson(R"({"a":"x","b":[1,null]})"));
+  const Value same = Value::Variant(std::move(reparsed));
+  EXPECT_EQ(variant, same);
+  EXPECT_EQ(variant.HashCode(), same.HashCode());
+  EXPECT_NE(variant, Value::Variant(VariantValue::String("x")));
+
+  // Numbers compare by value rather than by encoding.
+  ZETASQL_ASSERT_OK_AND_ASSIGN(VariantValue integer,
+                       VariantValue::ParseJson("1"));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(VariantValue decimal,
+                       VariantValue::ParseJson("1.0"));
+  EXPECT_EQ(Value::Variant(std::move(integer)),
+            Value::Variant(std::move(decimal)));
+  EXPECT_EQ(Value::Variant(VariantValue::Double(0.0)).HashCode(),
+            Value::Variant(VariantValue::Double(-0.0)).HashCode());
+
+  // Single byte encodings, such as JSON null and booleans, are shared.
+  EXPECT_EQ(Value::Variant(VariantValue::Null()),
+            Value::Variant(VariantValue::Null()));
+  EXPECT_NE(Value::Variant(VariantValue::Boolean(false)),
+            Value::Variant(VariantValue::Boolean(true)));
+
+  // VARIANT supports grouping but not ordering.
+  const LanguageOptions language_options;
+  EXPECT_TRUE(types::VariantType()->SupportsGrouping(language_options));
+  EXPECT_FALSE(types::VariantType()->SupportsOrdering(
+      language_options, /*type_description=*/nullptr));
+  EXPECT_FALSE(types::ObjectType()->SupportsOrdering(
+      language_options, /*type_description=*/nullptr));
+
+  ValueProto proto;
+  ZETASQL_ASSERT_OK(variant.Serialize(&proto));
+  EXPECT_TRUE(proto.has_variant_value());
+  EXPECT_THAT(Value::Deserialize(proto, types::VariantType()),
+              IsOkAndHolds(variant));
+  proto.set_variant_value("\xff");
+  EXPECT_THAT(Value::Deserialize(proto, types::VariantType()),
+              StatusIs(absl::StatusCode::kOutOfRange));
+}
+
+TEST_F(ValueTest, Object) {
+  ZETASQL_ASSERT_OK_AND_ASSIGN(VariantValue parsed,
+                       VariantValue::ParseJson(R"({"k": 1})"));
+  const Value object = Value::Object(std::move(parsed));
+  EXPECT_EQ(object.type_kind(), TYPE_OBJECT);
+  EXPECT_EQ(object.variant_value().GetObjectSize(), 1);
+  EXPECT_EQ(object.GetSQLLiteral(), R"(TO_OBJECT(PARSE_JSON('{"k":1}')))");
+  EXPECT_TRUE(Value::NullObject().is_null());
+
+  ValueProto proto;
+  ZETASQL_ASSERT_OK(object.Serialize(&proto));
+  EXPECT_THAT(Value::Deserialize(proto, types::ObjectType()),
+              IsOkAndHolds(object));
+  // Only objects can be deserialized as OBJECT.
+  ZETASQL_ASSERT_OK(Value::Variant(VariantValue::Integer(1)).Serialize(&proto));
+  EXPECT_THAT(Value::Deserialize(proto, types::ObjectType()),
+              StatusIs(absl::StatusCode::kOutOfRange,
+                       HasSubstr("not an object")));
+}
+
 TEST_F(ValueTest, GenericAccessors) {
   // Return types.
   static Value v;
@@ -3953,13 +4063,16 @@ TEST_F(ValueTest, PhysicalByteSize) {
   EXPECT_EQ(empty_array_size + 3 * Value::Int64(1).physical_byte_size(),
             values::Int64Array({1, 2, 3}).physical_byte_size());
 
-  EXPECT_EQ(sizeof(Value) + sizeof(internal::StringRef),
-            Value::Bytes("").physical_byte_size());
+  // Empty and single byte strings are shared, so they have no allocation.
+  EXPECT_EQ(sizeof(Value), Value::Bytes("").physical_byte_size());
+  EXPECT_EQ(sizeof(Value), Value::Bytes("a").physical_byte_size());
   EXPECT_EQ(sizeof(Value) + sizeof(internal::StringRef) + 3 * sizeof(char),
             Value::Bytes("abc").physical_byte_size());
   // Strings should be consistent with bytes.
   EXPECT_EQ(Value::Bytes("").physical_byte_size(),
             Value::String("").physical_byte_size());
+  EXPECT_EQ(Value::Bytes("a").physical_byte_size(),
+            Value::String("a").physical_byte_size());
   EXPECT_EQ(Value::Bytes("abc").physical_byte_size(),
             Value::String("abc").physical_byte_size());
 
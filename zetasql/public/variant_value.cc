@@ -0,0 +1,1290 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/public/variant_value.h"
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "zetasql/base/endian.h"
+#include "zetasql/base/logging.h"
+#include "zetasql/common/json_structural_index.h"
+#include "zetasql/common/json_util.h"
+#include "zetasql/common/string_util.h"
+#include "zetasql/public/civil_time.h"
+#include "zetasql/public/functions/date_time_util.h"
+#include "zetasql/public/numeric_value.h"
+#include "absl/base/casts.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/escaping.h"
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "zetasql/base/status_macros.h"
+
+namespace zetasql {
+namespace {
+
+using ::zetasql_base::LittleEndian;
+
+// The first byte of every encoded value.
+enum Tag : uint8_t {
+  kTagNull = 0,
+  kTagFalse = 1,
+  kTagTrue = 2,
+  kTagInteger = 3,
+  kTagDecimal = 4,
+  kTagDouble = 5,
+  kTagString = 6,
+  kTagBinary = 7,
+  kTagDate = 8,
+  kTagTime = 9,
+  kTagTimestampNtz = 10,
+  kTagTimestampTz = 11,
+  kTagArray = 12,
+  kTagObject = 13,
+};
+
+constexpr size_t kTagSize = 1;
+constexpr size_t kOffsetSize = sizeof(uint32_t);
+// Size of the tag and element count that start arrays and objects.
+constexpr size_t kContainerHeaderSize = kTagSize + kOffsetSize;
+// Offsets are 32 bits, which limits the data of a single container.
+constexpr size_t kMaxContainerDataSize = std::numeric_limits<uint32_t>::max();
+// Bounds the recursion of the parser and the validator.
+constexpr int kMaxNestingDepth = 1000;
+
+Tag GetTag(absl::string_view encoded) {
+  ABSL_DCHECK(!encoded.empty());
+  return static_cast<Tag>(static_cast<uint8_t>(encoded[0]));
+}
+
+void AppendTag(Tag tag, std::string* output) {
+  output->push_back(static_cast<char>(tag));
+}
+
+void AppendUint32(uint32_t value, std::string* output) {
+  char buffer[sizeof(value)];
+  LittleEndian::Store32(buffer, value);
+  output->append(buffer, sizeof(buffer));
+}
+
+void AppendUint64(uint64_t value, std::string* output) {
+  char buffer[sizeof(value)];
+  LittleEndian::Store64(buffer, value);
+  output->append(buffer, sizeof(buffer));
+}
+
+uint32_t LoadUint32(absl::string_view encoded, size_t position) {
+  return LittleEndian::Load32(encoded.data() + position);
+}
+
+uint64_t LoadUint64(absl::string_view encoded, size_t position) {
+  return LittleEndian::Load64(encoded.data() + position);
+}
+
+std::string EncodeTag(Tag tag) {
+  return std::string(1, static_cast<char>(tag));
+}
+
+std::string EncodeUint64(Tag tag, uint64_t value) {
+  std::string encoded = EncodeTag(tag);
+  AppendUint64(value, &encoded);
+  return encoded;
+}
+
+std::string EncodeBytes(Tag tag, absl::string_view value) {
+  std::string encoded;
+  encoded.reserve(kTagSize + value.size());
+  AppendTag(tag, &encoded);
+  encoded.append(value);
+  return encoded;
+}
+
+std::string EncodeDecimal(const NumericValue& value) {
+  std::string encoded = EncodeTag(kTagDecimal);
+  AppendUint64(value.high_bits(), &encoded);
+  AppendUint64(value.low_bits(), &encoded);
+  return encoded;
+}
+
+// Encodes a value as seconds and nanoseconds.
+std::string EncodeSecondsAndNanos(Tag tag, int64_t seconds, int32_t nanos) {
+  std::string encoded = EncodeTag(tag);
+  AppendUint64(static_cast<uint64_t>(seconds), &encoded);
+  AppendUint32(static_cast<uint32_t>(nanos), &encoded);
+  return encoded;
+}
+
+absl::Status ContainerTooLargeError() {
+  return absl::OutOfRangeError("VARIANT value is too large");
+}
+
+// Appends an array of the encoded values <elements> to <output>.
+absl::Status AppendArray(absl::Span<const absl::string_view> elements,
+                         std::string* output) {
+  size_t data_size = 0;
+  for (absl::string_view element : elements) {
+    data_size += element.size();
+  }
+  if (data_size > kMaxContainerDataSize) {
+    return ContainerTooLargeError();
+  }
+  output->reserve(output->size() + kContainerHeaderSize +
+                  kOffsetSize * elements.size() + data_size);
+  AppendTag(kTagArray, output);
+  AppendUint32(static_cast<uint32_t>(elements.size()), output);
+  uint32_t end = 0;
+  for (absl::string_view element : elements) {
+    end += static_cast<uint32_t>(element.size());
+    AppendUint32(end, output);
+  }
+  for (absl::string_view element : elements) {
+    output->append(element);
+  }
+  return absl::OkStatus();
+}
+
+using EncodedMember = std::pair<absl::string_view, absl::string_view>;
+
+// Appends an object to <output>. <members> holds keys and encoded values, and
+// must be sorted by key without duplicates.
+absl::Status AppendObject(absl::Span<const EncodedMember> members,
+                          std::string* output) {
+  size_t keys_size = 0;
+  size_t values_size = 0;
+  for (const EncodedMember& member : members) {
+    keys_size += member.first.size();
+    values_size += member.second.size();
+  }
+  if (keys_size > kMaxContainerDataSize ||
+      values_size > kMaxContainerDataSize) {
+    return ContainerTooLargeError();
+  }
+  output->reserve(output->size() + kContainerHeaderSize +
+                  2 * kOffsetSize * members.size() + keys_size + values_size);
+  AppendTag(kTagObject, output);
+  AppendUint32(static_cast<uint32_t>(members.size()), output);
+  uint32_t end = 0;
+  for (const EncodedMember& member : members) {
+    end += static_cast<uint32_t>(member.first.size());
+    AppendUint32(end, output);
+  }
+  end = 0;
+  for (const EncodedMember& member : members) {
+    end += static_cast<uint32_t>(member.second.size());
+    AppendUint32(end, output);
+  }
+  for (const EncodedMember& member : members) {
+    output->append(member.first);
+  }
+  for (const EncodedMember& member : members) {
+    output->append(member.second);
+  }
+  return absl::OkStatus();
+}
+
+// Appends the array parsed from JSON to <output>. <data> holds the encoded
+// elements, which end at <ends>.
+absl::Status AppendParsedArray(absl::string_view data,
+                               absl::Span<const size_t> ends,
+                               std::string* output) {
+  std::vector<absl::string_view> elements;
+  elements.reserve(ends.size());
+  size_t start = 0;
+  for (size_t end : ends) {
+    elements.push_back(data.substr(start, end - start));
+    start = end;
+  }
+  return AppendArray(elements, output);
+}
+
+// Appends the object parsed from JSON to <output>. <data> holds the encoded
+// values of <keys>, which end at <ends>.
+absl::Status AppendParsedObject(absl::Span<const std::string> keys,
+                                absl::string_view data,
+                                absl::Span<const size_t> ends,
+                                std::string* output) {
+  std::vector<EncodedMember> members;
+  members.reserve(keys.size());
+  size_t start = 0;
+  for (int i = 0; i < keys.size(); ++i) {
+    members.emplace_back(keys[i], data.substr(start, ends[i] - start));
+    start = ends[i];
+  }
+  // Sort by key, keeping the last value of duplicate keys.
+  std::stable_sort(members.begin(), members.end(),
+                   [](const EncodedMember& a, const EncodedMember& b) {
+                     return a.first < b.first;
+                   });
+  std::vector<EncodedMember> unique_members;
+  unique_members.reserve(members.size());
+  for (const EncodedMember& member : members) {
+    if (!unique_members.empty() &&
+        unique_members.back().first == member.first) {
+      unique_members.back() = member;
+    } else {
+      unique_members.push_back(member);
+    }
+  }
+  return AppendObject(unique_members, output);
+}
+
+// Appends the JSON number <number> to <output>: as an INTEGER if it is an
+// integer in range, as a DECIMAL if it has no exponent and fits, and as a
+// DOUBLE otherwise. Returns false if it overflows a DOUBLE.
+bool AppendJsonNumber(absl::string_view number, std::string* output) {
+  if (number.find_first_of("eE") == absl::string_view::npos) {
+    int64_t integer;
+    if (number.find('.') == absl::string_view::npos &&
+        absl::SimpleAtoi(number, &integer)) {
+      output->append(EncodeUint64(kTagInteger, integer));
+      return true;
+    }
+    absl::StatusOr<NumericValue> decimal =
+        NumericValue::FromStringStrict(number);
+    if (decimal.ok()) {
+      output->append(EncodeDecimal(*decimal));
+      return true;
+    }
+  }
+  double value;
+  if (!absl::SimpleAtod(number, &value) || !std::isfinite(value)) {
+    return false;
+  }
+  output->append(EncodeUint64(kTagDouble, absl::bit_cast<uint64_t>(value)));
+  return true;
+}
+
+// Appends the UTF-8 encoding of <code_point> to <output>.
+void AppendUtf8(uint32_t code_point, std::string* output) {
+  if (code_point < 0x80) {
+    output->push_back(static_cast<char>(code_point));
+  } else if (code_point < 0x800) {
+    output->push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+    output->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  } else if (code_point < 0x10000) {
+    output->push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+    output->push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+    output->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  } else {
+    output->push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+    output->push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+    output->push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+    output->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  }
+}
+
+// Parses JSON text directly into the VARIANT encoding, without building a
+// document tree first. This is the reference for JsonToVariantHandler and
+// reports the errors for input that the structural parser does not accept.
+class JsonToVariantParser {
+ public:
+  explicit JsonToVariantParser(absl::string_view input) : input_(input) {}
+
+  JsonToVariantParser(const JsonToVariantParser&) = delete;
+  JsonToVariantParser& operator=(const JsonToVariantParser&) = delete;
+
+  absl::Status Parse(std::string* output) {
+    SkipWhitespace();
+    ZETASQL_RETURN_IF_ERROR(ParseValue(/*depth=*/0, output));
+    SkipWhitespace();
+    if (position_ != input_.size()) {
+      return Error("unexpected trailing characters");
+    }
+    return absl::OkStatus();
+  }
+
+ private:
+  absl::Status Error(absl::string_view message) const {
+    return absl::OutOfRangeError(absl::StrCat(
+        "Invalid JSON at position ", position_, ": ", message));
+  }
+
+  bool AtEnd() const { return position_ >= input_.size(); }
+
+  char Peek() const { return input_[position_]; }
+
+  void SkipWhitespace() {
+    while (!AtEnd()) {
+      const char c = Peek();
+      if (c != ' ' && c != '\t' && c != '\n' && c != '\r') break;
+      ++position_;
+    }
+  }
+
+  // Consumes <c> and any whitespace following it, if the input is at <c>.
+  bool Consume(char c) {
+    if (AtEnd() || Peek() != c) return false;
+    ++position_;
+    SkipWhitespace();
+    return true;
+  }
+
+  absl::Status ParseLiteral(absl::string_view literal, Tag tag,
+                            std::string* output) {
+    if (!absl::StartsWith(input_.substr(position_), literal)) {
+      return Error("unexpected character");
+    }
+    position_ += literal.size();
+    AppendTag(tag, output);
+    return absl::OkStatus();
+  }
+
+  absl::Status ParseValue(int depth, std::string* output) {
+    if (AtEnd()) {
+      return Error("unexpected end of input");
+    }
+    switch (Peek()) {
+      case '{':
+        return ParseObject(depth, output);
+      case '[':
+        return ParseArray(depth, output);
+      case '"': {
+        std::string value;
+        ZETASQL_RETURN_IF_ERROR(ParseString(&value));
+        AppendTag(kTagString, output);
+        output->append(value);
+        return absl::OkStatus();
+      }
+      case 't':
+        return ParseLiteral("true", kTagTrue, output);
+      case 'f':
+        return ParseLiteral("false", kTagFalse, output);
+      case 'n':
+        return ParseLiteral("null", kTagNull, output);
+      default:
+        return ParseNumber(output);
+    }
+  }
+
+  absl::Status ParseArray(int depth, std::string* output) {
+    if (depth >= kMaxNestingDepth) {
+      return Error("maximum nesting depth exceeded");
+    }
+    ++position_;  // '['
+    SkipWhitespace();
+    std::string data;
+    std::vector<size_t> ends;
+    if (!Consume(']')) {
+      do {
+        ZETASQL_RETURN_IF_ERROR(ParseValue(depth + 1, &data));
+        ends.push_back(data.size());
+        SkipWhitespace();
+      } while (Consume(','));
+      if (!Consume(']')) {
+        return Error("expected ',' or ']'");
+      }
+    }
+    return AppendParsedArray(data, ends, output);
+  }
+
+  absl::Status ParseObject(int depth, std::string* output) {
+    if (depth >= kMaxNestingDepth) {
+      return Error("maximum nesting depth exceeded");
+    }
+    ++position_;  // '{'
+    SkipWhitespace();
+    std::vector<std::string> keys;
+    std::string data;
+    std::vector<size_t> ends;
+    if (!Consume('}')) {
+      do {
+        if (AtEnd() || Peek() != '"') {
+          return Error("expected object key");
+        }
+        keys.emplace_back();
+        ZETASQL_RETURN_IF_ERROR(ParseString(&keys.back()));
+        SkipWhitespace();
+        if (!Consume(':')) {
+          return Error("expected ':'");
+        }
+        ZETASQL_RETURN_IF_ERROR(ParseValue(depth + 1, &data));
+        ends.push_back(data.size());
+        SkipWhitespace();
+      } while (Consume(','));
+      if (!Consume('}')) {
+        return Error("expected ',' or '}'");
+      }
+    }
+    return AppendParsedObject(keys, data, ends, output);
+  }
+
+  absl::Status ParseHex4(uint32_t* code_unit) {
+    if (input_.size() - position_ < 4) {
+      return Error("incomplete unicode escape");
+    }
+    *code_unit = 0;
+    for (int i = 0; i < 4; ++i) {
+      const char c = input_[position_++];
+      uint32_t digit;
+      if (c >= '0' && c <= '9') {
+        digit = c - '0';
+      } else if (c >= 'a' && c <= 'f') {
+        digit = c - 'a' + 10;
+      } else if (c >= 'A' && c <= 'F') {
+        digit = c - 'A' + 10;
+      } else {
+        return Error("invalid unicode escape");
+      }
+      *code_unit = (*code_unit << 4) | digit;
+    }
+    return absl::OkStatus();
+  }
+
+  absl::Status ParseString(std::string* value) {
+    ++position_;  // '"'
+    while (true) {
+      // Copy runs of unescaped characters at once.
+      const size_t run_start = position_;
+      while (!AtEnd() && Peek() != '"' && Peek() != '\\' &&
+             static_cast<unsigned char>(Peek()) >= 0x20) {
+        ++position_;
+      }
+      value->append(input_.substr(run_start, position_ - run_start));
+      if (AtEnd()) {
+        return Error("unterminated string");
+      }
+      const char c = input_[position_++];
+      if (c == '"') {
+        return absl::OkStatus();
+      }
+      if (c != '\\') {
+        --position_;
+        return Error("control character in string");
+      }
+      if (AtEnd()) {
+        return Error("unterminated string");
+      }
+      switch (input_[position_++]) {
+        case '"':
+          value->push_back('"');
+          break;
+        case '\\':
+          value->push_back('\\');
+          break;
+        case '/':
+          value->push_back('/');
+          break;
+        case 'b':
+          value->push_back('\b');
+          break;
+        case 'f':
+          value->push_back('\f');
+          break;
+        case 'n':
+          value->push_back('\n');
+          break;
+        case 'r':
+          value->push_back('\r');
+          break;
+        case 't':
+          value->push_back('\t');
+          break;
+        case 'u': {
+          uint32_t code_point;
+          ZETASQL_RETURN_IF_ERROR(ParseHex4(&code_point));
+          if (code_point >= 0xDC00 && code_point <= 0xDFFF) {
+            return Error("unpaired surrogate in unicode escape");
+          }
+          if (code_point >= 0xD800 && code_point <= 0xDBFF) {
+            uint32_t low;
+            if (!absl::StartsWith(input_.substr(position_), "\\u")) {
+              return Error("unpaired surrogate in unicode escape");
+            }
+            position_ += 2;
+            ZETASQL_RETURN_IF_ERROR(ParseHex4(&low));
+            if (low < 0xDC00 || low > 0xDFFF) {
+              return Error("unpaired surrogate in unicode escape");
+            }
+            code_point = 0x10000 + ((code_point - 0xD800) << 10) +
+                         (low - 0xDC00);
+          }
+          AppendUtf8(code_point, value);
+          break;
+        }
+        default:
+          --position_;
+          return Error("invalid escape sequence");
+      }
+    }
+  }
+
+  void SkipDigits() {
+    while (!AtEnd() && absl::ascii_isdigit(Peek())) ++position_;
+  }
+
+  absl::Status ParseNumber(std::string* output) {
+    const size_t start = position_;
+    if (Peek() == '-') ++position_;
+    if (AtEnd() || !absl::ascii_isdigit(Peek())) {
+      return Error("unexpected character");
+    }
+    if (Peek() == '0') {
+      ++position_;
+    } else {
+      SkipDigits();
+    }
+    if (!AtEnd() && Peek() == '.') {
+      ++position_;
+      if (AtEnd() || !absl::ascii_isdigit(Peek())) {
+        return Error("expected digit after '.'");
+      }
+      SkipDigits();
+    }
+    if (!AtEnd() && (Peek() == 'e' || Peek() == 'E')) {
+      ++position_;
+      if (!AtEnd() && (Peek() == '+' || Peek() == '-')) ++position_;
+      if (AtEnd() || !absl::ascii_isdigit(Peek())) {
+        return Error("expected digit in exponent");
+      }
+      SkipDigits();
+    }
+    if (!AppendJsonNumber(input_.substr(start, position_ - start), output)) {
+      return Error("number out of range");
+    }
+    return absl::OkStatus();
+  }
+
+  const absl::string_view input_;
+  size_t position_ = 0;
+};
+
+// Builds the VARIANT encoding from the events of
+// ParseJSONWithStructuralIndex(), with the same result as JsonToVariantParser.
+// Stops at the first error, which is then reported by JsonToVariantParser.
+//
+// NOTE: Method names are specific requirement of the SAX parser interface.
+class JsonToVariantHandler {
+ public:
+  explicit JsonToVariantHandler(std::string* output) : output_(output) {}
+
+  JsonToVariantHandler(const JsonToVariantHandler&) = delete;
+  JsonToVariantHandler& operator=(const JsonToVariantHandler&) = delete;
+
+  bool null() { return AppendValue(EncodeTag(kTagNull)); }
+
+  bool boolean(bool val) {
+    return AppendValue(EncodeTag(val ? kTagTrue : kTagFalse));
+  }
+
+  bool number_integer(int64_t val) {
+    return AppendValue(EncodeUint64(kTagInteger, val));
+  }
+
+  bool number_unsigned(uint64_t val) {
+    if (val <= std::numeric_limits<int64_t>::max()) {
+      return AppendValue(EncodeUint64(kTagInteger, val));
+    }
+    return AppendJsonNumber(absl::StrCat(val), Target()) && EndValue();
+  }
+
+  bool number_float(double /*unused*/, const std::string& input_str) {
+    return AppendJsonNumber(input_str, Target()) && EndValue();
+  }
+
+  bool string(std::string& val) {
+    std::string* target = Target();
+    AppendTag(kTagString, target);
+    target->append(val);
+    return EndValue();
+  }
+
+  bool start_object(size_t /*unused*/) { return BeginContainer(); }
+
+  bool key(std::string& val) {
+    containers_.back().keys.push_back(std::move(val));
+    return true;
+  }
+
+  bool end_object() {
+    Container object = std::move(containers_.back());
+    containers_.pop_back();
+    return AppendParsedObject(object.keys, object.data, object.ends, Target())
+               .ok() &&
+           EndValue();
+  }
+
+  bool start_array(size_t /*unused*/) { return BeginContainer(); }
+
+  bool end_array() {
+    Container array = std::move(containers_.back());
+    containers_.pop_back();
+    return AppendParsedArray(array.data, array.ends, Target()).ok() &&
+           EndValue();
+  }
+
+ private:
+  struct Container {
+    // Keys of the members of an object, empty for arrays.
+    std::vector<std::string> keys;
+    // The encoded elements or member values, which end at 'ends'.
+    std::string data;
+    std::vector<size_t> ends;
+  };
+
+  // Returns where the next value is encoded.
+  std::string* Target() {
+    return containers_.empty() ? output_ : &containers_.back().data;
+  }
+
+  bool BeginContainer() {
+    if (containers_.size() >= kMaxNestingDepth) {
+      return false;
+    }
+    containers_.emplace_back();
+    return true;
+  }
+
+  bool AppendValue(absl::string_view encoded) {
+    Target()->append(encoded);
+    return EndValue();
+  }
+
+  // Records the end of a value appended to the enclosing container.
+  bool EndValue() {
+    if (!containers_.empty()) {
+      containers_.back().ends.push_back(containers_.back().data.size());
+    }
+    return true;
+  }
+
+  std::string* output_;
+  // Containers being parsed, innermost last.
+  std::vector<Container> containers_;
+};
+
+absl::Status InvalidEncodingError() {
+  return absl::OutOfRangeError("Invalid VARIANT encoding");
+}
+
+// Checks that the offset table starting at <position> holds <count>
+// non-decreasing offsets. Returns the last offset, or 0 if <count> is 0.
+absl::StatusOr<size_t> ValidateOffsets(absl::string_view encoded,
+                                       size_t position, size_t count) {
+  uint32_t previous = 0;
+  for (size_t i = 0; i < count; ++i) {
+    const uint32_t end = LoadUint32(encoded, position + i * kOffsetSize);
+    if (end < previous) {
+      return InvalidEncodingError();
+    }
+    previous = end;
+  }
+  return previous;
+}
+
+absl::Status ValidateEncoding(absl::string_view encoded, int depth) {
+  if (encoded.empty() || depth > kMaxNestingDepth) {
+    return InvalidEncodingError();
+  }
+  const absl::string_view payload = encoded.substr(kTagSize);
+  switch (GetTag(encoded)) {
+    case kTagNull:
+    case kTagFalse:
+    case kTagTrue:
+      return payload.empty() ? absl::OkStatus() : InvalidEncodingError();
+    case kTagInteger:
+    case kTagDouble:
+      return payload.size() == sizeof(uint64_t) ? absl::OkStatus()
+                                                 : InvalidEncodingError();
+    case kTagDecimal:
+      if (payload.size() != 2 * sizeof(uint64_t) ||
+          !NumericValue::FromHighAndLowBits(LoadUint64(payload, 0),
+                                            LoadUint64(payload, 8))
+               .ok()) {
+        return InvalidEncodingError();
+      }
+      return absl::OkStatus();
+    case kTagString:
+    case kTagBinary:
+      return absl::OkStatus();
+    case kTagDate:
+      if (payload.size() != sizeof(int32_t) ||
+          !functions::IsValidDate(
+              static_cast<int32_t>(LoadUint32(payload, 0)))) {
+        return InvalidEncodingError();
+      }
+      return absl::OkStatus();
+    case kTagTime:
+      if (payload.size() != sizeof(int64_t) ||
+          !TimeValue::FromPacked64Nanos(LoadUint64(payload, 0)).IsValid()) {
+        return InvalidEncodingError();
+      }
+      return absl::OkStatus();
+    case kTagTimestampNtz:
+    case kTagTimestampTz: {
+      if (payload.size() != sizeof(int64_t) + sizeof(int32_t)) {
+        return InvalidEncodingError();
+      }
+      const int64_t seconds = static_cast<int64_t>(LoadUint64(payload, 0));
+      const int32_t nanos = static_cast<int32_t>(LoadUint32(payload, 8));
+      const bool valid =
+          GetTag(encoded) == kTagTimestampNtz
+              ? DatetimeValue::FromPacked64SecondsAndNanos(seconds, nanos)
+                    .IsValid()
+              : nanos >= 0 && nanos < 1000000000 &&
+                    functions::IsValidTime(absl::FromUnixSeconds(seconds) +
+                                           absl::Nanoseconds(nanos));
+      return valid ? absl::OkStatus() : InvalidEncodingError();
+    }
+    case kTagArray: {
+      if (encoded.size() < kContainerHeaderSize) {
+        return InvalidEncodingError();
+      }
+      const size_t count = LoadUint32(encoded, kTagSize);
+      if (count > (encoded.size() - kContainerHeaderSize) / kOffsetSize) {
+        return InvalidEncodingError();
+      }
+      const size_t data_start = kContainerHeaderSize + count * kOffsetSize;
+      ZETASQL_ASSIGN_OR_RETURN(size_t data_size,
+                       ValidateOffsets(encoded, kContainerHeaderSize, count));
+      if (data_start + data_size != encoded.size()) {
+        return InvalidEncodingError();
+      }
+      const VariantConstRef array(encoded);
+      for (size_t i = 0; i < count; ++i) {
+        ZETASQL_RETURN_IF_ERROR(
+            ValidateEncoding(array.GetArrayElement(i).encoded(), depth + 1));
+      }
+      return absl::OkStatus();
+    }
+    case kTagObject: {
+      if (encoded.size() < kContainerHeaderSize) {
+        return InvalidEncodingError();
+      }
+      const size_t count = LoadUint32(encoded, kTagSize);
+      if (count > (encoded.size() - kContainerHeaderSize) / (2 * kOffsetSize)) {
+        return InvalidEncodingError();
+      }
+      const size_t key_offsets = kContainerHeaderSize;
+      const size_t value_offsets = key_offsets + count * kOffsetSize;
+      const size_t keys_start = value_offsets + count * kOffsetSize;
+      ZETASQL_ASSIGN_OR_RETURN(size_t keys_size,
+                       ValidateOffsets(encoded, key_offsets, count));
+      ZETASQL_ASSIGN_OR_RETURN(size_t values_size,
+                       ValidateOffsets(encoded, value_offsets, count));
+      if (keys_start + keys_size + values_size != encoded.size()) {
+        return InvalidEncodingError();
+      }
+      const VariantConstRef object(encoded);
+      for (size_t i = 0; i < count; ++i) {
+        if (i > 0 && object.GetObjectKey(i - 1) >= object.GetObjectKey(i)) {
+          return InvalidEncodingError();
+        }
+        ZETASQL_RETURN_IF_ERROR(
+            ValidateEncoding(object.GetObjectValue(i).encoded(), depth + 1));
+      }
+      return absl::OkStatus();
+    }
+    default:
+      return InvalidEncodingError();
+  }
+}
+
+// Returns the byte range [start, end) of entry <index> of a container, given
+// the position of its offset table and of its data.
+absl::string_view GetContainerEntry(absl::string_view encoded,
+                                    size_t offsets_position,
+                                    size_t data_position, size_t index) {
+  const uint32_t start =
+      index == 0
+          ? 0
+          : LoadUint32(encoded, offsets_position + (index - 1) * kOffsetSize);
+  const uint32_t end =
+      LoadUint32(encoded, offsets_position + index * kOffsetSize);
+  return encoded.substr(data_position + start, end - start);
+}
+
+bool IsNumber(VariantKind kind) {
+  return kind == VariantKind::kInteger || kind == VariantKind::kDecimal ||
+         kind == VariantKind::kDouble;
+}
+
+}  // namespace
+
+absl::string_view VariantKindName(VariantKind kind) {
+  switch (kind) {
+    case VariantKind::kNull:
+      return "NULL_VALUE";
+    case VariantKind::kBoolean:
+      return "BOOLEAN";
+    case VariantKind::kInteger:
+      return "INTEGER";
+    case VariantKind::kDecimal:
+      return "DECIMAL";
+    case VariantKind::kDouble:
+      return "DOUBLE";
+    case VariantKind::kString:
+      return "VARCHAR";
+    case VariantKind::kBinary:
+      return "BINARY";
+    case VariantKind::kDate:
+      return "DATE";
+    case VariantKind::kTime:
+      return "TIME";
+    case VariantKind::kTimestampNtz:
+      return "TIMESTAMP_NTZ";
+    case VariantKind::kTimestampTz:
+      return "TIMESTAMP_TZ";
+    case VariantKind::kArray:
+      return "ARRAY";
+    case VariantKind::kObject:
+      return "OBJECT";
+  }
+}
+
+VariantValue::VariantValue() : encoded_(EncodeTag(kTagNull)) {}
+
+VariantValue VariantValue::Null() { return VariantValue(); }
+
+VariantValue VariantValue::Boolean(bool value) {
+  return VariantValue(EncodeTag(value ? kTagTrue : kTagFalse));
+}
+
+VariantValue VariantValue::Integer(int64_t value) {
+  return VariantValue(EncodeUint64(kTagInteger, value));
+}
+
+VariantValue VariantValue::Decimal(const NumericValue& value) {
+  return VariantValue(EncodeDecimal(value));
+}
+
+VariantValue VariantValue::Double(double value) {
+  return VariantValue(
+      EncodeUint64(kTagDouble, absl::bit_cast<uint64_t>(value)));
+}
+
+VariantValue VariantValue::String(absl::string_view value) {
+  return VariantValue(EncodeBytes(kTagString, value));
+}
+
+VariantValue VariantValue::Binary(absl::string_view value) {
+  return VariantValue(EncodeBytes(kTagBinary, value));
+}
+
+VariantValue VariantValue::Date(int32_t value) {
+  std::string encoded = EncodeTag(kTagDate);
+  AppendUint32(static_cast<uint32_t>(value), &encoded);
+  return VariantValue(std::move(encoded));
+}
+
+VariantValue VariantValue::Time(TimeValue value) {
+  return VariantValue(EncodeUint64(kTagTime, value.Packed64TimeNanos()));
+}
+
+VariantValue VariantValue::TimestampNtz(DatetimeValue value) {
+  return VariantValue(EncodeSecondsAndNanos(kTagTimestampNtz,
+                                            value.Packed64DatetimeSeconds(),
+                                            value.Nanoseconds()));
+}
+
+VariantValue VariantValue::TimestampTz(absl::Time value) {
+  const int64_t seconds = absl::ToUnixSeconds(value);
+  const int32_t nanos = static_cast<int32_t>(
+      (value - absl::FromUnixSeconds(seconds)) / absl::Nanoseconds(1));
+  return VariantValue(EncodeSecondsAndNanos(kTagTimestampTz, seconds, nanos));
+}
+
+absl::StatusOr<VariantValue> VariantValue::Array(
+    absl::Span<const VariantConstRef> elements) {
+  std::vector<absl::string_view> encoded_elements;
+  encoded_elements.reserve(elements.size());
+  for (const VariantConstRef& element : elements) {
+    encoded_elements.push_back(element.encoded());
+  }
+  std::string encoded;
+  ZETASQL_RETURN_IF_ERROR(AppendArray(encoded_elements, &encoded));
+  return VariantValue(std::move(encoded));
+}
+
+absl::StatusOr<VariantValue> VariantValue::Object(
+    absl::Span<const std::pair<absl::string_view, VariantConstRef>> members) {
+  std::vector<EncodedMember> encoded_members;
+  encoded_members.reserve(members.size());
+  for (const auto& [key, value] : members) {
+    encoded_members.emplace_back(key, value.encoded());
+  }
+  std::sort(encoded_members.begin(), encoded_members.end(),
+            [](const EncodedMember& a, const EncodedMember& b) {
+              return a.first < b.first;
+            });
+  for (int i = 1; i < encoded_members.size(); ++i) {
+    if (encoded_members[i - 1].first == encoded_members[i].first) {
+      return absl::OutOfRangeError(
+          absl::StrCat("Duplicate field key '", encoded_members[i].first, "'"));
+    }
+  }
+  std::string encoded;
+  ZETASQL_RETURN_IF_ERROR(AppendObject(encoded_members, &encoded));
+  return VariantValue(std::move(encoded));
+}
+
+absl::StatusOr<VariantValue> VariantValue::ParseJson(absl::string_view json) {
+  std::string encoded;
+  JsonToVariantHandler handler(&encoded);
+  if (ParseJSONWithStructuralIndex(json, &handler) !=
+      JSONStructuralParseResult::kParsed) {
+    encoded.clear();
+    ZETASQL_RETURN_IF_ERROR(JsonToVariantParser(json).Parse(&encoded));
+  }
+  return VariantValue(std::move(encoded));
+}
+
+absl::StatusOr<VariantValue> VariantValue::FromEncoded(std::string encoded) {
+  ZETASQL_RETURN_IF_ERROR(ValidateEncoding(encoded, /*depth=*/0));
+  return VariantValue(std::move(encoded));
+}
+
+VariantValue VariantValue::CopyFrom(VariantConstRef value) {
+  return VariantValue(std::string(value.encoded()));
+}
+
+VariantConstRef VariantValue::GetConstRef() const {
+  return VariantConstRef(encoded_);
+}
+
+VariantKind VariantConstRef::kind() const {
+  switch (GetTag(encoded_)) {
+    case kTagNull:
+      return VariantKind::kNull;
+    case kTagFalse:
+    case kTagTrue:
+      return VariantKind::kBoolean;
+    case kTagInteger:
+      return VariantKind::kInteger;
+    case kTagDecimal:
+      return VariantKind::kDecimal;
+    case kTagDouble:
+      return VariantKind::kDouble;
+    case kTagString:
+      return VariantKind::kString;
+    case kTagBinary:
+      return VariantKind::kBinary;
+    case kTagDate:
+      return VariantKind::kDate;
+    case kTagTime:
+      return VariantKind::kTime;
+    case kTagTimestampNtz:
+      return VariantKind::kTimestampNtz;
+    case kTagTimestampTz:
+      return VariantKind::kTimestampTz;
+    case kTagArray:
+      return VariantKind::kArray;
+    case kTagObject:
+      return VariantKind::kObject;
+  }
+  ABSL_LOG(FATAL) << "Invalid VARIANT tag: " << static_cast<int>(encoded_[0]);
+}
+
+bool VariantConstRef::GetBoolean() const {
+  ABSL_DCHECK(kind() == VariantKind::kBoolean);
+  return GetTag(encoded_) == kTagTrue;
+}
+
+int64_t VariantConstRef::GetInteger() const {
+  ABSL_DCHECK(kind() == VariantKind::kInteger);
+  return static_cast<int64_t>(LoadUint64(encoded_, kTagSize));
+}
+
+NumericValue VariantConstRef::GetDecimal() const {
+  ABSL_DCHECK(kind() == VariantKind::kDecimal);
+  // The bits were validated when the value was encoded or decoded.
+  return NumericValue::FromHighAndLowBits(
+             LoadUint64(encoded_, kTagSize),
+             LoadUint64(encoded_, kTagSize + sizeof(uint64_t)))
+      .value();
+}
+
+double VariantConstRef::GetDouble() const {
+  ABSL_DCHECK(kind() == VariantKind::kDouble);
+  return absl::bit_cast<double>(LoadUint64(encoded_, kTagSize));
+}
+
+absl::string_view VariantConstRef::GetString() const {
+  ABSL_DCHECK(kind() == VariantKind::kString);
+  return encoded_.substr(kTagSize);
+}
+
+absl::string_view VariantConstRef::GetBinary() const {
+  ABSL_DCHECK(kind() == VariantKind::kBinary);
+  return encoded_.substr(kTagSize);
+}
+
+int32_t VariantConstRef::GetDate() const {
+  ABSL_DCHECK(kind() == VariantKind::kDate);
+  return static_cast<int32_t>(LoadUint32(encoded_, kTagSize));
+}
+
+TimeValue VariantConstRef::GetTime() const {
+  ABSL_DCHECK(kind() == VariantKind::kTime);
+  return TimeValue::FromPacked64Nanos(
+      static_cast<int64_t>(LoadUint64(encoded_, kTagSize)));
+}
+
+DatetimeValue VariantConstRef::GetTimestampNtz() const {
+  ABSL_DCHECK(kind() == VariantKind::kTimestampNtz);
+  return DatetimeValue::FromPacked64SecondsAndNanos(
+      static_cast<int64_t>(LoadUint64(encoded_, kTagSize)),
+      static_cast<int32_t>(
+          LoadUint32(encoded_, kTagSize + sizeof(uint64_t))));
+}
+
+absl::Time VariantConstRef::GetTimestampTz() const {
+  ABSL_DCHECK(kind() == VariantKind::kTimestampTz);
+  return absl::FromUnixSeconds(
+             static_cast<int64_t>(LoadUint64(encoded_, kTagSize))) +
+         absl::Nanoseconds(static_cast<int32_t>(
+             LoadUint32(encoded_, kTagSize + sizeof(uint64_t))));
+}
+
+size_t VariantConstRef::GetArraySize() const {
+  ABSL_DCHECK(kind() == VariantKind::kArray);
+  return LoadUint32(encoded_, kTagSize);
+}
+
+VariantConstRef VariantConstRef::GetArrayElement(size_t index) const {
+  const size_t count = GetArraySize();
+  ABSL_DCHECK_LT(index, count);
+  return VariantConstRef(
+      GetContainerEntry(encoded_, kContainerHeaderSize,
+                        kContainerHeaderSize + count * kOffsetSize, index));
+}
+
+size_t VariantConstRef::GetObjectSize() const {
+  ABSL_DCHECK(kind() == VariantKind::kObject);
+  return LoadUint32(encoded_, kTagSize);
+}
+
+absl::string_view VariantConstRef::GetObjectKey(size_t index) const {
+  const size_t count = GetObjectSize();
+  ABSL_DCHECK_LT(index, count);
+  return GetContainerEntry(encoded_, kContainerHeaderSize,
+                           kContainerHeaderSize + 2 * count * kOffsetSize,
+                           index);
+}
+
+VariantConstRef VariantConstRef::GetObjectValue(size_t index) const {
+  const size_t count = GetObjectSize();
+  ABSL_DCHECK_LT(index, count);
+  const size_t value_offsets = kContainerHeaderSize + count * kOffsetSize;
+  const size_t keys_start = value_offsets + count * kOffsetSize;
+  const size_t keys_size =
+      LoadUint32(encoded_, value_offsets - kOffsetSize);  // Last key end.
+  return VariantConstRef(GetContainerEntry(encoded_, value_offsets,
+                                           keys_start + keys_size, index));
+}
+
+std::optional<VariantConstRef> VariantConstRef::GetMemberIfExists(
+    absl::string_view key) const {
+  if (kind() != VariantKind::kObject) {
+    return std::nullopt;
+  }
+  size_t low = 0;
+  size_t high = GetObjectSize();
+  while (low < high) {
+    const size_t middle = low + (high - low) / 2;
+    const int comparison = GetObjectKey(middle).compare(key);
+    if (comparison == 0) {
+      return GetObjectValue(middle);
+    }
+    if (comparison < 0) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return std::nullopt;
+}
+
+std::optional<NumericValue> VariantConstRef::GetComparableDecimal() const {
+  switch (kind()) {
+    case VariantKind::kInteger:
+      return NumericValue(GetInteger());
+    case VariantKind::kDecimal:
+      return GetDecimal();
+    case VariantKind::kDouble: {
+      const double value = GetDouble();
+      absl::StatusOr<NumericValue> decimal = NumericValue::FromDouble(value);
+      if (decimal.ok() && decimal->ToDouble() == value) {
+        return *decimal;
+      }
+      return std::nullopt;
+    }
+    default:
+      ABSL_DCHECK(false) << "Not a number: " << VariantKindName(kind());
+      return std::nullopt;
+  }
+}
+
+bool VariantConstRef::Equals(VariantConstRef other) const {
+  if (encoded_ == other.encoded_) {
+    return true;
+  }
+  const VariantKind kind = this->kind();
+  const VariantKind other_kind = other.kind();
+  if (IsNumber(kind) && IsNumber(other_kind)) {
+    const std::optional<NumericValue> decimal = GetComparableDecimal();
+    const std::optional<NumericValue> other_decimal =
+        other.GetComparableDecimal();
+    if (decimal.has_value() || other_decimal.has_value()) {
+      return decimal == other_decimal;
+    }
+    // Both are doubles without a NUMERIC equivalent, such as NaN or 1e100.
+    const double value = GetDouble();
+    const double other_value = other.GetDouble();
+    return value == other_value ||
+           (std::isnan(value) && std::isnan(other_value));
+  }
+  if (kind != other_kind) {
+    return false;
+  }
+  switch (kind) {
+    case VariantKind::kArray: {
+      const size_t size = GetArraySize();
+      if (size != other.GetArraySize()) {
+        return false;
+      }
+      for (size_t i = 0; i < size; ++i) {
+        if (!GetArrayElement(i).Equals(other.GetArrayElement(i))) {
+          return false;
+        }
+      }
+      return true;
+    }
+    case VariantKind::kObject: {
+      const size_t size = GetObjectSize();
+      if (size != other.GetObjectSize()) {
+        return false;
+      }
+      // Keys are sorted, so equal objects have equal keys at each position.
+      for (size_t i = 0; i < size; ++i) {
+        if (GetObjectKey(i) != other.GetObjectKey(i) ||
+            !GetObjectValue(i).Equals(other.GetObjectValue(i))) {
+          return false;
+        }
+      }
+      return true;
+    }
+    default:
+      // Other scalars have a single encoding for each value.
+      return false;
+  }
+}
+
+std::string VariantConstRef::ToJsonString() const {
+  std::string output;
+  AppendJsonString(&output);
+  return output;
+}
+
+void VariantConstRef::AppendJsonString(std::string* output) const {
+  switch (kind()) {
+    case VariantKind::kNull:
+      output->append("null");
+      return;
+    case VariantKind::kBoolean:
+      output->append(GetBoolean() ? "true" : "false");
+      return;
+    case VariantKind::kInteger:
+      absl::StrAppend(output, GetInteger());
+      return;
+    case VariantKind::kDecimal:
+      GetDecimal().AppendToString(output);
+      return;
+    case VariantKind::kDouble: {
+      const double value = GetDouble();
+      if (std::isnan(value)) {
+        output->append("\"NaN\"");
+      } else if (std::isinf(value)) {
+        output->append(value > 0 ? "\"Infinity\"" : "\"-Infinity\"");
+      } else {
+        output->append(RoundTripDoubleToString(value));
+      }
+      return;
+    }
+    case VariantKind::kString:
+      JsonEscapeAndAppendString(GetString(), output);
+      return;
+    case VariantKind::kBinary:
+      JsonEscapeAndAppendString(
+          absl::AsciiStrToUpper(absl::BytesToHexString(GetBinary())), output);
+      return;
+    case VariantKind::kDate: {
+      std::string date;
+      ZETASQL_CHECK_OK(functions::ConvertDateToString(GetDate(), &date));
+      JsonEscapeAndAppendString(date, output);
+      return;
+    }
+    case VariantKind::kTime: {
+      std::string time;
+      ZETASQL_CHECK_OK(functions::ConvertTimeToString(
+          GetTime(), functions::kNanoseconds, &time));
+      JsonEscapeAndAppendString(time, output);
+      return;
+    }
+    case VariantKind::kTimestampNtz: {
+      std::string datetime;
+      ZETASQL_CHECK_OK(functions::ConvertDatetimeToString(
+          GetTimestampNtz(), functions::kNanoseconds, &datetime));
+      JsonEscapeAndAppendString(datetime, output);
+      return;
+    }
+    case VariantKind::kTimestampTz: {
+      std::string timestamp;
+      ZETASQL_CHECK_OK(functions::ConvertTimestampToString(
+          GetTimestampTz(), functions::kNanoseconds, "UTC", &timestamp));
+      JsonEscapeAndAppendString(timestamp, output);
+      return;
+    }
+    case VariantKind::kArray: {
+      output->push_back('[');
+      const size_t size = GetArraySize();
+      for (size_t i = 0; i < size; ++i) {
+        if (i > 0) output->push_back(',');
+        GetArrayElement(i).AppendJsonString(output);
+      }
+      output->push_back(']');
+      return;
+    }
+    case VariantKind::kObject: {
+      output->push_back('{');
+      const size_t size = GetObjectSize();
+      for (size_t i = 0; i < size; ++i) {
+        if (i > 0) output->push_back(',');
+        JsonEscapeAndAppendString(GetObjectKey(i), output);
+        output->push_back(':');
+        GetObjectValue(i).AppendJsonString(output);
+      }
+      output->push_back('}');
+      return;
+    }
+  }
+}
+
+}  // namespace zetasql
@@ -0,0 +1,257 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef ZETASQL_PUBLIC_VARIANT_VALUE_H_
+#define ZETASQL_PUBLIC_VARIANT_VALUE_H_
+
+#include <stddef.h>
+
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "zetasql/public/civil_time.h"
+#include "zetasql/public/numeric_value.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+
+namespace zetasql {
+
+class VariantConstRef;
+
+// The kinds of values a Snowflake VARIANT can hold. An OBJECT is a VARIANT
+// whose kind is kObject.
+enum class VariantKind {
+  kNull,  // The JSON null, which is different from a SQL NULL VARIANT.
+  kBoolean,
+  kInteger,
+  kDecimal,
+  kDouble,
+  kString,
+  kBinary,
+  kDate,
+  kTime,
+  kTimestampNtz,
+  kTimestampTz,
+  kArray,
+  kObject,
+};
+
+// Returns the name of <kind> as returned by Snowflake's TYPEOF, for example
+// "NULL_VALUE", "INTEGER" or "VARCHAR".
+absl::string_view VariantKindName(VariantKind kind);
+
+// VariantValue owns a VARIANT in its binary encoding. The encoding is a single
+// contiguous buffer that can be read in place through VariantConstRef, without
+// being parsed into a tree first.
+//
+// Every value starts with a one byte tag. Scalars are followed by a fixed size
+// little endian payload, except for strings and binaries whose bytes take up
+// the rest of the value. The size of each value is known from its container,
+// so no lengths are stored for them.
+//
+//   null, false, true : no payload
+//   integer           : int64
+//   decimal           : NumericValue as high and low uint64 bits
+//   double            : double
+//   string, binary    : the bytes
+//   date              : int32 days since the epoch
+//   time              : TimeValue::Packed64TimeNanos()
+//   timestamp_ntz     : DatetimeValue packed seconds (int64) and nanos (int32)
+//   timestamp_tz      : Unix seconds (int64) and nanos (int32)
+//   array             : uint32 count, uint32 end offset of each element, and
+//                       the elements
+//   object            : uint32 count, uint32 end offset of each key, uint32 end
+//                       offset of each value, the keys and the values
+//
+// Offsets are relative to the start of the element, key or value data, so a
+// value can be copied into a container as is. Array elements are accessed in
+// constant time through the offset table. Object keys are unique and sorted
+// bytewise, so a member is found with a binary search over the key table.
+//
+// The encoding is not canonical: numbers keep the kind they were built with,
+// so INTEGER 1 and DECIMAL 1.0 encode differently, and doubles keep their sign
+// of zero and NaN payload. Use VariantConstRef::Equals() rather than comparing
+// encodings.
+class VariantValue final {
+ public:
+  // Constructs a JSON null.
+  VariantValue();
+
+  VariantValue(VariantValue&& value) = default;
+  VariantValue& operator=(VariantValue&& value) = default;
+  VariantValue(const VariantValue&) = delete;
+  VariantValue& operator=(const VariantValue&) = delete;
+
+  static VariantValue Null();
+  static VariantValue Boolean(bool value);
+  static VariantValue Integer(int64_t value);
+  static VariantValue Decimal(const NumericValue& value);
+  static VariantValue Double(double value);
+  static VariantValue String(absl::string_view value);
+  static VariantValue Binary(absl::string_view value);
+  static VariantValue Date(int32_t value);
+  static VariantValue Time(TimeValue value);
+  static VariantValue TimestampNtz(DatetimeValue value);
+  static VariantValue TimestampTz(absl::Time value);
+
+  // Returns an array of the given elements. Returns an error if the array
+  // would exceed the 4GB addressable by the offset table.
+  static absl::StatusOr<VariantValue> Array(
+      absl::Span<const VariantConstRef> elements);
+
+  // Returns an object with the given members, in any order. Returns an error if
+  // a key appears more than once.
+  static absl::StatusOr<VariantValue> Object(
+      absl::Span<const std::pair<absl::string_view, VariantConstRef>> members);
+
+  // Parses a JSON document. Integers that fit into an INT64 become kInteger,
+  // numbers with a fraction and no exponent become kDecimal if they fit into
+  // a NUMERIC exactly, and all other numbers become kDouble. If a key appears
+  // more than once in an object, the last value is kept.
+  static absl::StatusOr<VariantValue> ParseJson(absl::string_view json);
+
+  // Returns a value holding <encoded>, which is validated first.
+  static absl::StatusOr<VariantValue> FromEncoded(std::string encoded);
+
+  static VariantValue CopyFrom(VariantConstRef value);
+
+  VariantConstRef GetConstRef() const;
+
+  const std::string& encoded() const { return encoded_; }
+
+  // Returns the encoding, leaving this value in an unspecified state.
+  std::string Release() && { return std::move(encoded_); }
+
+ private:
+  explicit VariantValue(std::string encoded) : encoded_(std::move(encoded)) {}
+
+  std::string encoded_;
+};
+
+// A read-only view of an encoded VARIANT. The referenced buffer, for example
+// the VariantValue or Value it came from, must outlive the reference.
+//
+// The Get*() accessors require kind() to match. This is only checked in debug
+// builds.
+class VariantConstRef {
+ public:
+  // <encoded> must be a valid encoding, see VariantValue::FromEncoded().
+  explicit VariantConstRef(absl::string_view encoded) : encoded_(encoded) {}
+
+  VariantConstRef(const VariantConstRef&) = default;
+  VariantConstRef& operator=(const VariantConstRef&) = default;
+
+  VariantKind kind() const;
+
+  bool GetBoolean() const;
+  int64_t GetInteger() const;
+  NumericValue GetDecimal() const;
+  double GetDouble() const;
+  absl::string_view GetString() const;
+  absl::string_view GetBinary() const;
+  int32_t GetDate() const;
+  TimeValue GetTime() const;
+  DatetimeValue GetTimestampNtz() const;
+  absl::Time GetTimestampTz() const;
+
+  size_t GetArraySize() const;
+  // Requires index < GetArraySize().
+  VariantConstRef GetArrayElement(size_t index) const;
+
+  // Members are ordered by key.
+  size_t GetObjectSize() const;
+  // Require index < GetObjectSize().
+  absl::string_view GetObjectKey(size_t index) const;
+  VariantConstRef GetObjectValue(size_t index) const;
+  // Returns the value of the member named <key>, or std::nullopt if the value
+  // is not an object or has no such member.
+  std::optional<VariantConstRef> GetMemberIfExists(absl::string_view key) const;
+
+  // Serializes the value as a compact JSON document. Values that have no JSON
+  // equivalent are written as JSON strings: BINARY as hex, and dates and times
+  // in their canonical ZetaSQL format.
+  std::string ToJsonString() const;
+  void AppendJsonString(std::string* output) const;
+
+  // Returns true if the values are equal. Numbers are compared by value
+  // whatever their kind: INTEGER 1, DECIMAL 1.0 and DOUBLE 1 are equal, 0 and
+  // -0 are equal, and all NaNs are equal to each other. A DOUBLE equals an
+  // INTEGER or DECIMAL only if it converts to that NUMERIC and back exactly.
+  // Other values are equal if they have the same kind and contents, compared
+  // recursively for arrays and objects.
+  bool Equals(VariantConstRef other) const;
+
+  // Hashes consistently with Equals().
+  template <typename H>
+  friend H AbslHashValue(H h, const VariantConstRef& value);
+
+  absl::string_view encoded() const { return encoded_; }
+
+ private:
+  // For a number, returns the NUMERIC that Equals() compares it as, or
+  // std::nullopt for a DOUBLE that has no exact NUMERIC equivalent.
+  std::optional<NumericValue> GetComparableDecimal() const;
+
+  absl::string_view encoded_;
+};
+
+template <typename H>
+H AbslHashValue(H h, const VariantConstRef& value) {
+  // This code is picked arbitrarily.
+  static constexpr uint64_t kNanHashCode = 0x5F0C2A1D9E4B7763ull;
+
+  switch (value.kind()) {
+    case VariantKind::kInteger:
+    case VariantKind::kDecimal:
+    case VariantKind::kDouble: {
+      std::optional<NumericValue> decimal = value.GetComparableDecimal();
+      if (decimal.has_value()) {
+        return H::combine(std::move(h), *decimal);
+      }
+      const double double_value = value.GetDouble();
+      if (std::isnan(double_value)) {
+        return H::combine(std::move(h), kNanHashCode);
+      }
+      return H::combine(std::move(h), double_value);
+    }
+    case VariantKind::kArray: {
+      const size_t size = value.GetArraySize();
+      for (size_t i = 0; i < size; ++i) {
+        h = H::combine(std::move(h), value.GetArrayElement(i));
+      }
+      return H::combine(std::move(h), size);
+    }
+    case VariantKind::kObject: {
+      const size_t size = value.GetObjectSize();
+      for (size_t i = 0; i < size; ++i) {
+        h = H::combine(std::move(h), value.GetObjectKey(i),
+                       value.GetObjectValue(i));
+      }
+      return H::combine(std::move(h), size);
+    }
+    default:
+      return H::combine(std::move(h), value.encoded());
+  }
+}
+
+}  // namespace zetasql
+
+#endif  // ZETASQL_PUBLIC_VARIANT_VALUE_H_
@@ -0,0 +1,271 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/public/variant_value.h"
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "zetasql/base/testing/status_matchers.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "zetasql/public/civil_time.h"
+#include "zetasql/public/numeric_value.h"
+#include "absl/hash/hash.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+
+namespace zetasql {
+namespace {
+
+using ::testing::HasSubstr;
+using ::zetasql_base::testing::IsOkAndHolds;
+using ::zetasql_base::testing::StatusIs;
+
+TEST(VariantValueTest, Scalars) {
+  EXPECT_EQ(VariantValue::Null().GetConstRef().kind(), VariantKind::kNull);
+  EXPECT_TRUE(VariantValue::Boolean(true).GetConstRef().GetBoolean());
+  EXPECT_EQ(VariantValue::Integer(std::numeric_limits<int64_t>::min())
+                .GetConstRef()
+                .GetInteger(),
+            std::numeric_limits<int64_t>::min());
+  EXPECT_EQ(VariantValue::Decimal(NumericValue::MaxValue())
+                .GetConstRef()
+                .GetDecimal(),
+            NumericValue::MaxValue());
+  EXPECT_EQ(VariantValue::Double(-1.5).GetConstRef().GetDouble(), -1.5);
+  EXPECT_EQ(VariantValue::String("abc").GetConstRef().GetString(), "abc");
+  EXPECT_EQ(VariantValue::Binary(absl::string_view("\0\1", 2))
+                .GetConstRef()
+                .GetBinary(),
+            absl::string_view("\0\1", 2));
+  EXPECT_EQ(VariantValue::Date(18000).GetConstRef().GetDate(), 18000);
+  const TimeValue time = TimeValue::FromHMSAndNanos(12, 34, 56, 789);
+  EXPECT_EQ(
+      VariantValue::Time(time).GetConstRef().GetTime().Packed64TimeNanos(),
+      time.Packed64TimeNanos());
+  const DatetimeValue datetime =
+      DatetimeValue::FromYMDHMSAndNanos(2023, 1, 2, 3, 4, 5, 6);
+  EXPECT_EQ(VariantValue::TimestampNtz(datetime)
+                .GetConstRef()
+                .GetTimestampNtz()
+                .Packed64DatetimeMicros(),
+            datetime.Packed64DatetimeMicros());
+  const absl::Time timestamp = absl::FromUnixMicros(1234567890123456);
+  EXPECT_EQ(VariantValue::TimestampTz(timestamp).GetConstRef().GetTimestampTz(),
+            timestamp);
+}
+
+TEST(VariantValueTest, ParseJsonRoundTrip) {
+  for (absl::string_view json :
+       {"null", "true", "false", "0", "-12", "1.25", "1e+100", "\"a\\\"b\"",
+        "[]", "{}", "[1,[2,[3]],{\"a\":null}]",
+        "{\"a\":1,\"b\":[true,\"x\"],\"c\":{\"d\":-1.5}}"}) {
+    SCOPED_TRACE(json);
+    ZETASQL_ASSERT_OK_AND_ASSIGN(VariantValue variant,
+                         VariantValue::ParseJson(json));
+    EXPECT_EQ(variant.GetConstRef().ToJsonString(), json);
+  }
+}
+
+TEST(VariantValueTest, ParseJsonNumbers) {
+  ZETASQL_ASSERT_OK_AND_ASSIGN(VariantValue integer,
+                       VariantValue::ParseJson("42"));
+  EXPECT_EQ(integer.GetConstRef().kind(), VariantKind::kInteger);
+  ZETASQL_ASSERT_OK_AND_ASSIGN(VariantValue decimal,
+                       VariantValue::ParseJson("12345678901234567890.5"));
+  EXPECT_EQ(decimal.GetConstRef().kind(), VariantKind::kDecimal);
+  ZETASQL_ASSERT_OK_AND_ASSIGN(VariantValue double_value,
+                       VariantValue::ParseJson("2.5e3"));
+  EXPECT_EQ(double_value.GetConstRef().kind(), VariantKind::kDouble);
+  EXPECT_EQ(double_value.GetConstRef().GetDouble(), 2500);
+}
+
+TEST(VariantValueTest, ParseJsonLargeDocument) {
+  std::string json = "[";
+  for (int i = 0; i < 100; ++i) {
+    absl::StrAppend(&json, i == 0 ? "" : ",", "{\"id\":", i,
+                    ",\"name\":\"a\\\"b\\\\\",\"x\":[1.5,null]}");
+  }
+  json.push_back(']');
+  ZETASQL_ASSERT_OK_AND_ASSIGN(VariantValue variant,
+                       VariantValue::ParseJson(json));
+  EXPECT_EQ(variant.GetConstRef().GetArraySize(), 100);
+  EXPECT_EQ(variant.GetConstRef().ToJsonString(), json);
+}
+
+TEST(VariantValueTest, ParseJsonInvalidUtf8) {
+  // Bytes that are not UTF-8 are copied as they are.
+  ZETASQL_ASSERT_OK_AND_ASSIGN(VariantValue variant,
+                       VariantValue::ParseJson("[\"a\xff\"]"));
+  EXPECT_EQ(variant.GetConstRef().GetArrayElement(0).GetString(), "a\xff");
+}
+
+TEST(VariantValueTest, ParseJsonErrors) {
+  for (absl::string_view json :
+       {"", "nul", "[1,", "{\"a\"}", "{\"a\":1,}", "\"abc", "1 2", "01x",
+        "\"\\ud800\""}) {
+    SCOPED_TRACE(json);
+    EXPECT_THAT(VariantValue::ParseJson(json),
+                StatusIs(absl::StatusCode::kOutOfRange));
+  }
+}
+
+TEST(VariantValueTest, ParsedObjectKeysAreSortedAndUnique) {
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      VariantValue object,
+      VariantValue::ParseJson("{\"b\":1,\"a\":2,\"b\":3}"));
+  const VariantConstRef ref = object.GetConstRef();
+  ASSERT_EQ(ref.GetObjectSize(), 2);
+  EXPECT_EQ(ref.GetObjectKey(0), "a");
+  EXPECT_EQ(ref.GetObjectKey(1), "b");
+  // The last duplicate wins, like in Snowflake.
+  EXPECT_EQ(ref.GetObjectValue(1).GetInteger(), 3);
+  EXPECT_EQ(ref.ToJsonString(), "{\"a\":2,\"b\":3}");
+}
+
+TEST(VariantValueTest, GetMemberIfExists) {
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      VariantValue object,
+      VariantValue::ParseJson("{\"x\":1,\"y\":\"two\",\"z\":[3]}"));
+  const VariantConstRef ref = object.GetConstRef();
+  std::optional<VariantConstRef> y = ref.GetMemberIfExists("y");
+  ASSERT_TRUE(y.has_value());
+  EXPECT_EQ(y->GetString(), "two");
+  EXPECT_FALSE(ref.GetMemberIfExists("Y").has_value());
+  EXPECT_FALSE(ref.GetMemberIfExists("").has_value());
+  // Lookups on anything but an object find nothing.
+  EXPECT_FALSE(ref.GetMemberIfExists("z")
+                   ->GetMemberIfExists("0")
+                   .has_value());
+}
+
+TEST(VariantValueTest, ArrayAndObjectConstruction) {
+  VariantValue one = VariantValue::Integer(1);
+  VariantValue two = VariantValue::String("two");
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      VariantValue array,
+      VariantValue::Array({one.GetConstRef(), two.GetConstRef()}));
+  EXPECT_EQ(array.GetConstRef().GetArraySize(), 2);
+  EXPECT_EQ(array.GetConstRef().GetArrayElement(1).GetString(), "two");
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      VariantValue object,
+      VariantValue::Object({{"k2", array.GetConstRef()},
+                            {"k1", one.GetConstRef()}}));
+  EXPECT_EQ(object.GetConstRef().ToJsonString(),
+            "{\"k1\":1,\"k2\":[1,\"two\"]}");
+
+  EXPECT_THAT(VariantValue::Object(
+                  {{"k", one.GetConstRef()}, {"k", two.GetConstRef()}}),
+              StatusIs(absl::StatusCode::kOutOfRange, HasSubstr("k")));
+}
+
+TEST(VariantValueTest, ObjectEncodingIgnoresMemberOrder) {
+  ZETASQL_ASSERT_OK_AND_ASSIGN(VariantValue parsed,
+                       VariantValue::ParseJson("{ \"b\" : [1] , \"a\" : 2 }"));
+  VariantValue one = VariantValue::Integer(1);
+  VariantValue two = VariantValue::Integer(2);
+  ZETASQL_ASSERT_OK_AND_ASSIGN(VariantValue array,
+                       VariantValue::Array({one.GetConstRef()}));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      VariantValue built,
+      VariantValue::Object(
+          {{"a", two.GetConstRef()}, {"b", array.GetConstRef()}}));
+  EXPECT_EQ(parsed.encoded(), built.encoded());
+}
+
+TEST(VariantValueTest, Equals) {
+  auto parse = [](absl::string_view json) {
+    return VariantValue::ParseJson(json).value();
+  };
+  auto equals = [](const VariantValue& x, const VariantValue& y) {
+    const bool result = x.GetConstRef().Equals(y.GetConstRef());
+    if (result) {
+      EXPECT_EQ(absl::Hash<VariantConstRef>()(x.GetConstRef()),
+                absl::Hash<VariantConstRef>()(y.GetConstRef()));
+    }
+    EXPECT_EQ(result, y.GetConstRef().Equals(x.GetConstRef()));
+    return result;
+  };
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+
+  // Numbers compare by value whatever their kind.
+  EXPECT_TRUE(equals(parse("1"), parse("1.0")));
+  EXPECT_TRUE(equals(parse("1"), VariantValue::Double(1)));
+  EXPECT_TRUE(equals(parse("0.5"), VariantValue::Double(0.5)));
+  EXPECT_TRUE(equals(VariantValue::Double(0.0), VariantValue::Double(-0.0)));
+  EXPECT_TRUE(equals(VariantValue::Double(nan), VariantValue::Double(-nan)));
+  EXPECT_TRUE(equals(VariantValue::Double(1e100), parse("1e100")));
+  EXPECT_FALSE(equals(parse("1"), parse("1.5")));
+  EXPECT_FALSE(equals(VariantValue::Double(1e-10), parse("0")));
+  EXPECT_FALSE(equals(VariantValue::Double(nan), parse("0")));
+  EXPECT_FALSE(equals(parse("1"), parse("\"1\"")));
+  EXPECT_FALSE(equals(parse("true"), parse("1")));
+
+  // Containers compare their contents.
+  EXPECT_TRUE(equals(parse(R"({"a": [1, 2.0], "b": {"c": -0.0}})"),
+                     parse(R"({"b": {"c": 0}, "a": [1.00, 2]})")));
+  EXPECT_FALSE(equals(parse("[1, 2]"), parse("[1, 2, 3]")));
+  EXPECT_FALSE(equals(parse("[1, 2]"), parse("[2, 1]")));
+  EXPECT_FALSE(equals(parse(R"({"a": 1})"), parse(R"({"b": 1})")));
+  EXPECT_FALSE(equals(parse(R"({"a": 1})"), parse(R"({"a": 2})")));
+  EXPECT_FALSE(equals(parse("[]"), parse("{}")));
+}
+
+TEST(VariantValueTest, FromEncoded) {
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      VariantValue value,
+      VariantValue::ParseJson("[{\"a\":\"b\"},1.5,null,\"x\"]"));
+  const std::string encoded = value.encoded();
+  EXPECT_THAT(VariantValue::FromEncoded(encoded),
+              IsOkAndHolds(::testing::Property(&VariantValue::encoded,
+                                               encoded)));
+  // Every truncation of a valid encoding is invalid.
+  for (size_t size = 0; size < encoded.size(); ++size) {
+    SCOPED_TRACE(size);
+    EXPECT_THAT(VariantValue::FromEncoded(encoded.substr(0, size)),
+                StatusIs(absl::StatusCode::kOutOfRange));
+  }
+  EXPECT_THAT(VariantValue::FromEncoded(std::string(1, '\xff')),
+              StatusIs(absl::StatusCode::kOutOfRange));
+}
+
+TEST(VariantValueTest, ToJsonStringSpecialValues) {
+  EXPECT_EQ(VariantValue::Double(std::numeric_limits<double>::quiet_NaN())
+                .GetConstRef()
+                .ToJsonString(),
+            "\"NaN\"");
+  EXPECT_EQ(VariantValue::Double(-std::numeric_limits<double>::infinity())
+                .GetConstRef()
+                .ToJsonString(),
+            "\"-Infinity\"");
+  EXPECT_EQ(VariantValue::Binary("\x01\xab").GetConstRef().ToJsonString(),
+            "\"01AB\"");
+  EXPECT_EQ(VariantValue::Date(0).GetConstRef().ToJsonString(),
+            "\"1970-01-01\"");
+  EXPECT_EQ(VariantValue::String("line\nbreak").GetConstRef().ToJsonString(),
+            "\"line\\nbreak\"");
+}
+
+}  // namespace
+}  // namespace zetasql
@@ -16,6 +16,7 @@
 
 // This file contains the code for evaluating aggregate functions.
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <optional>
@@ -27,6 +28,7 @@
 #include "zetasql/public/type.h"
 #include "zetasql/public/value.h"
 #include "zetasql/reference_impl/common.h"
+#include "zetasql/reference_impl/compact_key.h"
 #include "zetasql/reference_impl/evaluation.h"
 #include "zetasql/reference_impl/function.h"
 #include "zetasql/reference_impl/operator.h"
@@ -1383,7 +1385,8 @@ class GroupValue {
 
 }  // namespace
 
-absl::StatusOr<std::unique_ptr<TupleIterator>> AggregateOp::CreateIterator(
+absl::StatusOr<std::unique_ptr<TupleIterator>>
+AggregateOp::CreateIteratorInternal(
     absl::Span<const TupleData* const> params, int num_extra_slots,
     EvaluationContext* context) const {
   ZETASQL_ASSIGN_OR_RETURN(
@@ -1394,6 +1397,31 @@ absl::StatusOr<std::unique_ptr<TupleIterator>> AggregateOp::CreateIterator(
   absl::flat_hash_map<TupleDataPtr, std::unique_ptr<GroupValue>> group_map;
   std::vector<std::unique_ptr<TupleData>> group_map_keys_memory;
 
+  // When all the keys have simple types and no collation, groups are instead
+  // tracked by their compact key encoding in <compact_groups>, with the
+  // accumulators of the group with index i in <compact_group_accumulators[i]>.
+  // This avoids allocating a TupleData and a GroupValue for every group and
+  // hashing the keys as generic Values.
+  std::optional<CompactKeyEncoder> compact_key_encoder;
+  if (std::all_of(keys().begin(), keys().end(), [](const KeyArg* key) {
+        return key->collation() == nullptr &&
+               CompactKeyEncoder::IsSupportedType(key->type());
+      })) {
+    std::vector<const Type*> key_types;
+    key_types.reserve(keys().size());
+    for (const KeyArg* key : keys()) {
+      key_types.push_back(key->type());
+    }
+    ZETASQL_ASSIGN_OR_RETURN(compact_key_encoder,
+                     CompactKeyEncoder::Create(std::move(key_types)));
+  }
+  CompactKeyTable compact_groups(context->memory_accountant());
+  std::vector<AccumulatorList> compact_group_accumulators;
+  // Reused across rows on the compact path.
+  TupleData compact_key_data(compact_key_encoder.has_value() ? keys().size()
+                                                             : 0);
+  std::string encoded_key;
+
   CollatorList collators;
 
   // Prepare collators for each KeyArg.
@@ -1499,20 +1527,29 @@ absl::StatusOr<std::unique_ptr<TupleIterator>> AggregateOp::CreateIterator(
     // Determine the key to 'group_to_accumulator_map'.
     const std::vector<const TupleData*> params_and_input_tuple =
         ConcatSpans(params, {next_input});
-    auto key_data = std::make_unique<TupleData>(keys().size());
+    std::unique_ptr<TupleData> key_data;
     // If collator is present for <key_data[i]>, <collated_key_data[i]> is
     // collation_key for value of <key_data[i]>. Otherwise,
     // <collated_key_data[i]> is the same as <key_data[i]>.
-    auto collated_key_data = std::make_unique<TupleData>(keys().size());
+    std::unique_ptr<TupleData> collated_key_data;
+    TupleData* evaluated_key_data = &compact_key_data;
+    if (!compact_key_encoder.has_value()) {
+      key_data = std::make_unique<TupleData>(keys().size());
+      collated_key_data = std::make_unique<TupleData>(keys().size());
+      evaluated_key_data = key_data.get();
+    }
 
     for (int i = 0; i < keys().size(); ++i) {
-      TupleSlot* slot = key_data->mutable_slot(i);
+      TupleSlot* slot = evaluated_key_data->mutable_slot(i);
       const KeyArg* key = keys()[i];
       absl::Status status;
       if (!key->value_expr()->EvalSimple(params_and_input_tuple, context, slot,
                                          &status)) {
         return status;
       }
+      // Keys with compact encodings are never arrays, so the rest of this loop
+      // only applies to the generic path.
+      if (compact_key_encoder.has_value()) continue;
 
       if (  // Once we know the query is known to be non-deterministic, we
             // short-circuit to avoid any overhead from non-determinism
@@ -1535,38 +1572,62 @@ absl::StatusOr<std::unique_ptr<TupleIterator>> AggregateOp::CreateIterator(
       }
     }
 
-    // Look up the value in 'group_to_accumulator_map', initializing a new one
-    // if necessary.
-    AccumulatorList* accumulators = nullptr;
-    std::unique_ptr<GroupValue>* found_group_value =
-        zetasql_base::FindOrNull(group_map, TupleDataPtr(collated_key_data.get()));
-    if (found_group_value == nullptr) {
-      // Create the new GroupValue.
-      ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<GroupValue> inserted_group_value,
-                       GroupValue::Create(std::move(key_data),
-                                          context->memory_accountant()));
-
-      // Initialize the accumulators.
-      accumulators = inserted_group_value->mutable_accumulator_list();
-      accumulators->reserve(aggregators().size());
+    // Returns a new list of accumulators for a group seen for the first time.
+    auto create_accumulators = [&]() -> absl::StatusOr<AccumulatorList> {
+      AccumulatorList new_accumulators;
+      new_accumulators.reserve(aggregators().size());
       for (const AggregateArg* aggregator : aggregators()) {
         std::pair<std::unique_ptr<AggregateArgAccumulator>, bool>
             accumulator_and_stop_bit;
         ZETASQL_ASSIGN_OR_RETURN(accumulator_and_stop_bit.first,
                          aggregator->CreateAccumulator(params, context));
-        accumulators->push_back(std::move(accumulator_and_stop_bit));
+        new_accumulators.push_back(std::move(accumulator_and_stop_bit));
       }
+      return new_accumulators;
+    };
 
-      // Insert the new GroupValue.
-      ZETASQL_RET_CHECK(group_map
-                    .emplace(TupleDataPtr(collated_key_data.get()),
-                             std::move(inserted_group_value))
-                    .second);
-      group_map_keys_memory.push_back(std::move(collated_key_data));
+    // Look up the value in 'group_to_accumulator_map', initializing a new one
+    // if necessary.
+    AccumulatorList* accumulators = nullptr;
+    if (compact_key_encoder.has_value()) {
+      encoded_key.clear();
+      compact_key_encoder->Encode(compact_key_data, &encoded_key);
+      int64_t group_index;
+      bool inserted;
+      if (!compact_groups.Insert(encoded_key, &group_index, &inserted,
+                                 &status)) {
+        return status;
+      }
+      if (inserted) {
+        ZETASQL_RET_CHECK_EQ(group_index, compact_group_accumulators.size());
+        ZETASQL_ASSIGN_OR_RETURN(compact_group_accumulators.emplace_back(),
+                         create_accumulators());
+      }
+      accumulators = &compact_group_accumulators[group_index];
     } else {
-      accumulators = (*found_group_value)->mutable_accumulator_list();
-      key_data.reset();
-      collated_key_data.reset();
+      std::unique_ptr<GroupValue>* found_group_value = zetasql_base::FindOrNull(
+          group_map, TupleDataPtr(collated_key_data.get()));
+      if (found_group_value == nullptr) {
+        // Create the new GroupValue.
+        ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<GroupValue> inserted_group_value,
+                         GroupValue::Create(std::move(key_data),
+                                            context->memory_accountant()));
+
+        // Initialize the accumulators.
+        accumulators = inserted_group_value->mutable_accumulator_list();
+        ZETASQL_ASSIGN_OR_RETURN(*accumulators, create_accumulators());
+
+        // Insert the new GroupValue.
+        ZETASQL_RET_CHECK(group_map
+                      .emplace(TupleDataPtr(collated_key_data.get()),
+                               std::move(inserted_group_value))
+                      .second);
+        group_map_keys_memory.push_back(std::move(collated_key_data));
+      } else {
+        accumulators = (*found_group_value)->mutable_accumulator_list();
+        key_data.reset();
+        collated_key_data.reset();
+      }
     }
 
     // Accumulate.
@@ -1589,6 +1650,12 @@ absl::StatusOr<std::unique_ptr<TupleIterator>> AggregateOp::CreateIterator(
     }
   }
 
+  if (OperatorProfile* profile = context->operator_profile();
+      profile != nullptr) {
+    profile->RecordHashTableSize(
+        this, static_cast<int64_t>(group_map.size()) + compact_groups.size());
+  }
+
   // Build the tuples that the iterator should return.
   auto tuples = std::make_unique<TupleDataDeque>(context->memory_accountant());
   for (auto& entry : group_map) {
@@ -1614,10 +1681,32 @@ absl::StatusOr<std::unique_ptr<TupleIterator>> AggregateOp::CreateIterator(
     }
   }
 
+  for (int64_t i = 0; i < compact_groups.size(); ++i) {
+    AccumulatorList& accumulators = compact_group_accumulators[i];
+
+    auto tuple = std::make_unique<TupleData>(keys().size());
+    ZETASQL_RETURN_IF_ERROR(compact_key_encoder->Decode(compact_groups.key(i),
+                                                tuple.get()));
+    tuple->AddSlots(accumulators.size() + num_extra_slots);
+
+    for (int j = 0; j < accumulators.size(); ++j) {
+      AggregateArgAccumulator& accumulator = *accumulators[j].first;
+      ZETASQL_ASSIGN_OR_RETURN(Value value, accumulator.GetFinalResult(
+                                        /*inputs_in_defined_order=*/false));
+      tuple->mutable_slot(keys().size() + j)->SetValue(value);
+    }
+    accumulators.clear();
+
+    if (!tuples->PushBack(std::move(tuple), &status)) {
+      return status;
+    }
+  }
+
   // Clears <group_map_keys_memory> and <group_map> to reclaim the memory since
   // they are not used anymore.
   group_map_keys_memory.clear();
   group_map.clear();
+  compact_group_accumulators.clear();
 
   if (tuples->IsEmpty()) {
     if (keys().empty()) {
@@ -1829,7 +1918,8 @@ class TupleDataDequeIterator : public TupleIterator {
 
 }  // namespace
 
-absl::StatusOr<std::unique_ptr<TupleIterator>> GroupRowsOp::CreateIterator(
+absl::StatusOr<std::unique_ptr<TupleIterator>>
+GroupRowsOp::CreateIteratorInternal(
     absl::Span<const TupleData* const> params, int num_extra_slots,
     EvaluationContext* context) const {
   if (context->active_group_rows() == nullptr) {
@@ -789,6 +789,73 @@ TEST(CreateIteratorTest, AggregateAll) {
                HasSubstr("Out of memory")));
 }
 
+// Groups by STRING and INT64 keys, which use compact key encodings.
+TEST(CreateIteratorTest, AggregateGroupByCompactKeys) {
+  VariableId a("a"), b("b"), k1("k1"), k2("k2"), c("c");
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_a, DerefExpr::Create(a, StringType()));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_b, DerefExpr::Create(b, Int64Type()));
+
+  std::vector<std::unique_ptr<KeyArg>> keys;
+  keys.push_back(std::make_unique<KeyArg>(k1, std::move(deref_a)));
+  keys.push_back(std::make_unique<KeyArg>(k2, std::move(deref_b)));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      auto arg_c,
+      AggregateArg::Create(c, std::make_unique<BuiltinAggregateFunction>(
+                                  FunctionKind::kCount, Int64Type(),
+                                  /*num_input_fields=*/0, EmptyStructType())));
+  std::vector<std::unique_ptr<AggregateArg>> aggregators;
+  aggregators.push_back(std::move(arg_c));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      auto aggregate_op,
+      AggregateOp::Create(
+          std::move(keys), std::move(aggregators),
+          absl::WrapUnique(new TestRelationalOp(
+              {a, b},
+              CreateTestTupleDatas({{String("x"), Int64(1)},
+                                    {String(""), Int64(1)},
+                                    {NullString(), Int64(1)},
+                                    {String("x"), Int64(1)},
+                                    {String("x"), NullInt64()},
+                                    {NullString(), Int64(1)},
+                                    {String(""), NullInt64()}}),
+              /*preserves_order=*/true))));
+  ZETASQL_ASSERT_OK(aggregate_op->SetSchemasForEvaluation(EmptyParamsSchemas()));
+
+  EvaluationContext context((EvaluationOptions()));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<TupleIterator> iter,
+                       aggregate_op->CreateIterator(
+                           EmptyParams(), /*num_extra_slots=*/1, &context));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::vector<TupleData> data,
+                       ReadFromTupleIterator(iter.get()));
+  const std::vector<std::vector<Value>> expected = {
+      {NullString(), Int64(1), Int64(2)},
+      {String(""), NullInt64(), Int64(1)},
+      {String(""), Int64(1), Int64(1)},
+      {String("x"), NullInt64(), Int64(1)},
+      {String("x"), Int64(1), Int64(2)}};
+  ASSERT_EQ(data.size(), expected.size());
+  for (int i = 0; i < expected.size(); ++i) {
+    // Check for the extra slot.
+    ASSERT_EQ(data[i].num_slots(), 4);
+    for (int j = 0; j < expected[i].size(); ++j) {
+      EXPECT_EQ(data[i].slot(j).value(), expected[i][j])
+          << Tuple(&iter->Schema(), &data[i]).DebugString();
+    }
+  }
+
+  // Each group needs memory for its key, so a tight bound fails.
+  EvaluationContext memory_context(GetIntermediateMemoryEvaluationOptions(
+      /*total_bytes=*/100));
+  EXPECT_THAT(
+      aggregate_op->CreateIterator(EmptyParams(),
+                                   /*num_extra_slots=*/1, &memory_context),
+      StatusIs(absl::StatusCode::kResourceExhausted,
+               HasSubstr("Out of memory")));
+}
+
 TEST(CreateIteratorTest, AggregateOrderBy) {
   TypeFactory type_factory;
   VariableId a("a"), b("b"), c("c"), d("d"), e("e"), f("f"), g("g"), h("h"),
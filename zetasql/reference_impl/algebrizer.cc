@@ -18,6 +18,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <functional>
 #include <iterator>
 #include <memory>
@@ -32,6 +33,7 @@
 
 #include "zetasql/base/logging.h"
 #include "google/protobuf/descriptor.h"
+#include "zetasql/analyzer/expr_matching_helpers.h"
 #include "zetasql/analyzer/expr_resolver_helper.h"
 #include "zetasql/common/aggregate_null_handling.h"
 #include "zetasql/common/thread_stack.h"
@@ -135,6 +137,53 @@ bool IsAnalyticFunctionCollationSupported(const FunctionSignature& signature) {
          std::end(kCollationSupportedAnalyticFunctions);
 }
 
+// Folded values larger than this are left to be computed at runtime, rather
+// than copied into the algebrized tree.
+constexpr uint64_t kMaxFoldedValueBytes = 64 * 1024;
+
+// Returns true if 'expr' is a function call or cast that can be evaluated
+// ahead of time if all its arguments are constants.
+bool IsFoldable(const ResolvedExpr* expr) {
+  switch (expr->node_kind()) {
+    case RESOLVED_FUNCTION_CALL: {
+      const ResolvedFunctionCall* function_call =
+          expr->GetAs<ResolvedFunctionCall>();
+      const Function* function = function_call->function();
+      return function->IsZetaSQLBuiltin() &&
+             function->function_options().volatility ==
+                 FunctionEnums::IMMUTABLE &&
+             function_call->generic_argument_list().empty();
+    }
+    case RESOLVED_CAST:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Returns true if 'expr1' and 'expr2' are known to compute the same value.
+bool IsSameSubexpression(const ResolvedExpr* expr1,
+                         const ResolvedExpr* expr2) {
+  if (expr1 == expr2) {
+    return true;
+  }
+  // IsSameExpressionForGroupBy() clears and sets the accessed bits of both
+  // expressions. Comparing them does not interpret them, so restore the bits
+  // afterwards for the final CheckFieldsAccessed() of the statement.
+  std::vector<uint32_t> accessed1;
+  std::vector<uint32_t> accessed2;
+  expr1->SaveFieldsAccessed(&accessed1);
+  expr2->SaveFieldsAccessed(&accessed2);
+  // Expressions that cannot be compared are treated as different.
+  const absl::StatusOr<bool> is_same =
+      IsSameExpressionForGroupBy(expr1, expr2);
+  absl::Span<const uint32_t> saved2(accessed2);
+  expr2->RestoreFieldsAccessed(&saved2);
+  absl::Span<const uint32_t> saved1(accessed1);
+  expr1->RestoreFieldsAccessed(&saved1);
+  return is_same.ok() && *is_same;
+}
+
 }  // namespace
 
 Algebrizer::Algebrizer(const LanguageOptions& language_options,
@@ -455,6 +504,14 @@ absl::StatusOr<std::unique_ptr<ValueExpr>> Algebrizer::AlgebrizeFunctionCall(
         collation_list.empty() ? ResolvedCollation() : collation_list[0]);
   } else if (name == "float64") {
     kind = FunctionKind::kDouble;
+  } else if (name == "get_ignore_case") {
+    // Shares its signature ids with GET.
+    kind = FunctionKind::kVariantGetIgnoreCase;
+  } else if (std::optional<FunctionKind> signature_kind =
+                 BuiltinFunctionCatalog::GetKindBySignatureId(
+                     function_call->signature().context_id());
+             signature_kind.has_value()) {
+    kind = *signature_kind;
   } else {
     absl::StatusOr<FunctionKind> status_or_kind =
         BuiltinFunctionCatalog::GetKindByName(name);
@@ -1551,6 +1608,16 @@ absl::StatusOr<std::unique_ptr<ValueExpr>> Algebrizer::AlgebrizeExpression(
   }
 
   std::unique_ptr<ValueExpr> val_op;
+  for (const CommonSubexpression& shared : active_common_subexpressions_) {
+    if (IsSameSubexpression(expr, shared.expr)) {
+      // 'expr' is evaluated by the shared subexpression.
+      expr->MarkFieldsAccessed();
+      ZETASQL_ASSIGN_OR_RETURN(val_op,
+                       DerefExpr::Create(shared.variable, expr->type()));
+      return val_op;
+    }
+  }
+
   switch (expr->node_kind()) {
     case RESOLVED_LITERAL: {
       ZETASQL_ASSIGN_OR_RETURN(
@@ -1762,7 +1829,47 @@ absl::StatusOr<std::unique_ptr<ValueExpr>> Algebrizer::AlgebrizeExpression(
              << "Unhandled node type algebrizing an expression: "
              << expr->node_kind_string();
   }
-  return val_op;
+  return MaybeFoldConstant(expr, std::move(val_op));
+}
+
+absl::StatusOr<std::unique_ptr<ValueExpr>> Algebrizer::MaybeFoldConstant(
+    const ResolvedExpr* expr, std::unique_ptr<ValueExpr> algebrized) {
+  if (!algebrizer_options_.fold_constants || algebrized->IsConstant() ||
+      !IsFoldable(expr)) {
+    return algebrized;
+  }
+  // Subexpressions are folded bottom up, so it is enough to check that the
+  // arguments are constants. This also rules out operators that read
+  // variables.
+  for (const AlgebraArg* arg : algebrized->GetArgs()) {
+    if (arg == nullptr || !arg->has_node()) {
+      continue;
+    }
+    if (arg->has_variable() || arg->value_expr() == nullptr ||
+        !arg->value_expr()->IsConstant()) {
+      return algebrized;
+    }
+  }
+  if (!algebrized->SetSchemasForEvaluation(/*params_schemas=*/{}).ok()) {
+    return algebrized;
+  }
+
+  EvaluationContext context((EvaluationOptions()));
+  context.SetLanguageOptions(language_options_);
+  TupleSlot result;
+  absl::Status status;
+  // If evaluation fails, the error is raised at runtime instead, and only if
+  // the expression is actually evaluated. Results that depend on the default
+  // time zone or the current time may differ at runtime.
+  if (!algebrized->EvalSimple(/*params=*/{}, &context, &result, &status) ||
+      !context.IsDeterministicOutput() || context.UsedExecutionEnvironment() ||
+      result.value().physical_byte_size() > kMaxFoldedValueBytes) {
+    return algebrized;
+  }
+  ZETASQL_ASSIGN_OR_RETURN(
+      std::unique_ptr<ValueExpr> folded,
+      ConstExpr::CreateFolded(result.value(), algebrized->DebugString()));
+  return folded;
 }
 
 // Returns the set of columns referenced by 'expr'.
@@ -1795,6 +1902,100 @@ static absl::StatusOr<absl::flat_hash_set<ResolvedColumn>> GetReferencedColumns(
   return visitor.columns();
 }
 
+absl::Status Algebrizer::CollectReferencedColumns(const ResolvedNode* root) {
+  // ResolvedASTVisitor that records the columns that are read through a
+  // ResolvedColumnRef, or positionally from the column list of a scan whose
+  // parent is not a scan (e.g., the query of a statement, a subquery, a WITH
+  // entry or a set operation item). The column list of a scan whose parent is
+  // a scan is just the set of columns that it makes available to its parent,
+  // which reads them by reference. Only the scans that the algebrizer
+  // supports are known to behave that way.
+  class ReferencedColumnsVisitor : public ResolvedASTVisitor {
+   public:
+    ReferencedColumnsVisitor() = default;
+    ReferencedColumnsVisitor(const ReferencedColumnsVisitor&) = delete;
+    ReferencedColumnsVisitor& operator=(const ReferencedColumnsVisitor&) =
+        delete;
+
+    absl::flat_hash_set<ResolvedColumn>& columns() { return columns_; }
+    bool all_scans_supported() const { return all_scans_supported_; }
+
+    absl::Status DefaultVisit(const ResolvedNode* node) override {
+      const bool is_scan = node->IsScan();
+      if (is_scan) {
+        switch (node->node_kind()) {
+          case RESOLVED_SINGLE_ROW_SCAN:
+          case RESOLVED_TABLE_SCAN:
+          case RESOLVED_JOIN_SCAN:
+          case RESOLVED_ARRAY_SCAN:
+          case RESOLVED_FILTER_SCAN:
+          case RESOLVED_SAMPLE_SCAN:
+          case RESOLVED_AGGREGATE_SCAN:
+          case RESOLVED_ANONYMIZED_AGGREGATE_SCAN:
+          case RESOLVED_DIFFERENTIAL_PRIVACY_AGGREGATE_SCAN:
+          case RESOLVED_SET_OPERATION_SCAN:
+          case RESOLVED_PROJECT_SCAN:
+          case RESOLVED_ORDER_BY_SCAN:
+          case RESOLVED_LIMIT_OFFSET_SCAN:
+          case RESOLVED_TOP_SCAN:
+          case RESOLVED_OFFSET_FETCH_SCAN:
+          case RESOLVED_WITH_SCAN:
+          case RESOLVED_WITH_REF_SCAN:
+          case RESOLVED_ANALYTIC_SCAN:
+          case RESOLVED_RECURSIVE_SCAN:
+          case RESOLVED_RECURSIVE_REF_SCAN:
+          case RESOLVED_PIVOT_SCAN:
+          case RESOLVED_UNPIVOT_SCAN:
+          case RESOLVED_GROUP_ROWS_SCAN:
+            break;
+          default:
+            all_scans_supported_ = false;
+            break;
+        }
+        if (!parent_is_scan_) {
+          for (const ResolvedColumn& column :
+               node->GetAs<ResolvedScan>()->column_list()) {
+            columns_.insert(column);
+          }
+        }
+      }
+      const bool saved_parent_is_scan = parent_is_scan_;
+      parent_is_scan_ = is_scan;
+      const absl::Status status = node->ChildrenAccept(this);
+      parent_is_scan_ = saved_parent_is_scan;
+      return status;
+    }
+
+    absl::Status VisitResolvedColumnRef(
+        const ResolvedColumnRef* node) override {
+      columns_.insert(node->column());
+      return DefaultVisit(node);
+    }
+
+    absl::Status VisitResolvedColumnHolder(
+        const ResolvedColumnHolder* node) override {
+      columns_.insert(node->column());
+      return DefaultVisit(node);
+    }
+
+   private:
+    absl::flat_hash_set<ResolvedColumn> columns_;
+    bool parent_is_scan_ = false;
+    bool all_scans_supported_ = true;
+  };
+
+  referenced_columns_.reset();
+  if (!algebrizer_options_.prune_unused_table_columns) {
+    return absl::OkStatus();
+  }
+  ReferencedColumnsVisitor visitor;
+  ZETASQL_RETURN_IF_ERROR(root->Accept(&visitor));
+  if (visitor.all_scans_supported()) {
+    referenced_columns_ = std::move(visitor.columns());
+  }
+  return absl::OkStatus();
+}
+
 // Returns true if 'expr' is known to be non-volatile (per
 // FunctionEnums::VOLATILE).
 static bool IsNonVolatile(const ResolvedExpr* expr) {
@@ -1849,6 +2050,194 @@ static bool IsNonVolatile(const ResolvedExpr* expr) {
   }
 }
 
+namespace {
+
+// An occurrence of a subexpression that may be computed once and shared with
+// the other occurrences of equal subexpressions.
+struct SubexpressionOccurrence {
+  const ResolvedExpr* expr;
+  // The index of the closest enclosing occurrence, or -1.
+  int parent;
+  // The number of nodes in 'expr'.
+  int size;
+  // True if 'expr' is evaluated, with errors propagated, whenever the
+  // expression containing it is evaluated.
+  bool unconditional;
+  // Identifies the expression containing 'expr'. Chosen by the caller.
+  int source;
+};
+
+// Grouping occurrences into classes of equal subexpressions is quadratic, so
+// larger expressions are left alone.
+constexpr int kMaxSubexpressionOccurrences = 1000;
+
+// Returns the number of leading arguments of 'function_call' that are always
+// evaluated, with errors propagated, when it is evaluated. The other arguments
+// are evaluated depending on the values of those, or have their errors caught.
+int NumUnconditionalArguments(const ResolvedFunctionCall* function_call) {
+  const int num_args = function_call->argument_list_size();
+  if (!function_call->function()->IsZetaSQLBuiltin()) {
+    return num_args;
+  }
+  const std::string& name = function_call->function()->Name();
+  if (name == "if" || name == "$case_no_value" || name == "coalesce" ||
+      name == "ifnull") {
+    return std::min(num_args, 1);
+  }
+  if (name == "$case_with_value") {
+    return std::min(num_args, 2);
+  }
+  if (name == "iferror" || name == "iserror" || name == "nulliferror") {
+    return 0;
+  }
+  return num_args;
+}
+
+// Returns true if 'expr' may be computed once and shared.
+bool IsShareableSubexpression(const ResolvedExpr* expr) {
+  switch (expr->node_kind()) {
+    case RESOLVED_FUNCTION_CALL:
+      return expr->GetAs<ResolvedFunctionCall>()
+                 ->generic_argument_list()
+                 .empty() &&
+             IsNonVolatile(expr);
+    case RESOLVED_CAST:
+    case RESOLVED_GET_STRUCT_FIELD:
+      return IsNonVolatile(expr);
+    default:
+      return false;
+  }
+}
+
+// Appends the shareable subexpressions of 'expr', including 'expr' itself, to
+// 'occurrences' in pre-order, and returns the number of nodes in 'expr'.
+// Subqueries and lambdas, which are evaluated in a different scope, are not
+// searched.
+int CollectSubexpressions(const ResolvedExpr* expr, int parent,
+                          bool unconditional, int source,
+                          std::vector<SubexpressionOccurrence>* occurrences) {
+  int index = parent;
+  if (IsShareableSubexpression(expr)) {
+    index = static_cast<int>(occurrences->size());
+    occurrences->push_back(
+        {expr, parent, /*size=*/0, unconditional, source});
+  }
+  int size = 1;
+  switch (expr->node_kind()) {
+    case RESOLVED_FUNCTION_CALL: {
+      const ResolvedFunctionCall* function_call =
+          expr->GetAs<ResolvedFunctionCall>();
+      const int num_unconditional = NumUnconditionalArguments(function_call);
+      for (int i = 0; i < function_call->argument_list_size(); ++i) {
+        size += CollectSubexpressions(function_call->argument_list(i), index,
+                                      unconditional && i < num_unconditional,
+                                      source, occurrences);
+      }
+      break;
+    }
+    case RESOLVED_CAST:
+      size += CollectSubexpressions(expr->GetAs<ResolvedCast>()->expr(), index,
+                                    unconditional, source, occurrences);
+      break;
+    case RESOLVED_GET_STRUCT_FIELD:
+      size += CollectSubexpressions(
+          expr->GetAs<ResolvedGetStructField>()->expr(), index, unconditional,
+          source, occurrences);
+      break;
+    case RESOLVED_GET_PROTO_FIELD:
+      size += CollectSubexpressions(
+          expr->GetAs<ResolvedGetProtoField>()->expr(), index, unconditional,
+          source, occurrences);
+      break;
+    case RESOLVED_MAKE_STRUCT:
+      for (const auto& field_expr :
+           expr->GetAs<ResolvedMakeStruct>()->field_list()) {
+        size += CollectSubexpressions(field_expr.get(), index, unconditional,
+                                      source, occurrences);
+      }
+      break;
+    default:
+      break;
+  }
+  if (index != parent) {
+    (*occurrences)[index].size = size;
+  }
+  return size;
+}
+
+// Groups 'occurrences' into classes of equal subexpressions, and returns the
+// classes accepted by 'choose', from the smallest subexpression to the
+// largest, so that larger ones can reference the smaller ones they contain.
+// Classes are offered to 'choose' from the largest subexpression to the
+// smallest, and only with the occurrences that are not contained in an
+// occurrence of an accepted class, since those are not evaluated any more.
+std::vector<std::vector<int>> ChooseSubexpressions(
+    const std::vector<SubexpressionOccurrence>& occurrences,
+    const std::function<bool(const std::vector<int>&)>& choose) {
+  if (occurrences.size() > kMaxSubexpressionOccurrences) {
+    return {};
+  }
+  std::vector<std::vector<int>> classes;
+  for (int i = 0; i < occurrences.size(); ++i) {
+    bool found = false;
+    for (std::vector<int>& equal_occurrences : classes) {
+      const SubexpressionOccurrence& other = occurrences[equal_occurrences[0]];
+      if (other.size == occurrences[i].size &&
+          IsSameSubexpression(other.expr, occurrences[i].expr)) {
+        equal_occurrences.push_back(i);
+        found = true;
+        break;
+      }
+    }
+    if (!found) {
+      classes.push_back({i});
+    }
+  }
+  std::stable_sort(classes.begin(), classes.end(),
+                   [&occurrences](const std::vector<int>& class1,
+                                  const std::vector<int>& class2) {
+                     return occurrences[class1[0]].size >
+                            occurrences[class2[0]].size;
+                   });
+
+  std::vector<bool> is_shared(occurrences.size(), false);
+  std::vector<std::vector<int>> chosen;
+  for (const std::vector<int>& equal_occurrences : classes) {
+    std::vector<int> live_occurrences;
+    for (int i : equal_occurrences) {
+      bool is_live = true;
+      for (int p = occurrences[i].parent; p != -1; p = occurrences[p].parent) {
+        if (is_shared[p]) {
+          is_live = false;
+          break;
+        }
+      }
+      if (is_live) {
+        live_occurrences.push_back(i);
+      }
+    }
+    if (live_occurrences.empty() || !choose(live_occurrences)) {
+      continue;
+    }
+    for (int i : live_occurrences) {
+      is_shared[i] = true;
+    }
+    chosen.push_back(std::move(live_occurrences));
+  }
+  std::reverse(chosen.begin(), chosen.end());
+  return chosen;
+}
+
+// Returns true if any of 'occurrences[indexes]' is unconditional.
+bool AnyUnconditional(const std::vector<SubexpressionOccurrence>& occurrences,
+                      const std::vector<int>& indexes) {
+  return std::any_of(indexes.begin(), indexes.end(), [&occurrences](int i) {
+    return occurrences[i].unconditional;
+  });
+}
+
+}  // namespace
+
 absl::StatusOr<std::unique_ptr<Algebrizer::FilterConjunctInfo>>
 Algebrizer::FilterConjunctInfo::Create(const ResolvedExpr* conjunct) {
   auto info = std::make_unique<FilterConjunctInfo>();
@@ -1965,7 +2354,11 @@ absl::StatusOr<std::unique_ptr<RelationalOp>> Algebrizer::AlgebrizeTableScan(
     const std::vector<int>& column_idx_list = table_scan->column_index_list();
     ZETASQL_RET_CHECK_EQ(column_list.size(), column_idx_list.size());
 
-    // Figure out the column names and variables.
+    // Figure out the columns to read, with their names and variables. Columns
+    // that are never referenced are skipped, except that at least one column
+    // is read so that the iterator still produces rows.
+    std::vector<int> column_idxs;
+    column_idxs.reserve(column_list.size());
     std::vector<std::string> column_names;
     column_names.reserve(column_list.size());
     std::vector<VariableId> variables;
@@ -1974,12 +2367,20 @@ absl::StatusOr<std::unique_ptr<RelationalOp>> Algebrizer::AlgebrizeTableScan(
     column_info_map.reserve(column_list.size());
     for (int i = 0; i < column_list.size(); ++i) {
       const ResolvedColumn& column = column_list[i];
+      if (referenced_columns_.has_value() &&
+          !referenced_columns_->contains(column) &&
+          (!column_idxs.empty() || i + 1 < column_list.size())) {
+        continue;
+      }
+      const int scan_idx = static_cast<int>(column_idxs.size());
+      column_idxs.push_back(column_idx_list[i]);
       column_names.push_back(column.name());
       const VariableId variable =
           column_to_variable_->GetVariableNameFromColumn(column);
       variables.push_back(variable);
       ZETASQL_RET_CHECK(
-          column_info_map.emplace(column, std::make_pair(variable, i)).second);
+          column_info_map.emplace(column, std::make_pair(variable, scan_idx))
+              .second);
     }
 
     // Create ColumnFilterArgs from 'conjunct_infos'.
@@ -1998,7 +2399,7 @@ absl::StatusOr<std::unique_ptr<RelationalOp>> Algebrizer::AlgebrizeTableScan(
     }
 
     return EvaluatorTableScanOp::Create(
-        table_scan->table(), table_scan->alias(), column_idx_list, column_names,
+        table_scan->table(), table_scan->alias(), column_idxs, column_names,
         variables, std::move(and_filters), std::move(system_time_expr));
   }
 }
@@ -2192,6 +2593,10 @@ absl::Status Algebrizer::TryAlgebrizeFilterConjunctAsColumnFilterArgs(
 //
 //  t1 and t4 would have one reference, while t2 and t3 would have zero
 //  references.
+//
+// A reference from inside a subquery expression counts as two references,
+// since the subquery is evaluated again for every row of the enclosing scan.
+// Inlining the entry there would evaluate it once per row, rather than once.
 class FindWithEntryReferenceCountVisitor : public ResolvedASTVisitor {
  public:
   static absl::StatusOr<absl::flat_hash_map<std::string, int>> Run(
@@ -2255,17 +2660,28 @@ class FindWithEntryReferenceCountVisitor : public ResolvedASTVisitor {
     return absl::OkStatus();
   }
 
+  absl::Status VisitResolvedSubqueryExpr(
+      const ResolvedSubqueryExpr* expr) override {
+    const bool old_in_subquery_expr = in_subquery_expr_;
+    in_subquery_expr_ = true;
+    const absl::Status status = expr->ChildrenAccept(this);
+    in_subquery_expr_ = old_in_subquery_expr;
+    return status;
+  }
+
   absl::Status VisitResolvedWithRefScan(
       const ResolvedWithRefScan* scan) override {
     auto it = reference_count_.find(scan->with_query_name());
     if (it != reference_count_.end()) {
-      ++it->second;
+      it->second += in_subquery_expr_ ? 2 : 1;
     }
     return absl::OkStatus();
   }
 
  private:
   absl::flat_hash_map<std::string, int> reference_count_;
+  // True while visiting the children of a ResolvedSubqueryExpr.
+  bool in_subquery_expr_ = false;
 };
 
 absl::StatusOr<std::unique_ptr<RelationalOp>> Algebrizer::AlgebrizeWithScan(
@@ -2278,7 +2694,10 @@ absl::StatusOr<std::unique_ptr<RelationalOp>> Algebrizer::AlgebrizeWithScan(
   const absl::flat_hash_map<std::string, ExprArg*> old_with_map = with_map_;
 
   // Compute how many times each WITH entry is referenced. Entries referenced
-  // exactly once can be inlined, while entries not referenced at all can be
+  // exactly once can be inlined, so that their rows are streamed to the one
+  // consumer and filters and LIMITs there stop evaluation early. Entries
+  // referenced more than once are materialized once into an array whose memory
+  // is tracked by the MemoryAccountant. Entries not referenced at all can be
   // skipped altogether.
   std::optional<absl::flat_hash_map<std::string, int>> reference_count_by_name;
   if (algebrizer_options_.inline_with_entries) {
@@ -2367,8 +2786,9 @@ absl::StatusOr<std::unique_ptr<RelationalOp>> Algebrizer::AlgebrizeWithRefScan(
           std::make_unique<ExprArg>(to_varid, std::move(deref)));
     }
     ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<RelationalOp> compute_op,
-                     ComputeOp::Create(std::move(column_map),
-                                       std::move(algebrized_with_subquery)));
+                     ComputeOp::CreateForInlinedWithEntry(
+                         query_name, std::move(column_map),
+                         std::move(algebrized_with_subquery)));
     return compute_op;
   }
 
@@ -2710,6 +3130,27 @@ Algebrizer::AlgebrizeJoinScanInternal(
     }
   }
 
+  // Otherwise, use a range join if the join condition restricts a right column
+  // to a range determined by the left input.
+  JoinOp::RangeJoinExprs range_join_exprs;
+  if (algebrizer_options_.allow_range_join &&
+      hash_join_equality_exprs.empty()) {
+    switch (join_kind) {
+      case JoinOp::kInnerJoin:
+      case JoinOp::kLeftOuterJoin:
+      case JoinOp::kRightOuterJoin:
+      case JoinOp::kFullOuterJoin:
+        ZETASQL_RETURN_IF_ERROR(AlgebrizeJoinConditionForRangeJoin(
+            left_output_columns, right_output_columns,
+            join_condition_conjuncts_with_push_down, &range_join_exprs));
+        break;
+      case JoinOp::kCrossApply:
+      case JoinOp::kOuterApply:
+        // Range join is not supported for correlated joins.
+        break;
+    }
+  }
+
   // Algebrize all of the non-redundant remaining conjuncts for use in the join
   // condition. Iterate in reverse order to de-stackify the ordering.
   std::vector<std::unique_ptr<ValueExpr>> algebrized_conjuncts;
@@ -2767,7 +3208,7 @@ Algebrizer::AlgebrizeJoinScanInternal(
       JoinOp::Create(join_kind, std::move(hash_join_equality_exprs),
                      std::move(remaining_join_expr), std::move(left),
                      std::move(right), std::move(left_output),
-                     std::move(right_output)));
+                     std::move(right_output), std::move(range_join_exprs)));
 
   return join_op;
 }
@@ -2997,6 +3438,142 @@ Algebrizer::TryAlgebrizeFilterConjunctAsHashJoinEqualityExprs(
 
   return true;
 }
+
+// Returns true if Value::LessThan() on non-NULL values of 'type' agrees with
+// SQL comparison, so that a range join can sort on it.
+static bool IsRangeJoinKeyType(const Type* type) {
+  switch (type->kind()) {
+    case TYPE_BOOL:
+    case TYPE_INT32:
+    case TYPE_INT64:
+    case TYPE_UINT32:
+    case TYPE_UINT64:
+    case TYPE_STRING:
+    case TYPE_BYTES:
+    case TYPE_DATE:
+    case TYPE_TIMESTAMP:
+    case TYPE_DATETIME:
+    case TYPE_TIME:
+      return true;
+    default:
+      // In particular, FLOAT and DOUBLE are excluded because of NaN and signed
+      // zeros.
+      return false;
+  }
+}
+
+absl::Status Algebrizer::AlgebrizeJoinConditionForRangeJoin(
+    const absl::flat_hash_set<ResolvedColumn>& left_output_columns,
+    const absl::flat_hash_set<ResolvedColumn>& right_output_columns,
+    const std::vector<FilterConjunctInfo*>& conjuncts_with_push_down,
+    JoinOp::RangeJoinExprs* range_exprs) {
+  std::optional<ResolvedColumn> right_column;
+  const ResolvedExpr* lower_bound = nullptr;
+  const ResolvedExpr* upper_bound = nullptr;
+
+  // Returns true if 'arg' is a reference to a right column that can be used as
+  // the range join key.
+  const auto is_range_join_key = [&](const ResolvedExpr* arg) {
+    if (arg->node_kind() != RESOLVED_COLUMN_REF) return false;
+    const ResolvedColumn& column = arg->GetAs<ResolvedColumnRef>()->column();
+    if (!right_output_columns.contains(column)) return false;
+    if (right_column.has_value()) return *right_column == column;
+    return IsRangeJoinKeyType(column.type());
+  };
+  // Returns true if 'arg' can be a bound for 'key'.
+  const auto is_range_join_bound =
+      [&](const ResolvedExpr* arg,
+          const absl::flat_hash_set<ResolvedColumn>& arg_columns,
+          const ResolvedExpr* key) {
+        return IsSubsetOf(arg_columns, left_output_columns) &&
+               arg->type()->Equals(key->type());
+      };
+
+  // Iterate in reverse order because 'conjuncts_with_push_down' is a stack.
+  for (auto i = conjuncts_with_push_down.rbegin();
+       i != conjuncts_with_push_down.rend(); ++i) {
+    const FilterConjunctInfo* conjunct_info = *i;
+    if (conjunct_info->redundant || !conjunct_info->is_non_volatile) continue;
+    if (conjunct_info->kind != FilterConjunctInfo::kLE &&
+        conjunct_info->kind != FilterConjunctInfo::kGE &&
+        conjunct_info->kind != FilterConjunctInfo::kBetween) {
+      continue;
+    }
+    // Collated comparisons do not agree with Value::LessThan().
+    if (!conjunct_info->conjunct->GetAs<ResolvedFunctionCall>()
+             ->collation_list()
+             .empty()) {
+      continue;
+    }
+    const std::vector<const ResolvedExpr*>& args = conjunct_info->arguments;
+    const std::vector<absl::flat_hash_set<ResolvedColumn>>& arg_columns =
+        conjunct_info->argument_columns;
+
+    const ResolvedExpr* key = nullptr;
+    const ResolvedExpr* new_lower_bound = nullptr;
+    const ResolvedExpr* new_upper_bound = nullptr;
+    if (conjunct_info->kind == FilterConjunctInfo::kBetween) {
+      ZETASQL_RET_CHECK_EQ(args.size(), 3);
+      if (is_range_join_key(args[0]) &&
+          is_range_join_bound(args[1], arg_columns[1], args[0]) &&
+          is_range_join_bound(args[2], arg_columns[2], args[0])) {
+        key = args[0];
+        new_lower_bound = args[1];
+        new_upper_bound = args[2];
+      }
+    } else {
+      ZETASQL_RET_CHECK_EQ(args.size(), 2);
+      // For kLE, args[0] <= args[1] (or <), and vice versa for kGE.
+      const bool key_is_smaller =
+          conjunct_info->kind == FilterConjunctInfo::kLE;
+      const ResolvedExpr* bound = nullptr;
+      if (is_range_join_key(args[0]) &&
+          is_range_join_bound(args[1], arg_columns[1], args[0])) {
+        key = args[0];
+        bound = args[1];
+      } else if (is_range_join_key(args[1]) &&
+                 is_range_join_bound(args[0], arg_columns[0], args[1])) {
+        key = args[1];
+        bound = args[0];
+      }
+      // The key is on the smaller side of the comparison if it is args[0] of
+      // kLE or args[1] of kGE, in which case the other side bounds it above.
+      if ((key == args[0]) == key_is_smaller) {
+        new_upper_bound = bound;
+      } else {
+        new_lower_bound = bound;
+      }
+    }
+    if (key == nullptr) continue;
+
+    right_column = key->GetAs<ResolvedColumnRef>()->column();
+    if (lower_bound == nullptr) lower_bound = new_lower_bound;
+    if (upper_bound == nullptr) upper_bound = new_upper_bound;
+  }
+
+  if (!right_column.has_value()) return absl::OkStatus();
+
+  ZETASQL_ASSIGN_OR_RETURN(
+      std::unique_ptr<ValueExpr> right_expr,
+      DerefExpr::Create(
+          column_to_variable_->GetVariableNameFromColumn(*right_column),
+          right_column->type()));
+  range_exprs->right_expr = std::make_unique<ExprArg>(std::move(right_expr));
+  if (lower_bound != nullptr) {
+    ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<ValueExpr> algebrized_lower_bound,
+                     AlgebrizeExpression(lower_bound));
+    range_exprs->lower_bound =
+        std::make_unique<ExprArg>(std::move(algebrized_lower_bound));
+  }
+  if (upper_bound != nullptr) {
+    ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<ValueExpr> algebrized_upper_bound,
+                     AlgebrizeExpression(upper_bound));
+    range_exprs->upper_bound =
+        std::make_unique<ExprArg>(std::move(algebrized_upper_bound));
+  }
+  return absl::OkStatus();
+}
+
 absl::Status Algebrizer::RemapJoinColumns(
     const ResolvedColumnList& columns,
     std::vector<std::unique_ptr<ExprArg>>* output) {
@@ -3025,6 +3602,13 @@ Algebrizer::AlgebrizeFilterScanInternal(
   ZETASQL_RET_CHECK(filter_expr != nullptr);
   std::vector<std::unique_ptr<FilterConjunctInfo>> conjunct_infos;
   ZETASQL_RETURN_IF_ERROR(AddFilterConjunctsTo(filter_expr, &conjunct_infos));
+  if (filter_expr == shared_filter_expr_) {
+    for (std::unique_ptr<FilterConjunctInfo>& info : conjunct_infos) {
+      info->shared_subexpressions = shared_filter_subexpressions_;
+    }
+    shared_filter_expr_ = nullptr;
+    shared_filter_subexpressions_ = nullptr;
+  }
   // Push the new conjuncts onto 'active_conjuncts' in reverse order (because
   // it's a stack).
   for (auto i = conjunct_infos.rbegin(); i != conjunct_infos.rend(); ++i) {
@@ -3041,19 +3625,17 @@ Algebrizer::AlgebrizeFilterScanInternal(
   }
 
   // Drop any FilterConjunctInfos that are now redundant.
-  std::vector<std::unique_ptr<ValueExpr>> algebrized_conjuncts;
-  algebrized_conjuncts.reserve(conjunct_infos.size());
+  std::vector<FilterConjunctInfo*> remaining_conjuncts;
+  remaining_conjuncts.reserve(conjunct_infos.size());
   for (std::unique_ptr<FilterConjunctInfo>& info : conjunct_infos) {
     if (!info->redundant) {
-      ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<ValueExpr> algebrized_conjunct,
-                       AlgebrizeExpression(info->conjunct));
-      algebrized_conjuncts.push_back(std::move(algebrized_conjunct));
+      remaining_conjuncts.push_back(info.get());
     }
   }
 
   // Algebrize the filter.
-  return ApplyAlgebrizedFilterConjuncts(std::move(input),
-                                        std::move(algebrized_conjuncts));
+  return AlgebrizeAndApplyFilterConjuncts(std::move(input),
+                                          remaining_conjuncts);
 }
 
 absl::StatusOr<std::unique_ptr<RelationalOp>> Algebrizer::AlgebrizeFilterScan(
@@ -3069,6 +3651,115 @@ absl::StatusOr<std::unique_ptr<RelationalOp>> Algebrizer::AlgebrizeFilterScan(
                                      active_conjuncts);
 }
 
+absl::StatusOr<std::unique_ptr<RelationalOp>>
+Algebrizer::AlgebrizeAndApplyFilterConjuncts(
+    std::unique_ptr<RelationalOp> input,
+    const std::vector<FilterConjunctInfo*>& conjuncts) {
+  // Subexpressions of the enclosing operator are not computed by 'input'.
+  std::vector<CommonSubexpression> enclosing_common_subexpressions;
+  enclosing_common_subexpressions.swap(active_common_subexpressions_);
+  absl::Cleanup restore_common_subexpressions =
+      [this, &enclosing_common_subexpressions] {
+        active_common_subexpressions_.swap(enclosing_common_subexpressions);
+      };
+
+  std::vector<std::unique_ptr<ExprArg>> shared_args;
+  if (algebrizer_options_.eliminate_common_subexpressions) {
+    // The conjuncts are combined with AND, which evaluates all of them.
+    std::vector<SubexpressionOccurrence> occurrences;
+    std::vector<CommonSubexpression*> wanted;
+    for (const FilterConjunctInfo* info : conjuncts) {
+      CollectSubexpressions(info->conjunct, /*parent=*/-1,
+                            /*unconditional=*/true, /*source=*/0,
+                            &occurrences);
+      if (info->shared_subexpressions != nullptr) {
+        for (CommonSubexpression& shared : *info->shared_subexpressions) {
+          if (std::find(wanted.begin(), wanted.end(), &shared) ==
+              wanted.end()) {
+            wanted.push_back(&shared);
+          }
+        }
+      }
+    }
+    // Returns the subexpression wanted by the enclosing projection that is
+    // equal to 'expr', or NULL.
+    auto find_wanted = [&wanted](const ResolvedExpr* expr) {
+      for (CommonSubexpression* shared : wanted) {
+        if (IsSameSubexpression(shared->expr, expr)) {
+          return shared;
+        }
+      }
+      return static_cast<CommonSubexpression*>(nullptr);
+    };
+    const std::vector<std::vector<int>> chosen = ChooseSubexpressions(
+        occurrences, [&](const std::vector<int>& live_occurrences) {
+          return AnyUnconditional(occurrences, live_occurrences) &&
+                 (live_occurrences.size() > 1 ||
+                  find_wanted(occurrences[live_occurrences[0]].expr) !=
+                      nullptr);
+        });
+
+    std::unique_ptr<const TupleSchema> input_schema;
+    for (const std::vector<int>& live_occurrences : chosen) {
+      const ResolvedExpr* expr = occurrences[live_occurrences[0]].expr;
+      CommonSubexpression* shared = find_wanted(expr);
+      if (shared != nullptr && shared->computed) {
+        // Another conjunct of the same filter was applied further down.
+        if (input_schema == nullptr) {
+          input_schema = input->CreateOutputSchema();
+        }
+        if (input_schema->FindIndexForVariable(shared->variable)
+                .has_value()) {
+          active_common_subexpressions_.push_back(*shared);
+          continue;
+        }
+        shared = nullptr;
+      }
+      CommonSubexpression local_shared{expr};
+      if (shared == nullptr) {
+        if (live_occurrences.size() < 2) {
+          continue;
+        }
+        shared = &local_shared;
+      }
+      ZETASQL_RETURN_IF_ERROR(ComputeCommonSubexpression(shared, &shared_args));
+    }
+  }
+
+  std::vector<std::unique_ptr<ValueExpr>> algebrized_conjuncts;
+  algebrized_conjuncts.reserve(conjuncts.size());
+  for (const FilterConjunctInfo* info : conjuncts) {
+    ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<ValueExpr> algebrized_conjunct,
+                     AlgebrizeExpression(info->conjunct));
+    algebrized_conjuncts.push_back(std::move(algebrized_conjunct));
+  }
+  if (!shared_args.empty()) {
+    ZETASQL_ASSIGN_OR_RETURN(
+        input, ComputeOp::Create(std::move(shared_args), std::move(input)));
+  }
+  return ApplyAlgebrizedFilterConjuncts(std::move(input),
+                                        std::move(algebrized_conjuncts));
+}
+
+absl::Status Algebrizer::ComputeCommonSubexpression(
+    CommonSubexpression* shared,
+    std::vector<std::unique_ptr<ExprArg>>* arguments) {
+  ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<ValueExpr> value,
+                   AlgebrizeExpression(shared->expr));
+  if (value->IsConstant()) {
+    // Folded constants are as cheap to evaluate as a variable.
+    return absl::OkStatus();
+  }
+  if (!shared->variable.is_valid()) {
+    shared->variable = variable_gen_->GetNewVariableName("cse");
+  }
+  arguments->push_back(
+      std::make_unique<ExprArg>(shared->variable, std::move(value)));
+  shared->computed = true;
+  active_common_subexpressions_.push_back(*shared);
+  return absl::OkStatus();
+}
+
 absl::StatusOr<std::unique_ptr<RelationalOp>>
 Algebrizer::ApplyAlgebrizedFilterConjuncts(
     std::unique_ptr<RelationalOp> input,
@@ -4465,13 +5156,90 @@ absl::StatusOr<std::unique_ptr<RelationalOp>> Algebrizer::AlgebrizeProjectScan(
       input_active_conjuncts.push_back(info);
     }
   }
-  ZETASQL_ASSIGN_OR_RETURN(
-      std::unique_ptr<RelationalOp> input,
-      AlgebrizeScan(resolved_project->input_scan(), &input_active_conjuncts));
 
-  // Assign variables to the new columns and algebrize their definitions.
+  // Find the subexpressions that the new columns share with a filter directly
+  // below the projection. The filter computes them wherever it is applied, so
+  // that the projection can reuse them.
+  const ResolvedScan* input_scan = resolved_project->input_scan();
+  std::vector<SubexpressionOccurrence> occurrences;
+  std::vector<CommonSubexpression> filter_subexpressions;
+  if (algebrizer_options_.eliminate_common_subexpressions) {
+    for (const auto& entry : defined_columns_and_exprs) {
+      CollectSubexpressions(entry.second, /*parent=*/-1,
+                            /*unconditional=*/true, /*source=*/0,
+                            &occurrences);
+    }
+    const int num_project_occurrences = static_cast<int>(occurrences.size());
+    if (input_scan->node_kind() == RESOLVED_FILTER_SCAN) {
+      CollectSubexpressions(
+          input_scan->GetAs<ResolvedFilterScan>()->filter_expr(),
+          /*parent=*/-1, /*unconditional=*/true, /*source=*/1, &occurrences);
+      for (const std::vector<int>& live_occurrences : ChooseSubexpressions(
+               occurrences, [&occurrences](const std::vector<int>& live) {
+                 bool in_project = false;
+                 bool in_filter = false;
+                 for (int i : live) {
+                   in_project |= occurrences[i].source == 0;
+                   in_filter |= occurrences[i].source == 1 &&
+                                occurrences[i].unconditional;
+                 }
+                 return in_project && in_filter;
+               })) {
+        filter_subexpressions.push_back(
+            {occurrences[live_occurrences[0]].expr});
+      }
+      occurrences.resize(num_project_occurrences);
+    }
+  }
+  if (!filter_subexpressions.empty()) {
+    shared_filter_expr_ =
+        input_scan->GetAs<ResolvedFilterScan>()->filter_expr();
+    shared_filter_subexpressions_ = &filter_subexpressions;
+  }
+  absl::StatusOr<std::unique_ptr<RelationalOp>> algebrized_input =
+      AlgebrizeScan(input_scan, &input_active_conjuncts);
+  shared_filter_expr_ = nullptr;
+  shared_filter_subexpressions_ = nullptr;
+  ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<RelationalOp> input,
+                   std::move(algebrized_input));
+
+  // Reuse the subexpressions that the filter computed, and compute those that
+  // occur more than once in the new columns before the columns themselves.
   std::vector<std::unique_ptr<ExprArg>> arguments;
-  arguments.reserve(defined_columns_and_exprs.size());
+  if (!filter_subexpressions.empty()) {
+    const std::unique_ptr<const TupleSchema> input_schema =
+        input->CreateOutputSchema();
+    for (const CommonSubexpression& shared : filter_subexpressions) {
+      if (shared.computed &&
+          input_schema->FindIndexForVariable(shared.variable).has_value()) {
+        active_common_subexpressions_.push_back(shared);
+      }
+    }
+  }
+  const int num_reused = static_cast<int>(active_common_subexpressions_.size());
+  // Returns true if 'expr' is computed by the filter.
+  auto is_reused = [this, num_reused](const ResolvedExpr* expr) {
+    for (int i = 0; i < num_reused; ++i) {
+      if (IsSameSubexpression(active_common_subexpressions_[i].expr, expr)) {
+        return true;
+      }
+    }
+    return false;
+  };
+  for (const std::vector<int>& live_occurrences : ChooseSubexpressions(
+           occurrences, [&](const std::vector<int>& live) {
+             return is_reused(occurrences[live[0]].expr) ||
+                    (live.size() > 1 && AnyUnconditional(occurrences, live));
+           })) {
+    const ResolvedExpr* expr = occurrences[live_occurrences[0]].expr;
+    if (!is_reused(expr)) {
+      CommonSubexpression shared{expr};
+      ZETASQL_RETURN_IF_ERROR(ComputeCommonSubexpression(&shared, &arguments));
+    }
+  }
+
+  // Assign variables to the new columns and algebrize their definitions.
+  arguments.reserve(arguments.size() + defined_columns_and_exprs.size());
   for (const auto& entry : defined_columns_and_exprs) {
     const ResolvedColumn& column = entry.first;
     const ResolvedExpr* expr = entry.second;
@@ -4482,6 +5250,7 @@ absl::StatusOr<std::unique_ptr<RelationalOp>> Algebrizer::AlgebrizeProjectScan(
     arguments.push_back(
         std::make_unique<ExprArg>(variable, std::move(argument)));
   }
+  active_common_subexpressions_.clear();
 
   // If no columns were defined by this project then just drop it.
   if (!arguments.empty()) {
@@ -4684,6 +5453,14 @@ absl::StatusOr<std::unique_ptr<RelationalOp>> Algebrizer::AlgebrizeScan(
     std::vector<FilterConjunctInfo*>* active_conjuncts) {
   ZETASQL_RETURN_IF_ERROR(CheckHints(scan->hint_list()));
   const int original_active_conjuncts_size = active_conjuncts->size();
+  // Subexpressions computed for the enclosing operator are not visible to the
+  // operators of 'scan'.
+  std::vector<CommonSubexpression> enclosing_common_subexpressions;
+  enclosing_common_subexpressions.swap(active_common_subexpressions_);
+  absl::Cleanup restore_common_subexpressions =
+      [this, &enclosing_common_subexpressions] {
+        active_common_subexpressions_.swap(enclosing_common_subexpressions);
+      };
   std::unique_ptr<RelationalOp> rel_op;
   switch (scan->node_kind()) {
     case RESOLVED_SINGLE_ROW_SCAN: {
@@ -4824,23 +5601,20 @@ absl::StatusOr<std::unique_ptr<RelationalOp>>
 Algebrizer::MaybeApplyFilterConjuncts(
     std::unique_ptr<RelationalOp> input,
     std::vector<FilterConjunctInfo*>* active_conjuncts) {
-  std::vector<std::unique_ptr<ValueExpr>> algebrized_conjuncts;
+  std::vector<FilterConjunctInfo*> applied_conjuncts;
   if (algebrizer_options_.push_down_filters) {
     // Iterate over 'active_conjuncts' in reverse order because it's a stack.
     for (auto i = active_conjuncts->rbegin(); i != active_conjuncts->rend();
          ++i) {
       FilterConjunctInfo* conjunct_info = *i;
       if (!conjunct_info->redundant) {
-        ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<ValueExpr> algebrized_conjunct,
-                         AlgebrizeExpression(conjunct_info->conjunct));
-        algebrized_conjuncts.push_back(std::move(algebrized_conjunct));
+        applied_conjuncts.push_back(conjunct_info);
         conjunct_info->redundant = true;
       }
     }
   }
 
-  return ApplyAlgebrizedFilterConjuncts(std::move(input),
-                                        std::move(algebrized_conjuncts));
+  return AlgebrizeAndApplyFilterConjuncts(std::move(input), applied_conjuncts);
 }
 
 absl::StatusOr<std::unique_ptr<RelationalOp>> Algebrizer::AlgebrizeScan(
@@ -5474,6 +6248,7 @@ absl::Status Algebrizer::AlgebrizeStatement(
   Algebrizer single_use_algebrizer(language_options, algebrizer_options,
                                    type_factory, parameters, column_map,
                                    system_variables_map);
+  ZETASQL_RETURN_IF_ERROR(single_use_algebrizer.CollectReferencedColumns(ast_root));
   // Weirdly, the output_column_list of the statement may contain column
   // aliases not present in the output columns of 'query', so that the
   // statement wrapper acts as another PROJECT node. Compensate for this by
@@ -5572,6 +6347,7 @@ absl::Status Algebrizer::AlgebrizeQueryStatementAsRelation(
   Algebrizer single_use_algebrizer(language_options, algebrizer_options,
                                    type_factory, parameters, column_map,
                                    system_variables_map);
+  ZETASQL_RETURN_IF_ERROR(single_use_algebrizer.CollectReferencedColumns(ast_root));
   ZETASQL_ASSIGN_OR_RETURN(*output,
                    single_use_algebrizer.AlgebrizeQueryStatementAsRelation(
                        ast_root, output_column_list, output_column_names,
@@ -5590,6 +6366,7 @@ absl::Status Algebrizer::AlgebrizeExpression(
   Algebrizer single_use_algebrizer(language_options, algebrizer_options,
                                    type_factory, parameters, column_map,
                                    system_variables_map);
+  ZETASQL_RETURN_IF_ERROR(single_use_algebrizer.CollectReferencedColumns(ast_root));
   ZETASQL_ASSIGN_OR_RETURN(
       *output, single_use_algebrizer.AlgebrizeStandaloneExpression(ast_root));
 
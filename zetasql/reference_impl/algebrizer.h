@@ -72,6 +72,12 @@ struct AlgebrizerOptions {
   // compatible filter immediately above the join.
   bool allow_hash_join = false;
 
+  // If true, the algebrizer attempts to use a range join instead of a nested
+  // loop join when the join condition has no equalities usable for a hash join
+  // but restricts a column of one input to a range determined by the other,
+  // e.g., for BETWEEN or date-range joins.
+  bool allow_range_join = false;
+
   // If true, the algebrizer attempts to use a single operator for ORDER BY
   // LIMIT instead of LimitOp(SortOp), which saves memory.
   bool allow_order_by_limit_operator = false;
@@ -82,6 +88,15 @@ struct AlgebrizerOptions {
   // EvaluatorTableIterator does not have to honor the filter.
   bool push_down_filters = false;
 
+  // If true, EvaluatorTableScanOps only read the table columns that are
+  // referenced somewhere in the algebrized statement or expression, rather
+  // than every column in the ResolvedTableScan. This has the same effect as
+  // AnalyzerOptions::prune_unused_columns(), but also applies to resolved
+  // ASTs that were analyzed without it. Requires that all the tables in the
+  // catalog honor the column indexes passed to
+  // Table::CreateEvaluatorTableIterator().
+  bool prune_unused_table_columns = false;
+
   // True to inline references to WITH entries which are referenced at most
   // once. This causes rows in a WITH entry referenced only once to be evaluated
   // only when necessary to determine the primary query result, while also
@@ -91,6 +106,21 @@ struct AlgebrizerOptions {
   // evaluated up front, and the result stored in an in-memory array, which will
   // then be dereferenced when the WITH entry is referenced.
   bool inline_with_entries = false;
+
+  // If true, the algebrizer evaluates deterministic function calls and casts
+  // whose arguments are all constants, and replaces them with a ConstExpr
+  // holding the result. Calls that fail to evaluate are left in place, so
+  // that their errors are raised at runtime if and when they are evaluated.
+  bool fold_constants = false;
+
+  // If true, the algebrizer evaluates deterministic subexpressions that occur
+  // more than once in a projection, or in a set of filter conjuncts, only
+  // once per row in a ComputeOp below the operator, and references the result
+  // everywhere else. A subexpression that occurs in both a projection and the
+  // filter directly below it is computed below the filter. Only subexpressions
+  // that the operator evaluates on every row are computed early, so this
+  // cannot raise errors that would not otherwise be raised.
+  bool eliminate_common_subexpressions = false;
 };
 
 struct AnonymizationOptions {
@@ -281,6 +311,34 @@ class Algebrizer {
       std::unique_ptr<RelationalOp> haystack_rel,
       const ResolvedCollation& collation);
 
+  // A subexpression that is computed once into 'variable' and referenced
+  // wherever an equal subexpression occurs.
+  struct CommonSubexpression {
+    const ResolvedExpr* expr = nullptr;
+    VariableId variable;
+    // True once an operator that computes 'variable' has been created.
+    bool computed = false;
+  };
+
+  // Returns 'algebrized', the algebrized form of 'expr', or a ConstExpr
+  // holding its value if 'algebrizer_options_.fold_constants' is true and
+  // 'algebrized' can be evaluated ahead of time.
+  absl::StatusOr<std::unique_ptr<ValueExpr>> MaybeFoldConstant(
+      const ResolvedExpr* expr, std::unique_ptr<ValueExpr> algebrized);
+
+  // Algebrizes 'shared->expr' into an ExprArg that computes
+  // 'shared->variable', or a new variable if it is not valid, appends it to
+  // 'arguments' and makes 'shared' active. Does nothing if the expression
+  // algebrizes to a constant. Sets 'shared->computed' otherwise.
+  absl::Status ComputeCommonSubexpression(
+      CommonSubexpression* shared,
+      std::vector<std::unique_ptr<ExprArg>>* arguments);
+
+  // If 'algebrizer_options_.prune_unused_table_columns' is true, populates
+  // 'referenced_columns_' with the columns referenced in 'root', which is the
+  // statement or expression that is about to be algebrized.
+  absl::Status CollectReferencedColumns(const ResolvedNode* root);
+
   // Wrapper around AlgebrizeExpression() for use on standalone expressions.
   absl::StatusOr<std::unique_ptr<ValueExpr>> AlgebrizeStandaloneExpression(
       const ResolvedExpr* expr);
@@ -354,6 +412,12 @@ class Algebrizer {
     // algebrization of the ResolvedFilterScan corresponding to the WHERE clause
     // will just be the input scan (which is the JoinOp).
     bool redundant = false;
+
+    // If the filter is the input of a ResolvedProjectScan, the subexpressions
+    // that the projection shares with the filter, which should be computed
+    // wherever 'conjunct' is applied so that the projection can reuse them.
+    // Owned by AlgebrizeProjectScan(). NULL otherwise.
+    std::vector<CommonSubexpression>* shared_subexpressions = nullptr;
   };
 
   // Adds all the conjuncts in 'expr' to 'conjunct_infos'.
@@ -743,6 +807,20 @@ class Algebrizer {
       int num_previous_equality_exprs,
       JoinOp::HashJoinEqualityExprs* equality_exprs);
 
+  // Populates 'range_exprs' from the entries in 'conjuncts_with_push_down'
+  // (all of which must be non-redundant) that restrict a column of the right
+  // input to a range whose bounds only depend on the left input, e.g.,
+  // `left.start <= right.ts`, `right.ts < left.end` or `right.ts BETWEEN
+  // left.start AND left.end`. Only one right column is used. Unlike the hash
+  // join case, the conjuncts are left non-redundant, because the range join
+  // only uses them to narrow down the candidate right tuples. Leaves
+  // 'range_exprs' unset if there is no such conjunct.
+  absl::Status AlgebrizeJoinConditionForRangeJoin(
+      const absl::flat_hash_set<ResolvedColumn>& left_output_columns,
+      const absl::flat_hash_set<ResolvedColumn>& right_output_columns,
+      const std::vector<FilterConjunctInfo*>& conjuncts_with_push_down,
+      JoinOp::RangeJoinExprs* range_exprs);
+
   // Creates a new variable for each column and returns a vector of arguments,
   // each assigning the new variable from a DerefExpr of the old variable.
   absl::Status RemapJoinColumns(const ResolvedColumnList& columns,
@@ -756,6 +834,16 @@ class Algebrizer {
       std::unique_ptr<RelationalOp> input,
       std::vector<FilterConjunctInfo*>* active_conjuncts);
 
+  // Algebrizes 'conjuncts' and returns a RelationalOp that applies them to
+  // 'input'. If 'algebrizer_options_.eliminate_common_subexpressions' is true,
+  // subexpressions that occur more than once in 'conjuncts', or that are
+  // shared with an enclosing projection, are computed by a ComputeOp between
+  // 'input' and the filter.
+  absl::StatusOr<std::unique_ptr<RelationalOp>>
+  AlgebrizeAndApplyFilterConjuncts(
+      std::unique_ptr<RelationalOp> input,
+      const std::vector<FilterConjunctInfo*>& conjuncts);
+
   // Returns a RelationalOp corresponding to 'input' that applies
   // 'algebrized_conjuncts' as filters.
   absl::StatusOr<std::unique_ptr<RelationalOp>> ApplyAlgebrizedFilterConjuncts(
@@ -1024,6 +1112,24 @@ class Algebrizer {
 
   TypeFactory* type_factory_;  // Not owned.
 
+  // The columns that are referenced by the statement or expression being
+  // algebrized, other than by the ResolvedTableScans that produce them.
+  // Table columns that are not in this set are not read. Unset if all the
+  // columns must be read.
+  std::optional<absl::flat_hash_set<ResolvedColumn>> referenced_columns_;
+
+  // Subexpressions that AlgebrizeExpression() replaces with a DerefExpr of a
+  // variable that is already computed when the operator being algebrized
+  // evaluates its expressions. AlgebrizeScan() clears this while algebrizing
+  // nested scans.
+  std::vector<CommonSubexpression> active_common_subexpressions_;
+
+  // Set by AlgebrizeProjectScan() while it algebrizes a ResolvedFilterScan
+  // input with the filter expression 'shared_filter_expr_', to the
+  // subexpressions that the projection shares with it.
+  const ResolvedExpr* shared_filter_expr_ = nullptr;
+  std::vector<CommonSubexpression>* shared_filter_subexpressions_ = nullptr;
+
   // The top of the stack represents the variable id to use for the recursive
   // variable in the current RecursiveScan node being algebrized.
   std::stack<std::unique_ptr<ExprArg>> recursive_var_id_stack_;
@@ -2307,7 +2307,8 @@ class AnalyticTupleIterator : public TupleIterator {
 };
 }  // namespace
 
-absl::StatusOr<std::unique_ptr<TupleIterator>> AnalyticOp::CreateIterator(
+absl::StatusOr<std::unique_ptr<TupleIterator>>
+AnalyticOp::CreateIteratorInternal(
     absl::Span<const TupleData* const> params, int num_extra_slots,
     EvaluationContext* context) const {
   ZETASQL_ASSIGN_OR_RETURN(
@@ -0,0 +1,290 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/reference_impl/compact_key.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "zetasql/base/logging.h"
+#include "zetasql/public/value.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "zetasql/base/ret_check.h"
+#include "zetasql/base/status_macros.h"
+
+namespace zetasql {
+
+namespace {
+
+// Returns the marker byte that precedes the encoding of a value.
+char Marker(TypeKind kind, bool is_null) {
+  return static_cast<char>((kind << 1) | (is_null ? 0 : 1));
+}
+
+template <typename T>
+void AppendFixed(T value, std::string* out) {
+  char buf[sizeof(T)];
+  std::memcpy(buf, &value, sizeof(T));
+  out->append(buf, sizeof(T));
+}
+
+void AppendVarint(uint64_t value, std::string* out) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<char>((value & 0x7F) | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<char>(value));
+}
+
+void AppendLengthPrefixed(absl::string_view bytes, std::string* out) {
+  AppendVarint(bytes.size(), out);
+  out->append(bytes.data(), bytes.size());
+}
+
+// Reads values appended by the functions above from the front of 'input_'.
+class Reader {
+ public:
+  explicit Reader(absl::string_view input) : input_(input) {}
+
+  absl::StatusOr<char> ReadByte() {
+    ZETASQL_RET_CHECK(!input_.empty());
+    const char c = input_.front();
+    input_.remove_prefix(1);
+    return c;
+  }
+
+  template <typename T>
+  absl::StatusOr<T> ReadFixed() {
+    ZETASQL_RET_CHECK_GE(input_.size(), sizeof(T));
+    T value;
+    std::memcpy(&value, input_.data(), sizeof(T));
+    input_.remove_prefix(sizeof(T));
+    return value;
+  }
+
+  absl::StatusOr<absl::string_view> ReadLengthPrefixed() {
+    uint64_t length = 0;
+    for (int shift = 0;; shift += 7) {
+      ZETASQL_RET_CHECK_LT(shift, 64);
+      ZETASQL_ASSIGN_OR_RETURN(const char c, ReadByte());
+      length |= static_cast<uint64_t>(c & 0x7F) << shift;
+      if ((c & 0x80) == 0) break;
+    }
+    ZETASQL_RET_CHECK_GE(input_.size(), length);
+    absl::string_view bytes = input_.substr(0, length);
+    input_.remove_prefix(length);
+    return bytes;
+  }
+
+  bool empty() const { return input_.empty(); }
+
+ private:
+  absl::string_view input_;
+};
+
+}  // namespace
+
+bool CompactKeyEncoder::IsSupportedType(const Type* type) {
+  switch (type->kind()) {
+    case TYPE_BOOL:
+    case TYPE_INT32:
+    case TYPE_INT64:
+    case TYPE_UINT32:
+    case TYPE_UINT64:
+    case TYPE_DATE:
+    case TYPE_STRING:
+    case TYPE_BYTES:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool CompactKeyEncoder::AreSupportedTypes(
+    absl::Span<const Type* const> types) {
+  return std::all_of(types.begin(), types.end(), IsSupportedType);
+}
+
+absl::StatusOr<CompactKeyEncoder> CompactKeyEncoder::Create(
+    std::vector<const Type*> types) {
+  for (const Type* type : types) {
+    ZETASQL_RET_CHECK(IsSupportedType(type)) << type->DebugString();
+  }
+  return CompactKeyEncoder(std::move(types));
+}
+
+void CompactKeyEncoder::AppendValue(const Value& value, std::string* out) {
+  const TypeKind kind = value.type_kind();
+  ABSL_DCHECK(IsSupportedType(value.type())) << value.type()->DebugString();
+  out->push_back(Marker(kind, value.is_null()));
+  if (value.is_null()) return;
+  switch (kind) {
+    case TYPE_BOOL:
+      out->push_back(value.bool_value() ? 1 : 0);
+      break;
+    case TYPE_INT32:
+      AppendFixed(value.int32_value(), out);
+      break;
+    case TYPE_INT64:
+      AppendFixed(value.int64_value(), out);
+      break;
+    case TYPE_UINT32:
+      AppendFixed(value.uint32_value(), out);
+      break;
+    case TYPE_UINT64:
+      AppendFixed(value.uint64_value(), out);
+      break;
+    case TYPE_DATE:
+      AppendFixed(value.date_value(), out);
+      break;
+    case TYPE_STRING:
+      AppendLengthPrefixed(value.string_value(), out);
+      break;
+    case TYPE_BYTES:
+      AppendLengthPrefixed(value.bytes_value(), out);
+      break;
+    default:
+      ABSL_LOG(FATAL) << "Unsupported type: " << value.type()->DebugString();
+  }
+}
+
+void CompactKeyEncoder::Encode(const TupleData& key, std::string* out) const {
+  for (int i = 0; i < types_.size(); ++i) {
+    const Value& value = key.slot(i).value();
+    ABSL_DCHECK(value.type()->Equals(types_[i]));
+    AppendValue(value, out);
+  }
+}
+
+absl::Status CompactKeyEncoder::Decode(absl::string_view encoded,
+                                       TupleData* key) const {
+  ZETASQL_RET_CHECK_GE(key->num_slots(), types_.size());
+  Reader reader(encoded);
+  for (int i = 0; i < types_.size(); ++i) {
+    const Type* type = types_[i];
+    ZETASQL_ASSIGN_OR_RETURN(const char marker, reader.ReadByte());
+    if (marker == Marker(type->kind(), /*is_null=*/true)) {
+      key->mutable_slot(i)->SetValue(Value::Null(type));
+      continue;
+    }
+    ZETASQL_RET_CHECK_EQ(marker, Marker(type->kind(), /*is_null=*/false));
+    Value value;
+    switch (type->kind()) {
+      case TYPE_BOOL: {
+        ZETASQL_ASSIGN_OR_RETURN(const char c, reader.ReadByte());
+        value = Value::Bool(c != 0);
+        break;
+      }
+      case TYPE_INT32: {
+        ZETASQL_ASSIGN_OR_RETURN(const int32_t v, reader.ReadFixed<int32_t>());
+        value = Value::Int32(v);
+        break;
+      }
+      case TYPE_INT64: {
+        ZETASQL_ASSIGN_OR_RETURN(const int64_t v, reader.ReadFixed<int64_t>());
+        value = Value::Int64(v);
+        break;
+      }
+      case TYPE_UINT32: {
+        ZETASQL_ASSIGN_OR_RETURN(const uint32_t v,
+                         reader.ReadFixed<uint32_t>());
+        value = Value::Uint32(v);
+        break;
+      }
+      case TYPE_UINT64: {
+        ZETASQL_ASSIGN_OR_RETURN(const uint64_t v,
+                         reader.ReadFixed<uint64_t>());
+        value = Value::Uint64(v);
+        break;
+      }
+      case TYPE_DATE: {
+        ZETASQL_ASSIGN_OR_RETURN(const int32_t v, reader.ReadFixed<int32_t>());
+        value = Value::Date(v);
+        break;
+      }
+      case TYPE_STRING: {
+        ZETASQL_ASSIGN_OR_RETURN(const absl::string_view v,
+                         reader.ReadLengthPrefixed());
+        value = Value::String(v);
+        break;
+      }
+      case TYPE_BYTES: {
+        ZETASQL_ASSIGN_OR_RETURN(const absl::string_view v,
+                         reader.ReadLengthPrefixed());
+        value = Value::Bytes(v);
+        break;
+      }
+      default:
+        ZETASQL_RET_CHECK_FAIL() << "Unsupported type: " << type->DebugString();
+    }
+    key->mutable_slot(i)->SetValue(std::move(value));
+  }
+  ZETASQL_RET_CHECK(reader.empty());
+  return absl::OkStatus();
+}
+
+bool CompactKeyTable::Insert(absl::string_view key, int64_t* index,
+                             bool* inserted, absl::Status* status) {
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    *index = it->second;
+    *inserted = false;
+    return true;
+  }
+
+  if (!reservation_.Increase(static_cast<int64_t>(key.size()) + kBytesPerEntry,
+                            status)) {
+    return false;
+  }
+
+  const absl::string_view stored_key = CopyKey(key);
+  *index = size();
+  *inserted = true;
+  index_.emplace(stored_key, *index);
+  keys_.push_back(stored_key);
+  return true;
+}
+
+absl::string_view CompactKeyTable::CopyKey(absl::string_view key) {
+  if (key.empty()) return absl::string_view();
+  const int64_t key_size = static_cast<int64_t>(key.size());
+  char* dest;
+  if (key_size > kBlockSize / 4) {
+    // Large keys get a block of their own, so that the rest of the current
+    // block is not wasted.
+    blocks_.push_back(std::make_unique<char[]>(key_size));
+    dest = blocks_.back().get();
+  } else {
+    if (key_size > block_end_ - block_pos_) {
+      blocks_.push_back(std::make_unique<char[]>(kBlockSize));
+      block_pos_ = blocks_.back().get();
+      block_end_ = block_pos_ + kBlockSize;
+    }
+    dest = block_pos_;
+    block_pos_ += key_size;
+  }
+  std::memcpy(dest, key.data(), key_size);
+  return absl::string_view(dest, key_size);
+}
+
+}  // namespace zetasql
@@ -0,0 +1,134 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Compact binary encoding of grouping keys, and a hash table over such keys.
+// Used by operators that group or deduplicate rows to avoid materializing a
+// TupleData and hashing generic Values for every distinct key.
+
+#ifndef ZETASQL_REFERENCE_IMPL_COMPACT_KEY_H_
+#define ZETASQL_REFERENCE_IMPL_COMPACT_KEY_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "zetasql/public/type.h"
+#include "zetasql/public/value.h"
+#include "zetasql/reference_impl/tuple.h"
+#include "absl/base/attributes.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+
+namespace zetasql {
+
+// Encodes a fixed sequence of values, whose types are given up front, into a
+// byte string. Two sequences encode to the same bytes if and only if they are
+// equal according to Value::Equals(), and the encoding can be decoded back
+// into the original values.
+//
+// Each value is encoded as a marker byte holding its TypeKind and whether it
+// is NULL, followed, for non-NULL values, by a fixed-width payload for BOOL,
+// INT32, INT64, UINT32, UINT64 and DATE, or by a varint length and the raw
+// bytes for STRING and BYTES. Since the marker includes the type, values of
+// different types never encode the same. Other types are not supported (see
+// IsSupportedType()); callers fall back to generic TupleData hashing for them.
+class CompactKeyEncoder {
+ public:
+  // Returns true if values of <type> can be encoded.
+  static bool IsSupportedType(const Type* type);
+
+  // Appends the encoding of <value>, whose type must be supported, to <*out>.
+  static void AppendValue(const Value& value, std::string* out);
+
+  // Returns true if all of <types> are supported.
+  static bool AreSupportedTypes(absl::Span<const Type* const> types);
+
+  // All of <types> must be supported.
+  static absl::StatusOr<CompactKeyEncoder> Create(
+      std::vector<const Type*> types);
+
+  int num_values() const { return static_cast<int>(types_.size()); }
+
+  // Appends the encoding of the first num_values() slots of <key> to <*out>.
+  // The slot values must have the types passed to Create().
+  void Encode(const TupleData& key, std::string* out) const;
+
+  // Decodes <encoded>, which must have been produced by Encode(), into the
+  // first num_values() slots of <key>.
+  absl::Status Decode(absl::string_view encoded, TupleData* key) const;
+
+ private:
+  explicit CompactKeyEncoder(std::vector<const Type*> types)
+      : types_(std::move(types)) {}
+
+  std::vector<const Type*> types_;
+};
+
+// An append-only hash set of encoded keys that assigns each distinct key a
+// dense index in insertion order. Key bytes are copied into large, shared
+// blocks instead of being allocated one at a time.
+//
+// Memory for the keys and the hash table entries is charged to a
+// MemoryAccountant and returned when the table is destroyed.
+class CompactKeyTable {
+ public:
+  explicit CompactKeyTable(MemoryAccountant* accountant)
+      : reservation_(accountant) {}
+
+  CompactKeyTable(const CompactKeyTable&) = delete;
+  CompactKeyTable& operator=(const CompactKeyTable&) = delete;
+
+  // Looks up <key>, inserting it if it is not present. Sets <*index> to the
+  // index of the key and <*inserted> to whether it was newly inserted. Returns
+  // false and populates <*status> if the memory accountant does not have
+  // enough space for a new key.
+  ABSL_MUST_USE_RESULT bool Insert(absl::string_view key, int64_t* index,
+                                   bool* inserted, absl::Status* status);
+
+  // Returns the number of distinct keys.
+  int64_t size() const { return static_cast<int64_t>(keys_.size()); }
+
+  // Returns the key with the given <index>, which must be less than size().
+  absl::string_view key(int64_t index) const { return keys_[index]; }
+
+ private:
+  // Approximate bytes used per key by 'index_' and 'keys_'.
+  static constexpr int64_t kBytesPerEntry =
+      sizeof(std::pair<const absl::string_view, int64_t>) + 1 +
+      sizeof(absl::string_view);
+  // Size of the blocks that key bytes are copied into. Keys larger than a
+  // quarter of this get a block of their own.
+  static constexpr int64_t kBlockSize = 64 << 10;
+
+  // Copies <key> into 'blocks_' and returns the copy.
+  absl::string_view CopyKey(absl::string_view key);
+
+  absl::flat_hash_map<absl::string_view, int64_t> index_;
+  std::vector<absl::string_view> keys_;
+  std::vector<std::unique_ptr<char[]>> blocks_;
+  char* block_pos_ = nullptr;
+  char* block_end_ = nullptr;
+  MemoryReservation reservation_;
+};
+
+}  // namespace zetasql
+
+#endif  // ZETASQL_REFERENCE_IMPL_COMPACT_KEY_H_
@@ -0,0 +1,183 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/reference_impl/compact_key.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "zetasql/base/testing/status_matchers.h"
+#include "zetasql/public/types/type_factory.h"
+#include "zetasql/public/value.h"
+#include "zetasql/reference_impl/tuple.h"
+#include "zetasql/reference_impl/tuple_test_util.h"
+#include "zetasql/testing/test_value.h"
+#include "zetasql/testing/using_test_value.cc"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+
+using ::testing::HasSubstr;
+using ::zetasql_base::testing::StatusIs;
+
+namespace zetasql {
+namespace {
+
+std::vector<const Type*> TestKeyTypes() {
+  return {types::BoolType(),   types::Int32Type(),  types::Int64Type(),
+          types::Uint32Type(), types::Uint64Type(), types::DateType(),
+          types::StringType(), types::BytesType()};
+}
+
+TEST(CompactKeyEncoderTest, SupportedTypes) {
+  EXPECT_TRUE(CompactKeyEncoder::AreSupportedTypes(TestKeyTypes()));
+  EXPECT_FALSE(CompactKeyEncoder::IsSupportedType(types::DoubleType()));
+  EXPECT_FALSE(CompactKeyEncoder::IsSupportedType(types::TimestampType()));
+  EXPECT_FALSE(CompactKeyEncoder::IsSupportedType(types::Int64ArrayType()));
+  EXPECT_FALSE(CompactKeyEncoder::AreSupportedTypes(
+      {types::Int64Type(), types::NumericType()}));
+
+  EXPECT_THAT(CompactKeyEncoder::Create({types::DoubleType()}),
+              StatusIs(absl::StatusCode::kInternal));
+}
+
+TEST(CompactKeyEncoderTest, RoundTrip) {
+  ZETASQL_ASSERT_OK_AND_ASSIGN(CompactKeyEncoder encoder,
+                       CompactKeyEncoder::Create(TestKeyTypes()));
+  const std::vector<TupleData> keys = CreateTestTupleDatas({
+      {Bool(true), Int32(-1), Int64(int64_t{1} << 40), Uint32(7),
+       Uint64(uint64_t{1} << 63), Date(10), String("abc"),
+       Bytes(std::string("\x00\xff", 2))},
+      {NullBool(), NullInt32(), NullInt64(), NullUint32(), NullUint64(),
+       NullDate(), NullString(), NullBytes()},
+      {Bool(false), Int32(0), Int64(0), Uint32(0), Uint64(0), Date(0),
+       String(""), Bytes(std::string(300, 'x'))},
+  });
+  for (const TupleData& key : keys) {
+    std::string encoded;
+    encoder.Encode(key, &encoded);
+    TupleData decoded(encoder.num_values());
+    ZETASQL_ASSERT_OK(encoder.Decode(encoded, &decoded));
+    EXPECT_EQ(decoded, key) << key.DebugString();
+  }
+}
+
+TEST(CompactKeyEncoderTest, EqualKeysIffEqualEncodings) {
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      CompactKeyEncoder encoder,
+      CompactKeyEncoder::Create({types::StringType(), types::StringType()}));
+  // Length prefixes keep the split between adjacent strings unambiguous, and
+  // NULL differs from the empty string.
+  const std::vector<TupleData> keys = CreateTestTupleDatas({
+      {String("ab"), String("c")},
+      {String("a"), String("bc")},
+      {String(""), String("abc")},
+      {NullString(), String("abc")},
+      {String(""), String("")},
+      {String(""), NullString()},
+      {NullString(), NullString()},
+  });
+  std::vector<std::string> encodings;
+  for (const TupleData& key : keys) {
+    encoder.Encode(key, &encodings.emplace_back());
+  }
+  for (int i = 0; i < keys.size(); ++i) {
+    for (int j = 0; j < keys.size(); ++j) {
+      EXPECT_EQ(encodings[i] == encodings[j], keys[i] == keys[j])
+          << keys[i].DebugString() << " vs. " << keys[j].DebugString();
+    }
+  }
+}
+
+TEST(CompactKeyEncoderTest, DecodeRejectsMalformedInput) {
+  ZETASQL_ASSERT_OK_AND_ASSIGN(CompactKeyEncoder encoder,
+                       CompactKeyEncoder::Create({types::Int64Type()}));
+  TupleData decoded(1);
+  EXPECT_THAT(encoder.Decode("", &decoded),
+              StatusIs(absl::StatusCode::kInternal));
+  // Truncated INT64.
+  EXPECT_THAT(encoder.Decode("\x05\x02", &decoded),
+              StatusIs(absl::StatusCode::kInternal));
+  // Trailing bytes after a NULL INT64.
+  EXPECT_THAT(encoder.Decode(std::string("\x04\x00", 2), &decoded),
+              StatusIs(absl::StatusCode::kInternal));
+  // NULL INT32 instead of INT64.
+  EXPECT_THAT(encoder.Decode("\x02", &decoded),
+              StatusIs(absl::StatusCode::kInternal));
+}
+
+TEST(CompactKeyEncoderTest, AppendValueDistinguishesTypes) {
+  std::vector<std::string> encodings;
+  for (const Value& value :
+       {Int32(1), Int64(1), Uint32(1), Uint64(1), Date(1), NullInt32(),
+        NullInt64(), String("a"), Bytes("a"), NullString(), NullBytes()}) {
+    CompactKeyEncoder::AppendValue(value, &encodings.emplace_back());
+  }
+  for (int i = 0; i < encodings.size(); ++i) {
+    for (int j = i + 1; j < encodings.size(); ++j) {
+      EXPECT_NE(encodings[i], encodings[j]) << i << " vs. " << j;
+    }
+  }
+}
+
+TEST(CompactKeyTableTest, AssignsDenseIndexes) {
+  MemoryAccountant accountant(/*total_num_bytes=*/1 << 20, "test_limit");
+  {
+    CompactKeyTable table(&accountant);
+    absl::Status status;
+    int64_t index;
+    bool inserted;
+    const std::string long_key(100000, 'z');
+    for (const std::string& key :
+         std::vector<std::string>{"a", "b", "", "a", "", long_key}) {
+      ASSERT_TRUE(table.Insert(key, &index, &inserted, &status)) << status;
+    }
+    EXPECT_EQ(table.size(), 4);
+    EXPECT_EQ(table.key(0), "a");
+    EXPECT_EQ(table.key(1), "b");
+    EXPECT_EQ(table.key(2), "");
+    EXPECT_EQ(table.key(3), long_key);
+
+    ASSERT_TRUE(table.Insert("b", &index, &inserted, &status));
+    EXPECT_EQ(index, 1);
+    EXPECT_FALSE(inserted);
+    ASSERT_TRUE(table.Insert("c", &index, &inserted, &status));
+    EXPECT_EQ(index, 4);
+    EXPECT_TRUE(inserted);
+    EXPECT_LT(accountant.remaining_bytes(),
+              (1 << 20) - static_cast<int64_t>(long_key.size()));
+  }
+  // Everything is returned when the table is destroyed.
+  EXPECT_EQ(accountant.remaining_bytes(), 1 << 20);
+}
+
+TEST(CompactKeyTableTest, MemoryLimit) {
+  MemoryAccountant accountant(/*total_num_bytes=*/1000, "test_limit");
+  CompactKeyTable table(&accountant);
+  absl::Status status;
+  int64_t index;
+  bool inserted;
+  ASSERT_TRUE(table.Insert("abc", &index, &inserted, &status));
+  EXPECT_FALSE(table.Insert(std::string(1000, 'x'), &index, &inserted,
+                            &status));
+  EXPECT_THAT(status, StatusIs(absl::StatusCode::kResourceExhausted,
+                               HasSubstr("Out of memory")));
+  EXPECT_EQ(table.size(), 1);
+}
+
+}  // namespace
+}  // namespace zetasql
@@ -0,0 +1,502 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/reference_impl/compiled_expr.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "zetasql/public/functions/arithmetics.h"
+#include "zetasql/public/type.h"
+#include "zetasql/public/value.h"
+#include "zetasql/reference_impl/function.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "zetasql/base/ret_check.h"
+#include "zetasql/base/status_macros.h"
+
+namespace zetasql {
+
+namespace {
+
+// Sets <*result> to <fn>(<x>, <y>) and returns true, unless either value is
+// NULL or <fn> fails.
+template <typename T>
+bool TryArithmetic(bool (*fn)(T, T, T*, absl::Status*), const Value& x,
+                   const Value& y, Value* result) {
+  if (x.is_null() || y.is_null()) return false;
+  T out;
+  absl::Status error;
+  if (!fn(x.Get<T>(), y.Get<T>(), &out, &error)) return false;
+  *result = Value::Make<T>(out);
+  return true;
+}
+
+// Sets <*result> to <compare>(<x>, <y>) and returns true, unless either value
+// is NULL.
+template <typename T, typename Compare>
+bool TryComparison(Compare compare, const Value& x, const Value& y,
+                   Value* result) {
+  if (x.is_null() || y.is_null()) return false;
+  *result = Value::Bool(compare(x.Get<T>(), y.Get<T>()));
+  return true;
+}
+
+absl::string_view StringOrBytesValue(const Value& value) {
+  return value.type_kind() == TYPE_STRING ? value.string_value()
+                                          : value.bytes_value();
+}
+
+// Like TryComparison(), for STRING or BYTES values.
+template <typename Compare>
+bool TryStringComparison(Compare compare, const Value& x, const Value& y,
+                         Value* result) {
+  if (x.is_null() || y.is_null()) return false;
+  *result =
+      Value::Bool(compare(StringOrBytesValue(x), StringOrBytesValue(y)));
+  return true;
+}
+
+}  // namespace
+
+class CompiledValueExpr::Compiler {
+ public:
+  explicit Compiler(CompiledValueExpr* program) : program_(program) {}
+
+  Compiler(const Compiler&) = delete;
+  Compiler& operator=(const Compiler&) = delete;
+
+  // Returns the first of <n> new registers.
+  int NewRegisters(int n) {
+    const int first = program_->num_registers_;
+    program_->num_registers_ += n;
+    return first;
+  }
+
+  // Appends instructions that evaluate <expr> into register <dst>.
+  absl::Status Compile(const ValueExpr* expr, int dst) {
+    if (const auto* root = dynamic_cast<const RootExpr*>(expr);
+        root != nullptr) {
+      return Compile(root->value_expr(), dst);
+    }
+    if (const auto* constant = dynamic_cast<const ConstExpr*>(expr);
+        constant != nullptr) {
+      Instruction instruction{Opcode::kLoadConstant};
+      instruction.dst = dst;
+      instruction.arg = static_cast<int>(program_->constants_.size());
+      program_->constants_.push_back(constant->value());
+      Emit(instruction);
+      return absl::OkStatus();
+    }
+    if (const auto* deref = dynamic_cast<const DerefExpr*>(expr);
+        deref != nullptr) {
+      ZETASQL_RET_CHECK(deref->idx_in_params() >= 0 && deref->slot() >= 0)
+          << "SetSchemasForEvaluation() was not called on " << deref->name();
+      Instruction instruction{Opcode::kLoadParam};
+      instruction.dst = dst;
+      instruction.arg = deref->idx_in_params();
+      instruction.num_args = deref->slot();
+      Emit(instruction);
+      return absl::OkStatus();
+    }
+    if (const auto* call = dynamic_cast<const ScalarFunctionCallExpr*>(expr);
+        call != nullptr && HasOnlyValueArguments(call)) {
+      return CompileCall(call, dst);
+    }
+    if (const auto* if_expr = dynamic_cast<const IfExpr*>(expr);
+        if_expr != nullptr) {
+      return CompileIf(if_expr, dst);
+    }
+    Instruction instruction{Opcode::kEvalExpr};
+    instruction.dst = dst;
+    instruction.expr = expr;
+    Emit(instruction);
+    return absl::OkStatus();
+  }
+
+ private:
+  // Lambda arguments are evaluated by the function body itself, so calls
+  // that have them are left to the interpreter.
+  static bool HasOnlyValueArguments(const ScalarFunctionCallExpr* call) {
+    for (const AlgebraArg* arg : call->GetArgs()) {
+      if (arg->value_expr() == nullptr) return false;
+    }
+    return true;
+  }
+
+  absl::Status CompileCall(const ScalarFunctionCallExpr* call, int dst) {
+    absl::Span<const AlgebraArg* const> args = call->GetArgs();
+    const int first_arg = NewRegisters(static_cast<int>(args.size()));
+    for (int i = 0; i < args.size(); ++i) {
+      ZETASQL_RETURN_IF_ERROR(Compile(args[i]->value_expr(), first_arg + i));
+    }
+    Instruction instruction{TypedOpcode(call)};
+    instruction.dst = dst;
+    instruction.arg = first_arg;
+    instruction.num_args = static_cast<int>(args.size());
+    instruction.call = call;
+    Emit(instruction);
+    return absl::OkStatus();
+  }
+
+  // Evaluates only the branch that is taken, like IfExpr::Eval().
+  absl::Status CompileIf(const IfExpr* if_expr, int dst) {
+    const int condition = NewRegisters(1);
+    ZETASQL_RETURN_IF_ERROR(Compile(if_expr->join_expr(), condition));
+    Instruction jump_to_false{Opcode::kJumpIfNotTrue};
+    jump_to_false.arg = condition;
+    const int jump_to_false_idx = Emit(jump_to_false);
+    ZETASQL_RETURN_IF_ERROR(Compile(if_expr->true_value(), dst));
+    const int jump_to_end_idx = Emit(Instruction{Opcode::kJump});
+    program_->instructions_[jump_to_false_idx].target = NextInstruction();
+    ZETASQL_RETURN_IF_ERROR(Compile(if_expr->false_value(), dst));
+    program_->instructions_[jump_to_end_idx].target = NextInstruction();
+    return absl::OkStatus();
+  }
+
+  // Returns the typed opcode for <call>, or kCall if there is none.
+  static Opcode TypedOpcode(const ScalarFunctionCallExpr* call) {
+    const auto* function =
+        dynamic_cast<const BuiltinScalarFunction*>(call->function());
+    absl::Span<const AlgebraArg* const> args = call->GetArgs();
+    if (function == nullptr || args.size() != 2) return Opcode::kCall;
+    const Type* type = args[0]->value_expr()->output_type();
+    if (!type->Equals(args[1]->value_expr()->output_type())) {
+      return Opcode::kCall;
+    }
+    const bool same_output_type = call->output_type()->Equals(type);
+    switch (type->kind()) {
+      case TYPE_INT64:
+        switch (function->kind()) {
+          case FunctionKind::kAdd:
+            return same_output_type ? Opcode::kAddInt64 : Opcode::kCall;
+          case FunctionKind::kSubtract:
+            return same_output_type ? Opcode::kSubtractInt64 : Opcode::kCall;
+          case FunctionKind::kMultiply:
+            return same_output_type ? Opcode::kMultiplyInt64 : Opcode::kCall;
+          case FunctionKind::kEqual:
+            return Opcode::kEqualInt64;
+          case FunctionKind::kLess:
+            return Opcode::kLessInt64;
+          case FunctionKind::kLessOrEqual:
+            return Opcode::kLessOrEqualInt64;
+          default:
+            return Opcode::kCall;
+        }
+      case TYPE_DOUBLE:
+        switch (function->kind()) {
+          case FunctionKind::kAdd:
+            return same_output_type ? Opcode::kAddDouble : Opcode::kCall;
+          case FunctionKind::kSubtract:
+            return same_output_type ? Opcode::kSubtractDouble : Opcode::kCall;
+          case FunctionKind::kMultiply:
+            return same_output_type ? Opcode::kMultiplyDouble : Opcode::kCall;
+          case FunctionKind::kEqual:
+            return Opcode::kEqualDouble;
+          case FunctionKind::kLess:
+            return Opcode::kLessDouble;
+          case FunctionKind::kLessOrEqual:
+            return Opcode::kLessOrEqualDouble;
+          default:
+            return Opcode::kCall;
+        }
+      case TYPE_STRING:
+      case TYPE_BYTES:
+        // Collated comparisons have their own FunctionKinds, so these compare
+        // bytes.
+        switch (function->kind()) {
+          case FunctionKind::kEqual:
+            return Opcode::kEqualString;
+          case FunctionKind::kLess:
+            return Opcode::kLessString;
+          case FunctionKind::kLessOrEqual:
+            return Opcode::kLessOrEqualString;
+          case FunctionKind::kStartsWith:
+            return Opcode::kStartsWithString;
+          case FunctionKind::kEndsWith:
+            return Opcode::kEndsWithString;
+          default:
+            return Opcode::kCall;
+        }
+      default:
+        return Opcode::kCall;
+    }
+  }
+
+  int NextInstruction() const {
+    return static_cast<int>(program_->instructions_.size());
+  }
+
+  // Appends <instruction> and returns its index.
+  int Emit(const Instruction& instruction) {
+    program_->instructions_.push_back(instruction);
+    return NextInstruction() - 1;
+  }
+
+  CompiledValueExpr* program_;
+};
+
+absl::StatusOr<std::unique_ptr<CompiledValueExpr>> CompiledValueExpr::Create(
+    const ValueExpr* expr) {
+  ZETASQL_RET_CHECK(expr != nullptr);
+  std::unique_ptr<CompiledValueExpr> program =
+      absl::WrapUnique(new CompiledValueExpr(expr->output_type()));
+  Compiler compiler(program.get());
+  program->result_register_ = compiler.NewRegisters(1);
+  ZETASQL_RETURN_IF_ERROR(compiler.Compile(expr, program->result_register_));
+  return program;
+}
+
+bool CompiledValueExpr::Eval(absl::Span<const TupleData* const> params,
+                             EvaluationContext* context, Value* result,
+                             absl::Status* status) const {
+  std::vector<Value> registers(num_registers_);
+  const int num_instructions = static_cast<int>(instructions_.size());
+  int pc = 0;
+  while (pc < num_instructions) {
+    const Instruction& instruction = instructions_[pc++];
+    switch (instruction.opcode) {
+      case Opcode::kLoadConstant:
+        registers[instruction.dst] = constants_[instruction.arg];
+        break;
+      case Opcode::kLoadParam:
+        registers[instruction.dst] =
+            params[instruction.arg]->slot(instruction.num_args).value();
+        break;
+      case Opcode::kEvalExpr: {
+        std::shared_ptr<TupleSlot::SharedProtoState> shared_state;
+        VirtualTupleSlot slot(&registers[instruction.dst], &shared_state);
+        if (!instruction.expr->Eval(params, context, &slot, status)) {
+          return false;
+        }
+        break;
+      }
+      case Opcode::kCall:
+        if (!EvalCall(instruction, params, context, &registers, status)) {
+          return false;
+        }
+        break;
+      case Opcode::kJumpIfNotTrue: {
+        const Value& condition = registers[instruction.arg];
+        if (condition.is_null() || !condition.bool_value()) {
+          pc = instruction.target;
+        }
+        break;
+      }
+      case Opcode::kJump:
+        pc = instruction.target;
+        break;
+      default:
+        if (!EvalTyped(instruction, &registers) &&
+            !EvalCall(instruction, params, context, &registers, status)) {
+          return false;
+        }
+        break;
+    }
+  }
+  *result = std::move(registers[result_register_]);
+  return true;
+}
+
+bool CompiledValueExpr::EvalTyped(const Instruction& instruction,
+                                  std::vector<Value>* registers) {
+  const Value& x = (*registers)[instruction.arg];
+  const Value& y = (*registers)[instruction.arg + 1];
+  Value* result = &(*registers)[instruction.dst];
+  switch (instruction.opcode) {
+    case Opcode::kAddInt64:
+      return TryArithmetic(&functions::Add<int64_t>, x, y, result);
+    case Opcode::kSubtractInt64:
+      return TryArithmetic(&functions::Subtract<int64_t, int64_t>, x, y,
+                           result);
+    case Opcode::kMultiplyInt64:
+      return TryArithmetic(&functions::Multiply<int64_t>, x, y, result);
+    case Opcode::kAddDouble:
+      return TryArithmetic(&functions::Add<double>, x, y, result);
+    case Opcode::kSubtractDouble:
+      return TryArithmetic(&functions::Subtract<double, double>, x, y, result);
+    case Opcode::kMultiplyDouble:
+      return TryArithmetic(&functions::Multiply<double>, x, y, result);
+    case Opcode::kEqualInt64:
+      return TryComparison<int64_t>(std::equal_to<>(), x, y, result);
+    case Opcode::kLessInt64:
+      return TryComparison<int64_t>(std::less<>(), x, y, result);
+    case Opcode::kLessOrEqualInt64:
+      return TryComparison<int64_t>(std::less_equal<>(), x, y, result);
+    // Like Value::SqlEquals() and Value::SqlLessThan(), these are false if
+    // either value is NaN.
+    case Opcode::kEqualDouble:
+      return TryComparison<double>(std::equal_to<>(), x, y, result);
+    case Opcode::kLessDouble:
+      return TryComparison<double>(std::less<>(), x, y, result);
+    case Opcode::kLessOrEqualDouble:
+      return TryComparison<double>(std::less_equal<>(), x, y, result);
+    case Opcode::kEqualString:
+      return TryStringComparison(std::equal_to<>(), x, y, result);
+    case Opcode::kLessString:
+      return TryStringComparison(std::less<>(), x, y, result);
+    case Opcode::kLessOrEqualString:
+      return TryStringComparison(std::less_equal<>(), x, y, result);
+    case Opcode::kStartsWithString:
+      return TryStringComparison(
+          [](absl::string_view s, absl::string_view prefix) {
+            return absl::StartsWith(s, prefix);
+          },
+          x, y, result);
+    case Opcode::kEndsWithString:
+      return TryStringComparison(
+          [](absl::string_view s, absl::string_view suffix) {
+            return absl::EndsWith(s, suffix);
+          },
+          x, y, result);
+    default:
+      return false;
+  }
+}
+
+bool CompiledValueExpr::EvalCall(const Instruction& instruction,
+                                 absl::Span<const TupleData* const> params,
+                                 EvaluationContext* context,
+                                 std::vector<Value>* registers,
+                                 absl::Status* status) {
+  const ScalarFunctionCallExpr* call = instruction.call;
+  const absl::Span<const Value> args(registers->data() + instruction.arg,
+                                     instruction.num_args);
+  Value* result = &(*registers)[instruction.dst];
+  if (!call->function()->Eval(params, args, context, result, status)) {
+    if (ShouldSuppressError(*status, call->error_mode())) {
+      *status = absl::OkStatus();
+      *result = Value::Null(call->output_type());
+      return true;
+    }
+    return false;
+  }
+  return true;
+}
+
+int CompiledValueExpr::num_interpreted_exprs() const {
+  int count = 0;
+  for (const Instruction& instruction : instructions_) {
+    if (instruction.opcode == Opcode::kEvalExpr) ++count;
+  }
+  return count;
+}
+
+std::string CompiledValueExpr::OpcodeName(Opcode opcode) {
+  switch (opcode) {
+    case Opcode::kLoadConstant:
+      return "LoadConstant";
+    case Opcode::kLoadParam:
+      return "LoadParam";
+    case Opcode::kEvalExpr:
+      return "EvalExpr";
+    case Opcode::kCall:
+      return "Call";
+    case Opcode::kAddInt64:
+      return "AddInt64";
+    case Opcode::kSubtractInt64:
+      return "SubtractInt64";
+    case Opcode::kMultiplyInt64:
+      return "MultiplyInt64";
+    case Opcode::kAddDouble:
+      return "AddDouble";
+    case Opcode::kSubtractDouble:
+      return "SubtractDouble";
+    case Opcode::kMultiplyDouble:
+      return "MultiplyDouble";
+    case Opcode::kEqualInt64:
+      return "EqualInt64";
+    case Opcode::kLessInt64:
+      return "LessInt64";
+    case Opcode::kLessOrEqualInt64:
+      return "LessOrEqualInt64";
+    case Opcode::kEqualDouble:
+      return "EqualDouble";
+    case Opcode::kLessDouble:
+      return "LessDouble";
+    case Opcode::kLessOrEqualDouble:
+      return "LessOrEqualDouble";
+    case Opcode::kEqualString:
+      return "EqualString";
+    case Opcode::kLessString:
+      return "LessString";
+    case Opcode::kLessOrEqualString:
+      return "LessOrEqualString";
+    case Opcode::kStartsWithString:
+      return "StartsWithString";
+    case Opcode::kEndsWithString:
+      return "EndsWithString";
+    case Opcode::kJumpIfNotTrue:
+      return "JumpIfNotTrue";
+    case Opcode::kJump:
+      return "Jump";
+  }
+  return absl::StrCat("Opcode(", static_cast<int>(opcode), ")");
+}
+
+std::string CompiledValueExpr::DebugString() const {
+  std::string out;
+  for (int i = 0; i < instructions_.size(); ++i) {
+    const Instruction& instruction = instructions_[i];
+    absl::StrAppend(&out, i, ": ");
+    if (instruction.dst >= 0) {
+      absl::StrAppend(&out, "r", instruction.dst, " = ");
+    }
+    absl::StrAppend(&out, OpcodeName(instruction.opcode));
+    switch (instruction.opcode) {
+      case Opcode::kLoadConstant:
+        absl::StrAppend(&out, " ",
+                        constants_[instruction.arg].FullDebugString());
+        break;
+      case Opcode::kLoadParam:
+        absl::StrAppend(&out, " params[", instruction.arg, "][",
+                        instruction.num_args, "]");
+        break;
+      case Opcode::kEvalExpr:
+        absl::StrAppend(&out, " ", instruction.expr->DebugString());
+        break;
+      case Opcode::kJumpIfNotTrue:
+        absl::StrAppend(&out, " r", instruction.arg, " ", instruction.target);
+        break;
+      case Opcode::kJump:
+        absl::StrAppend(&out, " ", instruction.target);
+        break;
+      default:
+        if (instruction.opcode == Opcode::kCall) {
+          absl::StrAppend(&out, " ",
+                          instruction.call->function()->debug_name());
+        }
+        absl::StrAppend(&out, "(");
+        for (int arg = 0; arg < instruction.num_args; ++arg) {
+          absl::StrAppend(&out, arg == 0 ? "r" : ", r", instruction.arg + arg);
+        }
+        absl::StrAppend(&out, ")");
+        break;
+    }
+    absl::StrAppend(&out, "\n");
+  }
+  return out;
+}
+
+}  // namespace zetasql
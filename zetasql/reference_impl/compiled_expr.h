@@ -0,0 +1,152 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// A flattened, register based form of a scalar ValueExpr tree. Prepared
+// expressions are evaluated many times, so it pays to resolve the shape of the
+// tree once up front instead of walking the operator tree on every call.
+
+#ifndef ZETASQL_REFERENCE_IMPL_COMPILED_EXPR_H_
+#define ZETASQL_REFERENCE_IMPL_COMPILED_EXPR_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "zetasql/public/value.h"
+#include "zetasql/reference_impl/evaluation.h"
+#include "zetasql/reference_impl/operator.h"
+#include "zetasql/reference_impl/tuple.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+
+namespace zetasql {
+
+// A ValueExpr compiled into a linear program over a file of Value registers.
+//
+// Constants, parameter references, scalar function calls with value
+// arguments, and IfExpr (which is also how CASE is algebrized) are compiled
+// into instructions. Function bodies are resolved at compile time, and a few
+// common INT64, DOUBLE, STRING and BYTES functions have typed instructions
+// that skip the function body entirely. The typed instructions hand NULL
+// inputs and errors to the function body, so results and error messages are
+// the same as those of the interpreter. Any other subtree is evaluated by
+// calling its Eval() method from a single instruction.
+class CompiledValueExpr {
+ public:
+  // Compiles <expr>. SetSchemasForEvaluation() must already have been called
+  // on <expr>, which must outlive the result.
+  static absl::StatusOr<std::unique_ptr<CompiledValueExpr>> Create(
+      const ValueExpr* expr);
+
+  CompiledValueExpr(const CompiledValueExpr&) = delete;
+  CompiledValueExpr& operator=(const CompiledValueExpr&) = delete;
+
+  // Evaluates the expression. On success, populates <result> and returns
+  // true. On failure, populates <status> and returns false. Behaves like
+  // ValueExpr::EvalSimple() on the compiled expression. Thread safe.
+  bool Eval(absl::Span<const TupleData* const> params,
+            EvaluationContext* context, Value* result,
+            absl::Status* status) const;
+
+  const Type* output_type() const { return output_type_; }
+
+  int num_instructions() const {
+    return static_cast<int>(instructions_.size());
+  }
+
+  // Returns the number of subtrees that are evaluated by the interpreter.
+  int num_interpreted_exprs() const;
+
+  std::string DebugString() const;
+
+ private:
+  enum class Opcode {
+    // registers[dst] = constants[arg]
+    kLoadConstant,
+    // registers[dst] = params[arg]->slot(num_args)
+    kLoadParam,
+    // registers[dst] = expr->Eval(params)
+    kEvalExpr,
+    // registers[dst] = call->function()->Eval(registers[arg, arg + num_args))
+    kCall,
+    // Typed versions of kCall on registers[arg] and registers[arg + 1].
+    kAddInt64,
+    kSubtractInt64,
+    kMultiplyInt64,
+    kAddDouble,
+    kSubtractDouble,
+    kMultiplyDouble,
+    kEqualInt64,
+    kLessInt64,
+    kLessOrEqualInt64,
+    kEqualDouble,
+    kLessDouble,
+    kLessOrEqualDouble,
+    kEqualString,
+    kLessString,
+    kLessOrEqualString,
+    kStartsWithString,
+    kEndsWithString,
+    // Continues at instruction 'target' unless registers[arg] is TRUE.
+    kJumpIfNotTrue,
+    // Continues at instruction 'target'.
+    kJump,
+  };
+
+  struct Instruction {
+    Opcode opcode;
+    int dst = -1;
+    int arg = -1;
+    int num_args = 0;
+    int target = -1;
+    // Set for kEvalExpr.
+    const ValueExpr* expr = nullptr;
+    // Set for kCall and the typed versions of kCall, which fall back to the
+    // function body.
+    const ScalarFunctionCallExpr* call = nullptr;
+  };
+
+  class Compiler;
+
+  explicit CompiledValueExpr(const Type* output_type)
+      : output_type_(output_type) {}
+
+  static std::string OpcodeName(Opcode opcode);
+
+  // Evaluates a typed version of kCall. Returns false if the arguments are
+  // NULL or the function fails, in which case the caller must evaluate
+  // 'instruction.call' with EvalCall() instead.
+  static bool EvalTyped(const Instruction& instruction,
+                        std::vector<Value>* registers);
+
+  // Evaluates 'instruction.call' on its argument registers, as
+  // ScalarFunctionCallExpr::Eval() would.
+  static bool EvalCall(const Instruction& instruction,
+                       absl::Span<const TupleData* const> params,
+                       EvaluationContext* context,
+                       std::vector<Value>* registers, absl::Status* status);
+
+  const Type* output_type_;
+  std::vector<Value> constants_;
+  std::vector<Instruction> instructions_;
+  int num_registers_ = 0;
+  int result_register_ = -1;
+};
+
+}  // namespace zetasql
+
+#endif  // ZETASQL_REFERENCE_IMPL_COMPILED_EXPR_H_
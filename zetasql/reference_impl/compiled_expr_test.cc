@@ -0,0 +1,204 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/reference_impl/compiled_expr.h"
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "zetasql/base/testing/status_matchers.h"
+#include "zetasql/public/language_options.h"
+#include "zetasql/public/type.h"
+#include "zetasql/public/value.h"
+#include "zetasql/reference_impl/evaluation.h"
+#include "zetasql/reference_impl/function.h"
+#include "zetasql/reference_impl/operator.h"
+#include "zetasql/reference_impl/tuple.h"
+#include "zetasql/reference_impl/tuple_test_util.h"
+#include "zetasql/reference_impl/variable_id.h"
+#include "zetasql/resolved_ast/resolved_ast.h"
+#include "zetasql/testing/test_value.h"
+#include "zetasql/testing/using_test_value.cc"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+
+namespace zetasql {
+namespace {
+
+using ::testing::HasSubstr;
+using ::zetasql_base::testing::IsOkAndHolds;
+using ::zetasql_base::testing::StatusIs;
+
+class CompiledValueExprTest : public ::testing::Test {
+ protected:
+  std::unique_ptr<ValueExpr> Param(const VariableId& var, const Type* type) {
+    return DerefExpr::Create(var, type).value();
+  }
+
+  std::unique_ptr<ValueExpr> Const(const Value& value) {
+    return ConstExpr::Create(value).value();
+  }
+
+  std::unique_ptr<ValueExpr> Call(
+      FunctionKind kind, const Type* output_type,
+      std::unique_ptr<ValueExpr> x, std::unique_ptr<ValueExpr> y,
+      ResolvedFunctionCallBase::ErrorMode error_mode =
+          ResolvedFunctionCallBase::DEFAULT_ERROR_MODE) {
+    LanguageOptions language_options;
+    language_options.EnableMaximumLanguageFeaturesForDevelopment();
+    std::vector<std::unique_ptr<ValueExpr>> args;
+    args.push_back(std::move(x));
+    args.push_back(std::move(y));
+    return BuiltinScalarFunction::CreateCall(kind, language_options,
+                                             output_type, std::move(args),
+                                             error_mode)
+        .value();
+  }
+
+  std::unique_ptr<ValueExpr> If(std::unique_ptr<ValueExpr> condition,
+                                std::unique_ptr<ValueExpr> true_value,
+                                std::unique_ptr<ValueExpr> false_value) {
+    return IfExpr::Create(std::move(condition), std::move(true_value),
+                          std::move(false_value))
+        .value();
+  }
+
+  // Prepares <expr> over parameters <a> and <b>, and compiles it.
+  void Prepare(std::unique_ptr<ValueExpr> expr) {
+    expr_ = std::move(expr);
+    ZETASQL_ASSERT_OK(expr_->SetSchemasForEvaluation({&params_schema_}));
+    ZETASQL_ASSERT_OK_AND_ASSIGN(compiled_,
+                         CompiledValueExpr::Create(expr_.get()));
+  }
+
+  // Evaluates the compiled expression, and checks that the interpreter
+  // produces the same result.
+  absl::StatusOr<Value> Eval(const Value& a, const Value& b) {
+    const TupleData params_data = CreateTestTupleData({a, b});
+    EvaluationContext context((EvaluationOptions()));
+
+    TupleSlot expected;
+    absl::Status expected_status;
+    const bool expected_ok = expr_->EvalSimple(
+        {&params_data}, &context, &expected, &expected_status);
+
+    Value result;
+    absl::Status status;
+    if (!compiled_->Eval({&params_data}, &context, &result, &status)) {
+      EXPECT_FALSE(expected_ok);
+      EXPECT_EQ(status, expected_status);
+      return status;
+    }
+    EXPECT_TRUE(expected_ok) << expected_status;
+    EXPECT_TRUE(result.Equals(expected.value()))
+        << result.FullDebugString() << " vs "
+        << expected.value().FullDebugString();
+    return result;
+  }
+
+  const VariableId a_{"a"};
+  const VariableId b_{"b"};
+  const TupleSchema params_schema_{{a_, b_}};
+  std::unique_ptr<ValueExpr> expr_;
+  std::unique_ptr<CompiledValueExpr> compiled_;
+};
+
+TEST_F(CompiledValueExprTest, Int64Arithmetic) {
+  // a + b * 2
+  Prepare(Call(FunctionKind::kAdd, Int64Type(), Param(a_, Int64Type()),
+               Call(FunctionKind::kMultiply, Int64Type(),
+                    Param(b_, Int64Type()), Const(Int64(2)))));
+  EXPECT_EQ(compiled_->num_interpreted_exprs(), 0);
+  EXPECT_THAT(compiled_->DebugString(), HasSubstr("AddInt64"));
+  EXPECT_THAT(compiled_->DebugString(), HasSubstr("MultiplyInt64"));
+
+  EXPECT_THAT(Eval(Int64(1), Int64(3)), IsOkAndHolds(Int64(7)));
+  EXPECT_THAT(Eval(NullInt64(), Int64(3)), IsOkAndHolds(NullInt64()));
+  EXPECT_THAT(Eval(Int64(std::numeric_limits<int64_t>::max()), Int64(1)),
+              StatusIs(absl::StatusCode::kOutOfRange));
+}
+
+TEST_F(CompiledValueExprTest, SafeModeSuppressesErrors) {
+  Prepare(Call(FunctionKind::kSubtract, Int64Type(), Param(a_, Int64Type()),
+               Param(b_, Int64Type()),
+               ResolvedFunctionCallBase::SAFE_ERROR_MODE));
+  EXPECT_THAT(Eval(Int64(5), Int64(7)), IsOkAndHolds(Int64(-2)));
+  EXPECT_THAT(Eval(Int64(std::numeric_limits<int64_t>::min()), Int64(1)),
+              IsOkAndHolds(NullInt64()));
+}
+
+TEST_F(CompiledValueExprTest, DoubleComparisons) {
+  Prepare(Call(FunctionKind::kLessOrEqual, BoolType(), Param(a_, DoubleType()),
+               Param(b_, DoubleType())));
+  EXPECT_THAT(Eval(Double(1), Double(2)), IsOkAndHolds(Bool(true)));
+  EXPECT_THAT(Eval(Double(2), Double(2)), IsOkAndHolds(Bool(true)));
+  EXPECT_THAT(Eval(Double(NAN), Double(2)), IsOkAndHolds(Bool(false)));
+  EXPECT_THAT(Eval(Double(1), NullDouble()), IsOkAndHolds(NullBool()));
+}
+
+TEST_F(CompiledValueExprTest, StringFunctions) {
+  Prepare(Call(FunctionKind::kStartsWith, BoolType(), Param(a_, StringType()),
+               Param(b_, StringType())));
+  EXPECT_THAT(compiled_->DebugString(), HasSubstr("StartsWithString"));
+  EXPECT_THAT(Eval(String("abc"), String("ab")), IsOkAndHolds(Bool(true)));
+  EXPECT_THAT(Eval(String("abc"), String("bc")), IsOkAndHolds(Bool(false)));
+  EXPECT_THAT(Eval(NullString(), String("")), IsOkAndHolds(NullBool()));
+
+  Prepare(Call(FunctionKind::kLess, BoolType(), Param(a_, BytesType()),
+               Param(b_, BytesType())));
+  EXPECT_THAT(Eval(Bytes("a"), Bytes("b")), IsOkAndHolds(Bool(true)));
+  EXPECT_THAT(Eval(Bytes("b"), Bytes("a")), IsOkAndHolds(Bool(false)));
+}
+
+TEST_F(CompiledValueExprTest, IfEvaluatesOneBranch) {
+  // IF(a < b, a, a DIV (b - b)). The false branch fails if it is evaluated.
+  Prepare(If(Call(FunctionKind::kLess, BoolType(), Param(a_, Int64Type()),
+                  Param(b_, Int64Type())),
+             Param(a_, Int64Type()),
+             Call(FunctionKind::kDiv, Int64Type(), Param(a_, Int64Type()),
+                  Call(FunctionKind::kSubtract, Int64Type(),
+                       Param(b_, Int64Type()), Param(b_, Int64Type())))));
+  EXPECT_EQ(compiled_->num_interpreted_exprs(), 0);
+  EXPECT_THAT(Eval(Int64(1), Int64(2)), IsOkAndHolds(Int64(1)));
+  EXPECT_THAT(Eval(Int64(2), Int64(1)),
+              StatusIs(absl::StatusCode::kOutOfRange));
+  // A NULL condition takes the false branch.
+  EXPECT_THAT(Eval(NullInt64(), Int64(1)), IsOkAndHolds(NullInt64()));
+}
+
+TEST_F(CompiledValueExprTest, InterpretsOtherExprs) {
+  std::vector<std::unique_ptr<ValueExpr>> elements;
+  elements.push_back(Param(a_, Int64Type()));
+  elements.push_back(Param(b_, Int64Type()));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<ValueExpr> array,
+      NewArrayExpr::Create(Int64ArrayType(), std::move(elements)));
+  Prepare(If(Call(FunctionKind::kEqual, BoolType(), Param(a_, Int64Type()),
+                  Param(b_, Int64Type())),
+             Const(Int64Array({})), std::move(array)));
+  EXPECT_EQ(compiled_->num_interpreted_exprs(), 1);
+  EXPECT_THAT(Eval(Int64(1), Int64(1)), IsOkAndHolds(Int64Array({})));
+  EXPECT_THAT(Eval(Int64(1), Int64(2)), IsOkAndHolds(Int64Array({1, 2})));
+}
+
+}  // namespace
+}  // namespace zetasql
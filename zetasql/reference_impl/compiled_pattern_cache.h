@@ -0,0 +1,140 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef ZETASQL_REFERENCE_IMPL_COMPILED_PATTERN_CACHE_H_
+#define ZETASQL_REFERENCE_IMPL_COMPILED_PATTERN_CACHE_H_
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "zetasql/public/type.pb.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/functional/function_ref.h"
+#include "absl/hash/hash.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "zetasql/base/status_macros.h"
+
+namespace zetasql {
+
+// A bounded, least-recently-used cache of compiled patterns (e.g., LIKE or
+// REGEXP_* regular expressions), keyed by the pattern text and the TypeKind of
+// the input (STRING vs. BYTES select different regexp encodings).
+//
+// Functions whose pattern argument is a constant compile it once at prepare
+// time. When the pattern comes from a column or parameter instead, the pattern
+// would otherwise be recompiled for every row; this cache lets such functions
+// reuse compiled patterns across rows of a single evaluation.
+//
+// Pointers returned by GetOrCompile() are owned by the cache and remain valid
+// only until the next call to GetOrCompile() or Clear(), since that call may
+// evict the entry.
+//
+// This class is thread-compatible, like the EvaluationContext that owns it.
+template <typename CompiledPattern>
+class CompiledPatternCache {
+ public:
+  using CompileFn = absl::FunctionRef<
+      absl::StatusOr<std::unique_ptr<const CompiledPattern>>(
+          absl::string_view pattern)>;
+
+  // 'max_entries' <= 0 disables caching; every lookup compiles a new pattern
+  // which is kept alive only until the next lookup.
+  explicit CompiledPatternCache(int64_t max_entries)
+      : max_entries_(max_entries) {}
+  CompiledPatternCache(const CompiledPatternCache&) = delete;
+  CompiledPatternCache& operator=(const CompiledPatternCache&) = delete;
+
+  // Returns the compiled form of <pattern> for input type <type>, invoking
+  // <compile> on a cache miss. Compilation errors are returned but not cached.
+  absl::StatusOr<const CompiledPattern*> GetOrCompile(absl::string_view pattern,
+                                                      TypeKind type,
+                                                      CompileFn compile) {
+    auto it = index_.find(KeyView{type, pattern});
+    if (it != index_.end()) {
+      ++num_hits_;
+      // Move the entry to the front of the recency list.
+      entries_.splice(entries_.begin(), entries_, it->second);
+      return it->second->compiled.get();
+    }
+
+    ++num_misses_;
+    ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<const CompiledPattern> compiled,
+                     compile(pattern));
+    if (max_entries_ <= 0) {
+      uncached_ = std::move(compiled);
+      return uncached_.get();
+    }
+    if (static_cast<int64_t>(entries_.size()) >= max_entries_) {
+      const Entry& lru = entries_.back();
+      index_.erase(KeyView{lru.type, lru.pattern});
+      entries_.pop_back();
+    }
+    entries_.push_front(Entry{type, std::string(pattern), std::move(compiled)});
+    const Entry& entry = entries_.front();
+    index_.emplace(KeyView{entry.type, entry.pattern}, entries_.begin());
+    return entry.compiled.get();
+  }
+
+  void Clear() {
+    index_.clear();
+    entries_.clear();
+    uncached_.reset();
+  }
+
+  int64_t size() const { return entries_.size(); }
+  int64_t num_hits() const { return num_hits_; }
+  int64_t num_misses() const { return num_misses_; }
+
+ private:
+  struct Entry {
+    TypeKind type;
+    std::string pattern;
+    std::unique_ptr<const CompiledPattern> compiled;
+  };
+
+  // Index keys point into the std::string owned by the corresponding Entry,
+  // which is stable because std::list never relocates its elements.
+  struct KeyView {
+    TypeKind type;
+    absl::string_view pattern;
+
+    bool operator==(const KeyView& other) const {
+      return type == other.type && pattern == other.pattern;
+    }
+    template <typename H>
+    friend H AbslHashValue(H h, const KeyView& key) {
+      return H::combine(std::move(h), key.type, key.pattern);
+    }
+  };
+
+  const int64_t max_entries_;
+  // Most recently used entries first.
+  std::list<Entry> entries_;
+  absl::flat_hash_map<KeyView, typename std::list<Entry>::iterator> index_;
+  // Holds the most recent compilation when caching is disabled.
+  std::unique_ptr<const CompiledPattern> uncached_;
+
+  int64_t num_hits_ = 0;
+  int64_t num_misses_ = 0;
+};
+
+}  // namespace zetasql
+
+#endif  // ZETASQL_REFERENCE_IMPL_COMPILED_PATTERN_CACHE_H_
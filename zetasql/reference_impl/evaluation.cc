@@ -89,7 +89,13 @@ EvaluationContext::EvaluationContext(const EvaluationOptions& options)
     : options_(options),
       memory_accountant_(options.max_intermediate_byte_size,
                          "max_intermediate_byte_size"),
-      deterministic_output_(true) {}
+      deterministic_output_(true),
+      like_matcher_cache_(options.max_cached_compiled_patterns),
+      regexp_cache_(options.max_cached_compiled_patterns) {
+  if (options.collect_operator_profile) {
+    operator_profile_ = std::make_unique<OperatorProfile>();
+  }
+}
 
 absl::Status EvaluationContext::AddTableAsArray(
     absl::string_view table_name, bool is_value_table, Value array,
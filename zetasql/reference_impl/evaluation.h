@@ -17,6 +17,7 @@
 #ifndef ZETASQL_REFERENCE_IMPL_EVALUATION_H_
 #define ZETASQL_REFERENCE_IMPL_EVALUATION_H_
 
+#include <algorithm>
 #include <cstdint>
 #include <functional>
 #include <map>
@@ -28,16 +29,21 @@
 
 #include "zetasql/public/civil_time.h"
 #include "zetasql/public/language_options.h"
+#include "zetasql/public/functions/like.h"
+#include "zetasql/public/functions/regexp.h"
 #include "zetasql/public/value.h"
+#include "zetasql/reference_impl/compiled_pattern_cache.h"
 #include "zetasql/reference_impl/tuple.h"
 #include "zetasql/resolved_ast/resolved_ast.h"
 #include <cstdint>
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/node_hash_map.h"
 #include "absl/flags/declare.h"
 #include "absl/random/random.h"
 #include "absl/strings/string_view.h"
 #include "absl/time/time.h"
 #include "absl/types/optional.h"
+#include "absl/types/span.h"
 #include "zetasql/base/map_util.h"
 #include "zetasql/base/status.h"
 #include "zetasql/base/clock.h"
@@ -98,6 +104,12 @@ struct EvaluationOptions {
   // limit results in an error.
   int64_t max_intermediate_byte_size = 128 * 1024 * 1024;
 
+  // The maximum number of compiled LIKE and REGEXP_* patterns retained per
+  // EvaluationContext for patterns that are not constant (e.g., read from a
+  // column). Constant patterns are compiled once at prepare time and are not
+  // affected. A value <= 0 disables caching.
+  int64_t max_cached_compiled_patterns = 64;
+
   // If true, the results of DML statements will include all rows in the
   // modified table; otherwise, only modified rows (i.e. those matching the
   // WHERE clause) are included. For DELETE, 'modified rows' means the rows to
@@ -106,9 +118,64 @@ struct EvaluationOptions {
   // Note that rows are considered modified even if the new row happens to be
   // the same as the old as long as they match the WHERE clause.
   bool return_all_rows_for_dml = true;
+
+  // If true, the EvaluationContext has an OperatorProfile, in which relational
+  // operators record runtime statistics. This slows down evaluation.
+  bool collect_operator_profile = false;
 };
 
 class ProtoFieldReader;
+class RelationalOp;
+
+// Runtime statistics of the relational operators evaluated with an
+// EvaluationContext. Times and memory usage are inclusive: they include the
+// work done by the inputs of an operator while it produces its rows.
+class OperatorProfile {
+ public:
+  struct Stats {
+    // The number of iterators created for the operator. This is more than one
+    // if the operator is evaluated once per row of an outer relation, e.g.,
+    // for correlated subqueries.
+    int64_t num_iterators = 0;
+    // The number of rows produced by all the iterators.
+    int64_t num_rows = 0;
+    // The time spent creating the iterators and producing rows. CPU time is
+    // that of the whole process.
+    absl::Duration wall_time;
+    absl::Duration cpu_time;
+    // The largest number of bytes charged to the MemoryAccountant at any point
+    // while an iterator was being created or producing a row, relative to when
+    // the iterator was created.
+    int64_t peak_memory_bytes = 0;
+    // The largest number of entries in a hash table built by the operator
+    // (distinct rows, groups, or the right input of a hash join). Zero for
+    // operators that do not build hash tables.
+    int64_t max_hash_table_size = 0;
+  };
+
+  OperatorProfile() = default;
+  OperatorProfile(const OperatorProfile&) = delete;
+  OperatorProfile& operator=(const OperatorProfile&) = delete;
+
+  // Returns the statistics of <op>, or NULL if it has not been evaluated.
+  const Stats* GetStats(const RelationalOp* op) const {
+    auto it = stats_.find(op);
+    return it == stats_.end() ? nullptr : &it->second;
+  }
+
+  // Returns the statistics of <op>, adding them if necessary. The result is
+  // valid for the lifetime of this object.
+  Stats* GetMutableStats(const RelationalOp* op) { return &stats_[op]; }
+
+  void RecordHashTableSize(const RelationalOp* op, int64_t size) {
+    Stats* stats = GetMutableStats(op);
+    stats->max_hash_table_size = std::max(stats->max_hash_table_size, size);
+  }
+
+ private:
+  // A node_hash_map, so that pointers to the Stats are stable.
+  absl::node_hash_map<const RelationalOp*, Stats> stats_;
+};
 
 // Base class for C++ values which can be associated with a variable.
 class CppValueBase {
@@ -151,6 +218,14 @@ class EvaluationContext {
 
   bool IsDeterministicOutput() const { return deterministic_output_; }
 
+  // Returns true if evaluation has used the default time zone, the current
+  // timestamp or the random number generator. Results that did not use them
+  // only depend on the evaluated expressions and their inputs.
+  bool UsedExecutionEnvironment() const {
+    return default_timezone_.has_value() || current_timestamp_.has_value() ||
+           rand_.has_value();
+  }
+
   void SetLanguageOptions(LanguageOptions options) {
     language_options_ = std::move(options);
   }
@@ -300,6 +375,24 @@ class EvaluationContext {
     num_proto_deserializations_ = n;
   }
 
+  // Returns the number of rows produced by each iteration of the recursive
+  // queries evaluated so far, in evaluation order. The size of the result is
+  // the total number of iterations. The first iteration of a recursive query
+  // evaluates its non-recursive term, and the last one produces no rows.
+  absl::Span<const int64_t> recursive_iteration_row_counts() const {
+    return recursive_iteration_row_counts_;
+  }
+
+  void AddRecursiveIteration(int64_t num_rows) {
+    recursive_iteration_row_counts_.push_back(num_rows);
+  }
+
+  // Returns NULL unless EvaluationOptions::collect_operator_profile is true.
+  OperatorProfile* operator_profile() { return operator_profile_.get(); }
+  const OperatorProfile* operator_profile() const {
+    return operator_profile_.get();
+  }
+
   bool used_top_n_accumulator() const { return used_top_n_accumulator_; }
 
   void set_used_top_n_accumulator(bool value) {
@@ -354,6 +447,15 @@ class EvaluationContext {
   // Deletes the C++ value associated with the given variable Id.
   void ClearCppValue(VariableId variable) { cpp_values_.erase(variable); }
 
+  // Caches of compiled patterns for LIKE and REGEXP_* functions whose pattern
+  // is not a constant. See CompiledPatternCache.
+  CompiledPatternCache<functions::LikeMatcher>* like_matcher_cache() {
+    return &like_matcher_cache_;
+  }
+  CompiledPatternCache<functions::RegExp>* regexp_cache() {
+    return &regexp_cache_;
+  }
+
   const TupleDataDeque* active_group_rows() const { return active_group_rows_; }
   void set_active_group_rows(const TupleDataDeque* group_rows) {
     active_group_rows_ = group_rows;
@@ -419,9 +521,18 @@ class EvaluationContext {
   // Records whether a TopNAccumulator was used. Only for unit tests.
   bool used_top_n_accumulator_ = false;
 
+  // See recursive_iteration_row_counts().
+  std::vector<int64_t> recursive_iteration_row_counts_;
+
+  // Set if 'options_.collect_operator_profile' is true.
+  std::unique_ptr<OperatorProfile> operator_profile_;
+
   // Current C++ values associated with variables.
   absl::flat_hash_map<VariableId, std::unique_ptr<CppValueBase>> cpp_values_;
 
+  CompiledPatternCache<functions::LikeMatcher> like_matcher_cache_;
+  CompiledPatternCache<functions::RegExp> regexp_cache_;
+
   // The current user, specified by the engine. Used to evaluate the
   // SESSION_USER function. Defaults to an empty string if not set.
   std::string session_user_ = "";
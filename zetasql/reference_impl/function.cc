@@ -44,6 +44,7 @@
 #include "zetasql/common/internal_value.h"
 #include "zetasql/proto/anon_output_with_report.pb.h"
 #include "zetasql/public/anonymization_utils.h"
+#include "zetasql/public/builtin_function.pb.h"
 #include "zetasql/public/cast.h"
 #include "zetasql/public/catalog_helper.h"
 #include "zetasql/public/civil_time.h"
@@ -52,6 +53,7 @@
 #include "zetasql/public/functions/arithmetics.h"
 #include "zetasql/public/functions/bitcast.h"
 #include "zetasql/public/functions/bitwise.h"
+#include "zetasql/public/functions/cast_date_time.h"
 #include "zetasql/public/functions/common_proto.h"
 #include "zetasql/public/functions/comparison.h"
 #include "zetasql/public/functions/date_time_util.h"
@@ -115,7 +117,6 @@
 #include "zetasql/base/map_util.h"
 #include "zetasql/base/source_location.h"
 #include "zetasql/base/exactfloat.h"
-#include "re2/re2.h"
 #include "zetasql/base/ret_check.h"
 #include "zetasql/base/status.h"
 #include "zetasql/base/status_builder.h"
@@ -456,6 +457,11 @@ class FunctionMap {
     return function_kind_by_name_;
   }
 
+  const absl::flat_hash_map<int64_t, FunctionKind>&
+  function_kind_by_signature_id() const {
+    return function_kind_by_signature_id_;
+  }
+
  private:
   // We use string_view here to reduce stack frame usage in debug mode for
   // FunctionMap::FunctionMap.  We are not concerned about the performance
@@ -470,8 +476,18 @@ class FunctionMap {
     }
   }
 
+  // Maps signatures to functions that are looked up by signature id instead
+  // of by name. <kind> must be registered with RegisterFunction() as well.
+  void RegisterSignature(FunctionSignatureId signature_id, FunctionKind kind) {
+    ABSL_CHECK(function_kind_by_signature_id_.try_emplace(signature_id, kind)
+                   .second)
+        << "Duplicate function signature: "
+        << FunctionSignatureId_Name(signature_id);
+  }
+
   absl::flat_hash_map<FunctionKind, std::string> function_debug_name_by_kind_;
   absl::flat_hash_map<std::string, FunctionKind> function_kind_by_name_;
+  absl::flat_hash_map<int64_t, FunctionKind> function_kind_by_signature_id_;
 };
 
 FunctionMap::FunctionMap() {
@@ -983,6 +999,112 @@ FunctionMap::FunctionMap() {
     RegisterFunction(FunctionKind::kArrayFindAll, "array_find_all",
                      "ArrayFindAll");
   }();
+  [this]() {
+    RegisterFunction(FunctionKind::kVariantParseJson, kPrivate,
+                     "VariantParseJson");
+    RegisterFunction(FunctionKind::kVariantTryParseJson, kPrivate,
+                     "VariantTryParseJson");
+    RegisterFunction(FunctionKind::kVariantCheckJson, kPrivate,
+                     "VariantCheckJson");
+    RegisterFunction(FunctionKind::kVariantToJson, kPrivate, "VariantToJson");
+    RegisterFunction(FunctionKind::kToVariant, kPrivate, "ToVariant");
+    RegisterFunction(FunctionKind::kToObject, kPrivate, "ToObject");
+    RegisterFunction(FunctionKind::kObjectConstruct, kPrivate,
+                     "ObjectConstruct");
+    RegisterFunction(FunctionKind::kObjectInsert, kPrivate, "ObjectInsert");
+    RegisterFunction(FunctionKind::kObjectDelete, kPrivate, "ObjectDelete");
+    RegisterFunction(FunctionKind::kVariantArrayConstruct, kPrivate,
+                     "VariantArrayConstruct");
+    RegisterFunction(FunctionKind::kVariantArrayConstructCompact, kPrivate,
+                     "VariantArrayConstructCompact");
+    RegisterFunction(FunctionKind::kVariantArraySize, kPrivate,
+                     "VariantArraySize");
+    RegisterFunction(FunctionKind::kVariantGet, kPrivate, "VariantGet");
+    RegisterFunction(FunctionKind::kVariantGetIgnoreCase, kPrivate,
+                     "VariantGetIgnoreCase");
+    RegisterFunction(FunctionKind::kVariantGetPath, kPrivate,
+                     "VariantGetPath");
+    RegisterFunction(FunctionKind::kStripNullValue, kPrivate,
+                     "StripNullValue");
+    RegisterFunction(FunctionKind::kIsNullValue, kPrivate, "IsNullValue");
+    RegisterFunction(FunctionKind::kIsBoolean, kPrivate, "IsBoolean");
+    RegisterFunction(FunctionKind::kIsInteger, kPrivate, "IsInteger");
+    RegisterFunction(FunctionKind::kIsDecimal, kPrivate, "IsDecimal");
+    RegisterFunction(FunctionKind::kIsDouble, kPrivate, "IsDouble");
+    RegisterFunction(FunctionKind::kIsChar, kPrivate, "IsChar");
+    RegisterFunction(FunctionKind::kIsBinary, kPrivate, "IsBinary");
+    RegisterFunction(FunctionKind::kIsDate, kPrivate, "IsDate");
+    RegisterFunction(FunctionKind::kIsTime, kPrivate, "IsTime");
+    RegisterFunction(FunctionKind::kIsTimestamp, kPrivate, "IsTimestamp");
+    RegisterFunction(FunctionKind::kIsArray, kPrivate, "IsArray");
+    RegisterFunction(FunctionKind::kIsObject, kPrivate, "IsObject");
+    RegisterFunction(FunctionKind::kAsBoolean, kPrivate, "AsBoolean");
+    RegisterFunction(FunctionKind::kAsInteger, kPrivate, "AsInteger");
+    RegisterFunction(FunctionKind::kAsDecimal, kPrivate, "AsDecimal");
+    RegisterFunction(FunctionKind::kAsDouble, kPrivate, "AsDouble");
+    RegisterFunction(FunctionKind::kAsChar, kPrivate, "AsChar");
+    RegisterFunction(FunctionKind::kAsDate, kPrivate, "AsDate");
+    RegisterFunction(FunctionKind::kAsTime, kPrivate, "AsTime");
+    RegisterFunction(FunctionKind::kAsTimestamp, kPrivate, "AsTimestamp");
+    RegisterFunction(FunctionKind::kAsArray, kPrivate, "AsArray");
+    RegisterFunction(FunctionKind::kAsObject, kPrivate, "AsObject");
+  }();
+  [this]() {
+    RegisterSignature(FN_PARSE_JSON_SNOWFLAKE, FunctionKind::kVariantParseJson);
+    RegisterSignature(FN_TRY_PARSE_JSON_STRING,
+                      FunctionKind::kVariantTryParseJson);
+    RegisterSignature(FN_TRY_PARSE_JSON_VARIANT,
+                      FunctionKind::kVariantTryParseJson);
+    RegisterSignature(FN_CHECK_JSON_STRING, FunctionKind::kVariantCheckJson);
+    RegisterSignature(FN_CHECK_JSON_VARIANT, FunctionKind::kVariantCheckJson);
+    RegisterSignature(FN_TO_JSON_SNOWFLAKE, FunctionKind::kVariantToJson);
+    for (FunctionSignatureId signature_id :
+         {FN_TO_VARIANT_INT64, FN_TO_VARIANT_UINT64, FN_TO_VARIANT_DOUBLE,
+          FN_TO_VARIANT_FLOAT, FN_TO_VARIANT_NUMERIC, FN_TO_VARIANT_BIGNUMERIC,
+          FN_TO_VARIANT_STRING, FN_TO_VARIANT_BOOL, FN_TO_VARIANT_DATE,
+          FN_TO_VARIANT_DATETIME, FN_TO_VARIANT_TIMESTAMP, FN_TO_VARIANT_BYTES,
+          FN_TO_VARIANT_ARRAY, FN_TO_VARIANT_TIME}) {
+      RegisterSignature(signature_id, FunctionKind::kToVariant);
+    }
+    RegisterSignature(FN_TO_OBJECT_VARIANT, FunctionKind::kToObject);
+    RegisterSignature(FN_TO_OBJECT_OBJECT, FunctionKind::kToObject);
+    RegisterSignature(FN_OBJECT_CONSTRUCT, FunctionKind::kObjectConstruct);
+    RegisterSignature(FN_OBJECT_INSERT, FunctionKind::kObjectInsert);
+    RegisterSignature(FN_OBJECT_DELETE, FunctionKind::kObjectDelete);
+    RegisterSignature(FN_ARRAY_CONSTRUCT, FunctionKind::kVariantArrayConstruct);
+    RegisterSignature(FN_ARRAY_CONSTRUCT_COMPACT,
+                      FunctionKind::kVariantArrayConstructCompact);
+    RegisterSignature(FN_ARRAY_SIZE_ARRAY, FunctionKind::kVariantArraySize);
+    RegisterSignature(FN_ARRAY_SIZE_VARIANT, FunctionKind::kVariantArraySize);
+    RegisterSignature(FN_GET_ARRAY, FunctionKind::kVariantGet);
+    RegisterSignature(FN_GET_OBJECT, FunctionKind::kVariantGet);
+    RegisterSignature(FN_GET_VARIANT_INT64, FunctionKind::kVariantGet);
+    RegisterSignature(FN_GET_OBJECT_STRING, FunctionKind::kVariantGet);
+    RegisterSignature(FN_GET_PATH, FunctionKind::kVariantGetPath);
+    RegisterSignature(FN_STRIP_NULL_VALUE, FunctionKind::kStripNullValue);
+    RegisterSignature(FN_IS_NULL_VALUE, FunctionKind::kIsNullValue);
+    RegisterSignature(FN_IS_BOOLEAN, FunctionKind::kIsBoolean);
+    RegisterSignature(FN_IS_INTEGER, FunctionKind::kIsInteger);
+    RegisterSignature(FN_IS_DECIMAL, FunctionKind::kIsDecimal);
+    RegisterSignature(FN_IS_DOUBLE, FunctionKind::kIsDouble);
+    RegisterSignature(FN_IS_CHAR, FunctionKind::kIsChar);
+    RegisterSignature(FN_IS_BINARY, FunctionKind::kIsBinary);
+    RegisterSignature(FN_IS_DATE, FunctionKind::kIsDate);
+    RegisterSignature(FN_IS_TIME, FunctionKind::kIsTime);
+    RegisterSignature(FN_IS_TIMESTAMP, FunctionKind::kIsTimestamp);
+    RegisterSignature(FN_IS_ARRAY, FunctionKind::kIsArray);
+    RegisterSignature(FN_IS_OBJECT, FunctionKind::kIsObject);
+    RegisterSignature(FN_AS_BOOLEAN, FunctionKind::kAsBoolean);
+    RegisterSignature(FN_AS_INTEGER, FunctionKind::kAsInteger);
+    RegisterSignature(FN_AS_DECIMAL, FunctionKind::kAsDecimal);
+    RegisterSignature(FN_AS_DOUBLE, FunctionKind::kAsDouble);
+    RegisterSignature(FN_AS_CHAR, FunctionKind::kAsChar);
+    RegisterSignature(FN_AS_DATE, FunctionKind::kAsDate);
+    RegisterSignature(FN_AS_TIME, FunctionKind::kAsTime);
+    RegisterSignature(FN_AS_TIMESTAMP, FunctionKind::kAsTimestamp);
+    RegisterSignature(FN_AS_ARRAY, FunctionKind::kAsArray);
+    RegisterSignature(FN_AS_OBJECT, FunctionKind::kAsObject);
+  }();
 }  // NOLINT(readability/fn_size)
 
 const FunctionMap& GetFunctionMap() {
@@ -1519,15 +1641,17 @@ absl::Status ConcatError(int64_t max_output_size, zetasql_base::SourceLocation s
                          max_output_size, " bytes");
 }
 
+// Unparsed JSON is parsed into the compact representation, which is cheaper
+// to build than a document tree and enough for read-only access.
 absl::StatusOr<JSONValueConstRef> GetJSONValueConstRef(
     const Value& json, const JSONParsingOptions& json_parsing_options,
-    JSONValue& json_storage) {
+    CompactJSONValue& json_storage) {
   if (json.is_validated_json()) {
     return json.json_value();
   }
   ZETASQL_ASSIGN_OR_RETURN(json_storage,
-                   JSONValue::ParseJSONString(json.json_value_unparsed(),
-                                              json_parsing_options));
+                   CompactJSONValue::ParseJSONString(
+                       json.json_value_unparsed(), json_parsing_options));
   return json_storage.GetConstRef();
 }
 
@@ -1640,6 +1764,16 @@ absl::StatusOr<FunctionKind> BuiltinFunctionCatalog::GetKindByName(
   return *kind;
 }
 
+std::optional<FunctionKind> BuiltinFunctionCatalog::GetKindBySignatureId(
+    int64_t signature_id) {
+  const FunctionKind* kind = zetasql_base::FindOrNull(
+      GetFunctionMap().function_kind_by_signature_id(), signature_id);
+  if (kind == nullptr) {
+    return std::nullopt;
+  }
+  return *kind;
+}
+
 std::string BuiltinFunctionCatalog::GetDebugNameByKind(FunctionKind kind) {
   return zetasql_base::FindWithDefault(GetFunctionMap().function_debug_name_by_kind(),
                               kind);
@@ -1686,6 +1820,61 @@ static absl::Status ValidateSupportedTypes(
   return absl::OkStatus();
 }
 
+// Compiles the constant <format> of a cast from <from_type> to <to_type>.
+// Returns std::monostate if the cast is not between STRING and a date/time
+// type, or if the format is NULL or invalid.
+static CastFunction::FormatCaster CreateConstFormatCaster(
+    const Type* from_type, const Type* to_type, const Value& format) {
+  if (format.is_null() || !format.type()->IsString()) {
+    return std::monostate();
+  }
+  // We ignore errors here, falling back to runtime error handling to ensure
+  // SAFE_CAST works correctly.
+  auto to_format_caster = [](auto caster) -> CastFunction::FormatCaster {
+    if (!caster.ok()) {
+      return std::monostate();
+    }
+    return *std::move(caster);
+  };
+  const absl::string_view format_string = format.string_value();
+  if (from_type->IsString()) {
+    switch (to_type->kind()) {
+      case TYPE_DATE:
+        return to_format_caster(
+            functions::StringToDateCaster::Create(format_string));
+      case TYPE_DATETIME:
+        return to_format_caster(
+            functions::StringToDatetimeCaster::Create(format_string));
+      case TYPE_TIME:
+        return to_format_caster(
+            functions::StringToTimeCaster::Create(format_string));
+      case TYPE_TIMESTAMP:
+        return to_format_caster(
+            functions::StringToTimestampCaster::Create(format_string));
+      default:
+        break;
+    }
+  } else if (to_type->IsString()) {
+    switch (from_type->kind()) {
+      case TYPE_DATE:
+        return to_format_caster(
+            functions::DateToStringCaster::Create(format_string));
+      case TYPE_DATETIME:
+        return to_format_caster(
+            functions::DatetimeToStringCaster::Create(format_string));
+      case TYPE_TIME:
+        return to_format_caster(
+            functions::TimeToStringCaster::Create(format_string));
+      case TYPE_TIMESTAMP:
+        return to_format_caster(
+            functions::TimestampToStringCaster::Create(format_string));
+      default:
+        break;
+    }
+  }
+  return std::monostate();
+}
+
 absl::StatusOr<std::unique_ptr<ScalarFunctionCallExpr>>
 BuiltinScalarFunction::CreateCast(
     const LanguageOptions& language_options, const Type* output_type,
@@ -1699,6 +1888,15 @@ BuiltinScalarFunction::CreateCast(
   ZETASQL_RETURN_IF_ERROR(ValidateSupportedTypes(
       language_options, {output_type, argument->output_type()}));
 
+  // The format is only precompiled when the cast does not take a time zone,
+  // which would otherwise replace the default time zone on every row.
+  CastFunction::FormatCaster const_format_caster;
+  if (format != nullptr && format->IsConstant() && time_zone == nullptr) {
+    const_format_caster = CreateConstFormatCaster(
+        argument->output_type(), output_type,
+        static_cast<const ConstExpr*>(format.get())->value());
+  }
+
   std::vector<std::unique_ptr<ValueExpr>> args;
   args.push_back(std::move(argument));
   args.push_back(std::move(null_on_error_exp));
@@ -1712,7 +1910,8 @@ BuiltinScalarFunction::CreateCast(
   return ScalarFunctionCallExpr::Create(
       std::make_unique<CastFunction>(
           output_type, std::move(extended_cast_evaluator),
-          std::move(type_modifiers.type_parameters())),
+          std::move(type_modifiers.type_parameters()),
+          std::move(const_format_caster)),
       std::move(args), error_mode);
 }
 
@@ -2181,6 +2380,46 @@ BuiltinScalarFunction::CreateValidatedRaw(
     case FunctionKind::kRangeIntersect:
     case FunctionKind::kGenerateRangeArray:
       return BuiltinFunctionRegistry::GetScalarFunction(kind, output_type);
+    case FunctionKind::kVariantParseJson:
+    case FunctionKind::kVariantTryParseJson:
+    case FunctionKind::kVariantCheckJson:
+    case FunctionKind::kVariantToJson:
+    case FunctionKind::kToVariant:
+    case FunctionKind::kToObject:
+    case FunctionKind::kObjectConstruct:
+    case FunctionKind::kObjectInsert:
+    case FunctionKind::kObjectDelete:
+    case FunctionKind::kVariantArrayConstruct:
+    case FunctionKind::kVariantArrayConstructCompact:
+    case FunctionKind::kVariantArraySize:
+    case FunctionKind::kVariantGet:
+    case FunctionKind::kVariantGetIgnoreCase:
+    case FunctionKind::kVariantGetPath:
+    case FunctionKind::kStripNullValue:
+    case FunctionKind::kIsNullValue:
+    case FunctionKind::kIsBoolean:
+    case FunctionKind::kIsInteger:
+    case FunctionKind::kIsDecimal:
+    case FunctionKind::kIsDouble:
+    case FunctionKind::kIsChar:
+    case FunctionKind::kIsBinary:
+    case FunctionKind::kIsDate:
+    case FunctionKind::kIsTime:
+    case FunctionKind::kIsTimestamp:
+    case FunctionKind::kIsArray:
+    case FunctionKind::kIsObject:
+    case FunctionKind::kAsBoolean:
+    case FunctionKind::kAsInteger:
+    case FunctionKind::kAsDecimal:
+    case FunctionKind::kAsDouble:
+    case FunctionKind::kAsChar:
+    case FunctionKind::kAsDate:
+    case FunctionKind::kAsTime:
+    case FunctionKind::kAsTimestamp:
+    case FunctionKind::kAsArray:
+    case FunctionKind::kAsObject:
+      // Semi-structured functions are optional.
+      return BuiltinFunctionRegistry::GetScalarFunction(kind, output_type);
     default:
       ZETASQL_RET_CHECK_FAIL() << BuiltinFunctionCatalog::GetDebugNameByKind(kind)
                        << " is not a scalar function";
@@ -2200,25 +2439,23 @@ BuiltinScalarFunction::CreateValidated(
 }
 
 namespace {
-absl::StatusOr<std::unique_ptr<RE2>> GetLikePatternRegexp(
-    const ValueExpr& arg) {
+absl::StatusOr<std::unique_ptr<const functions::LikeMatcher>>
+GetLikePatternMatcher(const ValueExpr& arg) {
   if (arg.IsConstant() &&
       (arg.output_type()->IsString() || arg.output_type()->IsBytes())) {
     const ConstExpr& pattern_expr = static_cast<const ConstExpr&>(arg);
     if (!pattern_expr.value().is_null()) {
-      // Build and precompile the regexp.
+      // Build and precompile the matcher.
       const std::string& pattern =
           pattern_expr.value().type_kind() == TYPE_STRING
               ? pattern_expr.value().string_value()
               : pattern_expr.value().bytes_value();
-      std::unique_ptr<RE2> regexp;
-      ZETASQL_RETURN_IF_ERROR(functions::CreateLikeRegexp(
-          pattern, arg.output_type()->kind(), &regexp));
-      return regexp;
+      return functions::LikeMatcher::Create(pattern,
+                                            arg.output_type()->kind());
     }
   }
   // The pattern is not a constant expression or it is null; build and
-  // compile the regexp at evaluation time.
+  // compile the matcher at evaluation time.
   return nullptr;
 }
 }  // namespace
@@ -2227,48 +2464,49 @@ absl::StatusOr<std::unique_ptr<BuiltinScalarFunction>>
 BuiltinScalarFunction::CreateLikeFunction(
     FunctionKind kind, const Type* output_type,
     const std::vector<std::unique_ptr<AlgebraArg>>& arguments) {
-  ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<RE2> regexp,
-                   GetLikePatternRegexp(*arguments[1]->value_expr()));
+  ZETASQL_ASSIGN_OR_RETURN(
+      std::unique_ptr<const functions::LikeMatcher> matcher,
+      GetLikePatternMatcher(*arguments[1]->value_expr()));
   return std::unique_ptr<BuiltinScalarFunction>(
-      new LikeFunction(kind, output_type, std::move(regexp)));
+      new LikeFunction(kind, output_type, std::move(matcher)));
 }
 
 absl::StatusOr<std::unique_ptr<BuiltinScalarFunction>>
 BuiltinScalarFunction::CreateLikeAnyFunction(
     FunctionKind kind, const Type* output_type,
     const std::vector<std::unique_ptr<AlgebraArg>>& arguments) {
-  std::vector<std::unique_ptr<RE2>> regexp;
+  std::vector<std::unique_ptr<const functions::LikeMatcher>> matchers;
   for (int i = 1; i < arguments.size(); ++i) {
-    ZETASQL_ASSIGN_OR_RETURN(regexp.emplace_back(),
-                     GetLikePatternRegexp(*arguments[i]->value_expr()));
+    ZETASQL_ASSIGN_OR_RETURN(matchers.emplace_back(),
+                     GetLikePatternMatcher(*arguments[i]->value_expr()));
   }
   return std::unique_ptr<BuiltinScalarFunction>(
-      new LikeAnyFunction(kind, output_type, std::move(regexp)));
+      new LikeAnyFunction(kind, output_type, std::move(matchers)));
 }
 
 absl::StatusOr<std::unique_ptr<BuiltinScalarFunction>>
 BuiltinScalarFunction::CreateLikeAllFunction(
     FunctionKind kind, const Type* output_type,
     const std::vector<std::unique_ptr<AlgebraArg>>& arguments) {
-  std::vector<std::unique_ptr<RE2>> regexp;
+  std::vector<std::unique_ptr<const functions::LikeMatcher>> matchers;
   for (int i = 1; i < arguments.size(); ++i) {
-    ZETASQL_ASSIGN_OR_RETURN(regexp.emplace_back(),
-                     GetLikePatternRegexp(*arguments[i]->value_expr()));
+    ZETASQL_ASSIGN_OR_RETURN(matchers.emplace_back(),
+                     GetLikePatternMatcher(*arguments[i]->value_expr()));
   }
   return std::unique_ptr<BuiltinScalarFunction>(
-      new LikeAllFunction(kind, output_type, std::move(regexp)));
+      new LikeAllFunction(kind, output_type, std::move(matchers)));
 }
 
 absl::StatusOr<std::unique_ptr<BuiltinScalarFunction>>
 BuiltinScalarFunction::CreateLikeAnyAllArrayFunction(
     FunctionKind kind, const Type* output_type,
     const std::vector<std::unique_ptr<AlgebraArg>>& arguments) {
-  std::vector<std::unique_ptr<RE2>> regexp;
+  std::vector<std::unique_ptr<const functions::LikeMatcher>> matchers;
 
   // The second argument to this function will be an array.
-  // Theses values are unpacked in order to generate the regular expressions
-  // needed for the LIKE expressions when they are evaluated. Non-constant
-  // values will have their regular expressions generated at execution time.
+  // Theses values are unpacked in order to generate the matchers needed for
+  // the LIKE expressions when they are evaluated. Non-constant values will
+  // have their matchers generated at execution time.
   const ValueExpr* value_expression = arguments[1]->value_expr();
   if (value_expression->IsConstant() &&
       value_expression->output_type()->IsArray()) {
@@ -2278,18 +2516,18 @@ BuiltinScalarFunction::CreateLikeAnyAllArrayFunction(
       for (int i = 0; i < pattern_list->value().num_elements(); ++i) {
         ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<const ConstExpr> pattern,
                          ConstExpr::Create(pattern_list->value().element(i)));
-        ZETASQL_ASSIGN_OR_RETURN(regexp.emplace_back(),
-                         GetLikePatternRegexp(*pattern.get()));
+        ZETASQL_ASSIGN_OR_RETURN(matchers.emplace_back(),
+                         GetLikePatternMatcher(*pattern.get()));
       }
     }
   }
 
   if (kind == FunctionKind::kLikeAnyArray) {
     return std::make_unique<LikeAnyArrayFunction>(kind, output_type,
-                                                  std::move(regexp));
+                                                  std::move(matchers));
   } else {
     return std::make_unique<LikeAllArrayFunction>(kind, output_type,
-                                                  std::move(regexp));
+                                                  std::move(matchers));
   }
 }
 
@@ -4766,11 +5004,16 @@ absl::StatusOr<Value> CastFunction::Eval(
     time_zone = args[3].string_value();
   }
 
-  absl::StatusOr<Value> status_or = internal::CastValueWithoutTypeValidation(
-      v, context->GetDefaultTimeZone(),
-      absl::FromUnixMicros(context->GetCurrentTimestamp()),
-      context->GetLanguageOptions(), output_type(), format, time_zone,
-      extended_cast_evaluator_.get(), /*canonicalize_zero=*/true);
+  absl::StatusOr<Value> status_or =
+      !v.is_null() &&
+              !std::holds_alternative<std::monostate>(const_format_caster_)
+          ? CastWithConstFormat(v, context)
+          : internal::CastValueWithoutTypeValidation(
+                v, context->GetDefaultTimeZone(),
+                absl::FromUnixMicros(context->GetCurrentTimestamp()),
+                context->GetLanguageOptions(), output_type(), format,
+                time_zone, extended_cast_evaluator_.get(),
+                /*canonicalize_zero=*/true);
   if (!status_or.ok() && return_null_on_error) {
     // TODO: check that failure is not due to absence of
     // extended_type_function. In this case we still probably wants to fail the
@@ -4806,6 +5049,77 @@ absl::StatusOr<Value> CastFunction::Eval(
   return status_or;
 }
 
+absl::StatusOr<Value> CastFunction::CastWithConstFormat(
+    const Value& v, EvaluationContext* context) const {
+  const absl::TimeZone timezone = context->GetDefaultTimeZone();
+  const absl::Time current_timestamp =
+      absl::FromUnixMicros(context->GetCurrentTimestamp());
+  const functions::TimestampScale scale =
+      GetTimestampScale(context->GetLanguageOptions());
+  // Only used by the casts from STRING to DATE and DATETIME.
+  auto current_date = [&]() -> absl::StatusOr<int32_t> {
+    int32_t date;
+    ZETASQL_RETURN_IF_ERROR(functions::ExtractFromTimestamp(
+        functions::DATE, current_timestamp, timezone, &date));
+    return date;
+  };
+
+  if (const auto* caster =
+          std::get_if<functions::StringToDateCaster>(&const_format_caster_)) {
+    ZETASQL_ASSIGN_OR_RETURN(int32_t today, current_date());
+    int32_t date;
+    ZETASQL_RETURN_IF_ERROR(caster->Cast(v.string_value(), today, &date));
+    return Value::Date(date);
+  }
+  if (const auto* caster = std::get_if<functions::StringToDatetimeCaster>(
+          &const_format_caster_)) {
+    ZETASQL_ASSIGN_OR_RETURN(int32_t today, current_date());
+    DatetimeValue datetime;
+    ZETASQL_RETURN_IF_ERROR(
+        caster->Cast(v.string_value(), scale, today, &datetime));
+    return Value::Datetime(datetime);
+  }
+  if (const auto* caster =
+          std::get_if<functions::StringToTimeCaster>(&const_format_caster_)) {
+    TimeValue time;
+    ZETASQL_RETURN_IF_ERROR(caster->Cast(v.string_value(), scale, &time));
+    return Value::Time(time);
+  }
+  if (const auto* caster = std::get_if<functions::StringToTimestampCaster>(
+          &const_format_caster_)) {
+    if (scale == functions::kNanoseconds) {
+      absl::Time timestamp;
+      ZETASQL_RETURN_IF_ERROR(caster->Cast(v.string_value(), timezone,
+                                   current_timestamp, &timestamp));
+      return Value::Timestamp(timestamp);
+    }
+    int64_t timestamp;
+    ZETASQL_RETURN_IF_ERROR(caster->Cast(v.string_value(), timezone,
+                                 current_timestamp, &timestamp));
+    return Value::TimestampFromUnixMicros(timestamp);
+  }
+
+  std::string result;
+  if (const auto* caster =
+          std::get_if<functions::DateToStringCaster>(&const_format_caster_)) {
+    ZETASQL_RETURN_IF_ERROR(caster->Cast(v.date_value(), &result));
+  } else if (const auto* caster =
+                 std::get_if<functions::DatetimeToStringCaster>(
+                     &const_format_caster_)) {
+    ZETASQL_RETURN_IF_ERROR(caster->Cast(v.datetime_value(), &result));
+  } else if (const auto* caster = std::get_if<functions::TimeToStringCaster>(
+                 &const_format_caster_)) {
+    ZETASQL_RETURN_IF_ERROR(caster->Cast(v.time_value(), &result));
+  } else if (const auto* caster =
+                 std::get_if<functions::TimestampToStringCaster>(
+                     &const_format_caster_)) {
+    ZETASQL_RETURN_IF_ERROR(caster->Cast(v.ToTime(), timezone, &result));
+  } else {
+    ZETASQL_RET_CHECK_FAIL() << "No precompiled format for cast";
+  }
+  return Value::String(result);
+}
+
 bool BitCastFunction::Eval(absl::Span<const TupleData* const> params,
                            absl::Span<const Value> args,
                            EvaluationContext* context, Value* result,
@@ -7318,7 +7632,8 @@ BinaryStatFunction::CreateAccumulator(absl::Span<const Value> args,
 
 namespace {
 absl::StatusOr<Value> LikeImpl(const Value& lhs, const Value& rhs,
-                               const RE2* regexp) {
+                               const functions::LikeMatcher* matcher,
+                               EvaluationContext* context) {
   if (lhs.is_null() || rhs.is_null()) {
     return Value::Null(types::BoolType());
   }
@@ -7326,18 +7641,20 @@ absl::StatusOr<Value> LikeImpl(const Value& lhs, const Value& rhs,
   const std::string& text =
       lhs.type_kind() == TYPE_STRING ? lhs.string_value() : lhs.bytes_value();
 
-  if (regexp != nullptr) {
-    // Regexp is precompiled
-    return Value::Bool(RE2::FullMatch(text, *regexp));
-  } else {
-    // Regexp is not precompiled, compile it on the fly
+  if (matcher == nullptr) {
+    // Pattern is not precompiled, look it up in the per-evaluation cache and
+    // compile it on a miss.
     const std::string& pattern =
         rhs.type_kind() == TYPE_STRING ? rhs.string_value() : rhs.bytes_value();
-    std::unique_ptr<RE2> regexp;
-    ZETASQL_RETURN_IF_ERROR(
-        functions::CreateLikeRegexp(pattern, lhs.type_kind(), &regexp));
-    return Value::Bool(RE2::FullMatch(text, *regexp));
+    const TypeKind type_kind = lhs.type_kind();
+    ZETASQL_ASSIGN_OR_RETURN(
+        matcher,
+        context->like_matcher_cache()->GetOrCompile(
+            pattern, type_kind, [type_kind](absl::string_view pattern) {
+              return functions::LikeMatcher::Create(pattern, type_kind);
+            }));
   }
+  return Value::Bool(matcher->Match(text));
 }
 
 bool IsTrue(const Value& value) {
@@ -7354,14 +7671,14 @@ absl::StatusOr<Value> LikeFunction::Eval(
     absl::Span<const TupleData* const> params, absl::Span<const Value> args,
     EvaluationContext* context) const {
   ABSL_CHECK_EQ(2, args.size());
-  return LikeImpl(args[0], args[1], regexp_.get());
+  return LikeImpl(args[0], args[1], matcher_.get(), context);
 }
 
 absl::StatusOr<Value> LikeAnyFunction::Eval(
     absl::Span<const TupleData* const> params, absl::Span<const Value> args,
     EvaluationContext* context) const {
   ABSL_CHECK_LE(1, args.size());
-  ABSL_CHECK_EQ(regexp_.size(), args.size() - 1);
+  ABSL_CHECK_EQ(matchers_.size(), args.size() - 1);
 
   if (args[0].is_null()) {
     return Value::Null(output_type());
@@ -7370,8 +7687,9 @@ absl::StatusOr<Value> LikeAnyFunction::Eval(
   Value result = Value::Bool(false);
 
   for (int i = 1; i < args.size(); ++i) {
-    ZETASQL_ASSIGN_OR_RETURN(Value local_result,
-                     LikeImpl(args[0], args[i], regexp_[i - 1].get()));
+    ZETASQL_ASSIGN_OR_RETURN(
+        Value local_result,
+        LikeImpl(args[0], args[i], matchers_[i - 1].get(), context));
     if (IsTrue(local_result)) {
       return local_result;
     } else if (!IsTrue(result) && !IsFalse(local_result)) {
@@ -7385,7 +7703,7 @@ absl::StatusOr<Value> LikeAllFunction::Eval(
     absl::Span<const TupleData* const> params, absl::Span<const Value> args,
     EvaluationContext* context) const {
   ABSL_CHECK_LE(1, args.size());
-  ABSL_CHECK_EQ(regexp_.size(), args.size() - 1);
+  ABSL_CHECK_EQ(matchers_.size(), args.size() - 1);
 
   if (args[0].is_null()) {
     return Value::Null(output_type());
@@ -7394,8 +7712,9 @@ absl::StatusOr<Value> LikeAllFunction::Eval(
   Value result = Value::Bool(true);
 
   for (int i = 1; i < args.size(); ++i) {
-    ZETASQL_ASSIGN_OR_RETURN(Value local_result,
-                     LikeImpl(args[0], args[i], regexp_[i - 1].get()));
+    ZETASQL_ASSIGN_OR_RETURN(
+        Value local_result,
+        LikeImpl(args[0], args[i], matchers_[i - 1].get(), context));
     if (!IsFalse(result) && !IsTrue(local_result)) {
       result = local_result;
     }
@@ -7419,18 +7738,20 @@ absl::StatusOr<Value> LikeAnyArrayFunction::Eval(
   }
 
   // For cases with the rhs is a subquery expression creating an ARRAY, the
-  // number of regexps will be less than the number of elements and the regexp
-  // for each element will be generated during execution
-  ZETASQL_RET_CHECK_LE(regexp_.size(), args[1].num_elements())
-      << "The number of regular expressions should be less than or equal to"
+  // number of matchers will be less than the number of elements and the
+  // matcher for each element will be generated during execution
+  ZETASQL_RET_CHECK_LE(matchers_.size(), args[1].num_elements())
+      << "The number of matchers should be less than or equal to"
          "the number of arguments in the pattern list";
 
   Value result = Value::Bool(false);
 
   for (int i = 0; i < args[1].num_elements(); ++i) {
-    const RE2* current_regexp = i < regexp_.size() ? regexp_[i].get() : nullptr;
+    const functions::LikeMatcher* current_matcher =
+        i < matchers_.size() ? matchers_[i].get() : nullptr;
     ZETASQL_ASSIGN_OR_RETURN(Value local_result,
-                     LikeImpl(args[0], args[1].element(i), current_regexp));
+                     LikeImpl(args[0], args[1].element(i), current_matcher,
+                              context));
     if (IsTrue(local_result)) {
       return local_result;
     } else if (!IsTrue(result) && !IsFalse(local_result)) {
@@ -7456,20 +7777,22 @@ absl::StatusOr<Value> LikeAllArrayFunction::Eval(
   }
 
   // For cases with the rhs is a subquery expression creating an ARRAY, the
-  // number of regexps will be less than the number of elements and the regexp
-  // for each element will be generated during execution
-  ZETASQL_RET_CHECK_LE(regexp_.size(), args[1].num_elements())
-      << "The number of regular expressions should be less than or equal to"
+  // number of matchers will be less than the number of elements and the
+  // matcher for each element will be generated during execution
+  ZETASQL_RET_CHECK_LE(matchers_.size(), args[1].num_elements())
+      << "The number of matchers should be less than or equal to"
          "the number of arguments in the pattern list";
 
   Value result = Value::Bool(true);
 
   for (int i = 0; i < args[1].num_elements(); ++i) {
-    // If there is not a precomputed regexp for a pattern, then a nullptr can
-    // be passed to LikeImpl() to compute the regexp during execution
-    const RE2* current_regexp = i < regexp_.size() ? regexp_[i].get() : nullptr;
+    // If there is not a precomputed matcher for a pattern, then a nullptr can
+    // be passed to LikeImpl() to compute the matcher during execution
+    const functions::LikeMatcher* current_matcher =
+        i < matchers_.size() ? matchers_[i].get() : nullptr;
     ZETASQL_ASSIGN_OR_RETURN(Value local_result,
-                     LikeImpl(args[0], args[1].element(i), current_regexp));
+                     LikeImpl(args[0], args[1].element(i), current_matcher,
+                              context));
     if (!IsFalse(result) && !IsTrue(local_result)) {
       result = local_result;
     }
@@ -8304,11 +8627,16 @@ absl::StatusOr<Value> RegexpFunction::Eval(
     absl::Span<const TupleData* const> params, absl::Span<const Value> args,
     EvaluationContext* context) const {
   if (HasNulls(args)) return Value::Null(output_type());
-  std::unique_ptr<const functions::RegExp> runtime_regexp;
   const functions::RegExp* regexp = const_regexp_.get();
   if (regexp == nullptr) {
-    ZETASQL_ASSIGN_OR_RETURN(runtime_regexp, CreateRegexp(args[1]));
-    regexp = runtime_regexp.get();
+    const Value& pattern = args[1];
+    ZETASQL_ASSIGN_OR_RETURN(
+        regexp, context->regexp_cache()->GetOrCompile(
+                    pattern.type_kind() == TYPE_BYTES ? pattern.bytes_value()
+                                                      : pattern.string_value(),
+                    pattern.type_kind(), [&pattern](absl::string_view) {
+                      return CreateRegexp(pattern);
+                    }));
   }
   switch (FCT(kind(), args[0].type_kind())) {
     case FCT(FunctionKind::kRegexpContains, TYPE_STRING): {
@@ -9201,7 +9529,7 @@ absl::StatusOr<Value> StringConversionFunction::Eval(
       break;
     case TYPE_JSON: {
       ZETASQL_RET_CHECK_EQ(args.size(), 1);
-      JSONValue json_storage;
+      CompactJSONValue json_storage;
       const LanguageOptions& language_options = context->GetLanguageOptions();
       ZETASQL_ASSIGN_OR_RETURN(
           JSONValueConstRef json_value_const_ref,
@@ -19,17 +19,22 @@
 #ifndef ZETASQL_REFERENCE_IMPL_FUNCTION_H_
 #define ZETASQL_REFERENCE_IMPL_FUNCTION_H_
 
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
+#include <variant>
 #include <vector>
 
 #include "zetasql/base/logging.h"
 #include "zetasql/public/cast.h"
 #include "google/protobuf/descriptor.h"
 #include "zetasql/public/function.h"
+#include "zetasql/public/functions/cast_date_time.h"
 #include "zetasql/public/functions/date_time_util.h"
+#include "zetasql/public/functions/like.h"
 #include "zetasql/public/functions/regexp.h"
 #include "zetasql/public/language_options.h"
 #include "zetasql/public/proto/type_annotation.pb.h"
@@ -47,7 +52,6 @@
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
-#include "re2/re2.h"
 #include "zetasql/base/status.h"
 
 namespace zetasql {
@@ -449,6 +453,48 @@ enum class FunctionKind {
   kRangeOverlaps,
   kRangeIntersect,
   kGenerateRangeArray,
+
+  // Semi-structured (VARIANT and OBJECT) functions. These are looked up by
+  // signature id, since several of their names are shared with ZetaSQL
+  // functions of different semantics.
+  kVariantParseJson,
+  kVariantTryParseJson,
+  kVariantCheckJson,
+  kVariantToJson,
+  kToVariant,
+  kToObject,
+  kObjectConstruct,
+  kObjectInsert,
+  kObjectDelete,
+  kVariantArrayConstruct,
+  kVariantArrayConstructCompact,
+  kVariantArraySize,
+  kVariantGet,
+  kVariantGetIgnoreCase,
+  kVariantGetPath,
+  kStripNullValue,
+  kIsNullValue,
+  kIsBoolean,
+  kIsInteger,
+  kIsDecimal,
+  kIsDouble,
+  kIsChar,
+  kIsBinary,
+  kIsDate,
+  kIsTime,
+  kIsTimestamp,
+  kIsArray,
+  kIsObject,
+  kAsBoolean,
+  kAsInteger,
+  kAsDecimal,
+  kAsDouble,
+  kAsChar,
+  kAsDate,
+  kAsTime,
+  kAsTimestamp,
+  kAsArray,
+  kAsObject,
 };
 
 // Provides two utility methods to look up a built-in function name or function
@@ -460,6 +506,11 @@ class BuiltinFunctionCatalog {
 
   static absl::StatusOr<FunctionKind> GetKindByName(absl::string_view name);
 
+  // Returns the kind of functions that are identified by their signature
+  // rather than their name, or std::nullopt if <signature_id> is not one.
+  static std::optional<FunctionKind> GetKindBySignatureId(
+      int64_t signature_id);
+
   static std::string GetDebugNameByKind(FunctionKind kind);
 
  private:
@@ -949,13 +1000,27 @@ class IsFunction : public BuiltinScalarFunction {
 
 class CastFunction : public SimpleBuiltinScalarFunction {
  public:
+  // The FORMAT of a cast between STRING and a date/time type, compiled at
+  // prepare time. std::monostate if the format is not a constant.
+  using FormatCaster =
+      std::variant<std::monostate, functions::StringToDateCaster,
+                   functions::StringToDatetimeCaster,
+                   functions::StringToTimeCaster,
+                   functions::StringToTimestampCaster,
+                   functions::DateToStringCaster,
+                   functions::DatetimeToStringCaster,
+                   functions::TimeToStringCaster,
+                   functions::TimestampToStringCaster>;
+
   CastFunction(
       const Type* output_type,
       std::unique_ptr<ExtendedCompositeCastEvaluator> extended_cast_evaluator,
-      const TypeParameters type_params)
+      const TypeParameters type_params,
+      FormatCaster const_format_caster = std::monostate())
       : SimpleBuiltinScalarFunction(FunctionKind::kCast, output_type),
         extended_cast_evaluator_(std::move(extended_cast_evaluator)),
-        type_params_(std::move(type_params)) {}
+        type_params_(std::move(type_params)),
+        const_format_caster_(std::move(const_format_caster)) {}
   CastFunction(FunctionKind kind, const Type* output_type)
       : SimpleBuiltinScalarFunction(kind, output_type) {}
 
@@ -964,8 +1029,16 @@ class CastFunction : public SimpleBuiltinScalarFunction {
                              EvaluationContext* context) const override;
 
  private:
+  // Casts the non-NULL <v> with <const_format_caster_>, following the FORMAT
+  // semantics of CastValueWithoutTypeValidation().
+  absl::StatusOr<Value> CastWithConstFormat(const Value& v,
+                                            EvaluationContext* context) const;
+
   std::unique_ptr<ExtendedCompositeCastEvaluator> extended_cast_evaluator_;
   const TypeParameters type_params_;
+  // Format precompiled at prepare time; std::monostate if it cannot be
+  // precompiled.
+  const FormatCaster const_format_caster_;
 };
 
 class BitCastFunction : public BuiltinScalarFunction {
@@ -979,9 +1052,9 @@ class BitCastFunction : public BuiltinScalarFunction {
 class LikeFunction : public SimpleBuiltinScalarFunction {
  public:
   LikeFunction(FunctionKind kind, const Type* output_type,
-               std::unique_ptr<RE2> regexp)
+               std::unique_ptr<const functions::LikeMatcher> matcher)
       : SimpleBuiltinScalarFunction(kind, output_type),
-        regexp_(std::move(regexp)) {}
+        matcher_(std::move(matcher)) {}
   absl::StatusOr<Value> Eval(absl::Span<const TupleData* const> params,
                              absl::Span<const Value> args,
                              EvaluationContext* context) const override;
@@ -990,16 +1063,17 @@ class LikeFunction : public SimpleBuiltinScalarFunction {
   LikeFunction& operator=(const LikeFunction&) = delete;
 
  private:
-  // Regexp precompiled at prepare time; null if cannot be precompiled.
-  std::unique_ptr<RE2> regexp_;
+  // Pattern precompiled at prepare time; null if cannot be precompiled.
+  std::unique_ptr<const functions::LikeMatcher> matcher_;
 };
 
 class LikeAnyFunction : public SimpleBuiltinScalarFunction {
  public:
-  LikeAnyFunction(FunctionKind kind, const Type* output_type,
-                  std::vector<std::unique_ptr<RE2>> regexp)
+  LikeAnyFunction(
+      FunctionKind kind, const Type* output_type,
+      std::vector<std::unique_ptr<const functions::LikeMatcher>> matchers)
       : SimpleBuiltinScalarFunction(kind, output_type),
-        regexp_(std::move(regexp)) {}
+        matchers_(std::move(matchers)) {}
 
   absl::StatusOr<Value> Eval(absl::Span<const TupleData* const> params,
                              absl::Span<const Value> args,
@@ -1009,15 +1083,16 @@ class LikeAnyFunction : public SimpleBuiltinScalarFunction {
   LikeAnyFunction& operator=(const LikeAnyFunction&) = delete;
 
  private:
-  std::vector<std::unique_ptr<RE2>> regexp_;
+  std::vector<std::unique_ptr<const functions::LikeMatcher>> matchers_;
 };
 
 class LikeAllFunction : public SimpleBuiltinScalarFunction {
  public:
-  LikeAllFunction(FunctionKind kind, const Type* output_type,
-                  std::vector<std::unique_ptr<RE2>> regexp)
+  LikeAllFunction(
+      FunctionKind kind, const Type* output_type,
+      std::vector<std::unique_ptr<const functions::LikeMatcher>> matchers)
       : SimpleBuiltinScalarFunction(kind, output_type),
-        regexp_(std::move(regexp)) {}
+        matchers_(std::move(matchers)) {}
 
   absl::StatusOr<Value> Eval(absl::Span<const TupleData* const> params,
                              absl::Span<const Value> args,
@@ -1027,17 +1102,18 @@ class LikeAllFunction : public SimpleBuiltinScalarFunction {
   LikeAllFunction& operator=(const LikeAllFunction&) = delete;
 
  private:
-  std::vector<std::unique_ptr<RE2>> regexp_;
+  std::vector<std::unique_ptr<const functions::LikeMatcher>> matchers_;
 };
 
 // Invoked by expression such as:
 //   <expr> LIKE ANY UNNEST(<array-expression>)
 class LikeAnyArrayFunction : public SimpleBuiltinScalarFunction {
  public:
-  LikeAnyArrayFunction(FunctionKind kind, const Type* output_type,
-                       std::vector<std::unique_ptr<RE2>> regexp)
+  LikeAnyArrayFunction(
+      FunctionKind kind, const Type* output_type,
+      std::vector<std::unique_ptr<const functions::LikeMatcher>> matchers)
       : SimpleBuiltinScalarFunction(kind, output_type),
-        regexp_(std::move(regexp)) {}
+        matchers_(std::move(matchers)) {}
 
   absl::StatusOr<Value> Eval(absl::Span<const TupleData* const> params,
                              absl::Span<const Value> args,
@@ -1047,17 +1123,18 @@ class LikeAnyArrayFunction : public SimpleBuiltinScalarFunction {
   LikeAnyArrayFunction& operator=(const LikeAnyArrayFunction&) = delete;
 
  private:
-  std::vector<std::unique_ptr<RE2>> regexp_;
+  std::vector<std::unique_ptr<const functions::LikeMatcher>> matchers_;
 };
 
 // Invoked by expression such as:
 //   <expr> LIKE ALL UNNEST(<array-expression>)
 class LikeAllArrayFunction : public SimpleBuiltinScalarFunction {
  public:
-  LikeAllArrayFunction(FunctionKind kind, const Type* output_type,
-                       std::vector<std::unique_ptr<RE2>> regexp)
+  LikeAllArrayFunction(
+      FunctionKind kind, const Type* output_type,
+      std::vector<std::unique_ptr<const functions::LikeMatcher>> matchers)
       : SimpleBuiltinScalarFunction(kind, output_type),
-        regexp_(std::move(regexp)) {}
+        matchers_(std::move(matchers)) {}
 
   absl::StatusOr<Value> Eval(absl::Span<const TupleData* const> params,
                              absl::Span<const Value> args,
@@ -1067,7 +1144,7 @@ class LikeAllArrayFunction : public SimpleBuiltinScalarFunction {
   LikeAllArrayFunction& operator=(const LikeAllArrayFunction&) = delete;
 
  private:
-  std::vector<std::unique_ptr<RE2>> regexp_;
+  std::vector<std::unique_ptr<const functions::LikeMatcher>> matchers_;
 };
 
 class BitwiseFunction : public BuiltinScalarFunction {
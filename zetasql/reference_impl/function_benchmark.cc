@@ -0,0 +1,123 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Per-row cost of LIKE and REGEXP_CONTAINS when the pattern is a column value
+// rather than a constant, with and without the per-evaluation compiled pattern
+// cache.
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "zetasql/public/functions/like.h"
+#include "zetasql/public/functions/regexp.h"
+#include "zetasql/public/types/type_factory.h"
+#include "zetasql/public/value.h"
+#include "zetasql/reference_impl/evaluation.h"
+#include "zetasql/reference_impl/function.h"
+#include "benchmark/benchmark.h"
+#include "absl/strings/str_cat.h"
+
+namespace zetasql {
+
+static constexpr int kNumRows = 1024;
+
+// Builds kNumRows (text, pattern) rows cycling through <num_patterns> distinct
+// patterns, as when joining input rows against a table of rules.
+static void MakeRows(int num_patterns, std::vector<Value>* texts,
+                     std::vector<Value>* patterns) {
+  for (int i = 0; i < kNumRows; ++i) {
+    const int rule = i % num_patterns;
+    texts->push_back(
+        Value::String(absl::StrCat("customer_", i, "@example.com")));
+    patterns->push_back(Value::String(absl::StrCat("%_", rule, "@%.com")));
+  }
+}
+
+static EvaluationOptions OptionsWithCacheSize(int64_t max_cached_patterns) {
+  EvaluationOptions options;
+  options.max_cached_compiled_patterns = max_cached_patterns;
+  return options;
+}
+
+// Arguments: number of distinct patterns, maximum cached patterns.
+static void BM_LikeColumnPattern(::benchmark::State& state) {
+  std::vector<Value> texts, patterns;
+  MakeRows(state.range(0), &texts, &patterns);
+  LikeFunction like_fn(FunctionKind::kLike, types::BoolType(),
+                       /*matcher=*/nullptr);
+  EvaluationContext context(OptionsWithCacheSize(state.range(1)));
+  for (auto s : state) {
+    for (int i = 0; i < kNumRows; ++i) {
+      ::benchmark::DoNotOptimize(like_fn.Eval(
+          /*params=*/{}, {texts[i], patterns[i]}, &context));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumRows);
+}
+BENCHMARK(BM_LikeColumnPattern)
+    ->ArgPair(1, 0)
+    ->ArgPair(1, 64)
+    ->ArgPair(16, 0)
+    ->ArgPair(16, 64)
+    ->ArgPair(256, 64);
+
+// Baseline: a constant pattern precompiled at prepare time.
+static void BM_LikeConstantPattern(::benchmark::State& state) {
+  std::vector<Value> texts, patterns;
+  MakeRows(/*num_patterns=*/1, &texts, &patterns);
+  LikeFunction like_fn(
+      FunctionKind::kLike, types::BoolType(),
+      functions::LikeMatcher::Create(patterns[0].string_value(), TYPE_STRING)
+          .value());
+  EvaluationContext context{/*options=*/{}};
+  for (auto s : state) {
+    for (int i = 0; i < kNumRows; ++i) {
+      ::benchmark::DoNotOptimize(like_fn.Eval(
+          /*params=*/{}, {texts[i], patterns[i]}, &context));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumRows);
+}
+BENCHMARK(BM_LikeConstantPattern);
+
+// Arguments: number of distinct patterns, maximum cached patterns.
+static void BM_RegexpContainsColumnPattern(::benchmark::State& state) {
+  std::vector<Value> texts, patterns;
+  for (int i = 0; i < kNumRows; ++i) {
+    texts.push_back(Value::String(absl::StrCat("order-", i, "-shipped")));
+    patterns.push_back(Value::String(
+        absl::StrCat("^order-[0-9]*", i % state.range(0), "-(shipped|new)$")));
+  }
+  RegexpFunction contains_fn(/*const_regexp=*/nullptr,
+                             FunctionKind::kRegexpContains, types::BoolType());
+  EvaluationContext context(OptionsWithCacheSize(state.range(1)));
+  for (auto s : state) {
+    for (int i = 0; i < kNumRows; ++i) {
+      ::benchmark::DoNotOptimize(contains_fn.Eval(
+          /*params=*/{}, {texts[i], patterns[i]}, &context));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumRows);
+}
+BENCHMARK(BM_RegexpContainsColumnPattern)
+    ->ArgPair(1, 0)
+    ->ArgPair(1, 64)
+    ->ArgPair(16, 0)
+    ->ArgPair(16, 64);
+
+}  // namespace zetasql
@@ -23,6 +23,7 @@
 
 #include "zetasql/common/evaluator_registration_utils.h"
 #include "zetasql/base/testing/status_matchers.h"
+#include "zetasql/public/functions/like.h"
 #include "zetasql/public/interval_value.h"
 #include "zetasql/public/types/type_factory.h"
 #include "zetasql/reference_impl/evaluation.h"
@@ -30,9 +31,14 @@
 #include "zetasql/reference_impl/tuple.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
 
 namespace zetasql {
 
+using ::zetasql_base::testing::IsOkAndHolds;
+using ::zetasql_base::testing::StatusIs;
+
 TEST(SafeInvokeUnary, DoesNotLeakStatus) {
   ArithmeticFunction unary_minus_fn(FunctionKind::kSafeNegate,
                                     types::Int64Type());
@@ -498,4 +504,97 @@ TEST(NonDeterministicEvaluationContextTest,
   }
 }
 
+TEST(CompiledPatternCacheTest, LikeReusesNonConstantPatterns) {
+  LikeFunction like_fn(FunctionKind::kLike, types::BoolType(),
+                       /*matcher=*/nullptr);
+  EvaluationContext context{/*options=*/{}};
+  const CompiledPatternCache<functions::LikeMatcher>& cache =
+      *context.like_matcher_cache();
+
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_THAT(like_fn.Eval(/*params=*/{},
+                             {Value::String("abcd"), Value::String("a%")},
+                             &context),
+                IsOkAndHolds(Value::Bool(true)));
+    EXPECT_THAT(like_fn.Eval(/*params=*/{},
+                             {Value::String("abcd"), Value::String("%x")},
+                             &context),
+                IsOkAndHolds(Value::Bool(false)));
+  }
+  EXPECT_EQ(cache.size(), 2);
+  EXPECT_EQ(cache.num_misses(), 2);
+  EXPECT_EQ(cache.num_hits(), 4);
+
+  // The same pattern text over BYTES is compiled separately.
+  EXPECT_THAT(like_fn.Eval(/*params=*/{},
+                           {Value::Bytes("abcd"), Value::Bytes("a%")},
+                           &context),
+              IsOkAndHolds(Value::Bool(true)));
+  EXPECT_EQ(cache.size(), 3);
+  EXPECT_EQ(cache.num_misses(), 3);
+
+  // Errors are reported on every evaluation and are not cached.
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_THAT(like_fn.Eval(/*params=*/{},
+                             {Value::String("abcd"), Value::String("a\\")},
+                             &context),
+                StatusIs(absl::StatusCode::kOutOfRange));
+  }
+  EXPECT_EQ(cache.size(), 3);
+}
+
+TEST(CompiledPatternCacheTest, EvictsLeastRecentlyUsedPattern) {
+  LikeFunction like_fn(FunctionKind::kLike, types::BoolType(),
+                       /*matcher=*/nullptr);
+  EvaluationOptions options;
+  options.max_cached_compiled_patterns = 2;
+  EvaluationContext context(options);
+  const CompiledPatternCache<functions::LikeMatcher>& cache =
+      *context.like_matcher_cache();
+
+  for (absl::string_view pattern : {"a%", "b%", "a%", "c%", "a%", "b%"}) {
+    EXPECT_THAT(like_fn.Eval(/*params=*/{},
+                             {Value::String("abc"), Value::String(pattern)},
+                             &context),
+                IsOkAndHolds(Value::Bool(pattern == "a%")));
+  }
+  // "c%" evicted "b%", so only the second and third lookups of "a%" hit.
+  EXPECT_EQ(cache.size(), 2);
+  EXPECT_EQ(cache.num_hits(), 2);
+  EXPECT_EQ(cache.num_misses(), 4);
+}
+
+TEST(CompiledPatternCacheTest, CachingCanBeDisabled) {
+  LikeFunction like_fn(FunctionKind::kLike, types::BoolType(),
+                       /*matcher=*/nullptr);
+  EvaluationOptions options;
+  options.max_cached_compiled_patterns = 0;
+  EvaluationContext context(options);
+
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_THAT(like_fn.Eval(/*params=*/{},
+                             {Value::String("abc"), Value::String("%c")},
+                             &context),
+                IsOkAndHolds(Value::Bool(true)));
+  }
+  EXPECT_EQ(context.like_matcher_cache()->size(), 0);
+  EXPECT_EQ(context.like_matcher_cache()->num_misses(), 2);
+}
+
+TEST(CompiledPatternCacheTest, RegexpReusesNonConstantPatterns) {
+  RegexpFunction contains_fn(/*const_regexp=*/nullptr,
+                             FunctionKind::kRegexpContains, types::BoolType());
+  EvaluationContext context{/*options=*/{}};
+
+  for (absl::string_view text : {"foo123", "bar", "456"}) {
+    EXPECT_THAT(contains_fn.Eval(/*params=*/{},
+                                 {Value::String(text), Value::String("[0-9]+")},
+                                 &context),
+                IsOkAndHolds(Value::Bool(text != "bar")));
+  }
+  EXPECT_EQ(context.regexp_cache()->size(), 1);
+  EXPECT_EQ(context.regexp_cache()->num_hits(), 2);
+  EXPECT_EQ(context.regexp_cache()->num_misses(), 1);
+}
+
 }  // namespace zetasql
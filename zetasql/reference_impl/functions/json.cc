@@ -40,15 +40,17 @@ namespace {
 
 using functions::json_internal::StrictJSONPathIterator;
 
+// Unparsed JSON is parsed into the compact representation, which is cheaper
+// to build than a document tree and enough for read-only access.
 absl::StatusOr<JSONValueConstRef> GetJSONValueConstRef(
     const Value& json, const JSONParsingOptions& json_parsing_options,
-    JSONValue& json_storage) {
+    CompactJSONValue& json_storage) {
   if (json.is_validated_json()) {
     return json.json_value();
   }
   ZETASQL_ASSIGN_OR_RETURN(json_storage,
-                   JSONValue::ParseJSONString(json.json_value_unparsed(),
-                                              json_parsing_options));
+                   CompactJSONValue::ParseJSONString(
+                       json.json_value_unparsed(), json_parsing_options));
   return json_storage.GetConstRef();
 }
 
@@ -610,7 +612,7 @@ absl::StatusOr<Value> JsonTypeFunction::Eval(
   if (HasNulls(args)) {
     return Value::Null(output_type());
   }
-  JSONValue json_storage;
+  CompactJSONValue json_storage;
   LanguageOptions language_options = context->GetLanguageOptions();
   JSONParsingOptions json_parsing_options = JSONParsingOptions{
       .wide_number_mode = (language_options.LanguageFeatureEnabled(
@@ -632,7 +634,7 @@ absl::StatusOr<Value> ConvertJsonFunction::Eval(
   if (HasNulls(args)) {
     return Value::Null(output_type());
   }
-  JSONValue json_storage;
+  CompactJSONValue json_storage;
   LanguageOptions language_options = context->GetLanguageOptions();
   JSONParsingOptions json_parsing_options = JSONParsingOptions{
       .wide_number_mode = (language_options.LanguageFeatureEnabled(
@@ -696,7 +698,7 @@ absl::StatusOr<Value> ConvertJsonLaxFunction::Eval(
   if (HasNulls(args)) {
     return Value::Null(output_type());
   }
-  JSONValue json_storage;
+  CompactJSONValue json_storage;
   JSONParsingOptions json_parsing_options = JSONParsingOptions{
       .wide_number_mode = (context->GetLanguageOptions().LanguageFeatureEnabled(
                                FEATURE_JSON_STRICT_NUMBER_PARSING)
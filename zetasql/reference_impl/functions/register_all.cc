@@ -20,6 +20,7 @@
 #include "zetasql/reference_impl/functions/json.h"
 #include "zetasql/reference_impl/functions/range.h"
 #include "zetasql/reference_impl/functions/string_with_collation.h"
+#include "zetasql/reference_impl/functions/variant.h"
 
 namespace zetasql {
 
@@ -28,6 +29,7 @@ void RegisterAllOptionalBuiltinFunctions() {
   RegisterBuiltinHashFunctions();
   RegisterBuiltinStringWithCollationFunctions();
   RegisterBuiltinRangeFunctions();
+  RegisterBuiltinVariantFunctions();
 }
 
 }  // namespace zetasql
@@ -0,0 +1,930 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/reference_impl/functions/variant.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "zetasql/common/errors.h"
+#include "zetasql/public/civil_time.h"
+#include "zetasql/public/functions/date_time_util.h"
+#include "zetasql/public/numeric_value.h"
+#include "zetasql/public/type.pb.h"
+#include "zetasql/public/types/type_factory.h"
+#include "zetasql/public/value.h"
+#include "zetasql/public/variant_value.h"
+#include "zetasql/reference_impl/function.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "zetasql/base/ret_check.h"
+#include "zetasql/base/status_macros.h"
+
+namespace zetasql {
+namespace {
+
+// Converts <value> to a VARIANT. A NULL value, including a NULL element of an
+// array, becomes a JSON null.
+absl::StatusOr<VariantValue> ToVariantValue(const Value& value) {
+  if (value.is_null()) {
+    return VariantValue::Null();
+  }
+  switch (value.type_kind()) {
+    case TYPE_VARIANT:
+    case TYPE_OBJECT:
+      return VariantValue::CopyFrom(value.variant_value());
+    case TYPE_BOOL:
+      return VariantValue::Boolean(value.bool_value());
+    case TYPE_INT32:
+      return VariantValue::Integer(value.int32_value());
+    case TYPE_INT64:
+      return VariantValue::Integer(value.int64_value());
+    case TYPE_UINT32:
+      return VariantValue::Integer(value.uint32_value());
+    case TYPE_UINT64:
+      if (value.uint64_value() <=
+          static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
+        return VariantValue::Integer(
+            static_cast<int64_t>(value.uint64_value()));
+      }
+      return VariantValue::Decimal(NumericValue(value.uint64_value()));
+    case TYPE_FLOAT:
+      return VariantValue::Double(value.float_value());
+    case TYPE_DOUBLE:
+      return VariantValue::Double(value.double_value());
+    case TYPE_NUMERIC:
+      return VariantValue::Decimal(value.numeric_value());
+    case TYPE_BIGNUMERIC: {
+      // Values beyond the range or scale of a NUMERIC lose precision, like
+      // Snowflake numbers beyond NUMBER(38, 9) do.
+      absl::StatusOr<NumericValue> numeric =
+          value.bignumeric_value().ToNumericValue();
+      if (numeric.ok() &&
+          BigNumericValue(*numeric) == value.bignumeric_value()) {
+        return VariantValue::Decimal(*numeric);
+      }
+      return VariantValue::Double(value.bignumeric_value().ToDouble());
+    }
+    case TYPE_STRING:
+      return VariantValue::String(value.string_value());
+    case TYPE_BYTES:
+      return VariantValue::Binary(value.bytes_value());
+    case TYPE_DATE:
+      return VariantValue::Date(value.date_value());
+    case TYPE_TIME:
+      return VariantValue::Time(value.time_value());
+    case TYPE_DATETIME:
+      return VariantValue::TimestampNtz(value.datetime_value());
+    case TYPE_TIMESTAMP:
+      return VariantValue::TimestampTz(value.ToTime());
+    case TYPE_JSON:
+      return VariantValue::ParseJson(value.json_string());
+    case TYPE_ARRAY: {
+      std::vector<VariantValue> elements;
+      elements.reserve(value.num_elements());
+      for (const Value& element : value.elements()) {
+        ZETASQL_ASSIGN_OR_RETURN(VariantValue variant, ToVariantValue(element));
+        elements.push_back(std::move(variant));
+      }
+      std::vector<VariantConstRef> refs;
+      refs.reserve(elements.size());
+      for (const VariantValue& element : elements) {
+        refs.push_back(element.GetConstRef());
+      }
+      return VariantValue::Array(refs);
+    }
+    default:
+      return MakeEvalError() << "Cannot convert "
+                             << value.type()->DebugString() << " to VARIANT";
+  }
+}
+
+// A VARIANT view of a non-NULL function argument of any type. VARIANT and
+// OBJECT arguments are read in place, others are converted.
+class VariantArg {
+ public:
+  static absl::StatusOr<VariantArg> Create(const Value& value) {
+    ZETASQL_RET_CHECK(!value.is_null());
+    VariantArg arg(&value);
+    if (value.type_kind() != TYPE_VARIANT && value.type_kind() != TYPE_OBJECT) {
+      ZETASQL_ASSIGN_OR_RETURN(arg.converted_, ToVariantValue(value));
+    }
+    return arg;
+  }
+
+  VariantConstRef get() const {
+    return converted_.has_value() ? converted_->GetConstRef()
+                                  : value_->variant_value();
+  }
+
+ private:
+  explicit VariantArg(const Value* value) : value_(value) {}
+
+  const Value* value_;
+  std::optional<VariantValue> converted_;
+};
+
+Value MakeVariant(VariantConstRef variant) {
+  return Value::Variant(VariantValue::CopyFrom(variant));
+}
+
+// Returns <array> as an ARRAY<VARIANT> of type <array_type>. JSON null
+// elements stay JSON nulls.
+Value MakeVariantArray(const Type* array_type, VariantConstRef array) {
+  std::vector<Value> elements;
+  elements.reserve(array.GetArraySize());
+  for (size_t i = 0; i < array.GetArraySize(); ++i) {
+    elements.push_back(MakeVariant(array.GetArrayElement(i)));
+  }
+  return Value::Array(array_type->AsArray(), elements);
+}
+
+// Implementation of:
+// PARSE_JSON(STRING) -> VARIANT
+// TRY_PARSE_JSON(STRING|VARIANT) -> VARIANT
+// CHECK_JSON(STRING|VARIANT) -> STRING
+class VariantParseJsonFunction : public SimpleBuiltinScalarFunction {
+ public:
+  VariantParseJsonFunction(FunctionKind kind, const Type* output_type)
+      : SimpleBuiltinScalarFunction(kind, output_type) {}
+  absl::StatusOr<Value> Eval(absl::Span<const TupleData* const> params,
+                             absl::Span<const Value> args,
+                             EvaluationContext* context) const override;
+};
+
+absl::StatusOr<Value> VariantParseJsonFunction::Eval(
+    absl::Span<const TupleData* const> params, absl::Span<const Value> args,
+    EvaluationContext* context) const {
+  ZETASQL_RET_CHECK_EQ(args.size(), 1);
+  if (args[0].is_null()) {
+    return Value::Null(output_type());
+  }
+  absl::string_view json;
+  if (args[0].type_kind() == TYPE_STRING) {
+    json = args[0].string_value();
+  } else {
+    const VariantConstRef variant = args[0].variant_value();
+    if (variant.kind() != VariantKind::kString) {
+      // Anything but a string is already parsed.
+      return kind() == FunctionKind::kVariantCheckJson ? Value::NullString()
+                                                       : args[0];
+    }
+    json = variant.GetString();
+  }
+  // Like in Snowflake, blank input is NULL rather than invalid.
+  if (absl::StripAsciiWhitespace(json).empty()) {
+    return Value::Null(output_type());
+  }
+  absl::StatusOr<VariantValue> parsed = VariantValue::ParseJson(json);
+  switch (kind()) {
+    case FunctionKind::kVariantParseJson:
+      if (!parsed.ok()) {
+        return MakeEvalError() << "Error parsing JSON: "
+                               << parsed.status().message();
+      }
+      return Value::Variant(*std::move(parsed));
+    case FunctionKind::kVariantTryParseJson:
+      if (!parsed.ok()) {
+        return Value::NullVariant();
+      }
+      return Value::Variant(*std::move(parsed));
+    case FunctionKind::kVariantCheckJson:
+      if (!parsed.ok()) {
+        return Value::String(parsed.status().message());
+      }
+      return Value::NullString();
+    default:
+      ZETASQL_RET_CHECK_FAIL() << "Unexpected function: " << debug_name();
+  }
+}
+
+// Implementation of:
+// TO_VARIANT(<any>) -> VARIANT
+// STRIP_NULL_VALUE(<any>) -> VARIANT
+class ToVariantFunction : public SimpleBuiltinScalarFunction {
+ public:
+  explicit ToVariantFunction(FunctionKind kind)
+      : SimpleBuiltinScalarFunction(kind, types::VariantType()) {}
+  absl::StatusOr<Value> Eval(absl::Span<const TupleData* const> params,
+                             absl::Span<const Value> args,
+                             EvaluationContext* context) const override;
+};
+
+absl::StatusOr<Value> ToVariantFunction::Eval(
+    absl::Span<const TupleData* const> params, absl::Span<const Value> args,
+    EvaluationContext* context) const {
+  ZETASQL_RET_CHECK_EQ(args.size(), 1);
+  if (args[0].is_null()) {
+    return Value::NullVariant();
+  }
+  ZETASQL_ASSIGN_OR_RETURN(VariantValue variant, ToVariantValue(args[0]));
+  if (kind() == FunctionKind::kStripNullValue &&
+      variant.GetConstRef().kind() == VariantKind::kNull) {
+    return Value::NullVariant();
+  }
+  return Value::Variant(std::move(variant));
+}
+
+// Implementation of:
+// TO_JSON(VARIANT) -> STRING
+class VariantToJsonFunction : public SimpleBuiltinScalarFunction {
+ public:
+  VariantToJsonFunction()
+      : SimpleBuiltinScalarFunction(FunctionKind::kVariantToJson,
+                                    types::StringType()) {}
+  absl::StatusOr<Value> Eval(absl::Span<const TupleData* const> params,
+                             absl::Span<const Value> args,
+                             EvaluationContext* context) const override;
+};
+
+absl::StatusOr<Value> VariantToJsonFunction::Eval(
+    absl::Span<const TupleData* const> params, absl::Span<const Value> args,
+    EvaluationContext* context) const {
+  ZETASQL_RET_CHECK_EQ(args.size(), 1);
+  if (args[0].is_null()) {
+    return Value::NullString();
+  }
+  ZETASQL_ASSIGN_OR_RETURN(VariantArg variant, VariantArg::Create(args[0]));
+  return Value::String(variant.get().ToJsonString());
+}
+
+// Implementation of:
+// TO_OBJECT(VARIANT|OBJECT) -> OBJECT
+class ToObjectFunction : public SimpleBuiltinScalarFunction {
+ public:
+  ToObjectFunction()
+      : SimpleBuiltinScalarFunction(FunctionKind::kToObject,
+                                    types::ObjectType()) {}
+  absl::StatusOr<Value> Eval(absl::Span<const TupleData* const> params,
+                             absl::Span<const Value> args,
+                             EvaluationContext* context) const override;
+};
+
+absl::StatusOr<Value> ToObjectFunction::Eval(
+    absl::Span<const TupleData* const> params, absl::Span<const Value> args,
+    EvaluationContext* context) const {
+  ZETASQL_RET_CHECK_EQ(args.size(), 1);
+  if (args[0].is_null()) {
+    return Value::NullObject();
+  }
+  const VariantConstRef variant = args[0].variant_value();
+  if (variant.kind() != VariantKind::kObject) {
+    return MakeEvalError() << "Invalid object of type "
+                           << VariantKindName(variant.kind())
+                           << " for TO_OBJECT";
+  }
+  return Value::Object(VariantValue::CopyFrom(variant));
+}
+
+// Implementation of:
+// OBJECT_CONSTRUCT([<key>, <value> [, ...]]) -> OBJECT
+class ObjectConstructFunction : public SimpleBuiltinScalarFunction {
+ public:
+  ObjectConstructFunction()
+      : SimpleBuiltinScalarFunction(FunctionKind::kObjectConstruct,
+                                    types::ObjectType()) {}
+  absl::StatusOr<Value> Eval(absl::Span<const TupleData* const> params,
+                             absl::Span<const Value> args,
+                             EvaluationContext* context) const override;
+};
+
+absl::StatusOr<Value> ObjectConstructFunction::Eval(
+    absl::Span<const TupleData* const> params, absl::Span<const Value> args,
+    EvaluationContext* context) const {
+  if (args.size() % 2 != 0) {
+    return MakeEvalError()
+           << "OBJECT_CONSTRUCT requires an even number of arguments";
+  }
+  std::vector<absl::string_view> keys;
+  std::vector<VariantValue> values;
+  for (int i = 0; i < args.size(); i += 2) {
+    const Value& key = args[i];
+    const Value& value = args[i + 1];
+    // Pairs with a NULL key or value are omitted.
+    if (key.is_null() || value.is_null()) {
+      continue;
+    }
+    if (key.type_kind() == TYPE_STRING) {
+      keys.push_back(key.string_value());
+    } else if (key.type_kind() == TYPE_VARIANT &&
+               key.variant_value().kind() == VariantKind::kString) {
+      keys.push_back(key.variant_value().GetString());
+    } else {
+      return MakeEvalError() << "OBJECT_CONSTRUCT keys must be strings, got "
+                             << key.type()->DebugString();
+    }
+    ZETASQL_ASSIGN_OR_RETURN(VariantValue variant, ToVariantValue(value));
+    values.push_back(std::move(variant));
+  }
+  std::vector<std::pair<absl::string_view, VariantConstRef>> members;
+  members.reserve(keys.size());
+  for (int i = 0; i < keys.size(); ++i) {
+    members.emplace_back(keys[i], values[i].GetConstRef());
+  }
+  ZETASQL_ASSIGN_OR_RETURN(VariantValue object, VariantValue::Object(members));
+  return Value::Object(std::move(object));
+}
+
+// Returns the members of <object>, except the one named <skip_key> if any.
+std::vector<std::pair<absl::string_view, VariantConstRef>> GetMembers(
+    VariantConstRef object,
+    std::optional<absl::string_view> skip_key = std::nullopt) {
+  std::vector<std::pair<absl::string_view, VariantConstRef>> members;
+  members.reserve(object.GetObjectSize());
+  for (size_t i = 0; i < object.GetObjectSize(); ++i) {
+    if (skip_key.has_value() && object.GetObjectKey(i) == *skip_key) {
+      continue;
+    }
+    members.emplace_back(object.GetObjectKey(i), object.GetObjectValue(i));
+  }
+  return members;
+}
+
+// Implementation of:
+// OBJECT_INSERT(OBJECT, STRING, <any> [, BOOL update_flag]) -> OBJECT
+class ObjectInsertFunction : public SimpleBuiltinScalarFunction {
+ public:
+  ObjectInsertFunction()
+      : SimpleBuiltinScalarFunction(FunctionKind::kObjectInsert,
+                                    types::ObjectType()) {}
+  absl::StatusOr<Value> Eval(absl::Span<const TupleData* const> params,
+                             absl::Span<const Value> args,
+                             EvaluationContext* context) const override;
+};
+
+absl::StatusOr<Value> ObjectInsertFunction::Eval(
+    absl::Span<const TupleData* const> params, absl::Span<const Value> args,
+    EvaluationContext* context) const {
+  ZETASQL_RET_CHECK(args.size() == 3 || args.size() == 4);
+  if (args[0].is_null()) {
+    return Value::NullObject();
+  }
+  if (args[1].is_null()) {
+    return MakeEvalError() << "OBJECT_INSERT key must not be NULL";
+  }
+  const VariantConstRef object = args[0].variant_value();
+  const absl::string_view key = args[1].string_value();
+  const bool update =
+      args.size() == 4 && !args[3].is_null() && args[3].bool_value();
+  const bool exists = object.GetMemberIfExists(key).has_value();
+  if (exists && !update) {
+    return MakeEvalError() << "Duplicate field key '" << key << "'";
+  }
+
+  std::vector<std::pair<absl::string_view, VariantConstRef>> members =
+      GetMembers(object, /*skip_key=*/key);
+  // A NULL value removes the key instead.
+  std::optional<VariantValue> value;
+  if (!args[2].is_null()) {
+    ZETASQL_ASSIGN_OR_RETURN(value, ToVariantValue(args[2]));
+    members.emplace_back(key, value->GetConstRef());
+  }
+  ZETASQL_ASSIGN_OR_RETURN(VariantValue result, VariantValue::Object(members));
+  return Value::Object(std::move(result));
+}
+
+// Implementation of:
+// OBJECT_DELETE(OBJECT, STRING [, STRING ...]) -> OBJECT
+class ObjectDeleteFunction : public SimpleBuiltinScalarFunction {
+ public:
+  ObjectDeleteFunction()
+      : SimpleBuiltinScalarFunction(FunctionKind::kObjectDelete,
+                                    types::ObjectType()) {}
+  absl::StatusOr<Value> Eval(absl::Span<const TupleData* const> params,
+                             absl::Span<const Value> args,
+                             EvaluationContext* context) const override;
+};
+
+absl::StatusOr<Value> ObjectDeleteFunction::Eval(
+    absl::Span<const TupleData* const> params, absl::Span<const Value> args,
+    EvaluationContext* context) const {
+  ZETASQL_RET_CHECK_GE(args.size(), 2);
+  if (args[0].is_null()) {
+    return Value::NullObject();
+  }
+  const VariantConstRef object = args[0].variant_value();
+  std::vector<std::pair<absl::string_view, VariantConstRef>> members;
+  members.reserve(object.GetObjectSize());
+  for (const auto& member : GetMembers(object)) {
+    bool deleted = false;
+    for (const Value& key : args.subspan(1)) {
+      if (!key.is_null() && key.string_value() == member.first) {
+        deleted = true;
+        break;
+      }
+    }
+    if (!deleted) {
+      members.push_back(member);
+    }
+  }
+  ZETASQL_ASSIGN_OR_RETURN(VariantValue result, VariantValue::Object(members));
+  return Value::Object(std::move(result));
+}
+
+// Implementation of:
+// ARRAY_CONSTRUCT([<any> [, ...]]) -> ARRAY<VARIANT>
+// ARRAY_CONSTRUCT_COMPACT([<any> [, ...]]) -> ARRAY<VARIANT>
+class VariantArrayConstructFunction : public SimpleBuiltinScalarFunction {
+ public:
+  VariantArrayConstructFunction(FunctionKind kind, const Type* output_type)
+      : SimpleBuiltinScalarFunction(kind, output_type) {}
+  absl::StatusOr<Value> Eval(absl::Span<const TupleData* const> params,
+                             absl::Span<const Value> args,
+                             EvaluationContext* context) const override;
+};
+
+absl::StatusOr<Value> VariantArrayConstructFunction::Eval(
+    absl::Span<const TupleData* const> params, absl::Span<const Value> args,
+    EvaluationContext* context) const {
+  const bool compact =
+      kind() == FunctionKind::kVariantArrayConstructCompact;
+  std::vector<Value> elements;
+  elements.reserve(args.size());
+  for (const Value& arg : args) {
+    ZETASQL_ASSIGN_OR_RETURN(VariantValue element, ToVariantValue(arg));
+    if (compact && element.GetConstRef().kind() == VariantKind::kNull) {
+      continue;
+    }
+    elements.push_back(Value::Variant(std::move(element)));
+  }
+  return Value::Array(output_type()->AsArray(), elements);
+}
+
+// Implementation of:
+// ARRAY_SIZE(ARRAY<VARIANT>|VARIANT) -> INT64
+class VariantArraySizeFunction : public SimpleBuiltinScalarFunction {
+ public:
+  VariantArraySizeFunction()
+      : SimpleBuiltinScalarFunction(FunctionKind::kVariantArraySize,
+                                    types::Int64Type()) {}
+  absl::StatusOr<Value> Eval(absl::Span<const TupleData* const> params,
+                             absl::Span<const Value> args,
+                             EvaluationContext* context) const override;
+};
+
+absl::StatusOr<Value> VariantArraySizeFunction::Eval(
+    absl::Span<const TupleData* const> params, absl::Span<const Value> args,
+    EvaluationContext* context) const {
+  ZETASQL_RET_CHECK_EQ(args.size(), 1);
+  if (args[0].is_null()) {
+    return Value::NullInt64();
+  }
+  if (args[0].type_kind() == TYPE_ARRAY) {
+    return Value::Int64(args[0].num_elements());
+  }
+  const VariantConstRef variant = args[0].variant_value();
+  if (variant.kind() != VariantKind::kArray) {
+    return Value::NullInt64();
+  }
+  return Value::Int64(variant.GetArraySize());
+}
+
+// Implementation of:
+// GET(ARRAY<VARIANT>|VARIANT, INT64) -> VARIANT
+// GET(OBJECT|VARIANT, STRING) -> VARIANT
+//
+// GET_IGNORE_CASE(<same arguments>) -> VARIANT
+//
+// Missing elements and members, and lookups on values of the wrong kind, are
+// NULL. GET_IGNORE_CASE prefers an exact match of the member name, and
+// otherwise returns the first member, in key order, whose name matches
+// ignoring ASCII case.
+class VariantGetFunction : public SimpleBuiltinScalarFunction {
+ public:
+  explicit VariantGetFunction(FunctionKind kind)
+      : SimpleBuiltinScalarFunction(kind, types::VariantType()) {}
+  absl::StatusOr<Value> Eval(absl::Span<const TupleData* const> params,
+                             absl::Span<const Value> args,
+                             EvaluationContext* context) const override;
+};
+
+absl::StatusOr<Value> VariantGetFunction::Eval(
+    absl::Span<const TupleData* const> params, absl::Span<const Value> args,
+    EvaluationContext* context) const {
+  ZETASQL_RET_CHECK_EQ(args.size(), 2);
+  if (HasNulls(args)) {
+    return Value::NullVariant();
+  }
+  if (args[0].type_kind() == TYPE_ARRAY) {
+    const int64_t index = args[1].int64_value();
+    if (index < 0 || index >= args[0].num_elements()) {
+      return Value::NullVariant();
+    }
+    return args[0].element(static_cast<int>(index));
+  }
+  const VariantConstRef variant = args[0].variant_value();
+  if (args[1].type_kind() == TYPE_INT64) {
+    const int64_t index = args[1].int64_value();
+    if (variant.kind() != VariantKind::kArray || index < 0 ||
+        index >= variant.GetArraySize()) {
+      return Value::NullVariant();
+    }
+    return MakeVariant(variant.GetArrayElement(index));
+  }
+  const absl::string_view key = args[1].string_value();
+  std::optional<VariantConstRef> member = variant.GetMemberIfExists(key);
+  if (member.has_value()) {
+    return MakeVariant(*member);
+  }
+  if (kind() == FunctionKind::kVariantGetIgnoreCase &&
+      variant.kind() == VariantKind::kObject) {
+    for (size_t i = 0; i < variant.GetObjectSize(); ++i) {
+      if (absl::EqualsIgnoreCase(variant.GetObjectKey(i), key)) {
+        return MakeVariant(variant.GetObjectValue(i));
+      }
+    }
+  }
+  return Value::NullVariant();
+}
+
+// One step of a GET_PATH path, either an object member or an array element.
+struct VariantPathElement {
+  std::string key;
+  std::optional<int64_t> index;
+};
+
+// Parses a Snowflake path such as 'a.b[0]["c"].d' into its steps. Member
+// names are case sensitive, and can be double quoted after '.' or quoted in
+// brackets.
+absl::StatusOr<std::vector<VariantPathElement>> ParseVariantPath(
+    absl::string_view path) {
+  auto invalid_path = [&path]() {
+    return MakeEvalError() << "Invalid extraction path '" << path << "'";
+  };
+  // Parses a quoted name starting at path[*pos].
+  auto parse_quoted = [&path](size_t* pos, std::string* name) {
+    const char quote = path[(*pos)++];
+    const size_t end = path.find(quote, *pos);
+    if (end == absl::string_view::npos) {
+      return false;
+    }
+    *name = std::string(path.substr(*pos, end - *pos));
+    *pos = end + 1;
+    return true;
+  };
+
+  std::vector<VariantPathElement> elements;
+  size_t pos = 0;
+  while (pos < path.size()) {
+    VariantPathElement element;
+    if (path[pos] == '[') {
+      ++pos;
+      if (pos < path.size() && (path[pos] == '\'' || path[pos] == '"')) {
+        if (!parse_quoted(&pos, &element.key)) {
+          return invalid_path();
+        }
+      } else {
+        const size_t start = pos;
+        while (pos < path.size() && absl::ascii_isdigit(path[pos])) ++pos;
+        int64_t index;
+        if (!absl::SimpleAtoi(path.substr(start, pos - start), &index)) {
+          return invalid_path();
+        }
+        element.index = index;
+      }
+      if (pos >= path.size() || path[pos] != ']') {
+        return invalid_path();
+      }
+      ++pos;
+    } else {
+      if (!elements.empty()) {
+        if (path[pos] != '.') {
+          return invalid_path();
+        }
+        ++pos;
+      }
+      if (pos < path.size() && path[pos] == '"') {
+        if (!parse_quoted(&pos, &element.key)) {
+          return invalid_path();
+        }
+      } else {
+        const size_t start = pos;
+        while (pos < path.size() && path[pos] != '.' && path[pos] != '[') {
+          ++pos;
+        }
+        if (pos == start) {
+          return invalid_path();
+        }
+        element.key = std::string(path.substr(start, pos - start));
+      }
+    }
+    elements.push_back(std::move(element));
+  }
+  if (elements.empty()) {
+    return invalid_path();
+  }
+  return elements;
+}
+
+// Implementation of:
+// GET_PATH(VARIANT, STRING) -> VARIANT
+class VariantGetPathFunction : public SimpleBuiltinScalarFunction {
+ public:
+  VariantGetPathFunction()
+      : SimpleBuiltinScalarFunction(FunctionKind::kVariantGetPath,
+                                    types::VariantType()) {}
+  absl::StatusOr<Value> Eval(absl::Span<const TupleData* const> params,
+                             absl::Span<const Value> args,
+                             EvaluationContext* context) const override;
+};
+
+absl::StatusOr<Value> VariantGetPathFunction::Eval(
+    absl::Span<const TupleData* const> params, absl::Span<const Value> args,
+    EvaluationContext* context) const {
+  ZETASQL_RET_CHECK_EQ(args.size(), 2);
+  if (HasNulls(args)) {
+    return Value::NullVariant();
+  }
+  ZETASQL_ASSIGN_OR_RETURN(std::vector<VariantPathElement> path,
+                   ParseVariantPath(args[1].string_value()));
+  VariantConstRef current = args[0].variant_value();
+  for (const VariantPathElement& element : path) {
+    if (element.index.has_value()) {
+      if (current.kind() != VariantKind::kArray ||
+          *element.index >= current.GetArraySize()) {
+        return Value::NullVariant();
+      }
+      current = current.GetArrayElement(*element.index);
+    } else {
+      std::optional<VariantConstRef> member =
+          current.GetMemberIfExists(element.key);
+      if (!member.has_value()) {
+        return Value::NullVariant();
+      }
+      current = *member;
+    }
+  }
+  return MakeVariant(current);
+}
+
+// Implementation of IS_<type>(<any>) -> BOOL.
+class VariantIsFunction : public SimpleBuiltinScalarFunction {
+ public:
+  explicit VariantIsFunction(FunctionKind kind)
+      : SimpleBuiltinScalarFunction(kind, types::BoolType()) {}
+  absl::StatusOr<Value> Eval(absl::Span<const TupleData* const> params,
+                             absl::Span<const Value> args,
+                             EvaluationContext* context) const override;
+};
+
+absl::StatusOr<Value> VariantIsFunction::Eval(
+    absl::Span<const TupleData* const> params, absl::Span<const Value> args,
+    EvaluationContext* context) const {
+  ZETASQL_RET_CHECK_EQ(args.size(), 1);
+  if (args[0].is_null()) {
+    return Value::NullBool();
+  }
+  ZETASQL_ASSIGN_OR_RETURN(VariantArg variant, VariantArg::Create(args[0]));
+  const VariantKind variant_kind = variant.get().kind();
+  switch (kind()) {
+    case FunctionKind::kIsNullValue:
+      return Value::Bool(variant_kind == VariantKind::kNull);
+    case FunctionKind::kIsBoolean:
+      return Value::Bool(variant_kind == VariantKind::kBoolean);
+    case FunctionKind::kIsInteger:
+      return Value::Bool(variant_kind == VariantKind::kInteger);
+    case FunctionKind::kIsDecimal:
+      return Value::Bool(variant_kind == VariantKind::kInteger ||
+                         variant_kind == VariantKind::kDecimal);
+    case FunctionKind::kIsDouble:
+      return Value::Bool(variant_kind == VariantKind::kInteger ||
+                         variant_kind == VariantKind::kDecimal ||
+                         variant_kind == VariantKind::kDouble);
+    case FunctionKind::kIsChar:
+      return Value::Bool(variant_kind == VariantKind::kString);
+    case FunctionKind::kIsBinary:
+      return Value::Bool(variant_kind == VariantKind::kBinary);
+    case FunctionKind::kIsDate:
+      return Value::Bool(variant_kind == VariantKind::kDate);
+    case FunctionKind::kIsTime:
+      return Value::Bool(variant_kind == VariantKind::kTime);
+    case FunctionKind::kIsTimestamp:
+      return Value::Bool(variant_kind == VariantKind::kTimestampNtz ||
+                         variant_kind == VariantKind::kTimestampTz);
+    case FunctionKind::kIsArray:
+      return Value::Bool(variant_kind == VariantKind::kArray);
+    case FunctionKind::kIsObject:
+      return Value::Bool(variant_kind == VariantKind::kObject);
+    default:
+      ZETASQL_RET_CHECK_FAIL() << "Unexpected function: " << debug_name();
+  }
+}
+
+// Applies the optional precision and scale of AS_DECIMAL to <value>. Returns
+// NULL if the value does not fit.
+absl::StatusOr<Value> ApplyDecimalPrecisionAndScale(
+    const NumericValue& value, absl::Span<const Value> args) {
+  constexpr int64_t kMaxPrecision = 38;
+  const int64_t precision =
+      args.size() > 1 && !args[1].is_null() ? args[1].int64_value()
+                                            : kMaxPrecision;
+  const int64_t scale =
+      args.size() > 2 && !args[2].is_null() ? args[2].int64_value() : 0;
+  if (precision < 1 || precision > kMaxPrecision) {
+    return MakeEvalError() << "Invalid precision " << precision
+                           << " for AS_DECIMAL";
+  }
+  if (scale < 0 || scale > precision ||
+      scale > NumericValue::kMaxFractionalDigits) {
+    return MakeEvalError() << "Invalid scale " << scale << " for AS_DECIMAL";
+  }
+  absl::StatusOr<NumericValue> rounded = value.Round(scale);
+  if (!rounded.ok()) {
+    return Value::NullNumeric();
+  }
+  const int64_t integer_digits = precision - scale;
+  if (integer_digits < NumericValue::kMaxIntegerDigits) {
+    ZETASQL_ASSIGN_OR_RETURN(NumericValue bound,
+                     NumericValue::FromString(
+                         absl::StrCat("1", std::string(integer_digits, '0'))));
+    if (!(rounded->Abs() < bound)) {
+      return Value::NullNumeric();
+    }
+  }
+  return Value::Numeric(*rounded);
+}
+
+// Implementation of AS_<type>(<any>) -> <type>, which returns NULL unless the
+// value already has the requested type. Numbers are widened, so AS_DOUBLE
+// accepts integers and decimals, and AS_DECIMAL accepts integers.
+class VariantAsFunction : public SimpleBuiltinScalarFunction {
+ public:
+  VariantAsFunction(FunctionKind kind, const Type* output_type)
+      : SimpleBuiltinScalarFunction(kind, output_type) {}
+  absl::StatusOr<Value> Eval(absl::Span<const TupleData* const> params,
+                             absl::Span<const Value> args,
+                             EvaluationContext* context) const override;
+};
+
+absl::StatusOr<Value> VariantAsFunction::Eval(
+    absl::Span<const TupleData* const> params, absl::Span<const Value> args,
+    EvaluationContext* context) const {
+  ZETASQL_RET_CHECK_GE(args.size(), 1);
+  const Value null = Value::Null(output_type());
+  if (args[0].is_null()) {
+    return null;
+  }
+  ZETASQL_ASSIGN_OR_RETURN(VariantArg arg, VariantArg::Create(args[0]));
+  const VariantConstRef variant = arg.get();
+  switch (kind()) {
+    case FunctionKind::kAsBoolean:
+      if (variant.kind() != VariantKind::kBoolean) return null;
+      return Value::Bool(variant.GetBoolean());
+    case FunctionKind::kAsInteger:
+      if (variant.kind() != VariantKind::kInteger) return null;
+      return Value::Int64(variant.GetInteger());
+    case FunctionKind::kAsDecimal:
+      if (variant.kind() == VariantKind::kInteger) {
+        return ApplyDecimalPrecisionAndScale(
+            NumericValue(variant.GetInteger()), args);
+      }
+      if (variant.kind() != VariantKind::kDecimal) return null;
+      return ApplyDecimalPrecisionAndScale(variant.GetDecimal(), args);
+    case FunctionKind::kAsDouble:
+      switch (variant.kind()) {
+        case VariantKind::kInteger:
+          return Value::Double(static_cast<double>(variant.GetInteger()));
+        case VariantKind::kDecimal:
+          return Value::Double(variant.GetDecimal().ToDouble());
+        case VariantKind::kDouble:
+          return Value::Double(variant.GetDouble());
+        default:
+          return null;
+      }
+    case FunctionKind::kAsChar:
+      if (variant.kind() != VariantKind::kString) return null;
+      return Value::String(variant.GetString());
+    case FunctionKind::kAsDate:
+      if (variant.kind() != VariantKind::kDate) return null;
+      return Value::Date(variant.GetDate());
+    case FunctionKind::kAsTime:
+      if (variant.kind() != VariantKind::kTime) return null;
+      return Value::Time(variant.GetTime());
+    case FunctionKind::kAsTimestamp:
+      if (variant.kind() == VariantKind::kTimestampTz) {
+        return Value::Timestamp(variant.GetTimestampTz());
+      }
+      if (variant.kind() == VariantKind::kTimestampNtz) {
+        // TIMESTAMP_NTZ values are wall clock times, read as UTC.
+        absl::Time timestamp;
+        ZETASQL_RETURN_IF_ERROR(functions::ConvertDatetimeToTimestamp(
+            variant.GetTimestampNtz(), absl::UTCTimeZone(), &timestamp));
+        return Value::Timestamp(timestamp);
+      }
+      return null;
+    case FunctionKind::kAsArray:
+      if (variant.kind() != VariantKind::kArray) return null;
+      return MakeVariantArray(output_type(), variant);
+    case FunctionKind::kAsObject:
+      if (variant.kind() != VariantKind::kObject) return null;
+      return Value::Object(VariantValue::CopyFrom(variant));
+    default:
+      ZETASQL_RET_CHECK_FAIL() << "Unexpected function: " << debug_name();
+  }
+}
+
+}  // namespace
+
+void RegisterBuiltinVariantFunctions() {
+  BuiltinFunctionRegistry::RegisterScalarFunction(
+      {FunctionKind::kVariantParseJson, FunctionKind::kVariantTryParseJson,
+       FunctionKind::kVariantCheckJson},
+      [](FunctionKind kind, const Type* output_type) {
+        return new VariantParseJsonFunction(kind, output_type);
+      });
+  BuiltinFunctionRegistry::RegisterScalarFunction(
+      {FunctionKind::kToVariant, FunctionKind::kStripNullValue},
+      [](FunctionKind kind, const Type* output_type) {
+        return new ToVariantFunction(kind);
+      });
+  BuiltinFunctionRegistry::RegisterScalarFunction(
+      {FunctionKind::kVariantToJson},
+      [](FunctionKind kind, const Type* output_type) {
+        return new VariantToJsonFunction();
+      });
+  BuiltinFunctionRegistry::RegisterScalarFunction(
+      {FunctionKind::kToObject},
+      [](FunctionKind kind, const Type* output_type) {
+        return new ToObjectFunction();
+      });
+  BuiltinFunctionRegistry::RegisterScalarFunction(
+      {FunctionKind::kObjectConstruct},
+      [](FunctionKind kind, const Type* output_type) {
+        return new ObjectConstructFunction();
+      });
+  BuiltinFunctionRegistry::RegisterScalarFunction(
+      {FunctionKind::kObjectInsert},
+      [](FunctionKind kind, const Type* output_type) {
+        return new ObjectInsertFunction();
+      });
+  BuiltinFunctionRegistry::RegisterScalarFunction(
+      {FunctionKind::kObjectDelete},
+      [](FunctionKind kind, const Type* output_type) {
+        return new ObjectDeleteFunction();
+      });
+  BuiltinFunctionRegistry::RegisterScalarFunction(
+      {FunctionKind::kVariantArrayConstruct,
+       FunctionKind::kVariantArrayConstructCompact},
+      [](FunctionKind kind, const Type* output_type) {
+        return new VariantArrayConstructFunction(kind, output_type);
+      });
+  BuiltinFunctionRegistry::RegisterScalarFunction(
+      {FunctionKind::kVariantArraySize},
+      [](FunctionKind kind, const Type* output_type) {
+        return new VariantArraySizeFunction();
+      });
+  BuiltinFunctionRegistry::RegisterScalarFunction(
+      {FunctionKind::kVariantGet, FunctionKind::kVariantGetIgnoreCase},
+      [](FunctionKind kind, const Type* output_type) {
+        return new VariantGetFunction(kind);
+      });
+  BuiltinFunctionRegistry::RegisterScalarFunction(
+      {FunctionKind::kVariantGetPath},
+      [](FunctionKind kind, const Type* output_type) {
+        return new VariantGetPathFunction();
+      });
+  BuiltinFunctionRegistry::RegisterScalarFunction(
+      {FunctionKind::kIsNullValue, FunctionKind::kIsBoolean,
+       FunctionKind::kIsInteger, FunctionKind::kIsDecimal,
+       FunctionKind::kIsDouble, FunctionKind::kIsChar, FunctionKind::kIsBinary,
+       FunctionKind::kIsDate, FunctionKind::kIsTime, FunctionKind::kIsTimestamp,
+       FunctionKind::kIsArray, FunctionKind::kIsObject},
+      [](FunctionKind kind, const Type* output_type) {
+        return new VariantIsFunction(kind);
+      });
+  BuiltinFunctionRegistry::RegisterScalarFunction(
+      {FunctionKind::kAsBoolean, FunctionKind::kAsInteger,
+       FunctionKind::kAsDecimal, FunctionKind::kAsDouble, FunctionKind::kAsChar,
+       FunctionKind::kAsDate, FunctionKind::kAsTime, FunctionKind::kAsTimestamp,
+       FunctionKind::kAsArray, FunctionKind::kAsObject},
+      [](FunctionKind kind, const Type* output_type) {
+        return new VariantAsFunction(kind, output_type);
+      });
+}
+
+}  // namespace zetasql
@@ -0,0 +1,32 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef ZETASQL_REFERENCE_IMPL_FUNCTIONS_VARIANT_H_
+#define ZETASQL_REFERENCE_IMPL_FUNCTIONS_VARIANT_H_
+
+namespace zetasql {
+
+// This module registers implementations for the Snowflake semi-structured
+// functions over VARIANT, OBJECT and ARRAY<VARIANT>: PARSE_JSON,
+// TRY_PARSE_JSON, CHECK_JSON, TO_JSON, TO_VARIANT, TO_OBJECT,
+// OBJECT_CONSTRUCT, OBJECT_INSERT, OBJECT_DELETE, ARRAY_CONSTRUCT,
+// ARRAY_CONSTRUCT_COMPACT, ARRAY_SIZE, GET, GET_PATH, STRIP_NULL_VALUE, and the
+// IS_<type> and AS_<type> functions.
+void RegisterBuiltinVariantFunctions();
+
+}  // namespace zetasql
+
+#endif  // ZETASQL_REFERENCE_IMPL_FUNCTIONS_VARIANT_H_
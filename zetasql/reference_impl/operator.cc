@@ -27,6 +27,7 @@
 #include "absl/base/attributes.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
+#include "absl/time/time.h"
 #include "zetasql/base/stl_util.h"
 
 namespace zetasql {
@@ -209,6 +210,63 @@ AlgebraArg* AlgebraNode::GetMutableArg(int kind) {
   }
 }
 
+namespace {
+
+// Appends the relational operators nested in the arguments of <node> to
+// <*ops>, without descending into the operators themselves.
+void CollectChildRelationalOps(const AlgebraNode& node,
+                               std::vector<const RelationalOp*>* ops) {
+  for (const AlgebraArg* arg : node.GetArgs()) {
+    if (!arg->has_node()) continue;
+    if (const RelationalOp* op = arg->node()->AsRelationalOp();
+        op != nullptr) {
+      ops->push_back(op);
+    } else {
+      CollectChildRelationalOps(*arg->node(), ops);
+    }
+  }
+}
+
+void AppendOperatorProfile(const RelationalOp& op,
+                           const OperatorProfile& profile,
+                           const std::string& indent, std::string* output) {
+  // The name of the operator is the start of its debug string.
+  const std::string debug_string = op.DebugInternal("", /*verbose=*/false);
+  absl::StrAppend(output, indent,
+                  debug_string.substr(0, debug_string.find('(')), ":");
+  const OperatorProfile::Stats* stats = profile.GetStats(&op);
+  if (stats == nullptr) {
+    absl::StrAppend(output, " not evaluated");
+  } else {
+    absl::StrAppend(output, " iterators=", stats->num_iterators,
+                    " rows=", stats->num_rows,
+                    " wall=", absl::FormatDuration(stats->wall_time),
+                    " cpu=", absl::FormatDuration(stats->cpu_time),
+                    " peak_memory_bytes=", stats->peak_memory_bytes);
+    if (stats->max_hash_table_size > 0) {
+      absl::StrAppend(output, " hash_table_size=", stats->max_hash_table_size);
+    }
+  }
+  absl::StrAppend(output, "\n");
+
+  std::vector<const RelationalOp*> children;
+  CollectChildRelationalOps(op, &children);
+  for (const RelationalOp* child : children) {
+    AppendOperatorProfile(*child, profile,
+                          absl::StrCat(indent, AlgebraNode::kIndentSpace),
+                          output);
+  }
+}
+
+}  // namespace
+
+std::string OperatorProfileDebugString(const RelationalOp& root,
+                                       const OperatorProfile& profile) {
+  std::string output;
+  AppendOperatorProfile(root, profile, /*indent=*/"", &output);
+  return output;
+}
+
 std::string AlgebraNode::DebugString(bool verbose) const {
   return this->DebugInternal("\n", verbose);
 }
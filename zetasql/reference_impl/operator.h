@@ -1211,9 +1211,12 @@ class RelationalOp : public AlgebraNode {
   // wraps it in a PassThroughTupleIterator to allow for cancellation while it
   // is running. This method is only public for internal purposes. Users should
   // call Eval() instead.
-  virtual absl::StatusOr<std::unique_ptr<TupleIterator>> CreateIterator(
+  //
+  // If 'context' has an OperatorProfile, records the iterators created for
+  // this operator and the rows they produce in it.
+  absl::StatusOr<std::unique_ptr<TupleIterator>> CreateIterator(
       absl::Span<const TupleData* const> params, int num_extra_slots,
-      EvaluationContext* context) const = 0;
+      EvaluationContext* context) const;
 
   // Returns a copy of the output schema of the TupleIterator corresponding to
   // this operator.
@@ -1243,6 +1246,12 @@ class RelationalOp : public AlgebraNode {
   virtual bool may_preserve_order() const { return false; }
 
  protected:
+  // Implements CreateIterator() for the operator.
+  virtual absl::StatusOr<std::unique_ptr<TupleIterator>>
+  CreateIteratorInternal(absl::Span<const TupleData* const> params,
+                         int num_extra_slots,
+                         EvaluationContext* context) const = 0;
+
   // Depending on the EvaluationOptions in 'context', either returns 'iter' or a
   // ReorderingTupleIterator that wraps 'iter'.
   absl::StatusOr<std::unique_ptr<TupleIterator>> MaybeReorder(
@@ -1253,6 +1262,13 @@ class RelationalOp : public AlgebraNode {
   bool is_order_preserving_ = false;
 };
 
+// Returns the tree of relational operators under <root>, including those
+// nested in expressions such as subqueries, with the statistics recorded for
+// each of them in <profile>. Each line shows one operator, indented under the
+// operator that consumes its rows.
+std::string OperatorProfileDebugString(const RelationalOp& root,
+                                       const OperatorProfile& profile);
+
 // -------------------------------------------------------
 // Relational operators
 // -------------------------------------------------------
@@ -1282,7 +1298,7 @@ class EvaluatorTableScanOp final : public RelationalOp {
   absl::Status SetSchemasForEvaluation(
       absl::Span<const TupleSchema* const> params_schemas) override;
 
-  absl::StatusOr<std::unique_ptr<TupleIterator>> CreateIterator(
+  absl::StatusOr<std::unique_ptr<TupleIterator>> CreateIteratorInternal(
       absl::Span<const TupleData* const> params, int num_extra_slots,
       EvaluationContext* context) const override;
 
@@ -1331,7 +1347,7 @@ class LetOp final : public RelationalOp {
   absl::Status SetSchemasForEvaluation(
       absl::Span<const TupleSchema* const> params_schemas) override;
 
-  absl::StatusOr<std::unique_ptr<TupleIterator>> CreateIterator(
+  absl::StatusOr<std::unique_ptr<TupleIterator>> CreateIteratorInternal(
       absl::Span<const TupleData* const> params, int num_extra_slots,
       EvaluationContext* context) const override;
 
@@ -1409,6 +1425,24 @@ class JoinOp final : public RelationalOp {
     std::unique_ptr<ExprArg> right_expr;
   };
 
+  // Represents a range restriction in the join condition on an expression of
+  // the right-hand side, whose bounds are determined by the left-hand side.
+  // The algebrizer extracts this from inequality and BETWEEN conjuncts when
+  // there are no HashJoinEqualityExprs. The right-hand side is then sorted on
+  // 'right_expr' and only the tuples in [lower_bound, upper_bound] are
+  // considered for each left tuple. The bounds are inclusive and the
+  // conjuncts they came from remain in the join condition, so they only need
+  // to admit every tuple that can join. A NULL bound admits no tuples.
+  //
+  // 'right_expr' and the bounds must all have the same type, which must be one
+  // for which Value::LessThan() agrees with SQL comparison. At least one of
+  // the bounds must be set.
+  struct RangeJoinExprs {
+    std::unique_ptr<ExprArg> right_expr;
+    std::unique_ptr<ExprArg> lower_bound;
+    std::unique_ptr<ExprArg> upper_bound;
+  };
+
   JoinOp(const JoinOp&) = delete;
   JoinOp& operator=(const JoinOp&) = delete;
 
@@ -1418,18 +1452,21 @@ class JoinOp final : public RelationalOp {
       JoinKind join_kind, absl::string_view left_input_debug_string,
       absl::string_view right_input_debug_string);
 
-  // 'equality_exprs' must be empty for cross/outer apply.
+  // 'equality_exprs' must be empty for cross/outer apply. 'range_exprs' is
+  // unset if its 'right_expr' is NULL, and can only be set if
+  // 'equality_exprs' is empty and the join is not a cross/outer apply.
   static absl::StatusOr<std::unique_ptr<JoinOp>> Create(
       JoinKind kind, std::vector<HashJoinEqualityExprs> equality_exprs,
       std::unique_ptr<ValueExpr> remaining_condition,
       std::unique_ptr<RelationalOp> left, std::unique_ptr<RelationalOp> right,
       std::vector<std::unique_ptr<ExprArg>> left_outputs,
-      std::vector<std::unique_ptr<ExprArg>> right_outputs);
+      std::vector<std::unique_ptr<ExprArg>> right_outputs,
+      RangeJoinExprs range_exprs = {});
 
   absl::Status SetSchemasForEvaluation(
       absl::Span<const TupleSchema* const> params_schemas) override;
 
-  absl::StatusOr<std::unique_ptr<TupleIterator>> CreateIterator(
+  absl::StatusOr<std::unique_ptr<TupleIterator>> CreateIteratorInternal(
       absl::Span<const TupleData* const> params, int num_extra_slots,
       EvaluationContext* context) const override;
 
@@ -1449,6 +1486,9 @@ class JoinOp final : public RelationalOp {
     kRightOutput,
     kHashJoinEqualityLeftExprs,
     kHashJoinEqualityRightExprs,
+    kRangeJoinRightExpr,
+    kRangeJoinLowerBound,
+    kRangeJoinUpperBound,
     kRemainingCondition,
     kLeftInput,
     kRightInput
@@ -1457,6 +1497,7 @@ class JoinOp final : public RelationalOp {
   JoinOp(JoinKind kind,
          std::vector<std::unique_ptr<ExprArg>> hash_join_equality_left_exprs,
          std::vector<std::unique_ptr<ExprArg>> hash_join_equality_right_exprs,
+         RangeJoinExprs range_exprs,
          std::unique_ptr<ValueExpr> remaining_condition,
          std::unique_ptr<RelationalOp> left,
          std::unique_ptr<RelationalOp> right,
@@ -1469,6 +1510,16 @@ class JoinOp final : public RelationalOp {
   absl::Span<const ExprArg* const> hash_join_equality_right_exprs() const;
   absl::Span<ExprArg* const> mutable_hash_join_equality_right_exprs();
 
+  // The range join expressions return NULL if not set.
+  const ExprArg* range_join_right_expr() const;
+  ExprArg* mutable_range_join_right_expr();
+
+  const ExprArg* range_join_lower_bound() const;
+  ExprArg* mutable_range_join_lower_bound();
+
+  const ExprArg* range_join_upper_bound() const;
+  ExprArg* mutable_range_join_upper_bound();
+
   const ValueExpr* remaining_join_expr() const;
   ValueExpr* mutable_remaining_join_expr();
 
@@ -1507,7 +1558,7 @@ class AggregateOp final : public RelationalOp {
   absl::Status SetSchemasForEvaluation(
       absl::Span<const TupleSchema* const> params_schemas) override;
 
-  absl::StatusOr<std::unique_ptr<TupleIterator>> CreateIterator(
+  absl::StatusOr<std::unique_ptr<TupleIterator>> CreateIteratorInternal(
       absl::Span<const TupleData* const> params, int num_extra_slots,
       EvaluationContext* context) const override;
 
@@ -1553,7 +1604,7 @@ class GroupRowsOp : public RelationalOp {
   absl::Status SetSchemasForEvaluation(
       absl::Span<const TupleSchema* const> params_schemas) override;
 
-  absl::StatusOr<std::unique_ptr<TupleIterator>> CreateIterator(
+  absl::StatusOr<std::unique_ptr<TupleIterator>> CreateIteratorInternal(
       absl::Span<const TupleData* const> params, int num_extra_slots,
       EvaluationContext* context) const override;
 
@@ -1602,7 +1653,7 @@ class AnalyticOp final : public RelationalOp {
   absl::Status SetSchemasForEvaluation(
       absl::Span<const TupleSchema* const> params_schemas) override;
 
-  absl::StatusOr<std::unique_ptr<TupleIterator>> CreateIterator(
+  absl::StatusOr<std::unique_ptr<TupleIterator>> CreateIteratorInternal(
       absl::Span<const TupleData* const> params, int num_extra_slots,
       EvaluationContext* context) const override;
 
@@ -1669,7 +1720,7 @@ class SortOp final : public RelationalOp {
   absl::Status SetSchemasForEvaluation(
       absl::Span<const TupleSchema* const> params_schemas) override;
 
-  absl::StatusOr<std::unique_ptr<TupleIterator>> CreateIterator(
+  absl::StatusOr<std::unique_ptr<TupleIterator>> CreateIteratorInternal(
       absl::Span<const TupleData* const> params, int num_extra_slots,
       EvaluationContext* context) const override;
 
@@ -1754,7 +1805,7 @@ class ArrayScanOp final : public RelationalOp {
   absl::Status SetSchemasForEvaluation(
       absl::Span<const TupleSchema* const> params_schemas) override;
 
-  absl::StatusOr<std::unique_ptr<TupleIterator>> CreateIterator(
+  absl::StatusOr<std::unique_ptr<TupleIterator>> CreateIteratorInternal(
       absl::Span<const TupleData* const> params, int num_extra_slots,
       EvaluationContext* context) const override;
 
@@ -1816,7 +1867,7 @@ class DistinctOp final : public RelationalOp {
   absl::Status SetSchemasForEvaluation(
       absl::Span<const TupleSchema* const> params_schemas) override;
 
-  absl::StatusOr<std::unique_ptr<TupleIterator>> CreateIterator(
+  absl::StatusOr<std::unique_ptr<TupleIterator>> CreateIteratorInternal(
       absl::Span<const TupleData* const> params, int num_extra_slots,
       EvaluationContext* context) const override;
 
@@ -1863,7 +1914,7 @@ class UnionAllOp final : public RelationalOp {
   absl::Status SetSchemasForEvaluation(
       absl::Span<const TupleSchema* const> params_schemas) override;
 
-  absl::StatusOr<std::unique_ptr<TupleIterator>> CreateIterator(
+  absl::StatusOr<std::unique_ptr<TupleIterator>> CreateIteratorInternal(
       absl::Span<const TupleData* const> params, int num_extra_slots,
       EvaluationContext* context) const override;
 
@@ -1933,7 +1984,7 @@ class LoopOp final : public RelationalOp {
   absl::Status SetSchemasForEvaluation(
       absl::Span<const TupleSchema* const> params_schemas) override;
 
-  absl::StatusOr<std::unique_ptr<TupleIterator>> CreateIterator(
+  absl::StatusOr<std::unique_ptr<TupleIterator>> CreateIteratorInternal(
       absl::Span<const TupleData* const> params, int num_extra_slots,
       EvaluationContext* context) const override;
 
@@ -1994,10 +2045,19 @@ class ComputeOp final : public RelationalOp {
       std::vector<std::unique_ptr<ExprArg>> map,
       std::unique_ptr<RelationalOp> input);
 
+  // Like Create(), for the ComputeOp that maps the output columns of the WITH
+  // entry <with_query_name> to those of its only reference, where 'input' is
+  // the inlined definition of the entry. The name of the entry shows up in the
+  // debug string.
+  static absl::StatusOr<std::unique_ptr<ComputeOp>> CreateForInlinedWithEntry(
+      absl::string_view with_query_name,
+      std::vector<std::unique_ptr<ExprArg>> map,
+      std::unique_ptr<RelationalOp> input);
+
   absl::Status SetSchemasForEvaluation(
       absl::Span<const TupleSchema* const> params_schemas) override;
 
-  absl::StatusOr<std::unique_ptr<TupleIterator>> CreateIterator(
+  absl::StatusOr<std::unique_ptr<TupleIterator>> CreateIteratorInternal(
       absl::Span<const TupleData* const> params, int num_extra_slots,
       EvaluationContext* context) const override;
 
@@ -2021,6 +2081,9 @@ class ComputeOp final : public RelationalOp {
 
   const RelationalOp* input() const;
   RelationalOp* mutable_input();
+
+  // Set by CreateForInlinedWithEntry(). Only used for debugging.
+  std::string inlined_with_entry_;
 };
 
 // Discards tuples of 'input' on which 'predicate' evaluates to false or NULL.
@@ -2039,7 +2102,7 @@ class FilterOp final : public RelationalOp {
   absl::Status SetSchemasForEvaluation(
       absl::Span<const TupleSchema* const> params_schemas) override;
 
-  absl::StatusOr<std::unique_ptr<TupleIterator>> CreateIterator(
+  absl::StatusOr<std::unique_ptr<TupleIterator>> CreateIteratorInternal(
       absl::Span<const TupleData* const> params, int num_extra_slots,
       EvaluationContext* context) const override;
 
@@ -2081,7 +2144,7 @@ class LimitOp final : public RelationalOp {
   absl::Status SetSchemasForEvaluation(
       absl::Span<const TupleSchema* const> params_schemas) override;
 
-  absl::StatusOr<std::unique_ptr<TupleIterator>> CreateIterator(
+  absl::StatusOr<std::unique_ptr<TupleIterator>> CreateIteratorInternal(
       absl::Span<const TupleData* const> params, int num_extra_slots,
       EvaluationContext* context) const override;
 
@@ -2142,7 +2205,7 @@ class SampleScanOp final : public RelationalOp {
   absl::Status SetSchemasForEvaluation(
       absl::Span<const TupleSchema* const> params_schemas) override;
 
-  absl::StatusOr<std::unique_ptr<TupleIterator>> CreateIterator(
+  absl::StatusOr<std::unique_ptr<TupleIterator>> CreateIteratorInternal(
       absl::Span<const TupleData* const> params, int num_extra_slots,
       EvaluationContext* context) const override;
 
@@ -2208,7 +2271,7 @@ class EnumerateOp final : public RelationalOp {
   absl::Status SetSchemasForEvaluation(
       absl::Span<const TupleSchema* const> params_schemas) override;
 
-  absl::StatusOr<std::unique_ptr<TupleIterator>> CreateIterator(
+  absl::StatusOr<std::unique_ptr<TupleIterator>> CreateIteratorInternal(
       absl::Span<const TupleData* const> params, int num_extra_slots,
       EvaluationContext* context) const override;
 
@@ -2271,6 +2334,11 @@ class DerefExpr final : public ValueExpr {
 
   const VariableId& name() const { return name_; }
 
+  // The location of the variable in the 'params' passed to Eval(). Set by
+  // SetSchemasForEvaluation().
+  int idx_in_params() const { return idx_in_params_; }
+  int slot() const { return slot_; }
+
   absl::Status SetSchemasForEvaluation(
       absl::Span<const TupleSchema* const> params_schemas) override;
 
@@ -2635,6 +2703,12 @@ class ConstExpr final : public ValueExpr {
 
   static absl::StatusOr<std::unique_ptr<ConstExpr>> Create(const Value& value);
 
+  // Creates a ConstExpr for 'value', which the algebrizer computed ahead of
+  // time by evaluating the expression described by 'folded_from'.
+  // 'folded_from' only appears in the debug string.
+  static absl::StatusOr<std::unique_ptr<ConstExpr>> CreateFolded(
+      const Value& value, std::string folded_from);
+
   absl::Status SetSchemasForEvaluation(
       absl::Span<const TupleSchema* const> params_schemas) override;
 
@@ -2653,9 +2727,11 @@ class ConstExpr final : public ValueExpr {
   const TupleSlot& slot_test_only() const { return slot_; }
 
  private:
-  explicit ConstExpr(const Value& value);
+  ConstExpr(const Value& value, std::string folded_from);
 
   TupleSlot slot_;
+  // Empty unless the value was computed by constant folding.
+  const std::string folded_from_;
 };
 
 // Produces a single value from the variable ranging over the given 'input'
@@ -2873,6 +2949,9 @@ class ScalarFunctionCallExpr final : public ValueExpr {
   std::string DebugInternal(const std::string& indent,
                             bool verbose) const override;
 
+  const ScalarFunctionBody* function() const { return function_.get(); }
+  ResolvedFunctionCallBase::ErrorMode error_mode() const { return error_mode_; }
+
  private:
   enum ArgKind { kArgument };
 
@@ -2891,8 +2970,6 @@ class ScalarFunctionCallExpr final : public ValueExpr {
   ScalarFunctionCallExpr(const ScalarFunctionCallExpr&) = delete;
   ScalarFunctionCallExpr& operator=(const ScalarFunctionCallExpr&) = delete;
 
-  const ScalarFunctionBody* function() const { return function_.get(); }
-
   std::unique_ptr<const ScalarFunctionBody> function_;
   const ResolvedFunctionCallBase::ErrorMode error_mode_;
 };
@@ -3061,6 +3138,11 @@ class IfExpr final : public ValueExpr {
   std::string DebugInternal(const std::string& indent,
                             bool verbose) const override;
 
+  // Returns the condition.
+  const ValueExpr* join_expr() const;
+  const ValueExpr* true_value() const;
+  const ValueExpr* false_value() const;
+
  private:
   enum ArgKind { kCondition, kTrueValue, kFalseValue };
 
@@ -3068,13 +3150,8 @@ class IfExpr final : public ValueExpr {
          std::unique_ptr<ValueExpr> true_value,
          std::unique_ptr<ValueExpr> false_value);
 
-  const ValueExpr* join_expr() const;
   ValueExpr* mutable_join_expr();
-
-  const ValueExpr* true_value() const;
   ValueExpr* mutable_true_value();
-
-  const ValueExpr* false_value() const;
   ValueExpr* mutable_false_value();
 };
 
@@ -3995,7 +4072,7 @@ class RootOp final : public RelationalOp {
   absl::Status SetSchemasForEvaluation(
       absl::Span<const TupleSchema* const> params_schemas) override;
 
-  absl::StatusOr<std::unique_ptr<TupleIterator>> CreateIterator(
+  absl::StatusOr<std::unique_ptr<TupleIterator>> CreateIteratorInternal(
       absl::Span<const TupleData* const> params, int num_extra_slots,
       EvaluationContext* context) const override;
 
@@ -4040,14 +4117,15 @@ class RootExpr final : public ValueExpr {
   std::string DebugInternal(const std::string& indent,
                             bool verbose) const override;
 
+  // Returns the ValueExpr passed to the constructor.
+  const ValueExpr* value_expr() const;
+
  private:
   enum ArgKind { kValueExpr };
 
   RootExpr(std::unique_ptr<ValueExpr> value_expr,
            std::unique_ptr<RootData> root_data);
 
-  // Returns the ValueExpr passed to the constructor.
-  const ValueExpr* value_expr() const;
   ValueExpr* mutable_value_expr();
 
   std::unique_ptr<RootData> root_data_;
@@ -19,6 +19,7 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <ctime>
 #include <map>
 #include <memory>
 #include <optional>
@@ -53,6 +54,8 @@
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "absl/types/optional.h"
 #include "absl/types/span.h"
 #include "zetasql/base/source_location.h"
@@ -88,6 +91,110 @@ absl::Status RelationalOp::set_is_order_preserving(bool is_order_preserving) {
   return absl::OkStatus();
 }
 
+namespace {
+
+// Adds the time spent and the memory charged to the MemoryAccountant during its
+// lifetime to an OperatorProfile::Stats.
+class ScopedOperatorProfiler {
+ public:
+  // 'baseline_remaining_bytes' is the number of bytes that were available from
+  // the MemoryAccountant when the iterator being profiled was created.
+  ScopedOperatorProfiler(OperatorProfile::Stats* stats,
+                         const MemoryAccountant* accountant,
+                         int64_t baseline_remaining_bytes)
+      : stats_(stats),
+        accountant_(accountant),
+        baseline_remaining_bytes_(baseline_remaining_bytes),
+        start_wall_time_(absl::Now()),
+        start_cpu_time_(std::clock()) {}
+
+  ScopedOperatorProfiler(const ScopedOperatorProfiler&) = delete;
+  ScopedOperatorProfiler& operator=(const ScopedOperatorProfiler&) = delete;
+
+  ~ScopedOperatorProfiler() {
+    stats_->wall_time += absl::Now() - start_wall_time_;
+    stats_->cpu_time += absl::Seconds(
+        static_cast<double>(std::clock() - start_cpu_time_) / CLOCKS_PER_SEC);
+    stats_->peak_memory_bytes =
+        std::max(stats_->peak_memory_bytes,
+                 baseline_remaining_bytes_ - accountant_->remaining_bytes());
+  }
+
+ private:
+  OperatorProfile::Stats* stats_;
+  const MemoryAccountant* accountant_;
+  const int64_t baseline_remaining_bytes_;
+  const absl::Time start_wall_time_;
+  const std::clock_t start_cpu_time_;
+};
+
+// Passes through the tuples of another iterator, recording them and the time
+// spent producing them in an OperatorProfile::Stats.
+class ProfilingTupleIterator : public TupleIterator {
+ public:
+  ProfilingTupleIterator(std::unique_ptr<TupleIterator> iter,
+                         OperatorProfile::Stats* stats,
+                         const MemoryAccountant* accountant,
+                         int64_t baseline_remaining_bytes)
+      : iter_(std::move(iter)),
+        stats_(stats),
+        accountant_(accountant),
+        baseline_remaining_bytes_(baseline_remaining_bytes) {}
+
+  const TupleSchema& Schema() const override { return iter_->Schema(); }
+
+  TupleData* Next() override {
+    ScopedOperatorProfiler profiler(stats_, accountant_,
+                                    baseline_remaining_bytes_);
+    TupleData* data = iter_->Next();
+    if (data != nullptr) {
+      ++stats_->num_rows;
+    }
+    return data;
+  }
+
+  absl::Status Status() const override { return iter_->Status(); }
+
+  bool PreservesOrder() const override { return iter_->PreservesOrder(); }
+
+  absl::Status DisableReordering() override {
+    return iter_->DisableReordering();
+  }
+
+  std::string DebugString() const override { return iter_->DebugString(); }
+
+ private:
+  const std::unique_ptr<TupleIterator> iter_;
+  OperatorProfile::Stats* stats_;
+  const MemoryAccountant* accountant_;
+  const int64_t baseline_remaining_bytes_;
+};
+
+}  // namespace
+
+absl::StatusOr<std::unique_ptr<TupleIterator>> RelationalOp::CreateIterator(
+    absl::Span<const TupleData* const> params, int num_extra_slots,
+    EvaluationContext* context) const {
+  OperatorProfile* profile = context->operator_profile();
+  if (profile == nullptr) {
+    return CreateIteratorInternal(params, num_extra_slots, context);
+  }
+
+  OperatorProfile::Stats* stats = profile->GetMutableStats(this);
+  ++stats->num_iterators;
+  const MemoryAccountant* accountant = context->memory_accountant();
+  const int64_t baseline_remaining_bytes = accountant->remaining_bytes();
+  std::unique_ptr<TupleIterator> iter;
+  {
+    ScopedOperatorProfiler profiler(stats, accountant,
+                                    baseline_remaining_bytes);
+    ZETASQL_ASSIGN_OR_RETURN(iter,
+                     CreateIteratorInternal(params, num_extra_slots, context));
+  }
+  return std::make_unique<ProfilingTupleIterator>(
+      std::move(iter), stats, accountant, baseline_remaining_bytes);
+}
+
 absl::StatusOr<std::unique_ptr<TupleIterator>> RelationalOp::Eval(
     absl::Span<const TupleData* const> params, int num_extra_slots,
     EvaluationContext* context) const {
@@ -516,9 +623,9 @@ class EvaluatorTableTupleIterator : public TupleIterator {
 }  // namespace
 
 absl::StatusOr<std::unique_ptr<TupleIterator>>
-EvaluatorTableScanOp::CreateIterator(absl::Span<const TupleData* const> params,
-                                     int num_extra_slots,
-                                     EvaluationContext* context) const {
+EvaluatorTableScanOp::CreateIteratorInternal(
+    absl::Span<const TupleData* const> params, int num_extra_slots,
+    EvaluationContext* context) const {
   std::optional<absl::Time> read_time;
   if (read_time_ != nullptr) {
     std::shared_ptr<TupleSlot::SharedProtoState> shared_state;
@@ -735,7 +842,8 @@ class LetOpTupleIterator : public TupleIterator {
 };
 }  // namespace
 
-absl::StatusOr<std::unique_ptr<TupleIterator>> LetOp::CreateIterator(
+absl::StatusOr<std::unique_ptr<TupleIterator>>
+LetOp::CreateIteratorInternal(
     absl::Span<const TupleData* const> params, int num_extra_slots,
     EvaluationContext* context) const {
   // Initialize 'all_params' with 'params', then extend 'all_params' with new
@@ -1015,7 +1123,8 @@ class SortTupleIterator : public TupleIterator {
 };
 }  // namespace
 
-absl::StatusOr<std::unique_ptr<TupleIterator>> SortOp::CreateIterator(
+absl::StatusOr<std::unique_ptr<TupleIterator>>
+SortOp::CreateIteratorInternal(
     absl::Span<const TupleData* const> params, int num_extra_slots,
     EvaluationContext* context) const {
   Value limit_value;   // Invalid if no limit set.
@@ -1298,6 +1407,16 @@ absl::StatusOr<std::unique_ptr<ComputeOp>> ComputeOp::Create(
   return absl::WrapUnique(new ComputeOp(std::move(map), std::move(input)));
 }
 
+absl::StatusOr<std::unique_ptr<ComputeOp>> ComputeOp::CreateForInlinedWithEntry(
+    absl::string_view with_query_name,
+    std::vector<std::unique_ptr<ExprArg>> map,
+    std::unique_ptr<RelationalOp> input) {
+  ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<ComputeOp> op,
+                   Create(std::move(map), std::move(input)));
+  op->inlined_with_entry_ = std::string(with_query_name);
+  return op;
+}
+
 absl::Status ComputeOp::SetSchemasForEvaluation(
     absl::Span<const TupleSchema* const> params_schemas) {
   ZETASQL_RETURN_IF_ERROR(mutable_input()->SetSchemasForEvaluation(params_schemas));
@@ -1390,7 +1509,8 @@ class ComputeTupleIterator : public TupleIterator {
 };
 }  // namespace
 
-absl::StatusOr<std::unique_ptr<TupleIterator>> ComputeOp::CreateIterator(
+absl::StatusOr<std::unique_ptr<TupleIterator>>
+ComputeOp::CreateIteratorInternal(
     absl::Span<const TupleData* const> params, int num_extra_slots,
     EvaluationContext* context) const {
   ZETASQL_ASSIGN_OR_RETURN(
@@ -1418,8 +1538,11 @@ std::string ComputeOp::IteratorDebugString() const {
 std::string ComputeOp::DebugInternal(const std::string& indent,
                                      bool verbose) const {
   return absl::StrCat(
-      "ComputeOp(", ArgDebugString({"map", "input"}, {kN, k1}, indent, verbose),
-      ")");
+      "ComputeOp(",
+      inlined_with_entry_.empty()
+          ? ""
+          : absl::StrCat("inlined_with_entry=", inlined_with_entry_),
+      ArgDebugString({"map", "input"}, {kN, k1}, indent, verbose), ")");
 }
 
 ComputeOp::ComputeOp(std::vector<std::unique_ptr<ExprArg>> map,
@@ -1525,7 +1648,8 @@ class FilterTupleIterator : public TupleIterator {
 };
 }  // namespace
 
-absl::StatusOr<std::unique_ptr<TupleIterator>> FilterOp::CreateIterator(
+absl::StatusOr<std::unique_ptr<TupleIterator>>
+FilterOp::CreateIteratorInternal(
     absl::Span<const TupleData* const> params, int num_extra_slots,
     EvaluationContext* context) const {
   ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<TupleIterator> iter,
@@ -1691,7 +1815,8 @@ class LimitTupleIterator : public TupleIterator {
 };
 }  // namespace
 
-absl::StatusOr<std::unique_ptr<TupleIterator>> LimitOp::CreateIterator(
+absl::StatusOr<std::unique_ptr<TupleIterator>>
+LimitOp::CreateIteratorInternal(
     absl::Span<const TupleData* const> params, int num_extra_slots,
     EvaluationContext* context) const {
   TupleSlot count_slot;
@@ -2089,7 +2214,8 @@ class ReservoirSampleScanTupleIterator : public SampleScanTupleIteratorBase {
 };
 }  // namespace
 
-absl::StatusOr<std::unique_ptr<TupleIterator>> SampleScanOp::CreateIterator(
+absl::StatusOr<std::unique_ptr<TupleIterator>>
+SampleScanOp::CreateIteratorInternal(
     absl::Span<const TupleData* const> params, int num_extra_slots,
     EvaluationContext* context) const {
   absl::Status status;
@@ -2340,7 +2466,8 @@ class EnumerateTupleIterator : public TupleIterator {
 };
 }  // namespace
 
-absl::StatusOr<std::unique_ptr<TupleIterator>> EnumerateOp::CreateIterator(
+absl::StatusOr<std::unique_ptr<TupleIterator>>
+EnumerateOp::CreateIteratorInternal(
     absl::Span<const TupleData* const> params, int num_extra_slots,
     EvaluationContext* context) const {
   TupleSlot count_slot;
@@ -2404,12 +2531,35 @@ absl::StatusOr<std::unique_ptr<JoinOp>> JoinOp::Create(
     std::unique_ptr<ValueExpr> remaining_condition,
     std::unique_ptr<RelationalOp> left, std::unique_ptr<RelationalOp> right,
     std::vector<std::unique_ptr<ExprArg>> left_outputs,
-    std::vector<std::unique_ptr<ExprArg>> right_outputs) {
+    std::vector<std::unique_ptr<ExprArg>> right_outputs,
+    RangeJoinExprs range_exprs) {
   if (!equality_exprs.empty()) {
     ZETASQL_RET_CHECK(kind != kCrossApply && kind != kOuterApply)
         << JoinKindToString(kind)
         << " does not support hash join equality expressions";
   }
+  if (range_exprs.right_expr != nullptr) {
+    ZETASQL_RET_CHECK(kind != kCrossApply && kind != kOuterApply)
+        << JoinKindToString(kind) << " does not support range join expressions";
+    ZETASQL_RET_CHECK(equality_exprs.empty())
+        << "Range join expressions cannot be combined with hash join equality "
+        << "expressions";
+    ZETASQL_RET_CHECK(range_exprs.lower_bound != nullptr ||
+              range_exprs.upper_bound != nullptr)
+        << "Range join requires a lower or upper bound";
+    const Type* type = range_exprs.right_expr->type();
+    for (const ExprArg* bound :
+         {range_exprs.lower_bound.get(), range_exprs.upper_bound.get()}) {
+      if (bound != nullptr) {
+        ZETASQL_RET_CHECK(bound->type()->Equals(type))
+            << bound->type()->DebugString() << " vs. " << type->DebugString();
+      }
+    }
+  } else {
+    ZETASQL_RET_CHECK(range_exprs.lower_bound == nullptr &&
+              range_exprs.upper_bound == nullptr)
+        << "Range join bounds require a right expression";
+  }
   std::vector<std::unique_ptr<ExprArg>> hash_join_equality_left_exprs;
   hash_join_equality_left_exprs.reserve(equality_exprs.size());
   std::vector<std::unique_ptr<ExprArg>> hash_join_equality_right_exprs;
@@ -2431,9 +2581,9 @@ absl::StatusOr<std::unique_ptr<JoinOp>> JoinOp::Create(
 
   return absl::WrapUnique(new JoinOp(
       kind, std::move(hash_join_equality_left_exprs),
-      std::move(hash_join_equality_right_exprs), std::move(remaining_condition),
-      std::move(left), std::move(right), std::move(left_outputs),
-      std::move(right_outputs)));
+      std::move(hash_join_equality_right_exprs), std::move(range_exprs),
+      std::move(remaining_condition), std::move(left), std::move(right),
+      std::move(left_outputs), std::move(right_outputs)));
 }
 
 absl::Status JoinOp::SetSchemasForEvaluation(
@@ -2473,6 +2623,20 @@ absl::Status JoinOp::SetSchemasForEvaluation(
         ConcatSpans(params_schemas, {right_schema.get()})));
   }
 
+  if (range_join_right_expr() != nullptr) {
+    ZETASQL_RETURN_IF_ERROR(mutable_range_join_right_expr()
+                        ->mutable_value_expr()
+                        ->SetSchemasForEvaluation(ConcatSpans(
+                            params_schemas, {right_schema.get()})));
+  }
+  for (ExprArg* bound :
+       {mutable_range_join_lower_bound(), mutable_range_join_upper_bound()}) {
+    if (bound != nullptr) {
+      ZETASQL_RETURN_IF_ERROR(bound->mutable_value_expr()->SetSchemasForEvaluation(
+          ConcatSpans(params_schemas, {left_schema.get()})));
+    }
+  }
+
   for (ExprArg* left_output : mutable_left_outputs()) {
     ZETASQL_RETURN_IF_ERROR(left_output->mutable_value_expr()->SetSchemasForEvaluation(
         ConcatSpans(params_schemas, {left_schema.get()})));
@@ -2807,6 +2971,228 @@ class UncorrelatedHashedRightInput : public RightInputForJoin {
   EvaluationContext* context_;
 };
 
+// Represents the right-hand input side of a range join. The right tuples with
+// a non-NULL value of the range join right expression are sorted by that
+// value, so that the tuples that can join with a left tuple form a contiguous
+// run between the positions of its bounds.
+//
+// The positions are found by galloping from those for the previous left tuple.
+// If the left-hand side is ordered on the bounds, consecutive searches only
+// move forward, and the join proceeds like a merge join over the sorted
+// right-hand side. Otherwise each search still takes logarithmic time.
+class UncorrelatedRangeRightInput : public RightInputForJoin {
+ public:
+  static absl::StatusOr<std::unique_ptr<UncorrelatedRangeRightInput>> Create(
+      absl::Span<const TupleData* const> params, const ExprArg* right_expr,
+      const ExprArg* lower_bound, const ExprArg* upper_bound,
+      std::unique_ptr<TupleSchema> schema,
+      std::unique_ptr<TupleDataDeque> right_tuples,
+      std::unique_ptr<TupleIterator> iter_for_debug_string,
+      EvaluationContext* context) {
+    ZETASQL_RET_CHECK(right_expr != nullptr);
+    ZETASQL_RET_CHECK(lower_bound != nullptr || upper_bound != nullptr);
+
+    std::vector<RightTupleAndJoinedBit> right_tuples_and_bits =
+        WrapWithJoinedBits(right_tuples->GetTuplePtrs());
+
+    std::vector<KeyAndTuple> sorted_tuples;
+    sorted_tuples.reserve(right_tuples_and_bits.size());
+    for (RightTupleAndJoinedBit& tuple_and_bit : right_tuples_and_bits) {
+      TupleSlot slot;
+      absl::Status status;
+      if (!right_expr->value_expr()->EvalSimple(
+              ConcatSpans(params, {tuple_and_bit.tuple}), context, &slot,
+              &status)) {
+        return status;
+      }
+      // A NULL key never satisfies the range.
+      if (slot.value().is_null()) continue;
+      sorted_tuples.push_back({slot.value(), &tuple_and_bit});
+    }
+    std::stable_sort(sorted_tuples.begin(), sorted_tuples.end(),
+                     [](const KeyAndTuple& a, const KeyAndTuple& b) {
+                       return a.key.LessThan(b.key);
+                     });
+
+    return absl::WrapUnique(new UncorrelatedRangeRightInput(
+        params, lower_bound, upper_bound, std::move(schema),
+        std::move(right_tuples), std::move(right_tuples_and_bits),
+        std::move(sorted_tuples), std::move(iter_for_debug_string), context));
+  }
+
+  UncorrelatedRangeRightInput(const UncorrelatedRangeRightInput&) = delete;
+  UncorrelatedRangeRightInput& operator=(const UncorrelatedRangeRightInput&) =
+      delete;
+
+  bool IsCorrelated() const override { return false; }
+
+  const TupleSchema& Schema() const override { return *schema_; }
+
+  absl::Status ResetForLeftInput(const Tuple* left_input) override {
+    if (left_input == nullptr) {
+      match_all_ = true;
+      return absl::OkStatus();
+    }
+    match_all_ = false;
+    match_begin_ = 0;
+    match_end_ = static_cast<int64_t>(sorted_tuples_.size());
+
+    const std::vector<const TupleData*> bound_params = ConcatSpans(
+        absl::Span<const TupleData* const>(params_), {left_input->data});
+    if (lower_bound_ != nullptr) {
+      ZETASQL_ASSIGN_OR_RETURN(const std::optional<Value> bound,
+                       EvaluateBound(lower_bound_, bound_params));
+      if (!bound.has_value()) {
+        match_end_ = match_begin_;
+        return absl::OkStatus();
+      }
+      lower_hint_ = Seek(*bound, /*past_equal_keys=*/false, lower_hint_);
+      match_begin_ = lower_hint_;
+    }
+    if (upper_bound_ != nullptr) {
+      ZETASQL_ASSIGN_OR_RETURN(const std::optional<Value> bound,
+                       EvaluateBound(upper_bound_, bound_params));
+      if (!bound.has_value()) {
+        match_end_ = match_begin_;
+        return absl::OkStatus();
+      }
+      upper_hint_ = Seek(*bound, /*past_equal_keys=*/true, upper_hint_);
+      match_end_ = upper_hint_;
+    }
+    match_end_ = std::max(match_begin_, match_end_);
+    return absl::OkStatus();
+  }
+
+  int64_t GetNumMatchingTuples() const override {
+    if (match_all_) return right_tuples_and_bits_.size();
+    return match_end_ - match_begin_;
+  }
+
+  const TupleData& GetMatchingTuple(int64_t index) const override {
+    if (match_all_) return *right_tuples_and_bits_[index].tuple;
+    return *sorted_tuples_[match_begin_ + index].tuple_and_bit->tuple;
+  }
+
+  absl::Status RecordMatchingTupleJoined(int64_t index) override {
+    if (match_all_) {
+      right_tuples_and_bits_[index].joined = true;
+    } else {
+      sorted_tuples_[match_begin_ + index].tuple_and_bit->joined = true;
+    }
+    return absl::OkStatus();
+  }
+
+  absl::StatusOr<bool> DidMatchingTupleJoin(int64_t index) const override {
+    if (match_all_) return right_tuples_and_bits_[index].joined;
+    return sorted_tuples_[match_begin_ + index].tuple_and_bit->joined;
+  }
+
+  std::string DebugString() const override {
+    return iter_for_debug_string_->DebugString();
+  }
+
+ private:
+  struct KeyAndTuple {
+    Value key;
+    RightTupleAndJoinedBit* tuple_and_bit;  // Owned by the input.
+  };
+
+  UncorrelatedRangeRightInput(
+      absl::Span<const TupleData* const> params, const ExprArg* lower_bound,
+      const ExprArg* upper_bound, std::unique_ptr<TupleSchema> schema,
+      std::unique_ptr<TupleDataDeque> right_tuples,
+      // The TupleDatas in here are owned by 'right_tuples'.
+      std::vector<RightTupleAndJoinedBit> right_tuples_and_bits,
+      // Points into 'right_tuples_and_bits'.
+      std::vector<KeyAndTuple> sorted_tuples,
+      std::unique_ptr<TupleIterator> iter_for_debug_string,
+      EvaluationContext* context)
+      : params_(params.begin(), params.end()),
+        lower_bound_(lower_bound),
+        upper_bound_(upper_bound),
+        schema_(std::move(schema)),
+        right_tuples_(std::move(right_tuples)),
+        right_tuples_and_bits_(std::move(right_tuples_and_bits)),
+        sorted_tuples_(std::move(sorted_tuples)),
+        iter_for_debug_string_(std::move(iter_for_debug_string)),
+        context_(context) {}
+
+  // Evaluates 'bound' on 'params'. Returns std::nullopt if the bound is NULL.
+  absl::StatusOr<std::optional<Value>> EvaluateBound(
+      const ExprArg* bound, absl::Span<const TupleData* const> params) const {
+    TupleSlot slot;
+    absl::Status status;
+    if (!bound->value_expr()->EvalSimple(params, context_, &slot, &status)) {
+      return status;
+    }
+    if (slot.value().is_null()) return std::nullopt;
+    return slot.value();
+  }
+
+  // Returns the position of the first sorted tuple whose key is greater than
+  // or equal to 'bound', or greater than 'bound' if 'past_equal_keys' is true.
+  // Gallops outward from 'hint' before binary searching, so that the cost is
+  // logarithmic in the distance from 'hint' to the result.
+  int64_t Seek(const Value& bound, bool past_equal_keys, int64_t hint) const {
+    const auto precedes = [&bound, past_equal_keys](const KeyAndTuple& t) {
+      return past_equal_keys ? !bound.LessThan(t.key) : t.key.LessThan(bound);
+    };
+    const int64_t size = static_cast<int64_t>(sorted_tuples_.size());
+    // The result is in (lo, hi].
+    int64_t lo;
+    int64_t hi;
+    if (hint < size && precedes(sorted_tuples_[hint])) {
+      lo = hint;
+      hi = hint + 1;
+      for (int64_t step = 1; hi < size && precedes(sorted_tuples_[hi]);
+           step *= 2) {
+        lo = hi;
+        hi = lo + step;
+      }
+      hi = std::min(hi, size);
+    } else {
+      hi = std::min(hint, size);
+      lo = hi - 1;
+      for (int64_t step = 1; lo >= 0 && !precedes(sorted_tuples_[lo]);
+           step *= 2) {
+        hi = lo;
+        lo = hi - step;
+      }
+      lo = std::max<int64_t>(lo, -1);
+    }
+    return std::partition_point(sorted_tuples_.begin() + lo + 1,
+                                sorted_tuples_.begin() + hi, precedes) -
+           sorted_tuples_.begin();
+  }
+
+  const std::vector<const TupleData*> params_;
+  const ExprArg* lower_bound_;  // May be NULL.
+  const ExprArg* upper_bound_;  // May be NULL.
+  const std::unique_ptr<TupleSchema> schema_;
+
+  std::unique_ptr<TupleDataDeque> right_tuples_;
+  // The TupleDatas in here are owned by 'right_tuples_'.
+  std::vector<RightTupleAndJoinedBit> right_tuples_and_bits_;
+  // The entries of 'right_tuples_and_bits_' with a non-NULL key, sorted by key.
+  std::vector<KeyAndTuple> sorted_tuples_;
+
+  // True if the left tuple in the last call to ResetForLeftInput() was NULL,
+  // in which case GetNumMatchingTuples()/etc. iterate over everything.
+  // Otherwise the matching tuples are sorted_tuples_[match_begin_, match_end_).
+  bool match_all_ = false;
+  int64_t match_begin_ = 0;
+  int64_t match_end_ = 0;
+  // The results of the last searches for the lower and upper bounds.
+  int64_t lower_hint_ = 0;
+  int64_t upper_hint_ = 0;
+
+  // We store a TupleIterator instead of the debug string to avoid computing the
+  // debug string unnecessarily.
+  const std::unique_ptr<TupleIterator> iter_for_debug_string_;
+
+  EvaluationContext* context_;
+};
+
 // Reads the input tuples from 'op' and populates them in 'tuples'. If
 // 'iter_for_debug_string' is non-NULL, populates it with the iterator. (We pass
 // around the iterator instead of the debug string to avoid computing the debug
@@ -3409,7 +3795,8 @@ class JoinTupleIterator : public TupleIterator {
 
 }  // namespace
 
-absl::StatusOr<std::unique_ptr<TupleIterator>> JoinOp::CreateIterator(
+absl::StatusOr<std::unique_ptr<TupleIterator>>
+JoinOp::CreateIteratorInternal(
     absl::Span<const TupleData* const> params, int num_extra_slots,
     EvaluationContext* context) const {
 
@@ -3425,11 +3812,23 @@ absl::StatusOr<std::unique_ptr<TupleIterator>> JoinOp::CreateIterator(
       ZETASQL_RETURN_IF_ERROR(ExtractFromRelationalOp(right_input(), params, context,
                                               tuples.get(),
                                               &iter_for_right_debug_string));
-      if (hash_join_equality_left_exprs().empty()) {
+      if (range_join_right_expr() != nullptr) {
+        ZETASQL_ASSIGN_OR_RETURN(
+            right_hand_side,
+            UncorrelatedRangeRightInput::Create(
+                params, range_join_right_expr(), range_join_lower_bound(),
+                range_join_upper_bound(), right_input()->CreateOutputSchema(),
+                std::move(tuples), std::move(iter_for_right_debug_string),
+                context));
+      } else if (hash_join_equality_left_exprs().empty()) {
         right_hand_side = std::make_unique<UncorrelatedRightInput>(
             right_input()->CreateOutputSchema(), std::move(tuples),
             std::move(iter_for_right_debug_string));
       } else {
+        if (OperatorProfile* profile = context->operator_profile();
+            profile != nullptr) {
+          profile->RecordHashTableSize(this, tuples->GetSize());
+        }
         ZETASQL_ASSIGN_OR_RETURN(
             right_hand_side,
             UncorrelatedHashedRightInput::Create(
@@ -3537,6 +3936,9 @@ std::string JoinOp::DebugInternal(const std::string& indent,
                                    "right_outputs",
                                    "hash_join_equality_left_exprs",
                                    "hash_join_equality_right_exprs",
+                                   "range_join_right_expr",
+                                   "range_join_lower_bound",
+                                   "range_join_upper_bound",
                                    "remaining_condition",
                                    "left_input",
                                    "right_input"};
@@ -3547,7 +3949,8 @@ std::string JoinOp::DebugInternal(const std::string& indent,
   return absl::StrCat(
       "JoinOp(", JoinKindToString(join_kind_),
       ArgDebugString(*arg_names,
-                     {left_output_mode, right_output_mode, kN, kN, k1, k1, k1},
+                     {left_output_mode, right_output_mode, kN, kN, kNOpt,
+                      kNOpt, kNOpt, k1, k1, k1},
                      indent, verbose),
       ")");
 }
@@ -3556,7 +3959,7 @@ JoinOp::JoinOp(
     JoinKind kind,
     std::vector<std::unique_ptr<ExprArg>> hash_join_equality_left_exprs,
     std::vector<std::unique_ptr<ExprArg>> hash_join_equality_right_exprs,
-    std::unique_ptr<ValueExpr> remaining_condition,
+    RangeJoinExprs range_exprs, std::unique_ptr<ValueExpr> remaining_condition,
     std::unique_ptr<RelationalOp> left, std::unique_ptr<RelationalOp> right,
     std::vector<std::unique_ptr<ExprArg>> left_outputs,
     std::vector<std::unique_ptr<ExprArg>> right_outputs)
@@ -3567,6 +3970,17 @@ JoinOp::JoinOp(
                    std::move(hash_join_equality_left_exprs));
   SetArgs<ExprArg>(kHashJoinEqualityRightExprs,
                    std::move(hash_join_equality_right_exprs));
+  const auto to_optional_arg = [](std::unique_ptr<ExprArg> arg) {
+    std::vector<std::unique_ptr<ExprArg>> args;
+    if (arg != nullptr) args.push_back(std::move(arg));
+    return args;
+  };
+  SetArgs<ExprArg>(kRangeJoinRightExpr,
+                   to_optional_arg(std::move(range_exprs.right_expr)));
+  SetArgs<ExprArg>(kRangeJoinLowerBound,
+                   to_optional_arg(std::move(range_exprs.lower_bound)));
+  SetArgs<ExprArg>(kRangeJoinUpperBound,
+                   to_optional_arg(std::move(range_exprs.upper_bound)));
   SetArg(kRemainingCondition,
          std::make_unique<ExprArg>(std::move(remaining_condition)));
   SetArg(kLeftInput, std::make_unique<RelationalArg>(std::move(left)));
@@ -3590,6 +4004,36 @@ absl::Span<ExprArg* const> JoinOp::mutable_hash_join_equality_right_exprs() {
   return GetMutableArgs<ExprArg>(kHashJoinEqualityRightExprs);
 }
 
+const ExprArg* JoinOp::range_join_right_expr() const {
+  const auto args = GetArgs<ExprArg>(kRangeJoinRightExpr);
+  return args.empty() ? nullptr : args[0];
+}
+
+ExprArg* JoinOp::mutable_range_join_right_expr() {
+  const auto args = GetMutableArgs<ExprArg>(kRangeJoinRightExpr);
+  return args.empty() ? nullptr : args[0];
+}
+
+const ExprArg* JoinOp::range_join_lower_bound() const {
+  const auto args = GetArgs<ExprArg>(kRangeJoinLowerBound);
+  return args.empty() ? nullptr : args[0];
+}
+
+ExprArg* JoinOp::mutable_range_join_lower_bound() {
+  const auto args = GetMutableArgs<ExprArg>(kRangeJoinLowerBound);
+  return args.empty() ? nullptr : args[0];
+}
+
+const ExprArg* JoinOp::range_join_upper_bound() const {
+  const auto args = GetArgs<ExprArg>(kRangeJoinUpperBound);
+  return args.empty() ? nullptr : args[0];
+}
+
+ExprArg* JoinOp::mutable_range_join_upper_bound() {
+  const auto args = GetMutableArgs<ExprArg>(kRangeJoinUpperBound);
+  return args.empty() ? nullptr : args[0];
+}
+
 const ValueExpr* JoinOp::remaining_join_expr() const {
   return GetArg(kRemainingCondition)->node()->AsValueExpr();
 }
@@ -3764,7 +4208,8 @@ class ArrayScanTupleIterator : public TupleIterator {
 };
 }  // namespace
 
-absl::StatusOr<std::unique_ptr<TupleIterator>> ArrayScanOp::CreateIterator(
+absl::StatusOr<std::unique_ptr<TupleIterator>>
+ArrayScanOp::CreateIteratorInternal(
     absl::Span<const TupleData* const> params, int num_extra_slots,
     EvaluationContext* context) const {
   TupleSlot array_slot;
@@ -3952,12 +4397,14 @@ class DistinctRowSetValueArg : public CppValueArg {
 // one variable for each key.
 class DistinctOpTupleIterator : public TupleIterator {
  public:
-  DistinctOpTupleIterator(std::unique_ptr<TupleIterator> input_iterator,
+  DistinctOpTupleIterator(const DistinctOp* op,
+                          std::unique_ptr<TupleIterator> input_iterator,
                           DistinctRowSet* row_set,
                           std::unique_ptr<const TupleSchema> output_schema,
                           absl::Span<const KeyArg* const> keys,
                           EvaluationContext* context, int num_extra_slots)
-      : input_iterator_(std::move(input_iterator)),
+      : op_(op),
+        input_iterator_(std::move(input_iterator)),
         row_set_(row_set),
         output_schema_(std::move(output_schema)),
         keys_(std::move(keys)),
@@ -3971,6 +4418,10 @@ class DistinctOpTupleIterator : public TupleIterator {
       TupleData* input_data = input_iterator_->Next();
       if (input_data == nullptr) {
         status_ = input_iterator_->Status();
+        if (OperatorProfile* profile = context_->operator_profile();
+            profile != nullptr) {
+          profile->RecordHashTableSize(op_, row_set_->size());
+        }
         return nullptr;
       }
 
@@ -3979,15 +4430,10 @@ class DistinctOpTupleIterator : public TupleIterator {
         return nullptr;
       }
 
-      // Generate a copy of the row data for the row set, ignoring any
-      // "extra slots".
-      auto keys_data_copy = std::make_unique<TupleData>(keys_.size());
-      for (int i = 0; i < keys_.size(); ++i) {
-        keys_data_copy->mutable_slot(i)->CopyFromSlot(keys_data_.slot(i));
-      }
-
-      if (row_set_->InsertRowIfNotPresent(std::move(keys_data_copy),
-                                          &status_)) {
+      // The row set copies what it needs of the row, ignoring any "extra
+      // slots".
+      if (row_set_->InsertRowIfNotPresent(
+              keys_data_, static_cast<int>(keys_.size()), &status_)) {
         return &keys_data_;
       }
       if (!status_.ok()) {
@@ -4018,6 +4464,7 @@ class DistinctOpTupleIterator : public TupleIterator {
     return true;
   }
 
+  const DistinctOp* op_;
   const std::unique_ptr<TupleIterator> input_iterator_;
   DistinctRowSet* row_set_;
   const std::unique_ptr<const TupleSchema> output_schema_;
@@ -4033,7 +4480,8 @@ std::unique_ptr<CppValueArg> DistinctOp::MakeCppValueArgForRowSet(
   return std::make_unique<DistinctRowSetValueArg>(var);
 }
 
-absl::StatusOr<std::unique_ptr<TupleIterator>> DistinctOp::CreateIterator(
+absl::StatusOr<std::unique_ptr<TupleIterator>>
+DistinctOp::CreateIteratorInternal(
     absl::Span<const TupleData* const> params, int num_extra_slots,
     EvaluationContext* context) const {
   ZETASQL_ASSIGN_OR_RETURN(
@@ -4050,8 +4498,8 @@ absl::StatusOr<std::unique_ptr<TupleIterator>> DistinctOp::CreateIterator(
   }
 
   return std::make_unique<DistinctOpTupleIterator>(
-      std::move(input_iterator), row_set, CreateOutputSchema(), keys(), context,
-      num_extra_slots);
+      this, std::move(input_iterator), row_set, CreateOutputSchema(), keys(),
+      context, num_extra_slots);
 }
 
 // Returns the schema consisting of the variables for the keys, followed by
@@ -4216,7 +4664,8 @@ class UnionAllTupleIterator : public TupleIterator {
 };
 }  // namespace
 
-absl::StatusOr<std::unique_ptr<TupleIterator>> UnionAllOp::CreateIterator(
+absl::StatusOr<std::unique_ptr<TupleIterator>>
+UnionAllOp::CreateIteratorInternal(
     absl::Span<const TupleData* const> params, int num_extra_slots,
     EvaluationContext* context) const {
   std::vector<absl::Span<const ExprArg* const>> tuple_values;
@@ -4479,7 +4928,12 @@ class LoopTupleIterator : public TupleIterator {
     absl::StatusOr<TupleData*> status_or_data = NextInternal();
     status_ = status_or_data.status();
     TupleData* data = status_.ok() ? *status_or_data : nullptr;
-    if (data == nullptr) {
+    if (data != nullptr) {
+      ++num_rows_in_iteration_;
+    } else {
+      if (status_.ok() && iter_ != nullptr) {
+        context_->AddRecursiveIteration(num_rows_in_iteration_);
+      }
       // Free body iterator, including result from previous call to Next().
       iter_.reset();
     }
@@ -4565,6 +5019,10 @@ class LoopTupleIterator : public TupleIterator {
   //  - nullptr if the next iteration is empty (and terminates the loop)
   //  - An error status if an error occurred.
   absl::StatusOr<TupleData*> BeginNextIteration() {
+    if (iter_ != nullptr) {
+      context_->AddRecursiveIteration(num_rows_in_iteration_);
+      num_rows_in_iteration_ = 0;
+    }
     // Create a new iterator for the body
     ZETASQL_ASSIGN_OR_RETURN(iter_,
                      op_->body()->CreateIterator(params_and_loop_variables_,
@@ -4607,11 +5065,15 @@ class LoopTupleIterator : public TupleIterator {
   absl::Status status_;
 
   bool first_iteration_ = true;
+
+  // Number of rows returned by 'iter_' so far.
+  int64_t num_rows_in_iteration_ = 0;
 };
 
 }  // namespace
 
-absl::StatusOr<std::unique_ptr<TupleIterator>> LoopOp::CreateIterator(
+absl::StatusOr<std::unique_ptr<TupleIterator>>
+LoopOp::CreateIteratorInternal(
     absl::Span<const TupleData* const> params, int num_extra_slots,
     EvaluationContext* context) const {
   return LoopTupleIterator::Create(this, params, num_extra_slots, context);
@@ -4631,7 +5093,8 @@ absl::Status RootOp::SetSchemasForEvaluation(
   return mutable_input()->SetSchemasForEvaluation(params_schemas);
 }
 
-absl::StatusOr<std::unique_ptr<TupleIterator>> RootOp::CreateIterator(
+absl::StatusOr<std::unique_ptr<TupleIterator>>
+RootOp::CreateIteratorInternal(
     absl::Span<const TupleData* const> params, int num_extra_slots,
     EvaluationContext* context) const {
   return input()->CreateIterator(params, num_extra_slots, context);
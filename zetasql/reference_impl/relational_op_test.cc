@@ -29,6 +29,7 @@
 #include <vector>
 
 #include "zetasql/base/logging.h"
+#include "zetasql/common/evaluator_registration_utils.h"
 #include "zetasql/common/evaluator_test_table.h"
 #include "zetasql/base/testing/status_matchers.h"
 #include "zetasql/common/testing/testing_proto_util.h"
@@ -942,7 +943,7 @@ class TestCppValuesOp : public RelationalOp {
     return absl::OkStatus();
   }
 
-  absl::StatusOr<std::unique_ptr<TupleIterator>> CreateIterator(
+  absl::StatusOr<std::unique_ptr<TupleIterator>> CreateIteratorInternal(
       absl::Span<const TupleData* const> params, int num_extra_slots,
       EvaluationContext* context) const override {
     std::vector<TupleData> tuple_data;
@@ -2554,6 +2555,121 @@ TEST_F(CreateIteratorTest, FullOuterHashJoin) {
                        HasSubstr("Out of memory")));
 }
 
+TEST_F(CreateIteratorTest, FullOuterRangeJoin) {
+  VariableId x1("x1"), x2("x2"), x1_prime("x1'"), x2_prime("x2'"), y("y"),
+      y_prime("y'");
+
+  // The left input is not ordered on the bounds, so the right-hand side is
+  // searched in both directions.
+  auto input1 = absl::WrapUnique(
+      new TestRelationalOp({x1, x2},
+                           CreateTestTupleDatas({{Int64(5), Int64(5)},
+                                                 {Int64(1), Int64(3)},
+                                                 {Int64(9), NullInt64()},
+                                                 {Int64(7), Int64(100)}}),
+                           /*preserves_order=*/true));
+  auto input2 = absl::WrapUnique(new TestRelationalOp(
+      {y},
+      CreateTestTupleDatas({{Int64(0)},
+                            {Int64(2)},
+                            {Int64(3)},
+                            {NullInt64()},
+                            {Int64(5)},
+                            {Int64(8)}}),
+      /*preserves_order=*/true));
+
+  // y BETWEEN x1 AND x2
+  JoinOp::RangeJoinExprs range_exprs;
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_y, DerefExpr::Create(y, Int64Type()));
+  range_exprs.right_expr = std::make_unique<ExprArg>(std::move(deref_y));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_x1, DerefExpr::Create(x1, Int64Type()));
+  range_exprs.lower_bound = std::make_unique<ExprArg>(std::move(deref_x1));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_x2, DerefExpr::Create(x2, Int64Type()));
+  range_exprs.upper_bound = std::make_unique<ExprArg>(std::move(deref_x2));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto true_expr, ConstExpr::Create(Bool(true)));
+
+  std::vector<std::unique_ptr<ExprArg>> left_outputs;
+  for (const auto& [var, var_prime] : {std::make_pair(x1, x1_prime),
+                                       std::make_pair(x2, x2_prime)}) {
+    ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref, DerefExpr::Create(var, Int64Type()));
+    left_outputs.push_back(
+        std::make_unique<ExprArg>(var_prime, std::move(deref)));
+  }
+  std::vector<std::unique_ptr<ExprArg>> right_outputs;
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_y_output,
+                       DerefExpr::Create(y, Int64Type()));
+  right_outputs.push_back(
+      std::make_unique<ExprArg>(y_prime, std::move(deref_y_output)));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      auto join_op,
+      JoinOp::Create(JoinOp::kFullOuterJoin, EmptyHashJoinEqualityExprs(),
+                     std::move(true_expr), std::move(input1), std::move(input2),
+                     std::move(left_outputs), std::move(right_outputs),
+                     std::move(range_exprs)));
+  EXPECT_EQ(
+      "JoinOp(FULL OUTER\n"
+      "+-left_outputs: {\n"
+      "| +-$x1' := $x1,\n"
+      "| +-$x2' := $x2},\n"
+      "+-right_outputs: {\n"
+      "| +-$y' := $y},\n"
+      "+-hash_join_equality_left_exprs: {},\n"
+      "+-hash_join_equality_right_exprs: {},\n"
+      "+-range_join_right_expr: {\n"
+      "| +-$y},\n"
+      "+-range_join_lower_bound: {\n"
+      "| +-$x1},\n"
+      "+-range_join_upper_bound: {\n"
+      "| +-$x2},\n"
+      "+-remaining_condition: ConstExpr(true),\n"
+      "+-left_input: TestRelationalOp,\n"
+      "+-right_input: TestRelationalOp)",
+      join_op->DebugString());
+
+  EvaluationContext context((EvaluationOptions()));
+  ZETASQL_ASSERT_OK(join_op->SetSchemasForEvaluation(EmptyParamsSchemas()));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<TupleIterator> iter,
+      join_op->CreateIterator(EmptyParams(), /*num_extra_slots=*/0, &context));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::vector<TupleData> data,
+                       ReadFromTupleIterator(iter.get()));
+  std::vector<std::vector<Value>> values;
+  for (const TupleData& tuple : data) {
+    ASSERT_EQ(tuple.num_slots(), 3);
+    values.push_back({tuple.slot(0).value(), tuple.slot(1).value(),
+                      tuple.slot(2).value()});
+  }
+  EXPECT_THAT(values,
+              ElementsAre(ElementsAre(Int64(5), Int64(5), Int64(5)),
+                          ElementsAre(Int64(1), Int64(3), Int64(2)),
+                          ElementsAre(Int64(1), Int64(3), Int64(3)),
+                          ElementsAre(Int64(9), NullInt64(), NullInt64()),
+                          ElementsAre(Int64(7), Int64(100), Int64(8)),
+                          ElementsAre(NullInt64(), NullInt64(), Int64(0)),
+                          ElementsAre(NullInt64(), NullInt64(), NullInt64())));
+
+  // A range join requires at least one bound.
+  JoinOp::RangeJoinExprs unbounded_range_exprs;
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_y_again,
+                       DerefExpr::Create(y, Int64Type()));
+  unbounded_range_exprs.right_expr =
+      std::make_unique<ExprArg>(std::move(deref_y_again));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto true_expr2, ConstExpr::Create(Bool(true)));
+  auto empty_input1 = absl::WrapUnique(
+      new TestRelationalOp({x1}, /*values=*/{}, /*preserves_order=*/true));
+  auto empty_input2 = absl::WrapUnique(
+      new TestRelationalOp({y}, /*values=*/{}, /*preserves_order=*/true));
+  EXPECT_THAT(
+      JoinOp::Create(JoinOp::kInnerJoin, EmptyHashJoinEqualityExprs(),
+                     std::move(true_expr2), std::move(empty_input1),
+                     std::move(empty_input2), /*left_outputs=*/{},
+                     /*right_outputs=*/{}, std::move(unbounded_range_exprs)),
+      StatusIs(absl::StatusCode::kInternal,
+               HasSubstr("Range join requires a lower or upper bound")));
+}
+
 TEST_F(CreateIteratorTest, SortOpTotalOrder) {
   VariableId a("a"), b("b"), c("c"), param("param"), k("k"), v1("v1"), v2("v2"),
       v3("v3");
@@ -3026,6 +3142,69 @@ TEST_F(CreateIteratorTest, SortOpPartialOrderStableSort) {
   EXPECT_EQ(data[3].num_slots(), 2);
 }
 
+TEST_F(CreateIteratorTest, SortOpWithCollation) {
+  // Registers the ICU collator so that 'und:ci' can be used.
+  internal::EnableFullEvaluatorFeatures();
+
+  // Sorts the rows below by 'a COLLATE "und:ci"' in <order> with a stable sort
+  // and returns the 'b' values of the output rows.
+  auto sort_values = [this](KeyArg::SortOrder order)
+      -> absl::StatusOr<std::vector<Value>> {
+    VariableId a("a"), b("b"), k("k"), v("v");
+    ZETASQL_ASSIGN_OR_RETURN(auto deref_a, DerefExpr::Create(a, StringType()));
+    std::vector<std::unique_ptr<KeyArg>> keys;
+    keys.push_back(std::make_unique<KeyArg>(k, std::move(deref_a), order));
+    ZETASQL_ASSIGN_OR_RETURN(auto collation,
+                     ConstExpr::Create(Value::String("und:ci")));
+    keys.back()->set_collation(std::move(collation));
+
+    ZETASQL_ASSIGN_OR_RETURN(auto deref_b, DerefExpr::Create(b, Int64Type()));
+    std::vector<std::unique_ptr<ExprArg>> values;
+    values.push_back(std::make_unique<ExprArg>(v, std::move(deref_b)));
+
+    auto input = absl::WrapUnique(new TestRelationalOp(
+        {a, b},
+        CreateTestTupleDatas({{String("b"), Int64(1)},
+                              {String("A"), Int64(2)},
+                              {NullString(), Int64(3)},
+                              {String("a"), Int64(4)},
+                              {String("C"), Int64(5)},
+                              {String("B"), Int64(6)}}),
+        /*preserves_order=*/true));
+    ZETASQL_ASSIGN_OR_RETURN(
+        auto sort_op,
+        SortOp::Create(std::move(keys), std::move(values),
+                       /*limit=*/nullptr, /*offset=*/nullptr, std::move(input),
+                       /*is_order_preserving=*/true,
+                       /*is_stable_sort=*/true));
+    ZETASQL_RETURN_IF_ERROR(sort_op->SetSchemasForEvaluation(EmptyParamsSchemas()));
+
+    EvaluationContext context((EvaluationOptions()));
+    ZETASQL_ASSIGN_OR_RETURN(
+        std::unique_ptr<TupleIterator> iter,
+        sort_op->CreateIterator(EmptyParams(), /*num_extra_slots=*/0,
+                                &context));
+    ZETASQL_ASSIGN_OR_RETURN(std::vector<TupleData> data,
+                     ReadFromTupleIterator(iter.get()));
+    std::vector<Value> b_values;
+    for (const TupleData& tuple : data) {
+      // The collation sort keys used for sorting are not part of the output.
+      EXPECT_EQ(tuple.num_slots(), 2);
+      b_values.push_back(tuple.slot(1).value());
+    }
+    return b_values;
+  };
+
+  // "A" and "a", and "b" and "B", are equal under 'und:ci', so the stable sort
+  // keeps them in input order.
+  EXPECT_THAT(sort_values(KeyArg::kAscending),
+              IsOkAndHolds(ElementsAre(Int64(3), Int64(2), Int64(4), Int64(1),
+                                       Int64(6), Int64(5))));
+  EXPECT_THAT(sort_values(KeyArg::kDescending),
+              IsOkAndHolds(ElementsAre(Int64(5), Int64(1), Int64(6), Int64(2),
+                                       Int64(4), Int64(3))));
+}
+
 // Tests the reordering functionality in SortTupleIterator.
 TEST_F(CreateIteratorTest, SortOpPartialInputReordersTest) {
   const int num_keys = 10;
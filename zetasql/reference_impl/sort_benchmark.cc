@@ -0,0 +1,162 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Cost of ORDER BY on a STRING column, with and without COLLATE 'und:ci'. The
+// collated SortOp computes one ICU sort key per row; BM_SortCompareUtf8 shows
+// the cost of comparing the same rows through the collator on every
+// comparison instead.
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "zetasql/common/evaluator_registration_utils.h"
+#include "zetasql/public/types/type_factory.h"
+#include "zetasql/public/value.h"
+#include "zetasql/reference_impl/evaluation.h"
+#include "zetasql/reference_impl/operator.h"
+#include "zetasql/reference_impl/test_relational_op.h"
+#include "zetasql/reference_impl/tuple.h"
+#include "zetasql/reference_impl/tuple_comparator.h"
+#include "zetasql/reference_impl/variable_id.h"
+#include "benchmark/benchmark.h"
+#include "zetasql/base/status.h"
+
+namespace zetasql {
+
+static const VariableId kA("a");
+static const VariableId kK("k");
+static const VariableId kV("v");
+
+// Returns <num_rows> single-column rows of random mixed-case words, a few of
+// them with accented letters.
+static std::vector<TupleData> MakeStringRows(int num_rows) {
+  static const char* const kLetters[] = {"a", "b", "c", "d", "e", "k", "n",
+                                         "r", "s", "t", "A", "B", "E", "K",
+                                         "R", "S", "T", "é", "ö", "ß"};
+  std::mt19937 rng(12345);
+  std::vector<TupleData> rows;
+  rows.reserve(num_rows);
+  for (int i = 0; i < num_rows; ++i) {
+    std::string word;
+    const int length = 6 + rng() % 10;
+    for (int j = 0; j < length; ++j) {
+      word.append(kLetters[rng() % std::size(kLetters)]);
+    }
+    TupleData row(1);
+    row.mutable_slot(0)->SetValue(Value::String(word));
+    rows.push_back(std::move(row));
+  }
+  return rows;
+}
+
+// Returns the sort key 'a' [COLLATE <collation>] for a SortOp over the rows of
+// MakeStringRows(). An empty <collation> means no COLLATE clause.
+static std::unique_ptr<KeyArg> MakeSortKey(const std::string& collation) {
+  auto key = std::make_unique<KeyArg>(
+      kK, DerefExpr::Create(kA, types::StringType()).value(),
+      KeyArg::kAscending);
+  if (!collation.empty()) {
+    key->set_collation(ConstExpr::Create(Value::String(collation)).value());
+  }
+  return key;
+}
+
+// Runs ORDER BY a [COLLATE <collation>] over state.range(0) rows.
+static void SortStrings(::benchmark::State& state,
+                        const std::string& collation) {
+  internal::EnableFullEvaluatorFeatures();
+  const int num_rows = state.range(0);
+  std::vector<std::unique_ptr<KeyArg>> keys;
+  keys.push_back(MakeSortKey(collation));
+  std::vector<std::unique_ptr<ExprArg>> values;
+  values.push_back(std::make_unique<ExprArg>(
+      kV, DerefExpr::Create(kA, types::StringType()).value()));
+  std::unique_ptr<SortOp> sort_op =
+      SortOp::Create(std::move(keys), std::move(values), /*limit=*/nullptr,
+                     /*offset=*/nullptr,
+                     std::make_unique<TestRelationalOp>(
+                         std::vector<VariableId>{kA},
+                         MakeStringRows(num_rows), /*preserves_order=*/true),
+                     /*is_order_preserving=*/true, /*is_stable_sort=*/false)
+          .value();
+  ZETASQL_CHECK_OK(sort_op->SetSchemasForEvaluation(/*params_schemas=*/{}));
+
+  EvaluationOptions options;
+  options.max_intermediate_byte_size = int64_t{16} << 30;
+  EvaluationContext context(options);
+  for (auto s : state) {
+    std::unique_ptr<TupleIterator> iter =
+        sort_op->CreateIterator(/*params=*/{}, /*num_extra_slots=*/0, &context)
+            .value();
+    ::benchmark::DoNotOptimize(iter->Next());
+  }
+  state.SetItemsProcessed(state.iterations() * num_rows);
+}
+
+static void BM_SortBinary(::benchmark::State& state) {
+  SortStrings(state, /*collation=*/"");
+}
+BENCHMARK(BM_SortBinary)
+    ->Arg(1 << 14)
+    ->Arg(1 << 20)
+    ->Unit(::benchmark::kMillisecond);
+
+static void BM_SortCollated(::benchmark::State& state) {
+  SortStrings(state, "und:ci");
+}
+BENCHMARK(BM_SortCollated)
+    ->Arg(1 << 14)
+    ->Arg(1 << 20)
+    ->Unit(::benchmark::kMillisecond);
+
+// Baseline for BM_SortCollated: sorts the rows with
+// TupleComparator::operator(), which compares the strings with the collator on
+// every comparison.
+static void BM_SortCompareUtf8(::benchmark::State& state) {
+  internal::EnableFullEvaluatorFeatures();
+  const std::vector<TupleData> rows = MakeStringRows(state.range(0));
+  std::unique_ptr<KeyArg> key = MakeSortKey("und:ci");
+  ZETASQL_CHECK_OK(key->mutable_collation()->SetSchemasForEvaluation(
+      /*params_schemas=*/{}));
+  const KeyArg* keys[] = {key.get()};
+  const int slots_for_keys[] = {0};
+  EvaluationContext context{/*options=*/{}};
+  std::unique_ptr<TupleComparator> comparator =
+      TupleComparator::Create(keys, slots_for_keys, /*params=*/{}, &context)
+          .value();
+  for (auto s : state) {
+    std::vector<const TupleData*> sorted;
+    sorted.reserve(rows.size());
+    for (const TupleData& row : rows) {
+      sorted.push_back(&row);
+    }
+    std::sort(sorted.begin(), sorted.end(), *comparator);
+    ::benchmark::DoNotOptimize(sorted.data());
+  }
+  state.SetItemsProcessed(state.iterations() * rows.size());
+}
+BENCHMARK(BM_SortCompareUtf8)
+    ->Arg(1 << 14)
+    ->Arg(1 << 20)
+    ->Unit(::benchmark::kMillisecond);
+
+}  // namespace zetasql
@@ -46,7 +46,7 @@ class TestRelationalOp : public RelationalOp {
     return absl::OkStatus();
   }
 
-  absl::StatusOr<std::unique_ptr<TupleIterator>> CreateIterator(
+  absl::StatusOr<std::unique_ptr<TupleIterator>> CreateIteratorInternal(
       absl::Span<const TupleData* const> /*params*/, int num_extra_slots,
       EvaluationContext* context) const override {
     std::vector<TupleData> iter_values = values_;
@@ -18,7 +18,9 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <deque>
 #include <memory>
+#include <numeric>
 #include <optional>
 #include <string>
 #include <utility>
@@ -26,11 +28,14 @@
 
 #include "zetasql/base/logging.h"
 #include "zetasql/public/value.h"
+#include "zetasql/reference_impl/compact_key.h"
+#include "absl/hash/hash.h"
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
+#include "absl/types/span.h"
 #include "zetasql/base/map_util.h"
 
 namespace zetasql {
@@ -165,6 +170,10 @@ absl::Status TupleDataDeque::SetSlot(int slot_idx, std::vector<Value> values) {
 
 void TupleDataDeque::Sort(const TupleComparator& comparator,
                           bool use_stable_sort) {
+  if (comparator.num_sort_keys() > 0 && datas_.size() > 1 &&
+      SortWithSortKeys(comparator, use_stable_sort)) {
+    return;
+  }
   auto entry_comparator = [&comparator](const Entry& entry1,
                                         const Entry& entry2) {
     return comparator(entry1.second, entry2.second);
@@ -176,6 +185,60 @@ void TupleDataDeque::Sort(const TupleComparator& comparator,
   }
 }
 
+bool TupleDataDeque::SortWithSortKeys(const TupleComparator& comparator,
+                                      bool use_stable_sort) {
+  const int num_sort_keys = comparator.num_sort_keys();
+  // The sort keys only live for the duration of the sort, but they are about
+  // as large as the strings they are computed from, so charge them anyway.
+  // Reserve as the keys are built, so that a sort that does not fit gives up
+  // before computing the rest of them.
+  const int64_t num_fixed_bytes = static_cast<int64_t>(
+      datas_.size() *
+      (sizeof(int64_t) + num_sort_keys * sizeof(std::string)));
+  MemoryReservation reservation(accountant_);
+  absl::Status status;
+  if (!reservation.Increase(num_fixed_bytes, &status)) {
+    return false;
+  }
+  std::vector<std::string> sort_keys;
+  sort_keys.reserve(datas_.size() * num_sort_keys);
+  for (const Entry& entry : datas_) {
+    const size_t first_key = sort_keys.size();
+    if (!comparator.AppendSortKeys(*entry.second, &sort_keys).ok()) {
+      return false;
+    }
+    int64_t num_bytes = 0;
+    for (size_t i = first_key; i < sort_keys.size(); ++i) {
+      num_bytes += sort_keys[i].size();
+    }
+    if (!reservation.Increase(num_bytes, &status)) {
+      return false;
+    }
+  }
+
+  std::vector<int64_t> order(datas_.size());
+  std::iota(order.begin(), order.end(), 0);
+  auto index_comparator = [&](int64_t idx1, int64_t idx2) {
+    return comparator.LessWithSortKeys(
+        *datas_[idx1].second,
+        absl::MakeConstSpan(&sort_keys[idx1 * num_sort_keys], num_sort_keys),
+        *datas_[idx2].second,
+        absl::MakeConstSpan(&sort_keys[idx2 * num_sort_keys], num_sort_keys));
+  };
+  if (use_stable_sort) {
+    std::stable_sort(order.begin(), order.end(), index_comparator);
+  } else {
+    std::sort(order.begin(), order.end(), index_comparator);
+  }
+
+  std::deque<Entry> sorted_datas;
+  for (const int64_t idx : order) {
+    sorted_datas.push_back(std::move(datas_[idx]));
+  }
+  datas_.swap(sorted_datas);
+  return true;
+}
+
 // -------------------------------------------------------
 // ReorderingTupleIterator
 // -------------------------------------------------------
@@ -231,4 +294,113 @@ TupleData* ReorderingTupleIterator::Next() {
   return &current_batch_[index];
 }
 
+DistinctRowSet::DistinctRowSet(MemoryAccountant* accountant)
+    : accountant_(accountant), memory_reservation_(accountant) {}
+
+DistinctRowSet::~DistinctRowSet() = default;
+
+int64_t DistinctRowSet::size() const {
+  return static_cast<int64_t>(rows_.size()) +
+         (compact_rows_ == nullptr ? 0 : compact_rows_->size());
+}
+
+bool DistinctRowSet::EncodeRow(const TupleData& row, int num_slots,
+                               std::string* out) {
+  for (int i = 0; i < num_slots; ++i) {
+    if (!CompactKeyEncoder::IsSupportedType(row.slot(i).value().type())) {
+      return false;
+    }
+  }
+  for (int i = 0; i < num_slots; ++i) {
+    CompactKeyEncoder::AppendValue(row.slot(i).value(), out);
+  }
+  return true;
+}
+
+bool DistinctRowSet::InsertRowIfNotPresent(std::unique_ptr<TupleData> row,
+                                           absl::Status* status) {
+  encoded_row_.clear();
+  if (EncodeRow(*row, row->num_slots(), &encoded_row_)) {
+    return InsertEncodedRow(status);
+  }
+  return InsertFingerprintedRow(std::move(row), status);
+}
+
+bool DistinctRowSet::InsertRowIfNotPresent(const TupleData& row, int num_slots,
+                                           absl::Status* status) {
+  encoded_row_.clear();
+  if (EncodeRow(row, num_slots, &encoded_row_)) {
+    return InsertEncodedRow(status);
+  }
+  auto row_copy = std::make_unique<TupleData>(num_slots);
+  for (int i = 0; i < num_slots; ++i) {
+    row_copy->mutable_slot(i)->CopyFromSlot(row.slot(i));
+  }
+  return InsertFingerprintedRow(std::move(row_copy), status);
+}
+
+bool DistinctRowSet::InsertEncodedRow(absl::Status* status) {
+  if (compact_rows_ == nullptr) {
+    compact_rows_ = std::make_unique<CompactKeyTable>(accountant_);
+  }
+  int64_t index;
+  bool inserted;
+  return compact_rows_->Insert(encoded_row_, &index, &inserted, status) &&
+         inserted;
+}
+
+bool DistinctRowSet::InsertFingerprintedRow(std::unique_ptr<TupleData> row,
+                                            absl::Status* status) {
+  const FingerprintedRow fingerprinted_row{absl::Hash<TupleData>()(*row),
+                                           row.get()};
+  if (rows_set_.contains(fingerprinted_row)) {
+    // Duplicate; not inserted
+    return false;
+  }
+  if (!memory_reservation_.Increase(row->GetPhysicalByteSize() + kBytesPerRow,
+                                    status)) {
+    return false;
+  }
+  rows_set_.insert(fingerprinted_row);
+  rows_.push_back(std::move(row));
+  return true;
+}
+
+ValueHashSet::ValueHashSet(MemoryAccountant* accountant)
+    : accountant_(accountant) {}
+
+ValueHashSet::~ValueHashSet() { Clear(); }
+
+bool ValueHashSet::Insert(const Value& value, bool* inserted,
+                          absl::Status* status) {
+  *inserted = false;
+  if (CompactKeyEncoder::IsSupportedType(value.type())) {
+    if (compact_values_ == nullptr) {
+      compact_values_ = std::make_unique<CompactKeyTable>(accountant_);
+    }
+    encoded_value_.clear();
+    CompactKeyEncoder::AppendValue(value, &encoded_value_);
+    int64_t index;
+    return compact_values_->Insert(encoded_value_, &index, inserted, status);
+  }
+
+  if (values_.contains(value)) {
+    return true;
+  }
+  if (!accountant_->RequestBytes(value.physical_byte_size(), status)) {
+    return false;
+  }
+  values_.insert(value);
+  *inserted = true;
+  return true;
+}
+
+void ValueHashSet::Clear() {
+  compact_values_.reset();
+  for (const Value& value : values_) {
+    accountant_->ReturnBytes(value.physical_byte_size());
+  }
+  values_.clear();
+}
+
 }  // namespace zetasql
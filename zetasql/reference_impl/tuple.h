@@ -56,6 +56,8 @@
 
 namespace zetasql {
 
+class CompactKeyTable;
+
 // Stores the mapping of variables (which must all be distinct) to slots in a
 // tuple.
 class TupleSchema {
@@ -729,13 +731,23 @@ class TupleDataDeque {
   // into the appropriate slots. Also updates the memory accountant accordingly.
   absl::Status SetSlot(int slot_idx, std::vector<Value> values);
 
-  // Sorts the deque using std::sort or std::stable_sort.
+  // Sorts the deque using std::sort or std::stable_sort. If 'comparator' has
+  // keys with non-binary collations, their collation sort keys are computed
+  // once per tuple instead of comparing the strings with ICU on every
+  // comparison.
   void Sort(const TupleComparator& comparator, bool use_stable_sort);
 
  private:
   // Stores a TupleData and its memory size.
   using Entry = std::pair<int64_t, std::unique_ptr<TupleData>>;
 
+  // Implements Sort() for a comparator with num_sort_keys() > 0. Returns false
+  // without modifying the deque if the sort keys cannot be computed or do not
+  // fit in the memory budget, in which case the caller sorts with the plain
+  // comparator instead.
+  bool SortWithSortKeys(const TupleComparator& comparator,
+                        bool use_stable_sort);
+
   MemoryAccountant* accountant_;
 
   // Stores TupleDatas and their memory sizes.
@@ -862,15 +874,21 @@ class MemoryReservation {
 
 // Helper class to keep track of a distinct set of TupleData's.
 //
+// Rows whose values all have types supported by CompactKeyEncoder (e.g.,
+// integers and strings) are stored only by their compact encoding. Other rows
+// are stored as TupleData copies, indexed by a precomputed fingerprint so that
+// the set never needs to rehash full rows; rows with equal fingerprints are
+// compared in full.
+//
 // Keeps track of all memory usage, using a MemoryAccountant, and will fail
 // insert operations if the accountant does not have enough memory available.
 // Used memory is freed back to the accountant in the destructor.
 class DistinctRowSet {
  public:
-  explicit DistinctRowSet(MemoryAccountant* accountant)
-      : memory_reservation_(accountant) {}
+  explicit DistinctRowSet(MemoryAccountant* accountant);
   DistinctRowSet(const DistinctRowSet&) = delete;
   DistinctRowSet& operator=(const DistinctRowSet&) = delete;
+  ~DistinctRowSet();
 
   // Inserts a row into the row set, taking ownership of the given row.
   // - If successful, returns true.
@@ -879,21 +897,55 @@ class DistinctRowSet {
   //     memory limits), returns false and sets *status to a non-OK status
   //     describing the error.
   bool InsertRowIfNotPresent(std::unique_ptr<TupleData> row,
-                             absl::Status* status) {
-    if (!zetasql_base::InsertIfNotPresent(&rows_set_, TupleDataPtr(row.get()))) {
-      // Duplicate; not inserted
-      return false;
+                             absl::Status* status);
+
+  // Like above, but inserts the first <num_slots> slots of <row>. The slots are
+  // only copied into a new TupleData if they have no compact encoding.
+  bool InsertRowIfNotPresent(const TupleData& row, int num_slots,
+                             absl::Status* status);
+
+  // Returns the number of rows in the row set.
+  int64_t size() const;
+
+ private:
+  // A row stored as a TupleData, along with its fingerprint.
+  struct FingerprintedRow {
+    size_t fingerprint;
+    const TupleData* row;
+
+    bool operator==(const FingerprintedRow& other) const {
+      return fingerprint == other.fingerprint && *row == *other.row;
     }
-    if (!memory_reservation_.Increase(row->GetPhysicalByteSize(), status)) {
-      return false;
+
+    template <typename H>
+    friend H AbslHashValue(H h, const FingerprintedRow& r) {
+      return H::combine(std::move(h), r.fingerprint);
     }
-    rows_.push_back(std::move(row));
-    return true;
-  }
+  };
 
- private:
+  // Approximate bytes used per row by 'rows_' and 'rows_set_', in addition to
+  // the row itself.
+  static constexpr int64_t kBytesPerRow =
+      sizeof(std::unique_ptr<TupleData>) + sizeof(FingerprintedRow) + 1;
+
+  // Returns true and appends the compact encoding of the first <num_slots>
+  // slots of <row> to <*out> if they all have supported types.
+  static bool EncodeRow(const TupleData& row, int num_slots, std::string* out);
+
+  // Inserts the row encoded in 'encoded_row_'.
+  bool InsertEncodedRow(absl::Status* status);
+
+  // Inserts <row>, which has no compact encoding.
+  bool InsertFingerprintedRow(std::unique_ptr<TupleData> row,
+                              absl::Status* status);
+
+  MemoryAccountant* accountant_;
+  // Encodings of the rows that have one. Created on first use.
+  std::unique_ptr<CompactKeyTable> compact_rows_;
+  // Scratch space for encoding rows.
+  std::string encoded_row_;
   std::vector<std::unique_ptr<TupleData>> rows_;
-  absl::flat_hash_set<TupleDataPtr> rows_set_;
+  absl::flat_hash_set<FingerprintedRow> rows_set_;
   MemoryReservation memory_reservation_;
 };
 
@@ -960,41 +1012,29 @@ class ArrayBuilder {
 // Represents a hash set of values with memory tracked by a MemoryAccountant.
 class ValueHashSet {
  public:
-  explicit ValueHashSet(MemoryAccountant* accountant)
-      : accountant_(accountant) {}
+  explicit ValueHashSet(MemoryAccountant* accountant);
 
   ValueHashSet(const ValueHashSet&) = delete;
   ValueHashSet& operator=(const ValueHashSet&) = delete;
 
-  ~ValueHashSet() { Clear(); }
+  ~ValueHashSet();
 
   // If 'value' is in the underlying set, sets 'inserted' to false and returns
   // true. Otherwise requests bytes. If that succeeds, inserts 'value' into the
   // underlying set, sets 'inserted' to true, and returns false. Otherwise,
   // populates 'status' and returns false.
-  bool Insert(const Value& value, bool* inserted, absl::Status* status) {
-    *inserted = false;
-    if (values_.contains(value)) {
-      return true;
-    }
-    if (!accountant_->RequestBytes(value.physical_byte_size(), status)) {
-      return false;
-    }
-    values_.insert(value);
-    *inserted = true;
-    return true;
-  }
+  bool Insert(const Value& value, bool* inserted, absl::Status* status);
 
   // Clear the hash set.
-  void Clear() {
-    for (const Value& value : values_) {
-      accountant_->ReturnBytes(value.physical_byte_size());
-    }
-    values_.clear();
-  }
+  void Clear();
 
  private:
   MemoryAccountant* accountant_;
+  // Values whose types are supported by CompactKeyEncoder are stored only by
+  // their encoding. Created on first use.
+  std::unique_ptr<CompactKeyTable> compact_values_;
+  // Scratch space for encoding values.
+  std::string encoded_value_;
   absl::flat_hash_set<Value> values_;
 };
 
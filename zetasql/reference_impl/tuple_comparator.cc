@@ -35,6 +35,7 @@
 #include <cstdint>
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/cord.h"
 #include "absl/strings/string_view.h"
 #include "zetasql/base/source_location.h"
 #include "zetasql/base/ret_check.h"
@@ -109,8 +110,25 @@ absl::StatusOr<std::unique_ptr<TupleComparator>> TupleComparator::Create(
   return absl::WrapUnique(new TupleComparator(keys, slots_for_keys, collators));
 }
 
-bool TupleComparator::operator()(const TupleData& t1,
-                                 const TupleData& t2) const {
+TupleComparator::TupleComparator(absl::Span<const KeyArg* const> keys,
+                                 absl::Span<const int> slots_for_keys,
+                                 std::shared_ptr<const CollatorList> collators)
+    : keys_(keys.begin(), keys.end()),
+      slots_for_keys_(slots_for_keys.begin(), slots_for_keys.end()),
+      collators_(collators) {
+  sort_key_indexes_.reserve(collators_->size());
+  for (const std::unique_ptr<const ZetaSqlCollator>& collator : *collators_) {
+    if (collator != nullptr && !collator->IsBinaryComparison()) {
+      sort_key_indexes_.push_back(num_sort_keys_++);
+    } else {
+      sort_key_indexes_.push_back(-1);
+    }
+  }
+}
+
+template <typename CompareCollated>
+bool TupleComparator::LessThan(const TupleData& t1, const TupleData& t2,
+                               const CompareCollated& compare_collated) const {
   for (int i = 0; i < keys_.size(); ++i) {
     const KeyArg* key = keys_[i];
     const ZetaSqlCollator* collator = (*collators_)[i].get();
@@ -139,10 +157,7 @@ bool TupleComparator::operator()(const TupleData& t1,
     if (collator != nullptr) {
       ABSL_DCHECK(v1.type()->IsString());
       ABSL_DCHECK(v2.type()->IsString());
-      absl::Status status;
-      int64_t result =
-          collator->CompareUtf8(v1.string_value(), v2.string_value(), &status);
-      ZETASQL_DCHECK_OK(status);
+      const int64_t result = compare_collated(i, v1, v2);
       if (result != 0) {  // v1 != v2
         if (key->is_descending()) {
           return result > 0;  // v1 > v2
@@ -164,6 +179,53 @@ bool TupleComparator::operator()(const TupleData& t1,
   return false;
 }
 
+bool TupleComparator::operator()(const TupleData& t1,
+                                 const TupleData& t2) const {
+  return LessThan(t1, t2, [this](int i, const Value& v1, const Value& v2) {
+    absl::Status status;
+    const int64_t result = (*collators_)[i]->CompareUtf8(
+        v1.string_value(), v2.string_value(), &status);
+    ZETASQL_DCHECK_OK(status);
+    return result;
+  });
+}
+
+absl::Status TupleComparator::AppendSortKeys(
+    const TupleData& t, std::vector<std::string>* sort_keys) const {
+  absl::Cord sort_key;
+  for (int i = 0; i < keys_.size(); ++i) {
+    if (sort_key_indexes_[i] < 0) continue;
+    const Value& value = t.slot(slots_for_keys_[i]).value();
+    ZETASQL_RET_CHECK(value.type()->IsString()) << value.type()->DebugString();
+    std::string& out = sort_keys->emplace_back();
+    if (value.is_null()) continue;
+    ZETASQL_RETURN_IF_ERROR(
+        (*collators_)[i]->GetSortKeyUtf8(value.string_value(), &sort_key));
+    absl::CopyCordToString(sort_key, &out);
+  }
+  return absl::OkStatus();
+}
+
+bool TupleComparator::LessWithSortKeys(
+    const TupleData& t1, absl::Span<const std::string> sort_keys1,
+    const TupleData& t2, absl::Span<const std::string> sort_keys2) const {
+  ABSL_DCHECK_EQ(sort_keys1.size(), num_sort_keys_);
+  ABSL_DCHECK_EQ(sort_keys2.size(), num_sort_keys_);
+  return LessThan(t1, t2, [&](int i, const Value& v1, const Value& v2) {
+    const int sort_key_idx = sort_key_indexes_[i];
+    if (sort_key_idx < 0) {
+      // Binary collation.
+      const int result = v1.string_value().compare(v2.string_value());
+      return static_cast<int64_t>(result < 0 ? -1 : (result > 0 ? 1 : 0));
+    }
+    // ICU sort keys compare bytewise like the strings compare under the
+    // collator. std::string::compare() uses memcmp() on the bytes.
+    const int result =
+        sort_keys1[sort_key_idx].compare(sort_keys2[sort_key_idx]);
+    return static_cast<int64_t>(result < 0 ? -1 : (result > 0 ? 1 : 0));
+  });
+}
+
 bool TupleComparator::IsUniquelyOrdered(
     absl::Span<const TupleData* const> tuples,
     absl::Span<const int> slot_idxs_for_values) const {
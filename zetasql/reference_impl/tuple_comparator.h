@@ -18,11 +18,13 @@
 #define ZETASQL_REFERENCE_IMPL_TUPLE_COMPARATOR_H_
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "zetasql/common/internal_value.h"
 #include "zetasql/public/collator.h"
 #include "zetasql/reference_impl/common.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/types/span.h"
 #include "zetasql/base/status.h"
@@ -75,13 +77,37 @@ class TupleComparator {
 
   const std::vector<const KeyArg*>& keys() const { return keys_; }
 
+  // Returns the number of keys whose collator is not a simple binary
+  // comparison. Comparing such keys goes through ICU on every call, so callers
+  // that compare each tuple many times (e.g., sorting) should compute their
+  // collation sort keys once with AppendSortKeys() and use LessWithSortKeys().
+  int num_sort_keys() const { return num_sort_keys_; }
+
+  // Appends num_sort_keys() collation sort keys for <t> to <*sort_keys>, one
+  // for each key with a non-binary collator, in key order. The sort key of a
+  // NULL value is empty.
+  absl::Status AppendSortKeys(const TupleData& t,
+                              std::vector<std::string>* sort_keys) const;
+
+  // Same as operator(), but compares the keys with non-binary collators by
+  // memcmp() on <sort_keys1> and <sort_keys2>, which must have been produced
+  // by AppendSortKeys() for <t1> and <t2>.
+  bool LessWithSortKeys(const TupleData& t1,
+                        absl::Span<const std::string> sort_keys1,
+                        const TupleData& t2,
+                        absl::Span<const std::string> sort_keys2) const;
+
  private:
   TupleComparator(absl::Span<const KeyArg* const> keys,
                   absl::Span<const int> slots_for_keys,
-                  std::shared_ptr<const CollatorList> collators)
-      : keys_(keys.begin(), keys.end()),
-        slots_for_keys_(slots_for_keys.begin(), slots_for_keys.end()),
-        collators_(collators) {}
+                  std::shared_ptr<const CollatorList> collators);
+
+  // Shared implementation of operator() and LessWithSortKeys().
+  // <compare_collated(i, v1, v2)> returns the three-way comparison of the
+  // non-NULL values <v1> and <v2> of key i, which has a collator.
+  template <typename CompareCollated>
+  bool LessThan(const TupleData& t1, const TupleData& t2,
+                const CompareCollated& compare_collated) const;
 
   const std::vector<const KeyArg*> keys_;
   const std::vector<int> slots_for_keys_;
@@ -91,6 +117,11 @@ class TupleComparator {
   // compared based on their UTF-8 encoding.
   // We use std::shared_ptr<const ...> to allow the comparator to be copied.
   const std::shared_ptr<const CollatorList> collators_;
+  // <sort_key_indexes_[i]> is the index of the collation sort key of keys_[i]
+  // among those produced by AppendSortKeys(), or -1 if keys_[i] has no
+  // collator or a binary one.
+  std::vector<int> sort_key_indexes_;
+  int num_sort_keys_ = 0;
 };
 
 }  // namespace zetasql
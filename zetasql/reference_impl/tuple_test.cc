@@ -564,6 +564,92 @@ TEST(ValueHashSet, DestructorTest) {
   EXPECT_EQ(accountant.remaining_bytes(), 1000);
 }
 
+TEST(ValueHashSet, MixedTypes) {
+  MemoryAccountant accountant(/*total_num_bytes=*/10000, "test_limit");
+  ValueHashSet set(&accountant);
+  // INT64 and STRING values are stored in their compact encoding, while DOUBLE
+  // values are stored as Values. Equal values of different types are distinct.
+  for (const Value& value : {Int64(1), Int32(1), Double(1), String("1"),
+                             NullInt64(), NullDouble()}) {
+    bool inserted;
+    absl::Status status;
+    EXPECT_TRUE(set.Insert(value, &inserted, &status)) << status;
+    EXPECT_TRUE(inserted) << value.DebugString();
+    EXPECT_TRUE(set.Insert(value, &inserted, &status)) << status;
+    EXPECT_FALSE(inserted) << value.DebugString();
+  }
+  EXPECT_LT(accountant.remaining_bytes(), 10000);
+
+  set.Clear();
+  EXPECT_EQ(accountant.remaining_bytes(), 10000);
+  bool inserted;
+  absl::Status status;
+  EXPECT_TRUE(set.Insert(Int64(1), &inserted, &status));
+  EXPECT_TRUE(inserted);
+}
+
+TEST(DistinctRowSet, InsertRowIfNotPresent) {
+  MemoryAccountant accountant(/*total_num_bytes=*/10000, "test_limit");
+  {
+    DistinctRowSet row_set(&accountant);
+    absl::Status status;
+    // Rows of INT64 and STRING use the compact encoding, rows with a DOUBLE
+    // are fingerprinted.
+    const std::vector<TupleData> rows = CreateTestTupleDatas({
+        {Int64(1), String("a")},
+        {Int64(1), String("b")},
+        {Int64(1), Double(1)},
+        {Int64(1), Double(2)},
+        {Int64(1), NullDouble()},
+    });
+    for (const TupleData& row : rows) {
+      EXPECT_TRUE(row_set.InsertRowIfNotPresent(
+          std::make_unique<TupleData>(row), &status))
+          << row.DebugString();
+      EXPECT_FALSE(row_set.InsertRowIfNotPresent(
+          std::make_unique<TupleData>(row), &status))
+          << row.DebugString();
+      ZETASQL_EXPECT_OK(status);
+    }
+
+    // Only the first slots are considered.
+    const TupleData row_with_extra_slot =
+        CreateTestTupleData({Int64(1), String("a"), Int64(5)});
+    EXPECT_FALSE(
+        row_set.InsertRowIfNotPresent(row_with_extra_slot, 2, &status));
+    const TupleData double_row_with_extra_slot =
+        CreateTestTupleData({Int64(1), Double(1), Int64(5)});
+    EXPECT_FALSE(
+        row_set.InsertRowIfNotPresent(double_row_with_extra_slot, 2, &status));
+    EXPECT_TRUE(row_set.InsertRowIfNotPresent(
+        CreateTestTupleData({Int64(2), Double(1), Int64(5)}), 2, &status));
+    ZETASQL_EXPECT_OK(status);
+    EXPECT_LT(accountant.remaining_bytes(), 10000);
+  }
+  EXPECT_EQ(accountant.remaining_bytes(), 10000);
+}
+
+TEST(DistinctRowSet, MemoryLimit) {
+  MemoryAccountant accountant(/*total_num_bytes=*/1000, "test_limit");
+  for (const Value& first_value : {Int64(0), Double(0)}) {
+    DistinctRowSet row_set(&accountant);
+    absl::Status status;
+    int num_rows = 0;
+    while (row_set.InsertRowIfNotPresent(
+        CreateTestTupleData({first_value, Int64(num_rows)}), 2, &status)) {
+      ++num_rows;
+    }
+    EXPECT_THAT(status, StatusIs(absl::StatusCode::kResourceExhausted));
+    EXPECT_GE(num_rows, 1) << first_value.DebugString();
+    // Rows that were already inserted are still recognized as duplicates.
+    status = absl::OkStatus();
+    EXPECT_FALSE(row_set.InsertRowIfNotPresent(
+        CreateTestTupleData({first_value, Int64(0)}), 2, &status));
+    ZETASQL_EXPECT_OK(status);
+  }
+  EXPECT_EQ(accountant.remaining_bytes(), 1000);
+}
+
 TEST(MemoryReservation, Basic) {
   MemoryAccountant accountant(/*total_num_bytes=*/1000, "test_limit");
   MemoryReservation res(&accountant);
@@ -463,7 +463,13 @@ DerefExpr::DerefExpr(const VariableId& name, const Type* type)
 
 absl::StatusOr<std::unique_ptr<ConstExpr>> ConstExpr::Create(
     const Value& value) {
-  return absl::WrapUnique(new ConstExpr(value));
+  return absl::WrapUnique(new ConstExpr(value, /*folded_from=*/""));
+}
+
+absl::StatusOr<std::unique_ptr<ConstExpr>> ConstExpr::CreateFolded(
+    const Value& value, std::string folded_from) {
+  ZETASQL_RET_CHECK(!folded_from.empty());
+  return absl::WrapUnique(new ConstExpr(value, std::move(folded_from)));
 }
 
 absl::Status ConstExpr::SetSchemasForEvaluation(
@@ -481,10 +487,15 @@ bool ConstExpr::Eval(absl::Span<const TupleData* const> /* params */,
 
 std::string ConstExpr::DebugInternal(const std::string& indent,
                                      bool verbose) const {
+  if (!folded_from_.empty()) {
+    return absl::StrCat("ConstExpr(", value().DebugString(verbose),
+                        ", folded from ", folded_from_, ")");
+  }
   return absl::StrCat("ConstExpr(", value().DebugString(verbose), ")");
 }
 
-ConstExpr::ConstExpr(const Value& value) : ValueExpr(value.type()) {
+ConstExpr::ConstExpr(const Value& value, std::string folded_from)
+    : ValueExpr(value.type()), folded_from_(std::move(folded_from)) {
   slot_.SetValue(value);
 }
 
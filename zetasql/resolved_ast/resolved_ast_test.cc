@@ -41,6 +41,7 @@
 #include "zetasql/resolved_ast/validator.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "absl/types/span.h"
 #include "zetasql/base/status.h"
 
 namespace zetasql {
@@ -415,6 +416,28 @@ JoinScan
   ZETASQL_EXPECT_OK(node->CheckFieldsAccessed());
 }
 
+TEST_F(ResolvedASTTest, SaveAndRestoreFieldsAccessed) {
+  std::unique_ptr<const ResolvedJoinScan> node = MakeJoin();
+  AsTableScan(node->left_scan())->table()->FullName();
+  node->right_scan();
+  const std::string message(node->CheckFieldsAccessed().message());
+  EXPECT_THAT(message, HasSubstr("ResolvedTableScan::table not accessed"));
+
+  std::vector<uint32_t> accessed;
+  node->SaveFieldsAccessed(&accessed);
+  node->MarkFieldsAccessed();
+  ZETASQL_EXPECT_OK(node->CheckFieldsAccessed());
+  absl::Span<const uint32_t> saved(accessed);
+  node->RestoreFieldsAccessed(&saved);
+  EXPECT_TRUE(saved.empty());
+  EXPECT_EQ(node->CheckFieldsAccessed().message(), message);
+
+  node->ClearFieldsAccessed();
+  saved = accessed;
+  node->RestoreFieldsAccessed(&saved);
+  EXPECT_EQ(node->CheckFieldsAccessed().message(), message);
+}
+
 // Test CheckFieldsAccessed on a vector field.
 TEST_F(ResolvedASTTest, CheckVectorFieldsAccessed) {
   TypeFactory type_factory;
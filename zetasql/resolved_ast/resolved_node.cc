@@ -207,6 +207,11 @@ void ResolvedNode::ClearFieldsAccessed() const {}
 
 void ResolvedNode::MarkFieldsAccessed() const {}
 
+void ResolvedNode::SaveFieldsAccessed(std::vector<uint32_t>* accessed) const {}
+
+void ResolvedNode::RestoreFieldsAccessed(
+    absl::Span<const uint32_t>* accessed) const {}
+
 // NOTE: An equivalent method on ASTNodes exists in ../parser/parse_tree.cc.
 void ResolvedNode::GetDescendantsWithKinds(
     const std::set<ResolvedNodeKind>& node_kinds,
@@ -17,6 +17,7 @@
 #ifndef ZETASQL_RESOLVED_AST_RESOLVED_NODE_H_
 #define ZETASQL_RESOLVED_AST_RESOLVED_NODE_H_
 
+#include <cstdint>
 #include <memory>
 #include <set>
 #include <string>
@@ -235,6 +236,19 @@ class ResolvedNode {
   // ensures that new fields added in the future are not accidentally ignored.
   virtual void MarkFieldsAccessed() const;
 
+  // Appends the field accessed markers of this node and its children to
+  // 'accessed'. Engines can use this together with RestoreFieldsAccessed()
+  // around code that inspects a node without interpreting it, e.g. to compare
+  // it with another node, so that CheckFieldsAccessed() still reports the
+  // fields that were not interpreted.
+  virtual void SaveFieldsAccessed(std::vector<uint32_t>* accessed) const;
+
+  // Restores the field accessed markers of this node and its children from
+  // the front of 'accessed', which must have been saved by
+  // SaveFieldsAccessed() on this node, and removes them from 'accessed'.
+  virtual void RestoreFieldsAccessed(
+      absl::Span<const uint32_t>* accessed) const;
+
   // Returns in 'child_nodes' all non-NULL ResolvedNodes that are children of
   // this node. The order of 'child_nodes' is deterministic, but callers should
   // not depend on how the roles (fields) correspond to locations, especially
@@ -66,6 +66,8 @@ ABSL_FLAG(std::string, mode, "execute",
           "\n     'analyze'  print the resolved AST"
           "\n     'unanalyze'  analyze, then dump as sql"
           "\n     'explain'  print the evaluator query plan"
+          "\n     'explain_analyze'  run the query and print the evaluator"
+          "                  query plan with per-operator statistics"
           "\n     'execute'  actually run the query and print the result. (not"
           "                  all functionality is supported).");
 
@@ -168,6 +170,9 @@ absl::Status SetToolModeFromFlags(ExecuteQueryConfig& config) {
   } else if (mode == "explain") {
     config.set_tool_mode(ToolMode::kExplain);
     return absl::OkStatus();
+  } else if (mode == "explain_analyze") {
+    config.set_tool_mode(ToolMode::kExplainAnalyze);
+    return absl::OkStatus();
   } else if (mode == "execute") {
     config.set_tool_mode(ToolMode::kExecute);
     return absl::OkStatus();
@@ -512,8 +517,11 @@ absl::Status ExecuteQuery(absl::string_view sql, ExecuteQueryConfig& config,
   if (config.sql_mode() == SqlMode::kQuery) {
     ZETASQL_RET_CHECK_EQ(resolved_node->node_kind(), RESOLVED_QUERY_STMT);
 
+    EvaluatorOptions evaluator_options = config.evaluator_options();
+    evaluator_options.collect_operator_profile =
+        config.tool_mode() == ToolMode::kExplainAnalyze;
     PreparedQuery query{resolved_node->GetAs<ResolvedQueryStmt>(),
-                        config.evaluator_options()};
+                        evaluator_options};
 
     ZETASQL_RETURN_IF_ERROR(
         query.Prepare(config.analyzer_options(), &config.mutable_catalog()));
@@ -525,6 +533,18 @@ absl::Status ExecuteQuery(absl::string_view sql, ExecuteQueryConfig& config,
 
         return writer.explained(*resolved_node, explain);
       }
+      case ToolMode::kExplainAnalyze: {
+        ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<EvaluatorTableIterator> iter,
+                         query.ExecuteAfterPrepare(
+                             {.parameters = config.query_parameter_values()}));
+        while (iter->NextRow()) {
+        }
+        ZETASQL_RETURN_IF_ERROR(iter->Status());
+        ZETASQL_ASSIGN_OR_RETURN(const std::string explain,
+                         query.ExplainAnalyze(*iter));
+
+        return writer.explained(*resolved_node, explain);
+      }
       case ToolMode::kExecute: {
         ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<EvaluatorTableIterator> iter,
                          query.ExecuteAfterPrepare(
@@ -560,6 +580,9 @@ absl::Status ExecuteQuery(absl::string_view sql, ExecuteQueryConfig& config,
 
         return writer.ExecutedExpression(*resolved_node, value);
       }
+      case ToolMode::kExplainAnalyze:
+        return zetasql_base::InvalidArgumentErrorBuilder()
+               << "--mode=explain_analyze is only supported for queries";
       default:
         return absl::InternalError(absl::StrCat(
             "unknown tool mode: ", static_cast<int>(config.tool_mode())));
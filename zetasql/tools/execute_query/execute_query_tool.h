@@ -67,6 +67,10 @@ class ExecuteQueryConfig {
     // reference implementation.
     kExplain,
 
+    // Execute the query, discarding the result, and print the query plan
+    // annotated with the rows, time and memory used by each operator.
+    kExplainAnalyze,
+
     // Execute the query and pretty print the result.
     kExecute
   };
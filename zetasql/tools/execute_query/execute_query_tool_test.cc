@@ -84,6 +84,7 @@ TEST(SetToolModeFromFlags, ToolMode) {
   CheckFlag("resolve", ToolMode::kResolve);
   CheckFlag("unanalyze", ToolMode::kUnAnalyze);
   CheckFlag("explain", ToolMode::kExplain);
+  CheckFlag("explain_analyze", ToolMode::kExplainAnalyze);
   CheckFlag("execute", ToolMode::kExecute);
 }
 
@@ -575,6 +576,67 @@ TEST(ExecuteQuery, ExplainQuery) {
 )");
 }
 
+TEST(ExecuteQuery, ExplainFoldsConstants) {
+  ExecuteQueryConfig config;
+  config.set_tool_mode(ToolMode::kExplain);
+  std::ostringstream output;
+  ZETASQL_EXPECT_OK(ExecuteQuery("select 1 + 2, div(1, 0)", config, output));
+  EXPECT_THAT(output.str(),
+              HasSubstr("ConstExpr(3, folded from Add(ConstExpr(1), "
+                        "ConstExpr(2)))"));
+  // Errors are left to be raised at runtime.
+  EXPECT_THAT(output.str(), HasSubstr("Div(ConstExpr(1), ConstExpr(0))"));
+}
+
+TEST(ExecuteQuery, ExplainSharesCommonSubexpressions) {
+  ExecuteQueryConfig config;
+  config.set_tool_mode(ToolMode::kExplain);
+  std::ostringstream output;
+  ZETASQL_EXPECT_OK(ExecuteQuery(
+      "select x * 3 as a, x * 3 + 1 as b from unnest([1, 2, 3]) as x "
+      "where x * 3 > 4",
+      config, output));
+  // The filter computes x * 3 once, and the projection reuses it.
+  const std::string explain = output.str();
+  EXPECT_THAT(explain, HasSubstr("$cse := Multiply("));
+  EXPECT_EQ(explain.find("Multiply("), explain.rfind("Multiply("));
+}
+
+TEST(ExecuteQuery, ExplainShowsWithEntryPlan) {
+  ExecuteQueryConfig config;
+  config.set_tool_mode(ToolMode::kExplain);
+  std::ostringstream output;
+  ZETASQL_EXPECT_OK(ExecuteQuery(
+      "with a as (select 1 as x), b as (select x from a), "
+      "c as (select 2 as y), d as (select 3 as z) "
+      "select * from b, c as c1, c as c2 "
+      "where x < (select max(z) from d)",
+      config, output));
+  const std::string explain = output.str();
+  // 'a' and 'b' are referenced once, so they are inlined.
+  EXPECT_THAT(explain, HasSubstr("ComputeOp(inlined_with_entry=a"));
+  EXPECT_THAT(explain, HasSubstr("ComputeOp(inlined_with_entry=b"));
+  // 'c' is referenced twice, and 'd' is referenced from a subquery expression
+  // that is evaluated for each row, so both are materialized.
+  EXPECT_THAT(explain, Not(HasSubstr("inlined_with_entry=c")));
+  EXPECT_THAT(explain, Not(HasSubstr("inlined_with_entry=d")));
+  EXPECT_THAT(explain, HasSubstr("ArrayNestExpr(is_with_table=1"));
+}
+
+TEST(ExecuteQuery, ExplainAnalyzeShowsOperatorStatistics) {
+  ExecuteQueryConfig config;
+  config.set_tool_mode(ToolMode::kExplainAnalyze);
+  std::ostringstream output;
+  ZETASQL_EXPECT_OK(ExecuteQuery(
+      "select x, count(*) from unnest([1, 2, 2, 3, 3, 3]) as x group by x",
+      config, output));
+  const std::string explain = output.str();
+  EXPECT_THAT(explain, HasSubstr("Profile:"));
+  EXPECT_THAT(explain, HasSubstr("AggregateOp: iterators=1 rows=3"));
+  EXPECT_THAT(explain, HasSubstr("hash_table_size=3"));
+  EXPECT_THAT(explain, HasSubstr("ArrayScanOp: iterators=1 rows=6"));
+}
+
 TEST(ExecuteQuery, ExecuteQuery) {
   ExecuteQueryConfig config;
   config.set_tool_mode(ToolMode::kExecute);